@@ -5,6 +5,7 @@
 #include "DatabaseEnv.h"
 #include "Language.h"
 #include "ObjectAccessor.h"
+#include "PvPMgr.h"
 
 ArenaTeamMgr::ArenaTeamMgr()
 {
@@ -143,7 +144,7 @@ void ArenaTeamMgr::ResetWeeklyCap()
         }
     }
 
-    CharacterDatabase.PExecute("UPDATE characters SET weeklyArenaPoints = 0, arenaPointsCap = 0");
+    sPvPMgr->ResetWeeklyArenaPoints();
 
     sWorld->SendGlobalText("Update of arena statistics finished.", NULL);
 }
@@ -2414,6 +2414,7 @@ static bool HandleResetStatsOrLevelHelper(Player* player)
 
     player->SetFloatValue(UNIT_FIELD_BOUNDINGRADIUS, DEFAULT_WORLD_OBJECT_SIZE);
     player->SetFloatValue(UNIT_FIELD_COMBATREACH, DEFAULT_COMBAT_REACH);
+    player->UpdateCellIndex();
 
     player->setFactionForRace(player->getRace());
 
@@ -2618,10 +2619,13 @@ bool ChatHandler::HandleResetAllCommand(const char* args)
 
     CharacterDatabase.Execute(stmt);
 
-    AXIUM_READ_GUARD(HashMapHolder<Player>::LockType, *HashMapHolder<Player>::GetLock());
-    HashMapHolder<Player>::MapType const& plist = sObjectAccessor->GetPlayers();
-    for (HashMapHolder<Player>::MapType::const_iterator itr = plist.begin(); itr != plist.end(); ++itr)
-        itr->second->SetAtLoginFlag(atLogin);
+    for (uint32 shard = 0; shard < HashMapHolder<Player>::SHARDS; ++shard)
+    {
+        AXIUM_READ_GUARD(HashMapHolder<Player>::LockType, *HashMapHolder<Player>::GetLock(shard));
+        HashMapHolder<Player>::MapType const& plist = sObjectAccessor->GetPlayers(shard);
+        for (HashMapHolder<Player>::MapType::const_iterator itr = plist.begin(); itr != plist.end(); ++itr)
+            itr->second->SetAtLoginFlag(atLogin);
+    }
 
     return true;
 }
@@ -4438,20 +4442,23 @@ bool ChatHandler::HandlePlayAllCommand(const char* args)
 
 bool ChatHandler::HandleKillAllOrcsCommand(const char* args)
 {
-    AXIUM_READ_GUARD(HashMapHolder<Player>::LockType, *HashMapHolder<Player>::GetLock());
-    HashMapHolder<Player>::MapType const& m = sObjectAccessor->GetPlayers();
-    for (HashMapHolder<Player>::MapType::const_iterator itr = m.begin(); itr != m.end(); ++itr)
+    for (uint32 shard = 0; shard < HashMapHolder<Player>::SHARDS; ++shard)
     {
-        if (!itr->second->isAlive())
-            continue;
+        AXIUM_READ_GUARD(HashMapHolder<Player>::LockType, *HashMapHolder<Player>::GetLock(shard));
+        HashMapHolder<Player>::MapType const& m = sObjectAccessor->GetPlayers(shard);
+        for (HashMapHolder<Player>::MapType::const_iterator itr = m.begin(); itr != m.end(); ++itr)
+        {
+            if (!itr->second->isAlive())
+                continue;
 
-        if (itr->second->InArena())
-            continue;
+            if (itr->second->InArena())
+                continue;
 
-        if (itr->second->getRace() != RACE_ORC)
-            continue;
+            if (itr->second->getRace() != RACE_ORC)
+                continue;
 
-        itr->second->Kill(itr->second, false);
+            itr->second->Kill(itr->second, false);
+        }
     }
     WorldPacket data(SMSG_PLAY_SOUND, 4);
     data << uint32(1322) << m_session->GetPlayer()->GetGUID();
@@ -331,6 +331,7 @@ bool Creature::InitEntry(uint32 Entry, uint32 /*team*/, const CreatureData* data
 
     SetFloatValue(UNIT_FIELD_BOUNDINGRADIUS, minfo->bounding_radius);
     SetFloatValue(UNIT_FIELD_COMBATREACH, minfo->combat_reach);
+    UpdateCellIndex();
 
     SetFloatValue(UNIT_MOD_CAST_SPEED, 1.0f);
 
@@ -1776,10 +1777,6 @@ SpellInfo const* Creature::reachWithSpellCure(Unit* pVictim)
 // select nearest hostile unit within the given distance (regardless of threat list).
 Unit* Creature::SelectNearestTarget(float dist) const
 {
-    CellCoord p(Axium::ComputeCellCoord(GetPositionX(), GetPositionY()));
-    Cell cell(p);
-    cell.SetNoCreate();
-
     Unit* target = NULL;
 
     {
@@ -1789,11 +1786,9 @@ Unit* Creature::SelectNearestTarget(float dist) const
         Axium::NearestHostileUnitCheck u_check(this, dist);
         Axium::UnitLastSearcher<Axium::NearestHostileUnitCheck> searcher(this, target, u_check);
 
-        TypeContainerVisitor<Axium::UnitLastSearcher<Axium::NearestHostileUnitCheck>, WorldTypeMapContainer > world_unit_searcher(searcher);
-        TypeContainerVisitor<Axium::UnitLastSearcher<Axium::NearestHostileUnitCheck>, GridTypeMapContainer >  grid_unit_searcher(searcher);
-
-        cell.Visit(p, world_unit_searcher, *GetMap(), *this, dist);
-        cell.Visit(p, grid_unit_searcher, *GetMap(), *this, dist);
+        // the check adds the size of both units to dist
+        CellIndexQuery query(GetPositionX(), GetPositionY(), dist + GetObjectSize(), TYPEMASK_UNIT);
+        GetMap()->VisitIndexed(query, searcher);
     }
 
     return target;
@@ -1864,16 +1859,13 @@ void Creature::CallAssistance()
             std::list<Creature*> assistList;
 
             {
-                CellCoord p(Axium::ComputeCellCoord(GetPositionX(), GetPositionY()));
-                Cell cell(p);
-                cell.SetNoCreate();
-
                 Axium::AnyAssistCreatureInRangeCheck u_check(this, getVictim(), radius);
                 Axium::CreatureListSearcher<Axium::AnyAssistCreatureInRangeCheck> searcher(this, assistList, u_check);
 
-                TypeContainerVisitor<Axium::CreatureListSearcher<Axium::AnyAssistCreatureInRangeCheck>, GridTypeMapContainer >  grid_creature_searcher(searcher);
-
-                cell.Visit(p, grid_creature_searcher, *GetMap(), *this, radius);
+                // creatures of the grid object lists only, the check adds the size of both to radius
+                CellIndexQuery query(GetPositionX(), GetPositionY(), radius + GetObjectSize(), TYPEMASK_UNIT);
+                query.lists = CELL_INDEX_GRID_OBJECT;
+                GetMap()->VisitIndexed(query, searcher);
             }
 
             if (!assistList.empty())
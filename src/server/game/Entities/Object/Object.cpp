@@ -55,16 +55,21 @@ Object::Object() : m_PackGUID(sizeof(uint64)+1)
 
     m_uint32Values      = NULL;
     _changedFields      = NULL;
+    _lowDetailChangedFields = NULL;
     m_valuesCount       = 0;
 
     m_inWorld           = false;
     m_objectUpdated     = false;
+    m_lowDetailPending  = false;
+    m_lowDetailTime     = 0;
 
     m_PackGUID.appendPackGUID(0);
 }
 
 WorldObject::~WorldObject()
 {
+    CellIndex::Remove(this);
+
     // this may happen because there are many !create/delete
     if (IsWorldObject() && m_currMap)
     {
@@ -97,7 +102,7 @@ Object::~Object()
 
     delete [] m_uint32Values;
     delete [] _changedFields;
-
+    delete [] _lowDetailChangedFields;
 }
 
 void Object::_InitValues()
@@ -257,17 +262,20 @@ void Object::SendUpdateToPlayer(Player* player)
 void Object::BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target) const
 {
     ByteBuffer buf(500);
+    _BuildValuesUpdateBlock(&buf, target);
+    data->AddUpdateBlock(buf);
+}
 
-    buf << (uint8) UPDATETYPE_VALUES;
-    buf.append(GetPackGUID());
+void Object::_BuildValuesUpdateBlock(ByteBuffer* data, Player* target) const
+{
+    *data << (uint8) UPDATETYPE_VALUES;
+    data->append(GetPackGUID());
 
     UpdateMask updateMask;
     updateMask.SetCount(m_valuesCount);
 
     _SetUpdateBits(&updateMask, target);
-    _BuildValuesUpdate(UPDATETYPE_VALUES, &buf, &updateMask, target);
-
-    data->AddUpdateBlock(buf);
+    _BuildValuesUpdate(UPDATETYPE_VALUES, data, &updateMask, target);
 }
 
 void Object::BuildOutOfRangeUpdateBlock(UpdateData* data) const
@@ -714,6 +722,30 @@ void Object::ClearUpdateMask(bool remove)
             sObjectAccessor->RemoveUpdateObject(this);
         m_objectUpdated = false;
     }
+
+    if (remove && m_lowDetailPending)
+    {
+        sObjectAccessor->RemoveLowDetailObject(this);
+        memset(_lowDetailChangedFields, 0, m_valuesCount*sizeof(bool));
+        m_lowDetailPending = false;
+    }
+}
+
+bool Object::IsLowDetailUpdateDue() const
+{
+    return getMSTimeDiff(m_lowDetailTime, getMSTime()) >= sWorld->getIntConfig(CONFIG_VISIBILITY_LOD_INTERVAL);
+}
+
+void Object::MergeLowDetailChanges()
+{
+    if (!_lowDetailChangedFields)
+    {
+        _lowDetailChangedFields = new bool[m_valuesCount];
+        memset(_lowDetailChangedFields, 0, m_valuesCount*sizeof(bool));
+    }
+
+    for (uint16 index = 0; index < m_valuesCount; ++index)
+        _lowDetailChangedFields[index] = _lowDetailChangedFields[index] || _changedFields[index];
 }
 
 void Object::BuildFieldsUpdate(Player* player, UpdateDataMapType& data_map) const
@@ -730,6 +762,61 @@ void Object::BuildFieldsUpdate(Player* player, UpdateDataMapType& data_map) cons
     BuildValuesUpdateBlockForPlayer(&iter->second, iter->first);
 }
 
+void Object::BuildFieldsUpdate(Player* player, UpdateDataMapType& data_map, SharedUpdateBlockPtr& shared) const
+{
+    if (!HasTargetIndependentValuesUpdate(player))
+    {
+        BuildFieldsUpdate(player, data_map);
+        return;
+    }
+
+    // serialized for the first of these players, every other one gets the same block
+    if (!shared.get())
+    {
+        shared = SharedUpdateBlockPtr(new SharedUpdateBlock());
+        _BuildValuesUpdateBlock(&shared->GetData(), player);
+    }
+
+    data_map[player].AddSharedBlock(shared);
+}
+
+// True when the values update built for target is byte for byte the one any other such player
+// gets, i.e. when none of the per target cases of _BuildValuesUpdate can apply
+bool Object::HasTargetIndependentValuesUpdate(Player* target) const
+{
+    // own player gets the full mask, gamemasters see through triggers and non selectable flags
+    if (target == this || target->HasGameMasterTagOn())
+        return false;
+
+    // quest dependent GAMEOBJECT_DYNAMIC is always sent
+    if (isType(TYPEMASK_GAMEOBJECT))
+        return ((GameObject*)this)->IsTransport();
+
+    if (!isType(TYPEMASK_UNIT))
+        return true;
+
+    Unit const* unit = (Unit const*)this;
+    if (unit->HasFlag(UNIT_FIELD_AURASTATE, PER_CASTER_AURA_STATE_MASK))
+        return false;
+
+    if (GetTypeId() == TYPEID_UNIT)
+    {
+        if (_changedFields[UNIT_NPC_FLAGS] && HasFlag(UNIT_NPC_FLAGS, UNIT_NPC_FLAG_SPELLCLICK | UNIT_NPC_FLAG_TRAINER))
+            return false;
+
+        // tapped and lootable flags
+        if (_changedFields[UNIT_DYNAMIC_FLAGS])
+            return false;
+    }
+
+    // faction override for raid members of the other team
+    if ((_changedFields[UNIT_FIELD_BYTES_2] || _changedFields[UNIT_FIELD_FACTIONTEMPLATE]) &&
+        unit->IsControlledByPlayer() && sWorld->getBoolConfig(CONFIG_ALLOW_TWO_SIDE_INTERACTION_GROUP))
+        return false;
+
+    return true;
+}
+
 void Object::_LoadIntoDataField(char const* data, uint32 startOffset, uint32 count)
 {
     if (!data)
@@ -1160,7 +1247,7 @@ void MovementInfo::OutDebug()
 WorldObject::WorldObject(bool isWorldObject): WorldLocation(),
 m_name(""), m_isActive(false), m_isWorldObject(isWorldObject), m_zoneScript(NULL),
 m_transport(NULL), m_currMap(NULL), m_InstanceId(0),
-m_phaseMask(PHASEMASK_NORMAL), m_notifyflags(0), m_executed_notifies(0)
+m_phaseMask(PHASEMASK_NORMAL), m_notifyflags(0), m_executed_notifies(0), m_cellIndex(NULL), m_cellIndexSlot(0)
 {
     m_serverSideVisibility.SetValue(SERVERSIDE_VISIBILITY_GHOST, GHOST_VISIBILITY_ALIVE | GHOST_VISIBILITY_GHOST);
     m_serverSideVisibilityDetect.SetValue(SERVERSIDE_VISIBILITY_GHOST, GHOST_VISIBILITY_ALIVE);
@@ -2039,12 +2126,14 @@ void WorldObject::SendMessageToSet(WorldPacket* data, bool self)
 
 void WorldObject::SendMessageToSetInRange(WorldPacket* data, float dist, bool /*self*/)
 {
+    SharedPacketScope shared(data);
     Axium::MessageDistDeliverer notifier(this, data, dist);
     VisitNearbyWorldObject(dist, notifier);
 }
 
 void WorldObject::SendMessageToSet(WorldPacket* data, Player const* skipped_rcvr)
 {
+    SharedPacketScope shared(data);
     Axium::MessageDistDeliverer notifier(this, data, GetVisibilityRange(), false, skipped_rcvr);
     VisitNearbyWorldObject(GetVisibilityRange(), notifier);
 }
@@ -2799,7 +2888,11 @@ struct WorldObjectChangeAccumulator
     UpdateDataMapType& i_updateDatas;
     WorldObject& i_object;
     std::set<uint64> plr_list;
-    WorldObjectChangeAccumulator(WorldObject &obj, UpdateDataMapType &d) : i_updateDatas(d), i_object(obj) {}
+    SharedUpdateBlockPtr i_sharedBlock;
+    bool i_lowDetail;                                       // hold back the changes from distant players
+    uint32 i_lowDetailSkipped;
+    WorldObjectChangeAccumulator(WorldObject &obj, UpdateDataMapType &d, bool lowDetail) : i_updateDatas(d), i_object(obj),
+        i_lowDetail(lowDetail), i_lowDetailSkipped(0) {}
     void Visit(PlayerMapType &m)
     {
         Player* source = NULL;
@@ -2856,7 +2949,10 @@ struct WorldObjectChangeAccumulator
         // Only send update once to a player
         if (plr_list.find(player->GetGUID()) == plr_list.end() && player->HaveAtClient(&i_object))
         {
-            i_object.BuildFieldsUpdate(player, i_updateDatas);
+            if (i_lowDetail && player->IsLowDetail(&i_object))
+                ++i_lowDetailSkipped;
+            else
+                i_object.BuildFieldsUpdate(player, i_updateDatas, i_sharedBlock);
             plr_list.insert(player->GetGUID());
         }
     }
@@ -2869,15 +2965,52 @@ void WorldObject::BuildUpdate(UpdateDataMapType& data_map)
     CellCoord p = Axium::ComputeCellCoord(GetPositionX(), GetPositionY());
     Cell cell(p);
     cell.SetNoCreate();
-    WorldObjectChangeAccumulator notifier(*this, data_map);
+
+    // units gather their changes for distant players and send them once per Visibility.LOD.Interval
+    bool lowDetail = isType(TYPEMASK_UNIT) && sWorld->getBoolConfig(CONFIG_VISIBILITY_LOD);
+    bool flush = m_lowDetailPending && (!lowDetail || IsLowDetailUpdateDue());
+    if (flush)
+    {
+        // near players get them as well, they may have been distant when the changes were made
+        MergeLowDetailChanges();
+        std::swap(_changedFields, _lowDetailChangedFields);
+    }
+
+    WorldObjectChangeAccumulator notifier(*this, data_map, lowDetail && !flush);
     TypeContainerVisitor<WorldObjectChangeAccumulator, WorldTypeMapContainer > player_notifier(notifier);
     Map& map = *GetMap();
     //we must build packets for all visible players
     cell.Visit(p, player_notifier, map, *this, GetVisibilityRange());
 
+    if (flush)
+    {
+        std::swap(_changedFields, _lowDetailChangedFields);
+        memset(_lowDetailChangedFields, 0, m_valuesCount*sizeof(bool));
+        m_lowDetailPending = false;
+        m_lowDetailTime = getMSTime();
+        sObjectAccessor->RemoveLowDetailObject(this);
+    }
+    else if (notifier.i_lowDetailSkipped)
+    {
+        MergeLowDetailChanges();
+        if (!m_lowDetailPending)
+        {
+            m_lowDetailPending = true;
+            sObjectAccessor->AddLowDetailObject(this);
+        }
+    }
+
     ClearUpdateMask(false);
 }
 
+void WorldObject::SendMessageToNearSet(WorldPacket* data, Player const* skipped_rcvr)
+{
+    SharedPacketScope shared(data);
+    Axium::MessageDistDeliverer notifier(this, data, GetVisibilityRange(), false, skipped_rcvr);
+    notifier.i_nearOnly = true;
+    VisitNearbyWorldObject(GetVisibilityRange(), notifier);
+}
+
 uint64 WorldObject::GetTransGUID() const
 {
     if (GetTransport())
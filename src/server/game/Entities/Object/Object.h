@@ -270,6 +270,8 @@ class Object
         }
 
         void ClearUpdateMask(bool remove);
+        //! Changes held back from distant players are to be sent, see Visibility.LOD.Enable
+        bool IsLowDetailUpdateDue() const;
 
         uint16 GetValuesCount() const { return m_valuesCount; }
 
@@ -277,6 +279,8 @@ class Object
         virtual bool hasInvolvedQuest(uint32 /* quest_id */) const { return false; }
         virtual void BuildUpdate(UpdateDataMapType&) {}
         void BuildFieldsUpdate(Player*, UpdateDataMapType &) const;
+        void BuildFieldsUpdate(Player*, UpdateDataMapType &, SharedUpdateBlockPtr& shared) const;
+        bool HasTargetIndependentValuesUpdate(Player* target) const;
 
         // FG: some hacky helpers
         void ForceValuesUpdateAtIndex(uint32);
@@ -312,6 +316,7 @@ class Object
         virtual void _SetCreateBits(UpdateMask* updateMask, Player* target) const;
         void _BuildMovementUpdate(ByteBuffer * data, uint16 flags) const;
         void _BuildValuesUpdate(uint8 updatetype, ByteBuffer *data, UpdateMask* updateMask, Player* target) const;
+        void _BuildValuesUpdateBlock(ByteBuffer* data, Player* target) const;
 
         uint16 m_objectType;
 
@@ -326,10 +331,15 @@ class Object
         };
 
         bool* _changedFields;
+        bool* _lowDetailChangedFields;                      // not sent yet to distant players, allocated on first use
 
         uint16 m_valuesCount;
 
         bool m_objectUpdated;
+        bool m_lowDetailPending;
+        uint32 m_lowDetailTime;                             // last update of distant players
+
+        void MergeLowDetailChanges();
 
     private:
         bool m_inWorld;
@@ -518,7 +528,7 @@ class GridObject
     public:
         bool IsInGrid() const { return _gridRef.isValid(); }
         void AddToGrid(GridRefManager<T>& m) { ASSERT(!IsInGrid()); _gridRef.link(&m, (T*)this); }
-        void RemoveFromGrid() { ASSERT(IsInGrid()); _gridRef.unlink(); }
+        void RemoveFromGrid() { ASSERT(IsInGrid()); _gridRef.unlink(); CellIndex::Remove((T*)this); }
     private:
         GridReference<T> _gridRef;
 };
@@ -549,11 +559,27 @@ class FlaggedValuesArray32
 
 class WorldObject : public Object, public WorldLocation
 {
+    friend class CellIndex;
+
     protected:
         explicit WorldObject(bool isWorldObject); //note: here it means if it is in grid object list or world object list
     public:
         virtual ~WorldObject();
 
+        // keep the entry of the object in the index of its cell up to date
+        void Relocate(float x, float y)
+            { Position::Relocate(x, y); UpdateCellIndex(); }
+        void Relocate(float x, float y, float z)
+            { Position::Relocate(x, y, z); UpdateCellIndex(); }
+        void Relocate(float x, float y, float z, float orientation)
+            { Position::Relocate(x, y, z, orientation); UpdateCellIndex(); }
+        void Relocate(const Position &pos)
+            { Position::Relocate(pos); UpdateCellIndex(); }
+        void Relocate(const Position* pos)
+            { Position::Relocate(pos); UpdateCellIndex(); }
+        //! Also needed when the combat reach changes
+        void UpdateCellIndex() { if (m_cellIndex) CellIndex::Update(this); }
+
         virtual void Update (uint32 /*time_diff*/) { }
 
         void _Create(uint32 guidlow, HighGuid guidhigh, uint32 phaseMask);
@@ -704,6 +730,8 @@ class WorldObject : public Object, public WorldLocation
         virtual void SendMessageToSet(WorldPacket* data, bool self);
         virtual void SendMessageToSetInRange(WorldPacket* data, float dist, bool self);
         virtual void SendMessageToSet(WorldPacket* data, Player const* skipped_rcvr);
+        //! Leaves out the players this object is low detail for, see Player::IsLowDetail
+        void SendMessageToNearSet(WorldPacket* data, Player const* skipped_rcvr);
 
         virtual uint8 getLevelForTarget(WorldObject const* /*target*/) const { return 1; }
 
@@ -850,6 +878,9 @@ class WorldObject : public Object, public WorldLocation
         uint16 m_notifyflags;
         uint16 m_executed_notifies;
 
+        CellIndex* m_cellIndex;                             // of the cell whose lists hold the object
+        uint32 m_cellIndexSlot;
+
         virtual bool _IsWithinDist(WorldObject const* obj, float dist2compare, bool is3D) const;
 
         bool CanNeverSee(WorldObject const* obj) const { return GetMap() != obj->GetMap() || !InSamePhase(obj); }
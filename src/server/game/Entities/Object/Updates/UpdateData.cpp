@@ -7,6 +7,74 @@
 #include "World.h"
 #include "zlib.h"
 
+#include <ace/TSS_T.h>
+#include <ace/OS_NS_sys_time.h>
+
+/*
+    Deflate streams of one thread. A deflate state is about 256KB of allocations, so
+    streams are set up once per thread and compression level and only deflateReset
+    between packets.
+*/
+class DeflateStreams
+{
+    public:
+        DeflateStreams()
+        {
+            for (uint8 i = 0; i < MAX_STREAMS; ++i)
+                m_level[i] = -1;
+        }
+
+        ~DeflateStreams()
+        {
+            for (uint8 i = 0; i < MAX_STREAMS; ++i)
+                if (m_level[i] >= 0)
+                    deflateEnd(&m_streams[i]);
+        }
+
+        // zlib wrapped stream for whole packets, raw one for shared fragments
+        z_stream* Acquire(bool raw)
+        {
+            uint8 i = raw ? STREAM_RAW : STREAM_ZLIB;
+            int level = int(sWorld->getIntConfig(CONFIG_COMPRESSION));
+
+            if (m_level[i] == level && deflateReset(&m_streams[i]) == Z_OK)
+                return &m_streams[i];
+
+            if (m_level[i] >= 0)
+                deflateEnd(&m_streams[i]);
+            m_level[i] = -1;
+
+            z_stream& stream = m_streams[i];
+            stream.zalloc = (alloc_func)0;
+            stream.zfree = (free_func)0;
+            stream.opaque = (voidpf)0;
+
+            int z_res = deflateInit2(&stream, level, Z_DEFLATED, raw ? -MAX_WBITS : MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+            if (z_res != Z_OK)
+            {
+                sLog->outError("Can't compress update packet (zlib: deflateInit2) Error code: %i (%s)", z_res, zError(z_res));
+                return NULL;
+            }
+
+            m_level[i] = level;
+            return &stream;
+        }
+
+    private:
+        enum
+        {
+            STREAM_ZLIB,
+            STREAM_RAW,
+            MAX_STREAMS
+        };
+
+        z_stream m_streams[MAX_STREAMS];
+        int m_level[MAX_STREAMS];                           // -1 while not initialized
+};
+
+typedef ACE_TSS<DeflateStreams> DeflateStreamsTSS;
+static DeflateStreamsTSS deflateStreams;
+
 UpdateData::UpdateData() : m_blockCount(0)
 {
 }
@@ -27,29 +95,70 @@ void UpdateData::AddUpdateBlock(const ByteBuffer &block)
     ++m_blockCount;
 }
 
-void UpdateData::Compress(void* dst, uint32 *dst_size, void* src, int src_size)
+void UpdateData::AddSharedBlock(SharedUpdateBlockPtr const& block)
+{
+    m_sharedBlocks.push_back(block);
+    ++m_blockCount;
+}
+
+std::vector<uint8> const& SharedUpdateBlock::GetCompressed(uint32* adler)
 {
-    z_stream c_stream;
+    if (!m_compressed)
+    {
+        m_compressed = true;
+        m_adler = adler32(adler32(0L, Z_NULL, 0), m_data.contents(), m_data.wpos());
+        if (!UpdateData::CompressFragment(m_data.contents(), m_data.wpos(), m_fragment))
+            m_fragment.clear();
+    }
 
-    c_stream.zalloc = (alloc_func)0;
-    c_stream.zfree = (free_func)0;
-    c_stream.opaque = (voidpf)0;
+    *adler = m_adler;
+    return m_fragment;
+}
 
+bool UpdateData::CompressFragment(uint8 const* src, size_t src_size, std::vector<uint8>& dst)
+{
+    // raw deflate, the zlib header and trailer are written by BuildSharedPacket
+    z_stream* c_stream = deflateStreams->Acquire(true);
+    if (!c_stream)
+        return false;
+
+    // deflateBound does not account for the flush marker
+    dst.resize(deflateBound(c_stream, uLong(src_size)) + 16);
+
+    c_stream->next_out = (Bytef*)&dst[0];
+    c_stream->avail_out = uInt(dst.size());
+    c_stream->next_in = (Bytef*)src;
+    c_stream->avail_in = uInt(src_size);
+
+    // a full flush ends the fragment on a byte boundary and without references into it,
+    // the stream is deliberately left unfinished and reset on next use
+    int z_res = deflate(c_stream, Z_FULL_FLUSH);
+    if (z_res != Z_OK || c_stream->avail_in != 0 || c_stream->avail_out == 0)
+    {
+        sLog->outError("Can't compress update fragment (zlib: deflate) Error code: %i (%s)", z_res, zError(z_res));
+        return false;
+    }
+
+    dst.resize(c_stream->total_out);
+    return true;
+}
+
+void UpdateData::Compress(void* dst, uint32 *dst_size, void* src, int src_size)
+{
     // default Z_BEST_SPEED (1)
-    int z_res = deflateInit(&c_stream, sWorld->getIntConfig(CONFIG_COMPRESSION));
-    if (z_res != Z_OK)
+    z_stream* c_stream = deflateStreams->Acquire(false);
+    if (!c_stream)
     {
-        sLog->outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
         *dst_size = 0;
         return;
     }
 
-    c_stream.next_out = (Bytef*)dst;
-    c_stream.avail_out = *dst_size;
-    c_stream.next_in = (Bytef*)src;
-    c_stream.avail_in = (uInt)src_size;
+    c_stream->next_out = (Bytef*)dst;
+    c_stream->avail_out = *dst_size;
+    c_stream->next_in = (Bytef*)src;
+    c_stream->avail_in = (uInt)src_size;
 
-    z_res = deflate(&c_stream, Z_NO_FLUSH);
+    int z_res = deflate(c_stream, Z_NO_FLUSH);
     if (z_res != Z_OK)
     {
         sLog->outError("Can't compress update packet (zlib: deflate) Error code: %i (%s)", z_res, zError(z_res));
@@ -57,14 +166,14 @@ void UpdateData::Compress(void* dst, uint32 *dst_size, void* src, int src_size)
         return;
     }
 
-    if (c_stream.avail_in != 0)
+    if (c_stream->avail_in != 0)
     {
         sLog->outError("Can't compress update packet (zlib: deflate not greedy)");
         *dst_size = 0;
         return;
     }
 
-    z_res = deflate(&c_stream, Z_FINISH);
+    z_res = deflate(c_stream, Z_FINISH);
     if (z_res != Z_STREAM_END)
     {
         sLog->outError("Can't compress update packet (zlib: deflate should report Z_STREAM_END instead %i (%s)", z_res, zError(z_res));
@@ -72,15 +181,48 @@ void UpdateData::Compress(void* dst, uint32 *dst_size, void* src, int src_size)
         return;
     }
 
-    z_res = deflateEnd(&c_stream);
-    if (z_res != Z_OK)
+    *dst_size = c_stream->total_out;
+}
+
+uint32 UpdateData::BenchmarkCompression(ByteBuffer const& data, uint32 count, bool pooled)
+{
+    if (!data.wpos())
+        return 0;
+
+    std::vector<uint8> dst(compressBound(uLong(data.wpos())));
+    ACE_Time_Value start = ACE_OS::gettimeofday();
+
+    for (uint32 i = 0; i < count; ++i)
     {
-        sLog->outError("Can't compress update packet (zlib: deflateEnd) Error code: %i (%s)", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
+        uint32 destsize = uint32(dst.size());
+
+        if (pooled)
+        {
+            Compress(&dst[0], &destsize, (void*)data.contents(), int(data.wpos()));
+            continue;
+        }
+
+        // what Compress did before the per thread streams
+        z_stream c_stream;
+        c_stream.zalloc = (alloc_func)0;
+        c_stream.zfree = (free_func)0;
+        c_stream.opaque = (voidpf)0;
+
+        if (deflateInit(&c_stream, sWorld->getIntConfig(CONFIG_COMPRESSION)) != Z_OK)
+            return 0;
+
+        c_stream.next_out = (Bytef*)&dst[0];
+        c_stream.avail_out = destsize;
+        c_stream.next_in = (Bytef*)data.contents();
+        c_stream.avail_in = uInt(data.wpos());
+
+        deflate(&c_stream, Z_FINISH);
+        deflateEnd(&c_stream);
     }
 
-    *dst_size = c_stream.total_out;
+    ACE_UINT64 elapsed;
+    (ACE_OS::gettimeofday() - start).to_usec(elapsed);
+    return uint32(elapsed);
 }
 
 bool UpdateData::BuildPacket(WorldPacket* packet)
@@ -102,6 +244,9 @@ bool UpdateData::BuildPacket(WorldPacket* packet)
 
     buf.append(m_data);
 
+    if (!m_sharedBlocks.empty())
+        return BuildSharedPacket(packet, buf);
+
     size_t pSize = buf.wpos();                              // use real used data size
 
     if (pSize > 100)                                       // compress large packets
@@ -126,9 +271,59 @@ bool UpdateData::BuildPacket(WorldPacket* packet)
     return true;
 }
 
+bool UpdateData::BuildSharedPacket(WorldPacket* packet, ByteBuffer const& head)
+{
+    size_t pSize = head.wpos();
+    for (std::vector<SharedUpdateBlockPtr>::const_iterator itr = m_sharedBlocks.begin(); itr != m_sharedBlocks.end(); ++itr)
+        pSize += (*itr)->GetData().wpos();
+
+    if (pSize <= 100)                                       // send small packets without compression
+    {
+        packet->append(head);
+        for (std::vector<SharedUpdateBlockPtr>::const_iterator itr = m_sharedBlocks.begin(); itr != m_sharedBlocks.end(); ++itr)
+            packet->append((*itr)->GetData());
+
+        packet->SetOpcode(SMSG_UPDATE_OBJECT);
+        return true;
+    }
+
+    // only the head (block count, out of range guids, blocks for this player alone) is deflated here,
+    // the shared blocks are spliced in as already compressed fragments of the same stream
+    std::vector<uint8> fragment;
+    if (!CompressFragment(head.contents(), head.wpos(), fragment))
+        return false;
+
+    uLong adler = adler32(adler32(0L, Z_NULL, 0), head.contents(), head.wpos());
+
+    *packet << uint32(pSize);
+    *packet << uint8(0x78) << uint8(0x9C);                  // zlib header: deflate, 32K window
+    packet->append(&fragment[0], fragment.size());
+
+    for (std::vector<SharedUpdateBlockPtr>::const_iterator itr = m_sharedBlocks.begin(); itr != m_sharedBlocks.end(); ++itr)
+    {
+        uint32 blockAdler;
+        std::vector<uint8> const& blockFragment = (*itr)->GetCompressed(&blockAdler);
+        if (blockFragment.empty())
+        {
+            packet->clear();
+            return false;
+        }
+
+        packet->append(&blockFragment[0], blockFragment.size());
+        adler = adler32_combine(adler, blockAdler, z_off_t((*itr)->GetData().wpos()));
+    }
+
+    *packet << uint8(0x03) << uint8(0x00);                  // empty final block
+    *packet << uint8(adler >> 24) << uint8(adler >> 16) << uint8(adler >> 8) << uint8(adler);
+
+    packet->SetOpcode(SMSG_COMPRESSED_UPDATE_OBJECT);
+    return true;
+}
+
 void UpdateData::Clear()
 {
     m_data.clear();
+    m_sharedBlocks.clear();
     m_outOfRangeGUIDs.clear();
     m_blockCount = 0;
 }
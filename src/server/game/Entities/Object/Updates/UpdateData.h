@@ -2,6 +2,9 @@
 #define __UPDATEDATA_H
 
 #include "ByteBuffer.h"
+#include <ace/Refcounted_Auto_Ptr.h>
+#include <ace/Null_Mutex.h>
+
 class WorldPacket;
 
 enum OBJECT_UPDATE_TYPE
@@ -29,6 +32,33 @@ enum OBJECT_UPDATE_FLAGS
     UPDATEFLAG_ROTATION     = 0x0200
 };
 
+/*
+    An update block sent unchanged to several players, e.g. the values update of a
+    boss seen by a whole raid. It is serialized once and, the first time a packet
+    that carries it gets compressed, deflated once into a byte aligned fragment
+    (Z_FULL_FLUSH, no back references) that every other packet splices in as is.
+*/
+class SharedUpdateBlock
+{
+    public:
+        SharedUpdateBlock() : m_data(500), m_adler(0), m_compressed(false) { }
+
+        ByteBuffer& GetData() { return m_data; }
+        ByteBuffer const& GetData() const { return m_data; }
+
+        // raw deflate fragment and adler32 of the block, compressed on first call
+        std::vector<uint8> const& GetCompressed(uint32* adler);
+
+    private:
+        ByteBuffer m_data;
+        std::vector<uint8> m_fragment;
+        uint32 m_adler;
+        bool m_compressed;
+};
+
+// update blocks are built and sent from the world thread only
+typedef ACE_Refcounted_Auto_Ptr<SharedUpdateBlock, ACE_Null_Mutex> SharedUpdateBlockPtr;
+
 class UpdateData
 {
     public:
@@ -37,18 +67,28 @@ class UpdateData
         void AddOutOfRangeGUID(std::set<uint64>& guids);
         void AddOutOfRangeGUID(uint64 guid);
         void AddUpdateBlock(const ByteBuffer &block);
+        void AddSharedBlock(SharedUpdateBlockPtr const& block);
         bool BuildPacket(WorldPacket* packet);
         bool HasData() const { return m_blockCount > 0 || !m_outOfRangeGUIDs.empty(); }
         void Clear();
 
         std::set<uint64> const& GetOutOfRangeGUIDs() const { return m_outOfRangeGUIDs; }
 
+        static bool CompressFragment(uint8 const* src, size_t src_size, std::vector<uint8>& dst);
+
+        ByteBuffer const& GetBlockData() const { return m_data; }
+
+        // time (usec) to compress blocks count times with the per thread streams or a fresh stream each time
+        static uint32 BenchmarkCompression(ByteBuffer const& blocks, uint32 count, bool pooled);
+
     protected:
         uint32 m_blockCount;
         std::set<uint64> m_outOfRangeGUIDs;
         ByteBuffer m_data;
+        std::vector<SharedUpdateBlockPtr> m_sharedBlocks;    // sent after m_data
 
-        void Compress(void* dst, uint32 *dst_size, void* src, int src_size);
+        static void Compress(void* dst, uint32 *dst_size, void* src, int src_size);
+        bool BuildSharedPacket(WorldPacket* packet, ByteBuffer const& head);
 };
 #endif
 
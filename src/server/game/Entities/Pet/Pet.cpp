@@ -754,6 +754,7 @@ bool Guardian::InitStatsForLevel(uint8 petlevel)
     SetFloatValue(UNIT_MOD_CAST_SPEED, 1.0f);
 
     SetFloatValue(UNIT_FIELD_COMBATREACH, 1.5f);
+    UpdateCellIndex();
 
     //scale
     CreatureFamilyEntry const* cFamily = sCreatureFamilyStore.LookupEntry(cinfo->family);
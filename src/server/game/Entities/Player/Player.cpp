@@ -40,6 +40,7 @@
 #include "BattlegroundMgr.h"
 #include "OutdoorPvP.h"
 #include "OutdoorPvPMgr.h"
+#include "PvPMgr.h"
 #include "ArenaTeam.h"
 #include "Chat.h"
 #include "Spell.h"
@@ -666,6 +667,7 @@ Player::Player(WorldSession* session): Unit(true), m_achievementMgr(this), m_rep
     m_areaUpdateId = 0;
 
     m_nextSave = sWorld->getIntConfig(CONFIG_INTERVAL_SAVE);
+    m_saveDelay = 0;
 
     clearResurrectRequestData();
 
@@ -816,6 +818,8 @@ Player::Player(WorldSession* session): Unit(true), m_achievementMgr(this), m_rep
     m_mover = this;
     m_movedPlayer = this;
     m_seer = this;
+    ResetVisibilityUpdate();
+    m_lowDetailHeartbeatTime = 0;
 
     m_contestedPvPTimer = 0;
 
@@ -1716,9 +1720,18 @@ void Player::Update(uint32 p_time)
     {
         if (p_time >= m_nextSave)
         {
-            // m_nextSave reseted in SaveToDB call
-            SaveToDB();
-            sLog->outDetail("Player '%s' (GUID: %u) saved", GetName(), GetGUIDLow());
+            // spread the saves while the character database is behind on writes, but not for longer than an interval
+            if (sWorld->IsCharacterDatabaseBusy() && m_saveDelay < sWorld->getIntConfig(CONFIG_INTERVAL_SAVE))
+            {
+                m_nextSave = urand(1 * IN_MILLISECONDS, 5 * IN_MILLISECONDS);
+                m_saveDelay += m_nextSave;
+            }
+            else
+            {
+                // m_nextSave reseted in SaveToDB call
+                SaveToDB();
+                sLog->outDetail("Player '%s' (GUID: %u) saved", GetName(), GetGUIDLow());
+            }
         }
         else
             m_nextSave -= p_time;
@@ -5003,6 +5016,8 @@ void Player::DeleteFromDB(uint64 playerguid, uint32 accountId, bool updateRealmC
             trans->PAppend("DELETE FROM character_skills WHERE guid = '%u'", guid);
 
             CharacterDatabase.CommitTransaction(trans);
+
+            sPvPMgr->DeletePlayerStats(playerguid);
             break;
         }
         // The character gets unlinked from the account, the name gets freed up and appears as deleted ingame
@@ -6781,6 +6796,7 @@ void Player::SaveRecallPosition()
 
 void Player::SendMessageToSetInRange(WorldPacket* data, float dist, bool self)
 {
+    SharedPacketScope shared(data);
     if (self)
         GetSession()->SendPacket(data);
 
@@ -6790,6 +6806,7 @@ void Player::SendMessageToSetInRange(WorldPacket* data, float dist, bool self)
 
 void Player::SendMessageToSetInRange(WorldPacket* data, float dist, bool self, bool own_team_only)
 {
+    SharedPacketScope shared(data);
     if (self)
         GetSession()->SendPacket(data);
 
@@ -6799,6 +6816,7 @@ void Player::SendMessageToSetInRange(WorldPacket* data, float dist, bool self, b
 
 void Player::SendMessageToSet(WorldPacket* data, Player const* skipped_rcvr)
 {
+    SharedPacketScope shared(data);
     if (skipped_rcvr != this)
         GetSession()->SendPacket(data);
 
@@ -7395,7 +7413,9 @@ uint32 Player::GetZoneIdFromDB(uint64 guid)
 
 uint32 Player::GetLevelFromDB(uint64 guid)
 {
-    QueryResult result = CharacterDatabase.PQuery("SELECT level FROM characters WHERE guid='%u'", GUID_LOPART(guid));
+    PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_SEL_CHARACTER_LEVEL);
+    stmt->setUInt32(0, GUID_LOPART(guid));
+    PreparedQueryResult result = CharacterDatabase.Query(stmt);
     if (!result)
         return 0;
 
@@ -16488,17 +16508,15 @@ void Player::_LoadMatchMakerRating()
 
 void Player::_LoadPvPStats()
 {
-                                               //        0                  1               2                3
-   QueryResult result = CharacterDatabase.PQuery("SELECT Lifetime2v2Rating, Lifetime2v2MMR, Lifetime2v2Wins, Lifetime2v2Games, "
-                                               // 4                  5               6                7
-                                                 "Lifetime3v3Rating, Lifetime3v3MMR, Lifetime3v3Wins, Lifetime3v3Games, "
-                                               // 8                  9               10               11
-                                                 "Lifetime5v5Rating, Lifetime5v5MMR, Lifetime5v5Wins, Lifetime5v5Games "
-                                                 "FROM character_pvp_stats WHERE guid = %u", GetGUIDLow());
+    PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_SEL_PVP_STATS);
+    stmt->setUInt32(0, GetGUIDLow());
+    PreparedQueryResult result = CharacterDatabase.Query(stmt);
 
     if (!result)
     {
-        CharacterDatabase.PExecute("INSERT INTO character_pvp_stats (guid) VALUES (%u)", GetGUIDLow());
+        stmt = CharacterDatabase.GetPreparedStatement(CHAR_INS_PVP_STATS);
+        stmt->setUInt32(0, GetGUIDLow());
+        CharacterDatabase.Execute(stmt);
         return;
     }
 
@@ -16792,6 +16810,8 @@ bool Player::LoadFromDB(uint32 guid, SQLQueryHolder *holder)
     SetArenaPoints(fields[40].GetUInt32());
     m_arenaPointsCap = fields[41].GetUInt32();
 
+    sPvPMgr->LoadPlayerStats(this);
+
     // check arena teams integrity
     for (uint8 arena_slot = 0; arena_slot < MAX_ARENA_SLOT; ++arena_slot)
     {
@@ -18633,6 +18653,7 @@ void Player::SaveToDB(bool create /*=false*/)
 {
     // delay auto save at any saves (manual, in code, or autosave)
     m_nextSave = sWorld->getIntConfig(CONFIG_INTERVAL_SAVE);
+    m_saveDelay = 0;
 
     //lets allow only players in world to be saved
     if (IsBeingTeleportedFar())
@@ -18876,7 +18897,13 @@ void Player::SaveToDB(bool create /*=false*/)
     if (m_mailsUpdated)                                     //save mails only when needed
         _SaveMail(trans);
 
+    // unchanged sections are only left out once the save that wrote them is known to be in the database
+    bool lastSaveCommitted = !m_lastSave.null() && m_lastSave->GetState() == TRANSACTION_COMMITTED;
+
+    size_t start = trans->GetSize();
     _SaveBGData(trans);
+    _SkipUnchangedSave(trans, PLAYER_SAVE_BG_DATA, start, lastSaveCommitted);
+
     _SaveInventory(trans);
     _SaveQuestStatus(trans);
     _SaveDailyQuestStatus(trans);
@@ -18884,9 +18911,17 @@ void Player::SaveToDB(bool create /*=false*/)
     _SaveSeasonalQuestStatus(trans);
     _SaveTalents(trans);
     _SaveSpells(trans);
+
+    start = trans->GetSize();
     _SaveSpellCooldowns(trans);
+    _SkipUnchangedSave(trans, PLAYER_SAVE_SPELL_COOLDOWNS, start, lastSaveCommitted);
+
     _SaveActions(trans);
+
+    start = trans->GetSize();
     _SaveAuras(trans);
+    _SkipUnchangedSave(trans, PLAYER_SAVE_AURAS, start, lastSaveCommitted);
+
     _SaveSkills(trans);
     m_achievementMgr.SaveToDB(trans);
     m_reputationMgr.SaveToDB(trans);
@@ -18898,17 +18933,34 @@ void Player::SaveToDB(bool create /*=false*/)
     // check if stats should only be saved on logout
     // save stats can be out of transaction
     if (m_session->isLogingOut() || !sWorld->getBoolConfig(CONFIG_STATS_SAVE_ONLY_ON_LOGOUT))
+    {
+        start = trans->GetSize();
         _SaveStats(trans);
+        _SkipUnchangedSave(trans, PLAYER_SAVE_STATS, start, lastSaveCommitted);
+    }
 
-    _SaveTransmogItems();
+    _SaveTransmogItems(trans);
 
     CharacterDatabase.CommitTransaction(trans);
+    m_lastSave = trans;
 
     // save pet (hunter pet level and experience and all type pets health/mana).
     if (Pet* pet = GetPet())
         pet->SavePetToDB(PET_SAVE_AS_CURRENT);
 }
 
+// drops what a section appended when the previous save, committed, wrote exactly the same
+void Player::_SkipUnchangedSave(SQLTransaction& trans, PlayerSaveSection section, size_t start, bool lastSaveCommitted)
+{
+    std::string content;
+    trans->GetContent(start, content);
+
+    if (lastSaveCommitted && !content.empty() && content == m_saveContent[section])
+        trans->Truncate(start);
+    else
+        m_saveContent[section].swap(content);
+}
+
 // fast save function for item/money cheating preventing - save only inventory and money state
 void Player::SaveInventoryAndGoldToDB(SQLTransaction& trans)
 {
@@ -19015,8 +19067,10 @@ void Player::_SaveInventory(SQLTransaction& trans)
         Item* item = m_items[i];
         if (!item || item->GetState() == ITEM_NEW)
             continue;
-        trans->PAppend("DELETE FROM character_inventory WHERE item = '%u'", item->GetGUIDLow());
-        PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_ITEM_INSTANCE);
+        PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_INVENTORY_ITEM);
+        stmt->setUInt32(0, item->GetGUIDLow());
+        trans->Append(stmt);
+        stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_ITEM_INSTANCE);
         stmt->setUInt32(0, item->GetGUIDLow());
         trans->Append(stmt);
         m_items[i]->FSetState(ITEM_NEW);
@@ -19054,6 +19108,10 @@ void Player::_SaveInventory(SQLTransaction& trans)
     if (m_itemUpdateQueue.empty())
         return;
 
+    // inventory records first and the items after them, so the same statements follow in a row
+    std::vector<Item*> savedItems;
+    savedItems.reserve(m_itemUpdateQueue.size());
+
     uint32 lowGuid = GetGUIDLow();
     for (size_t i = 0; i < m_itemUpdateQueue.size(); ++i)
     {
@@ -19086,7 +19144,7 @@ void Player::_SaveInventory(SQLTransaction& trans)
                 sLog->outError("Player(GUID: %u Name: %s)::_SaveInventory - the bag(%u) and slot(%u) values for the item with guid %u are incorrect, the item with guid %u is there instead!", lowGuid, GetName(), item->GetBagSlot(), item->GetSlot(), item->GetGUIDLow(), test->GetGUIDLow());
                 // save all changes to the item...
                 if (item->GetState() != ITEM_NEW) // only for existing items, no dupes
-                    item->SaveToDB(trans);
+                    savedItems.push_back(item);
                 // ...but do not save position in invntory
                 continue;
             }
@@ -19112,9 +19170,12 @@ void Player::_SaveInventory(SQLTransaction& trans)
                 break;
         }
 
-        item->SaveToDB(trans);                                   // item have unchanged inventory record and can be save standalone
+        savedItems.push_back(item);                              // item have unchanged inventory record and can be save standalone
     }
     m_itemUpdateQueue.clear();
+
+    for (size_t i = 0; i < savedItems.size(); ++i)
+        savedItems[i]->SaveToDB(trans);
 }
 
 void Player::_SaveMail(SQLTransaction& trans)
@@ -19182,28 +19243,69 @@ void Player::_SaveQuestStatus(SQLTransaction& trans)
 
     bool keepAbandoned = !(sWorld->GetCleaningFlags() & CharacterDatabaseCleaner::CLEANING_FLAG_QUESTSTATUS);
 
+    PreparedStatement* stmt = NULL;
+
+    // deletes first, each statement in a row is merged into one
     for (saveItr = m_QuestStatusSave.begin(); saveItr != m_QuestStatusSave.end(); ++saveItr)
     {
         if (saveItr->second)
-        {
-            statusItr = m_QuestStatus.find(saveItr->first);
-            if (statusItr != m_QuestStatus.end() && (keepAbandoned || statusItr->second.m_status != QUEST_STATUS_NONE))
-                trans->PAppend("REPLACE INTO character_queststatus (guid, quest, status, explored, timer, mobcount1, mobcount2, mobcount3, mobcount4, itemcount1, itemcount2, itemcount3, itemcount4, playercount) "
-                    "VALUES ('%u', '%u', '%u', '%u', '" UI64FMTD "', '%u', '%u', '%u', '%u', '%u', '%u', '%u', '%u', '%u')",
-                    GetGUIDLow(), statusItr->first, statusItr->second.m_status, statusItr->second.m_explored, uint64(statusItr->second.m_timer / IN_MILLISECONDS+ sWorld->GetGameTime()), statusItr->second.m_creatureOrGOcount[0], statusItr->second.m_creatureOrGOcount[1], statusItr->second.m_creatureOrGOcount[2], statusItr->second.m_creatureOrGOcount[3], statusItr->second.m_itemcount[0], statusItr->second.m_itemcount[1], statusItr->second.m_itemcount[2], statusItr->second.m_itemcount[3], statusItr->second.m_playercount);
-        }
-        else
-            trans->PAppend("DELETE FROM character_queststatus WHERE guid = %u AND quest = %u", GetGUIDLow(), saveItr->first);
+            continue;
+
+        stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_CHARACTER_QUESTSTATUS_BY_QUEST);
+        stmt->setUInt32(0, GetGUIDLow());
+        stmt->setUInt32(1, saveItr->first);
+        trans->Append(stmt);
+    }
+
+    for (saveItr = m_QuestStatusSave.begin(); saveItr != m_QuestStatusSave.end(); ++saveItr)
+    {
+        if (!saveItr->second)
+            continue;
+
+        statusItr = m_QuestStatus.find(saveItr->first);
+        if (statusItr == m_QuestStatus.end() || (!keepAbandoned && statusItr->second.m_status == QUEST_STATUS_NONE))
+            continue;
+
+        uint8 index = 0;
+        stmt = CharacterDatabase.GetPreparedStatement(CHAR_REP_CHARACTER_QUESTSTATUS);
+        stmt->setUInt32(index++, GetGUIDLow());
+        stmt->setUInt32(index++, statusItr->first);
+        stmt->setUInt8(index++, uint8(statusItr->second.m_status));
+        stmt->setBool(index++, statusItr->second.m_explored);
+        stmt->setUInt64(index++, uint64(statusItr->second.m_timer / IN_MILLISECONDS+ sWorld->GetGameTime()));
+        for (uint8 i = 0; i < 4; ++i)                       // mobcount1-4
+            stmt->setUInt16(index++, statusItr->second.m_creatureOrGOcount[i]);
+        for (uint8 i = 0; i < 4; ++i)                       // itemcount1-4
+            stmt->setUInt16(index++, statusItr->second.m_itemcount[i]);
+        stmt->setUInt16(index, statusItr->second.m_playercount);
+        trans->Append(stmt);
     }
 
     m_QuestStatusSave.clear();
 
+    if (!keepAbandoned)
+    {
+        for (saveItr = m_RewardedQuestsSave.begin(); saveItr != m_RewardedQuestsSave.end(); ++saveItr)
+        {
+            if (saveItr->second)
+                continue;
+
+            stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_CHARACTER_QUESTSTATUS_REWARDED_BY_QUEST);
+            stmt->setUInt32(0, GetGUIDLow());
+            stmt->setUInt32(1, saveItr->first);
+            trans->Append(stmt);
+        }
+    }
+
     for (saveItr = m_RewardedQuestsSave.begin(); saveItr != m_RewardedQuestsSave.end(); ++saveItr)
     {
-        if (saveItr->second)
-            trans->PAppend("INSERT IGNORE INTO character_queststatus_rewarded (guid, quest) VALUES (%u, %u)", GetGUIDLow(), saveItr->first);
-        else if (!keepAbandoned)
-            trans->PAppend("DELETE FROM character_queststatus_rewarded WHERE guid = %u AND quest = %u", GetGUIDLow(), saveItr->first);
+        if (!saveItr->second)
+            continue;
+
+        stmt = CharacterDatabase.GetPreparedStatement(CHAR_INS_CHARACTER_QUESTSTATUS_REWARDED);
+        stmt->setUInt32(0, GetGUIDLow());
+        stmt->setUInt32(1, saveItr->first);
+        trans->Append(stmt);
     }
 
     m_RewardedQuestsSave.clear();
@@ -19301,55 +19403,84 @@ void Player::_SaveSeasonalQuestStatus(SQLTransaction& trans)
 
 void Player::_SaveSkills(SQLTransaction& trans)
 {
+    PreparedStatement* stmt = NULL;
+
     // we don't need transactions here.
+    // deletes, inserts and updates one after another, each statement in a row is merged into one
     for (SkillStatusMap::iterator itr = mSkillStatus.begin(); itr != mSkillStatus.end();)
     {
-        if (itr->second.uState == SKILL_UNCHANGED)
+        if (itr->second.uState != SKILL_DELETED)
         {
             ++itr;
             continue;
         }
 
-        if (itr->second.uState == SKILL_DELETED)
-        {
-            trans->PAppend("DELETE FROM character_skills WHERE guid = '%u' AND skill = '%u' ", GetGUIDLow(), itr->first);
-            mSkillStatus.erase(itr++);
+        stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_CHARACTER_SKILL);
+        stmt->setUInt32(0, GetGUIDLow());
+        stmt->setUInt16(1, itr->first);
+        trans->Append(stmt);
+        mSkillStatus.erase(itr++);
+    }
+
+    for (SkillStatusMap::iterator itr = mSkillStatus.begin(); itr != mSkillStatus.end(); ++itr)
+    {
+        if (itr->second.uState != SKILL_NEW)
             continue;
-        }
 
         uint32 valueData = GetUInt32Value(PLAYER_SKILL_VALUE_INDEX(itr->second.pos));
-        uint16 value = SKILL_VALUE(valueData);
-        uint16 max = SKILL_MAX(valueData);
-
-        switch (itr->second.uState)
-        {
-            case SKILL_NEW:
-                trans->PAppend("INSERT INTO character_skills (guid, skill, value, max) VALUES ('%u', '%u', '%u', '%u')",
-                    GetGUIDLow(), itr->first, value, max);
-                break;
-            case SKILL_CHANGED:
-                trans->PAppend("UPDATE character_skills SET value = '%u', max = '%u'WHERE guid = '%u' AND skill = '%u' ",
-                    value, max, GetGUIDLow(), itr->first);
-                break;
-            default:
-                break;
-        }
+        stmt = CharacterDatabase.GetPreparedStatement(CHAR_INS_CHARACTER_SKILL);
+        stmt->setUInt32(0, GetGUIDLow());
+        stmt->setUInt16(1, itr->first);
+        stmt->setUInt16(2, SKILL_VALUE(valueData));
+        stmt->setUInt16(3, SKILL_MAX(valueData));
+        trans->Append(stmt);
         itr->second.uState = SKILL_UNCHANGED;
+    }
 
-        ++itr;
+    for (SkillStatusMap::iterator itr = mSkillStatus.begin(); itr != mSkillStatus.end(); ++itr)
+    {
+        if (itr->second.uState != SKILL_CHANGED)
+            continue;
+
+        uint32 valueData = GetUInt32Value(PLAYER_SKILL_VALUE_INDEX(itr->second.pos));
+        stmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_CHARACTER_SKILL);
+        stmt->setUInt16(0, SKILL_VALUE(valueData));
+        stmt->setUInt16(1, SKILL_MAX(valueData));
+        stmt->setUInt32(2, GetGUIDLow());
+        stmt->setUInt16(3, itr->first);
+        trans->Append(stmt);
+        itr->second.uState = SKILL_UNCHANGED;
     }
 }
 
 void Player::_SaveSpells(SQLTransaction& trans)
 {
-    for (PlayerSpellMap::iterator itr = m_spells.begin(); itr != m_spells.end();)
+    PreparedStatement* stmt = NULL;
+
+    // all deletes before the inserts, each statement in a row is merged into one
+    for (PlayerSpellMap::iterator itr = m_spells.begin(); itr != m_spells.end(); ++itr)
     {
         if (itr->second->state == PLAYERSPELL_REMOVED || itr->second->state == PLAYERSPELL_CHANGED)
-            trans->PAppend("DELETE FROM character_spell WHERE guid = '%u' and spell = '%u'", GetGUIDLow(), itr->first);
+        {
+            stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_CHARACTER_SPELL_BY_SPELL);
+            stmt->setUInt32(0, GetGUIDLow());
+            stmt->setUInt32(1, itr->first);
+            trans->Append(stmt);
+        }
+    }
 
+    for (PlayerSpellMap::iterator itr = m_spells.begin(); itr != m_spells.end();)
+    {
         // add only changed/new not dependent spells
         if (!itr->second->dependent && (itr->second->state == PLAYERSPELL_NEW || itr->second->state == PLAYERSPELL_CHANGED))
-            trans->PAppend("INSERT INTO character_spell (guid, spell, active, disabled) VALUES ('%u', '%u', '%u', '%u')", GetGUIDLow(), itr->first, itr->second->active ? 1 : 0, itr->second->disabled ? 1 : 0);
+        {
+            stmt = CharacterDatabase.GetPreparedStatement(CHAR_INS_CHARACTER_SPELL);
+            stmt->setUInt32(0, GetGUIDLow());
+            stmt->setUInt32(1, itr->first);
+            stmt->setBool(2, itr->second->active);
+            stmt->setBool(3, itr->second->disabled);
+            trans->Append(stmt);
+        }
 
         if (itr->second->state == PLAYERSPELL_REMOVED)
         {
@@ -21722,27 +21853,27 @@ bool Player::IsVisibleGloballyFor(Player* u) const
 }
 
 template<class T>
-inline void UpdateVisibilityOf_helper(std::set<uint64>& s64, T* target, std::set<Unit*>& /*v*/)
+inline void UpdateVisibilityOf_helper(Player::ClientGUIDs& s64, T* target, std::set<Unit*>& /*v*/)
 {
     s64.insert(target->GetGUID());
 }
 
 template<>
-inline void UpdateVisibilityOf_helper(std::set<uint64>& s64, GameObject* target, std::set<Unit*>& /*v*/)
+inline void UpdateVisibilityOf_helper(Player::ClientGUIDs& s64, GameObject* target, std::set<Unit*>& /*v*/)
 {
     if (!target->IsTransport())
         s64.insert(target->GetGUID());
 }
 
 template<>
-inline void UpdateVisibilityOf_helper(std::set<uint64>& s64, Creature* target, std::set<Unit*>& v)
+inline void UpdateVisibilityOf_helper(Player::ClientGUIDs& s64, Creature* target, std::set<Unit*>& v)
 {
     s64.insert(target->GetGUID());
     v.insert(target);
 }
 
 template<>
-inline void UpdateVisibilityOf_helper(std::set<uint64>& s64, Player* target, std::set<Unit*>& v)
+inline void UpdateVisibilityOf_helper(Player::ClientGUIDs& s64, Player* target, std::set<Unit*>& v)
 {
     s64.insert(target->GetGUID());
     v.insert(target);
@@ -21779,6 +21910,11 @@ void Player::UpdateVisibilityOf(WorldObject* target)
     }
     else
     {
+        // distant units only take free places, the next relocation notify ranks them
+        if (uint32 limit = GetVisibleObjectsLimit())
+            if (m_clientGUIDs.size() >= limit && IsLowDetail(target))
+                return;
+
         if (canSeeOrDetect(target, false, true))
         {
             //if (target->isType(TYPEMASK_UNIT) && ((Unit*)target)->m_Vehicle)
@@ -21877,6 +22013,9 @@ template void Player::UpdateVisibilityOf(DynamicObject* target, UpdateData& data
 
 void Player::UpdateObjectVisibility(bool forced)
 {
+    // something else than the position changed, the next relocation notify evaluates everything
+    ResetVisibilityUpdate();
+
     if (!forced)
         AddToNotify(NOTIFY_VISIBILITY_CHANGED);
     else
@@ -21886,6 +22025,62 @@ void Player::UpdateObjectVisibility(bool forced)
     }
 }
 
+bool Player::IsLowDetail(WorldObject const* obj) const
+{
+    if (obj == this || !obj->isType(TYPEMASK_UNIT) || !sWorld->getBoolConfig(CONFIG_VISIBILITY_LOD))
+        return false;
+
+    float nearDistance = sWorld->getFloatConfig(CONFIG_VISIBILITY_LOD_NEAR_DISTANCE);
+    if (m_seer->GetExactDist2dSq(obj) <= nearDistance * nearDistance)
+        return false;
+
+    Unit const* unit = (Unit const*)obj;
+    if (unit->GetGUID() == GetSelection() || unit->getVictim() == this || getVictim() == unit)
+        return false;
+
+    // own or group members' pets, vehicles and players
+    if (Player* player = unit->GetCharmerOrOwnerPlayerOrPlayerItself())
+        if (IsInSameRaidWith(player))
+            return false;
+
+    return true;
+}
+
+uint32 Player::GetVisibleObjectsLimit() const
+{
+    return sWorld->getBoolConfig(CONFIG_VISIBILITY_LOD) ? sWorld->getIntConfig(CONFIG_VISIBILITY_LOD_MAX_OBJECTS) : 0;
+}
+
+bool Player::IsLowDetailHeartbeat()
+{
+    if (!sWorld->getBoolConfig(CONFIG_VISIBILITY_LOD))
+        return false;
+
+    uint32 now = getMSTime();
+    if (getMSTimeDiff(m_lowDetailHeartbeatTime, now) < sWorld->getIntConfig(CONFIG_VISIBILITY_LOD_INTERVAL))
+        return true;
+
+    m_lowDetailHeartbeatTime = now;
+    return false;
+}
+
+bool Player::StartVisibilityUpdate()
+{
+    // dead players also see around their corpse, views of other objects are always updated in full
+    if (m_seer != this || !isAlive())
+    {
+        ResetVisibilityUpdate();
+        return false;
+    }
+
+    uint32 cell = Axium::ComputeCellCoord(GetPositionX(), GetPositionY()).GetId();
+    if (cell == m_visibilityCell)
+        return true;
+
+    m_visibilityCell = cell;
+    return false;
+}
+
 void Player::UpdateVisibilityForPlayer()
 {
     // updates visibility of all objects around point of view for current player
@@ -22494,7 +22689,7 @@ void Player::SendAurasForTarget(Unit* target)
     if (!target || target->GetVisibleAuras()->empty())                  // speedup things
         return;
 
-    WorldPacket data(SMSG_AURA_UPDATE_ALL);
+    WorldPacket data(SMSG_AURA_UPDATE_ALL, 8 + target->GetVisibleAuras()->size() * 25);
     data.append(target->GetPackGUID());
 
     Unit::VisibleAuraMap const* visibleAuras = target->GetVisibleAuras();
@@ -24924,15 +25119,36 @@ void Player::_LoadTalents(PreparedQueryResult result)
 
 void Player::_SaveTalents(SQLTransaction& trans)
 {
+    PreparedStatement* stmt = NULL;
+
+    // all deletes before the inserts, each statement in a row is merged into one
     for (uint8 i = 0; i < MAX_TALENT_SPECS; ++i)
     {
-        for (PlayerTalentMap::iterator itr = m_talents[i]->begin(); itr != m_talents[i]->end();)
+        for (PlayerTalentMap::iterator itr = m_talents[i]->begin(); itr != m_talents[i]->end(); ++itr)
         {
             if (itr->second->state == PLAYERSPELL_REMOVED || itr->second->state == PLAYERSPELL_CHANGED)
-                trans->PAppend("DELETE FROM character_talent WHERE guid = '%u' and spell = '%u' and spec = '%u'", GetGUIDLow(), itr->first, itr->second->spec);
+            {
+                stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_CHARACTER_TALENT_BY_SPELL_SPEC);
+                stmt->setUInt32(0, GetGUIDLow());
+                stmt->setUInt32(1, itr->first);
+                stmt->setUInt8(2, itr->second->spec);
+                trans->Append(stmt);
+            }
+        }
+    }
 
+    for (uint8 i = 0; i < MAX_TALENT_SPECS; ++i)
+    {
+        for (PlayerTalentMap::iterator itr = m_talents[i]->begin(); itr != m_talents[i]->end();)
+        {
             if (itr->second->state == PLAYERSPELL_NEW || itr->second->state == PLAYERSPELL_CHANGED)
-                trans->PAppend("INSERT INTO character_talent (guid, spell, spec) VALUES ('%u', '%u', '%u')", GetGUIDLow(), itr->first, itr->second->spec);
+            {
+                stmt = CharacterDatabase.GetPreparedStatement(CHAR_INS_CHARACTER_TALENT);
+                stmt->setUInt32(0, GetGUIDLow());
+                stmt->setUInt32(1, itr->first);
+                stmt->setUInt8(2, itr->second->spec);
+                trans->Append(stmt);
+            }
 
             if (itr->second->state == PLAYERSPELL_REMOVED)
             {
@@ -25659,10 +25875,16 @@ void Player::UntransmogrifyEnchant(Item* item, uint16 slot)
     transmogItemsSaveQueue[item->GetGUIDLow()] = tItemInfo;
 }
 
-void Player::_SaveTransmogItems()
+void Player::_SaveTransmogItems(SQLTransaction& trans)
 {
     for (TransmogItemsSaveQueue::iterator itr = transmogItemsSaveQueue.begin(); itr != transmogItemsSaveQueue.end(); ++itr)
-        CharacterDatabase.PQuery("UPDATE item_instance SET TransmogEntry = '%u', TransmogEnchant = '%u' WHERE guid = '%u'", itr->second.TransmogEntry, itr->second.TransmogEnchant, itr->first);
+    {
+        PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_ITEM_INSTANCE_TRANSMOG);
+        stmt->setUInt32(0, itr->second.TransmogEntry);
+        stmt->setUInt32(1, itr->second.TransmogEnchant);
+        stmt->setUInt32(2, itr->first);
+        trans->Append(stmt);
+    }
 
     transmogItemsSaveQueue.clear();
 }
@@ -8,6 +8,7 @@
 #include "Common.h"
 #include "DatabaseEnv.h"
 #include "DBCEnums.h"
+#include "FlatSet.h"
 #include "GroupReference.h"
 #include "ItemPrototype.h"
 #include "Item.h"
@@ -807,6 +808,17 @@ enum PlayedTimeIndex
 
 #define MAX_PLAYED_TIME_INDEX 2
 
+// parts of Player::SaveToDB that rewrite all their rows, not written again while they stay the same
+enum PlayerSaveSection
+{
+    PLAYER_SAVE_BG_DATA         = 0,
+    PLAYER_SAVE_SPELL_COOLDOWNS = 1,
+    PLAYER_SAVE_AURAS           = 2,
+    PLAYER_SAVE_STATS           = 3
+};
+
+#define MAX_PLAYER_SAVE_SECTIONS 4
+
 // used at player loading query list preparing, and later result selection
 enum PlayerLoginQueryIndex
 {
@@ -2382,11 +2394,24 @@ class Player : public Unit, public GridObject<Player>
         WorldLocation GetStartPosition() const;
 
         // currently visible objects at player client
-        typedef std::set<uint64> ClientGUIDs;
+        typedef FlatSet<uint64> ClientGUIDs;
         ClientGUIDs m_clientGUIDs;
 
+        uint32 m_lowDetailHeartbeatTime;                    // last heartbeat sent to distant players
+
+        // cell of the last full visibility update, relocations within it only evaluate the objects crossing the sight range
+        uint32 m_visibilityCell;
+        bool StartVisibilityUpdate();
+        void ResetVisibilityUpdate() { m_visibilityCell = TOTAL_NUMBER_OF_CELLS_PER_MAP * TOTAL_NUMBER_OF_CELLS_PER_MAP; }
+
         bool HaveAtClient(WorldObject const* u) const { return u == this || m_clientGUIDs.find(u->GetGUID()) != m_clientGUIDs.end(); }
 
+        //! Updated at a reduced rate for this player, see Visibility.LOD.Enable
+        bool IsLowDetail(WorldObject const* obj) const;
+        uint32 GetVisibleObjectsLimit() const;
+        //! Movement heartbeat held back from distant players
+        bool IsLowDetailHeartbeat();
+
         bool IsNeverVisible() const;
 
         bool IsVisibleGloballyFor(Player* player) const;
@@ -2798,7 +2823,8 @@ class Player : public Unit, public GridObject<Player>
         void _SaveTalents(SQLTransaction& trans);
         void _SaveStats(SQLTransaction& trans);
         void _SaveInstanceTimeRestrictions(SQLTransaction& trans);
-        void _SaveTransmogItems();
+        void _SaveTransmogItems(SQLTransaction& trans);
+        void _SkipUnchangedSave(SQLTransaction& trans, PlayerSaveSection section, size_t start, bool lastSaveCommitted);
 
         void _SetCreateBits(UpdateMask* updateMask, Player* target) const;
         void _SetUpdateBits(UpdateMask* updateMask, Player* target) const;
@@ -2822,6 +2848,9 @@ class Player : public Unit, public GridObject<Player>
 
         uint32 m_team;
         uint32 m_nextSave;
+        uint32 m_saveDelay;                                 // ms the autosave waited for the character database
+        SQLTransaction m_lastSave;                          // state of the previous SaveToDB transaction
+        std::string m_saveContent[MAX_PLAYER_SAVE_SECTIONS]; // what the sections wrote last, see _SkipUnchangedSave
         time_t m_speakTime;
         uint32 m_speakCount;
         Difficulty m_dungeonDifficulty;
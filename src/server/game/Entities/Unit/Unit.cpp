@@ -179,7 +179,11 @@ Unit::Unit(bool isWorldObject): WorldObject(isWorldObject),
     for (uint8 i = 0; i < MAX_GAMEOBJECT_SLOT; ++i)
         m_ObjectSlot[i] = 0;
 
-    m_auraUpdateIterator = m_ownedAuras.end();
+    m_auraUpdateHoles = 0;
+    m_visibleAuraUpdateMask = 0;
+
+    for (uint16 i = 0; i < TOTAL_AURAS; ++i)
+        m_auraModifierCache[i] = NULL;
 
     m_interruptMask = 0;
     m_transform = 0;
@@ -292,6 +296,9 @@ Unit::~Unit()
     delete movespline;
     delete m_preGeneratedPath;
 
+    for (uint16 i = 0; i < TOTAL_AURAS; ++i)
+        delete m_auraModifierCache[i];
+
     ASSERT(!m_duringRemoveFromWorld);
     ASSERT(!m_attacking);
     ASSERT(m_attackers.empty());
@@ -3069,29 +3076,33 @@ void Unit::_UpdateSpells(uint32 time)
         }
     }
 
-    // m_auraUpdateIterator can be updated in indirect called code at aura remove to skip next planned to update but removed auras
-    for (m_auraUpdateIterator = m_ownedAuras.begin(); m_auraUpdateIterator != m_ownedAuras.end();)
-    {
-        Aura* i_aura = m_auraUpdateIterator->second;
-        ++m_auraUpdateIterator;                            // need shift to next for allow update if need into aura update
-        i_aura->UpdateOwner(time, this);
-    }
+    // auras removed in indirect called code leave a hole in m_auraUpdateList, added ones are appended
+    for (size_t i = 0; i < m_auraUpdateList.size(); ++i)
+        if (UnitAura* aura = m_auraUpdateList[i])
+            aura->UpdateOwner(time, this);
 
     // remove expired auras - do that after updates(used in scripts?)
-    for (AuraMap::iterator i = m_ownedAuras.begin(); i != m_ownedAuras.end();)
+    for (size_t i = 0; i < m_auraUpdateList.size(); ++i)
+        if (UnitAura* aura = m_auraUpdateList[i])
+            if (aura->IsExpired())
+                RemoveOwnedAura(aura, AURA_REMOVE_BY_EXPIRE);
+
+    if (m_visibleAuraUpdateMask)
     {
-        if (i->second->IsExpired())
-            RemoveOwnedAura(i, AURA_REMOVE_BY_EXPIRE);
-        else
-            ++i;
+        uint64 mask = m_visibleAuraUpdateMask;
+        m_visibleAuraUpdateMask = 0;
+        for (uint8 slot = 0; mask; ++slot, mask >>= 1)
+            if (mask & 1)
+                if (AuraApplication* aurApp = GetVisibleAura(slot))
+                    if (aurApp->IsNeedClientUpdate())
+                        aurApp->ClientUpdate();
     }
 
-    for (VisibleAuraMap::iterator itr = m_visibleAuras.begin(); itr != m_visibleAuras.end(); ++itr)
-        if (itr->second->IsNeedClientUpdate())
-            itr->second->ClientUpdate();
-
     _DeleteRemovedAuras();
 
+    if (m_auraUpdateHoles)
+        _CompactAuraUpdateList();
+
     if (!m_gameObj.empty())
     {
         GameObjectList::iterator itr;
@@ -3411,6 +3422,8 @@ void Unit::_AddAura(UnitAura* aura, Unit* caster)
 {
     ASSERT(!m_cleanupDone);
     m_ownedAuras.insert(AuraMap::value_type(aura->GetId(), aura));
+    aura->SetOwnerSlot(uint32(m_auraUpdateList.size()));
+    m_auraUpdateList.push_back(aura);
 
     _RemoveNoStackAurasDueToAura(aura);
 
@@ -3670,6 +3683,77 @@ void Unit::_RegisterAuraEffect(AuraEffect* aurEff, bool apply)
         m_modAuras[aurEff->GetAuraType()].push_back(aurEff);
     else
         m_modAuras[aurEff->GetAuraType()].remove(aurEff);
+
+    _UpdateAuraModifierCache(aurEff->GetAuraType());
+}
+
+void Unit::_UpdateAuraModifierCache(AuraType auratype)
+{
+    AuraModifierCache*& cache = m_auraModifierCache[auratype];
+
+    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
+    if (mTotalAuraList.empty())
+    {
+        delete cache;
+        cache = NULL;
+        return;
+    }
+
+    if (!cache)
+        cache = new AuraModifierCache();
+
+    cache->total = 0;
+    cache->maxPositive = 0;
+    cache->maxNegative = 0;
+    cache->multiplier = 1.0f;
+    cache->miscEntries.clear();
+
+    for (AuraEffectList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
+    {
+        int32 amount = (*i)->GetAmount();
+        cache->total += amount;
+        AddPctN(cache->multiplier, amount);
+        if (amount > cache->maxPositive)
+            cache->maxPositive = amount;
+        if (amount < cache->maxNegative)
+            cache->maxNegative = amount;
+
+        AuraModifierCache::MiscEntry* entry = cache->FindMisc((*i)->GetMiscValue());
+        if (!entry)
+        {
+            AuraModifierCache::MiscEntry newEntry;
+            newEntry.misc = (*i)->GetMiscValue();
+            newEntry.total = 0;
+            newEntry.maxPositive = 0;
+            newEntry.maxNegative = 0;
+            newEntry.multiplier = 1.0f;
+            cache->miscEntries.push_back(newEntry);
+            entry = &cache->miscEntries.back();
+        }
+
+        entry->total += amount;
+        AddPctN(entry->multiplier, amount);
+        if (amount > entry->maxPositive)
+            entry->maxPositive = amount;
+        if (amount < entry->maxNegative)
+            entry->maxNegative = amount;
+    }
+}
+
+void Unit::_CompactAuraUpdateList()
+{
+    size_t count = 0;
+    for (size_t i = 0; i < m_auraUpdateList.size(); ++i)
+    {
+        if (UnitAura* aura = m_auraUpdateList[i])
+        {
+            aura->SetOwnerSlot(uint32(count));
+            m_auraUpdateList[count++] = aura;
+        }
+    }
+
+    m_auraUpdateList.resize(count);
+    m_auraUpdateHoles = 0;
 }
 
 // All aura base removes should go threw this function!
@@ -3678,9 +3762,9 @@ void Unit::RemoveOwnedAura(AuraMap::iterator &i, AuraRemoveMode removeMode)
     Aura* aura = i->second;
     ASSERT(!aura->IsRemoved());
 
-    // if unit currently update aura list then make safe update iterator shift to next
-    if (m_auraUpdateIterator == i)
-        ++m_auraUpdateIterator;
+    // _UpdateSpells may be walking the update list, it is compacted afterwards
+    m_auraUpdateList[static_cast<UnitAura*>(aura)->GetOwnerSlot()] = NULL;
+    ++m_auraUpdateHoles;
 
     m_ownedAuras.erase(i);
     m_removedAuras.push_back(aura);
@@ -4654,61 +4738,40 @@ uint32 Unit::GetDoTsByCaster(uint64 casterGUID) const
 
 int32 Unit::GetTotalAuraModifier(AuraType auratype) const
 {
-    int32 modifier = 0;
-
-    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
-    for (AuraEffectList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
-        modifier += (*i)->GetAmount();
-
-    return modifier;
+    AuraModifierCache const* cache = m_auraModifierCache[auratype];
+    return cache ? cache->total : 0;
 }
 
 float Unit::GetTotalAuraMultiplier(AuraType auratype) const
 {
-    float multiplier = 1.0f;
-
-    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
-    for (AuraEffectList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
-        AddPctN(multiplier, (*i)->GetAmount());
-
-    return multiplier;
+    AuraModifierCache const* cache = m_auraModifierCache[auratype];
+    return cache ? cache->multiplier : 1.0f;
 }
 
 int32 Unit::GetMaxPositiveAuraModifier(AuraType auratype)
 {
-    int32 modifier = 0;
-
-    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
-    for (AuraEffectList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
-    {
-        if ((*i)->GetAmount() > modifier)
-            modifier = (*i)->GetAmount();
-    }
-
-    return modifier;
+    AuraModifierCache const* cache = m_auraModifierCache[auratype];
+    return cache ? cache->maxPositive : 0;
 }
 
 int32 Unit::GetMaxNegativeAuraModifier(AuraType auratype) const
 {
-    int32 modifier = 0;
-
-    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
-    for (AuraEffectList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
-        if ((*i)->GetAmount() < modifier)
-            modifier = (*i)->GetAmount();
-
-    return modifier;
+    AuraModifierCache const* cache = m_auraModifierCache[auratype];
+    return cache ? cache->maxNegative : 0;
 }
 
 int32 Unit::GetTotalAuraModifierByMiscMask(AuraType auratype, uint32 misc_mask) const
 {
+    AuraModifierCache const* cache = m_auraModifierCache[auratype];
+    if (!cache)
+        return 0;
+
     int32 modifier = 0;
 
-    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
-    for (AuraEffectList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
+    for (std::vector<AuraModifierCache::MiscEntry>::const_iterator i = cache->miscEntries.begin(); i != cache->miscEntries.end(); ++i)
     {
-        if ((*i)->GetMiscValue()& misc_mask)
-            modifier += (*i)->GetAmount();
+        if (i->misc & misc_mask)
+            modifier += i->total;
     }
     return modifier;
 }
@@ -4742,6 +4805,20 @@ int32 Unit::GetMaxPositiveAuraModifierByMiscMask(AuraType auratype, uint32 misc_
 {
     int32 modifier = 0;
 
+    if (!except)
+    {
+        AuraModifierCache const* cache = m_auraModifierCache[auratype];
+        if (!cache)
+            return 0;
+
+        for (std::vector<AuraModifierCache::MiscEntry>::const_iterator i = cache->miscEntries.begin(); i != cache->miscEntries.end(); ++i)
+        {
+            if (i->misc & misc_mask && i->maxPositive > modifier)
+                modifier = i->maxPositive;
+        }
+        return modifier;
+    }
+
     AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
     for (AuraEffectList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
     {
@@ -4754,13 +4831,16 @@ int32 Unit::GetMaxPositiveAuraModifierByMiscMask(AuraType auratype, uint32 misc_
 
 int32 Unit::GetMaxNegativeAuraModifierByMiscMask(AuraType auratype, uint32 misc_mask) const
 {
+    AuraModifierCache const* cache = m_auraModifierCache[auratype];
+    if (!cache)
+        return 0;
+
     int32 modifier = 0;
 
-    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
-    for (AuraEffectList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
+    for (std::vector<AuraModifierCache::MiscEntry>::const_iterator i = cache->miscEntries.begin(); i != cache->miscEntries.end(); ++i)
     {
-        if ((*i)->GetMiscValue()& misc_mask && (*i)->GetAmount() < modifier)
-            modifier = (*i)->GetAmount();
+        if (i->misc & misc_mask && i->maxNegative < modifier)
+            modifier = i->maxNegative;
     }
 
     return modifier;
@@ -4768,56 +4848,30 @@ int32 Unit::GetMaxNegativeAuraModifierByMiscMask(AuraType auratype, uint32 misc_
 
 int32 Unit::GetTotalAuraModifierByMiscValue(AuraType auratype, int32 misc_value) const
 {
-    int32 modifier = 0;
-
-    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
-    for (AuraEffectList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
-    {
-        if ((*i)->GetMiscValue() == misc_value)
-            modifier += (*i)->GetAmount();
-    }
-    return modifier;
+    AuraModifierCache const* cache = m_auraModifierCache[auratype];
+    AuraModifierCache::MiscEntry const* entry = cache ? cache->FindMisc(misc_value) : NULL;
+    return entry ? entry->total : 0;
 }
 
 float Unit::GetTotalAuraMultiplierByMiscValue(AuraType auratype, int32 misc_value) const
 {
-    float multiplier = 1.0f;
-
-    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
-    for (AuraEffectList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
-    {
-        if ((*i)->GetMiscValue() == misc_value)
-            AddPctN(multiplier, (*i)->GetAmount());
-    }
-    return multiplier;
+    AuraModifierCache const* cache = m_auraModifierCache[auratype];
+    AuraModifierCache::MiscEntry const* entry = cache ? cache->FindMisc(misc_value) : NULL;
+    return entry ? entry->multiplier : 1.0f;
 }
 
 int32 Unit::GetMaxPositiveAuraModifierByMiscValue(AuraType auratype, int32 misc_value) const
 {
-    int32 modifier = 0;
-
-    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
-    for (AuraEffectList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
-    {
-        if ((*i)->GetMiscValue() == misc_value && (*i)->GetAmount() > modifier)
-            modifier = (*i)->GetAmount();
-    }
-
-    return modifier;
+    AuraModifierCache const* cache = m_auraModifierCache[auratype];
+    AuraModifierCache::MiscEntry const* entry = cache ? cache->FindMisc(misc_value) : NULL;
+    return entry ? entry->maxPositive : 0;
 }
 
 int32 Unit::GetMaxNegativeAuraModifierByMiscValue(AuraType auratype, int32 misc_value) const
 {
-    int32 modifier = 0;
-
-    AuraEffectList const& mTotalAuraList = GetAuraEffectsByType(auratype);
-    for (AuraEffectList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
-    {
-        if ((*i)->GetMiscValue() == misc_value && (*i)->GetAmount() < modifier)
-            modifier = (*i)->GetAmount();
-    }
-
-    return modifier;
+    AuraModifierCache const* cache = m_auraModifierCache[auratype];
+    AuraModifierCache::MiscEntry const* entry = cache ? cache->FindMisc(misc_value) : NULL;
+    return entry ? entry->maxNegative : 0;
 }
 
 int32 Unit::GetTotalAuraModifierByAffectMask(AuraType auratype, SpellInfo const* affectedSpell) const
@@ -14648,7 +14702,7 @@ void Unit::SetPower(Powers power, uint32 val)
 
     SetStatInt32Value(UNIT_FIELD_POWER1 + power, val);
 
-    WorldPacket data(SMSG_POWER_UPDATE);
+    WorldPacket data(SMSG_POWER_UPDATE, 8 + 1 + 4);
     data.append(GetPackGUID());
     data << uint8(power);
     data << uint32(val);
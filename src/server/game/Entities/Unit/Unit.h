@@ -1212,6 +1212,46 @@ enum PlayerTotemType
 
 struct SpellProcEventEntry;                                 // used only privately
 
+/*
+    Aggregated amounts of the aura effects of one type on a unit, so the damage, crit,
+    hit and armor formulas don't walk the effect list for every GetTotalAuraModifier()
+    and friends. Rebuilt by the unit whenever an effect of the type is registered,
+    unregistered or changes amount, queries only read it.
+*/
+struct AuraModifierCache
+{
+    AuraModifierCache() : total(0), maxPositive(0), maxNegative(0), multiplier(1.0f) {}
+
+    // the same aggregates over the effects with one misc value
+    struct MiscEntry
+    {
+        int32 misc;
+        int32 total;
+        int32 maxPositive;
+        int32 maxNegative;
+        float multiplier;
+    };
+
+    MiscEntry const* FindMisc(int32 misc) const
+    {
+        for (std::vector<MiscEntry>::const_iterator itr = miscEntries.begin(); itr != miscEntries.end(); ++itr)
+            if (itr->misc == misc)
+                return &*itr;
+        return NULL;
+    }
+
+    MiscEntry* FindMisc(int32 misc)
+    {
+        return const_cast<MiscEntry*>(static_cast<AuraModifierCache const*>(this)->FindMisc(misc));
+    }
+
+    int32 total;
+    int32 maxPositive;
+    int32 maxNegative;
+    float multiplier;
+    std::vector<MiscEntry> miscEntries;                     // one per distinct misc value
+};
+
 class Unit : public WorldObject
 {
     public:
@@ -1761,6 +1801,8 @@ class Unit : public WorldObject
         void _RemoveNoStackAurasDueToAura(Aura* aura);
         bool _IsNoStackAuraDueToAura(Aura* appliedAura, Aura* existingAura) const;
         void _RegisterAuraEffect(AuraEffect* aurEff, bool apply);
+        //! Amount of an effect of the type changed
+        void _UpdateAuraModifierCache(AuraType auratype);
 
         // m_ownedAuras container management
         AuraMap      & GetOwnedAuras()       { return m_ownedAuras; }
@@ -2002,6 +2044,8 @@ class Unit : public WorldObject
         }
         void SetVisibleAura(uint8 slot, AuraApplication * aur){ m_visibleAuras[slot]=aur; UpdateAuraForGroup(slot);}
         void RemoveVisibleAura(uint8 slot){ m_visibleAuras.erase(slot); UpdateAuraForGroup(slot);}
+        //! The visible aura of the slot is sent to the client on the next update
+        void _AddVisibleAuraUpdate(uint8 slot) { m_visibleAuraUpdateMask |= UI64LIT(1) << slot; }
 
         uint32 GetInterruptMask() const { return m_interruptMask; }
         void AddInterruptMask(uint32 mask) { m_interruptMask |= mask; }
@@ -2280,6 +2324,7 @@ class Unit : public WorldObject
 
         void _UpdateSpells(uint32 time);
         void _DeleteRemovedAuras();
+        void _CompactAuraUpdateList();
 
         void _UpdateAutoRepeatSpell();
 
@@ -2307,10 +2352,12 @@ class Unit : public WorldObject
         AuraMap m_ownedAuras;
         AuraApplicationMap m_appliedAuras;
         AuraList m_removedAuras;
-        AuraMap::iterator m_auraUpdateIterator;
+        std::vector<UnitAura*> m_auraUpdateList;            // m_ownedAuras in the order they were added, NULL where one was removed
+        uint32 m_auraUpdateHoles;
         uint32 m_removedAurasCount;
 
         AuraEffectList m_modAuras[TOTAL_AURAS];
+        AuraModifierCache* m_auraModifierCache[TOTAL_AURAS]; // NULL while no effect of the type is registered
         AuraList m_scAuras;                        // casted singlecast auras
         AuraApplicationList m_interruptableAuras;             // auras which have interrupt mask applied on unit
         AuraStateAurasMap m_auraStateAuras;        // Used for improve performance of aura state checks on aura apply/remove
@@ -2320,6 +2367,7 @@ class Unit : public WorldObject
         float m_weaponDamage[MAX_ATTACK][2];
         bool m_canModifyStats;
         VisibleAuraMap m_visibleAuras;
+        uint64 m_visibleAuraUpdateMask;                     // slots of m_visibleAuras waiting for ClientUpdate()
 
         float m_speed_rate[MAX_MOVE_TYPE];
 
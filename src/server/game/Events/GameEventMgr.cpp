@@ -1347,6 +1347,7 @@ void GameEventMgr::ChangeEquipOrModel(int16 event_id, bool activate)
                         creature->SetNativeDisplayId(itr->second.modelid);
                         creature->SetFloatValue(UNIT_FIELD_BOUNDINGRADIUS, minfo->bounding_radius);
                         creature->SetFloatValue(UNIT_FIELD_COMBATREACH, minfo->combat_reach);
+                        creature->UpdateCellIndex();
                     }
                 }
             }
@@ -1362,6 +1363,7 @@ void GameEventMgr::ChangeEquipOrModel(int16 event_id, bool activate)
                         creature->SetNativeDisplayId(itr->second.modelid_prev);
                         creature->SetFloatValue(UNIT_FIELD_BOUNDINGRADIUS, minfo->bounding_radius);
                         creature->SetFloatValue(UNIT_FIELD_COMBATREACH, minfo->combat_reach);
+                        creature->UpdateCellIndex();
                     }
                 }
             }
@@ -1640,16 +1642,18 @@ void GameEventMgr::RunSmartAIScripts(uint16 event_id, bool activate)
 {
     //! Iterate over every supported source type (creature and gameobject)
     //! Not entirely sure how this will affect units in non-loaded grids.
+    for (uint32 shard = 0; shard < HashMapHolder<Creature>::SHARDS; ++shard)
     {
-        AXIUM_READ_GUARD(HashMapHolder<Creature>::LockType, *HashMapHolder<Creature>::GetLock());
-        HashMapHolder<Creature>::MapType const& m = ObjectAccessor::GetCreatures();
+        AXIUM_READ_GUARD(HashMapHolder<Creature>::LockType, *HashMapHolder<Creature>::GetLock(shard));
+        HashMapHolder<Creature>::MapType const& m = ObjectAccessor::GetCreatures(shard);
         for (HashMapHolder<Creature>::MapType::const_iterator iter = m.begin(); iter != m.end(); ++iter)
             if (iter->second->IsInWorld())
                 iter->second->AI()->sOnGameEvent(activate, event_id);
     }
+    for (uint32 shard = 0; shard < HashMapHolder<GameObject>::SHARDS; ++shard)
     {
-        AXIUM_READ_GUARD(HashMapHolder<GameObject>::LockType, *HashMapHolder<GameObject>::GetLock());
-        HashMapHolder<GameObject>::MapType const& m = ObjectAccessor::GetGameObjects();
+        AXIUM_READ_GUARD(HashMapHolder<GameObject>::LockType, *HashMapHolder<GameObject>::GetLock(shard));
+        HashMapHolder<GameObject>::MapType const& m = ObjectAccessor::GetGameObjects(shard);
         for (HashMapHolder<GameObject>::MapType::const_iterator iter = m.begin(); iter != m.end(); ++iter)
             if (iter->second->IsInWorld())
                 iter->second->AI()->OnGameEvent(activate, event_id);
@@ -20,6 +20,7 @@
 #include "World.h"
 
 #include <cmath>
+#include <ace/Task.h>
 
 ObjectAccessor::ObjectAccessor()
 {
@@ -147,22 +148,28 @@ Unit* ObjectAccessor::FindUnit(uint64 guid)
 
 Player* ObjectAccessor::FindPlayerByName(const char* name)
 {
-    AXIUM_READ_GUARD(HashMapHolder<Player>::LockType, *HashMapHolder<Player>::GetLock());
-    HashMapHolder<Player>::MapType const& m = GetPlayers();
-    for (HashMapHolder<Player>::MapType::const_iterator iter = m.begin(); iter != m.end(); ++iter)
-        if (iter->second->GetSession())
-            if (strcmp(name, iter->second->GetName()) == 0)
-                return iter->second;
+    for (uint32 shard = 0; shard < HashMapHolder<Player>::SHARDS; ++shard)
+    {
+        AXIUM_READ_GUARD(HashMapHolder<Player>::LockType, *HashMapHolder<Player>::GetLock(shard));
+        HashMapHolder<Player>::MapType const& m = GetPlayers(shard);
+        for (HashMapHolder<Player>::MapType::const_iterator iter = m.begin(); iter != m.end(); ++iter)
+            if (iter->second->GetSession())
+                if (strcmp(name, iter->second->GetName()) == 0)
+                    return iter->second;
+    }
 
     return NULL;
 }
 
 void ObjectAccessor::SaveAllPlayers()
 {
-    AXIUM_READ_GUARD(HashMapHolder<Player>::LockType, *HashMapHolder<Player>::GetLock());
-    HashMapHolder<Player>::MapType const& m = GetPlayers();
-    for (HashMapHolder<Player>::MapType::const_iterator itr = m.begin(); itr != m.end(); ++itr)
-        itr->second->SaveToDB();
+    for (uint32 shard = 0; shard < HashMapHolder<Player>::SHARDS; ++shard)
+    {
+        AXIUM_READ_GUARD(HashMapHolder<Player>::LockType, *HashMapHolder<Player>::GetLock(shard));
+        HashMapHolder<Player>::MapType const& m = GetPlayers(shard);
+        for (HashMapHolder<Player>::MapType::const_iterator itr = m.begin(); itr != m.end(); ++itr)
+            itr->second->SaveToDB();
+    }
 }
 
 Corpse* ObjectAccessor::GetCorpseForPlayerGUID(uint64 guid)
@@ -338,6 +345,18 @@ void ObjectAccessor::Update(uint32 /*diff*/)
 {
     UpdateDataMapType update_players;
 
+    // distant players of these objects are due for the changes held back from them
+    for (std::set<Object*>::iterator itr = i_lowDetailObjects.begin(); itr != i_lowDetailObjects.end();)
+    {
+        if ((*itr)->IsLowDetailUpdateDue())
+        {
+            i_objects.insert(*itr);
+            i_lowDetailObjects.erase(itr++);
+        }
+        else
+            ++itr;
+    }
+
     while (!i_objects.empty())
     {
         Object* obj = *i_objects.begin();
@@ -364,10 +383,79 @@ void ObjectAccessor::UnloadAll()
     }
 }
 
+// guids used by the benchmark, half of them in the map at any time
+#define HASHMAP_BENCHMARK_KEYS 65536
+
+/// Threads doing Find (90%), Insert and Remove on one map
+template <uint32 SHARDS>
+class HashMapBenchmark : public ACE_Task_Base
+{
+    public:
+        explicit HashMapBenchmark(uint32 operations) : _operations(operations), _nextThread(0)
+        {
+            for (uint32 i = 0; i < HASHMAP_BENCHMARK_KEYS; i += 2)
+                _map.Insert(MAKE_NEW_GUID(i, 0, HIGHGUID_PLAYER), this);
+        }
+
+        virtual int svc()
+        {
+            uint32 seed = uint32(++_nextThread) * 2654435761u;
+            for (uint32 i = 0; i < _operations; ++i)
+            {
+                // xorshift, cheap enough not to hide the map
+                seed ^= seed << 13;
+                seed ^= seed >> 17;
+                seed ^= seed << 5;
+
+                uint64 guid = MAKE_NEW_GUID(seed % HASHMAP_BENCHMARK_KEYS, 0, HIGHGUID_PLAYER);
+                uint32 op = (seed >> 16) % 100;
+                if (op < 90)
+                    _map.Find(guid);
+                else if (op < 95)
+                    _map.Insert(guid, this);
+                else
+                    _map.Remove(guid);
+            }
+            return 0;
+        }
+
+    private:
+        ShardedHashMap<HashMapBenchmark, SHARDS> _map;
+        uint32 _operations;
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> _nextThread;
+};
+
+template <uint32 SHARDS>
+static uint32 RunHashMapBenchmark(uint32 threads, uint32 operations)
+{
+    HashMapBenchmark<SHARDS>* benchmark = new HashMapBenchmark<SHARDS>(operations);
+
+    uint32 startTime = getMSTime();
+    if (benchmark->activate(THR_NEW_LWP | THR_JOINABLE, int(threads)) == -1)
+    {
+        delete benchmark;
+        return 0;
+    }
+
+    benchmark->wait();
+    uint32 duration = GetMSTimeDiffToNow(startTime);
+
+    delete benchmark;
+    return duration;
+}
+
+uint32 ObjectAccessor::BenchmarkHashMapHolder(uint32 threads, uint32 operations, bool sharded)
+{
+    if (sharded)
+        return RunHashMapBenchmark<HASHMAPHOLDER_SHARDS>(threads, operations);
+
+    // a single shard is a map behind one lock
+    return RunHashMapBenchmark<1>(threads, operations);
+}
+
 /// Define the static members of HashMapHolder
 
-template <class T> UNORDERED_MAP< uint64, T* > HashMapHolder<T>::m_objectMap;
-template <class T> typename HashMapHolder<T>::LockType HashMapHolder<T>::i_lock;
+template <class T> typename HashMapHolder<T>::ContainerType HashMapHolder<T>::m_objectMap;
 
 /// Global definitions for the hashmap storage
 
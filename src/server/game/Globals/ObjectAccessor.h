@@ -5,6 +5,7 @@
 #include <ace/Singleton.h>
 #include <ace/Thread_Mutex.h>
 #include "UnorderedMap.h"
+#include "ShardedHashMap.h"
 
 #include "UpdateData.h"
 
@@ -24,44 +25,46 @@ class Vehicle;
 class Map;
 class WorldRunnable;
 
+// power of two, see ShardedHashMap
+#define HASHMAPHOLDER_SHARDS 64
+
 template <class T>
 class HashMapHolder
 {
     public:
 
-        typedef UNORDERED_MAP<uint64, T*> MapType;
-        typedef ACE_RW_Thread_Mutex LockType;
+        typedef ShardedHashMap<T, HASHMAPHOLDER_SHARDS> ContainerType;
+        typedef typename ContainerType::MapType MapType;
+        typedef typename ContainerType::LockType LockType;
+
+        enum { SHARDS = HASHMAPHOLDER_SHARDS };
 
         static void Insert(T* o)
         {
-            AXIUM_WRITE_GUARD(LockType, i_lock);
-            m_objectMap[o->GetGUID()] = o;
+            m_objectMap.Insert(o->GetGUID(), o);
         }
 
         static void Remove(T* o)
         {
-            AXIUM_WRITE_GUARD(LockType, i_lock);
-            m_objectMap.erase(o->GetGUID());
+            m_objectMap.Remove(o->GetGUID());
         }
 
         static T* Find(uint64 guid)
         {
-            AXIUM_READ_GUARD(LockType, i_lock);
-            typename MapType::iterator itr = m_objectMap.find(guid);
-            return (itr != m_objectMap.end()) ? itr->second : NULL;
+            return m_objectMap.Find(guid);
         }
 
-        static MapType& GetContainer() { return m_objectMap; }
+        // objects are iterated shard by shard, each under its own lock
+        static MapType& GetContainer(uint32 shard) { return m_objectMap.GetContainer(shard); }
 
-        static LockType* GetLock() { return &i_lock; }
+        static LockType* GetLock(uint32 shard) { return m_objectMap.GetLock(shard); }
 
     private:
 
         //Non instanceable only static
         HashMapHolder() {}
 
-        static LockType i_lock;
-        static MapType  m_objectMap;
+        static ContainerType m_objectMap;
 };
 
 class ObjectAccessor
@@ -176,22 +179,22 @@ class ObjectAccessor
         static Unit* FindUnit(uint64);
         static Player* FindPlayerByName(const char* name);
 
-        // when using this, you must use the hashmapholder's lock
-        static HashMapHolder<Player>::MapType const& GetPlayers()
+        // when using this, you must use the hashmapholder's lock of the shard
+        static HashMapHolder<Player>::MapType const& GetPlayers(uint32 shard)
         {
-            return HashMapHolder<Player>::GetContainer();
+            return HashMapHolder<Player>::GetContainer(shard);
         }
 
-        // when using this, you must use the hashmapholder's lock
-        static HashMapHolder<Creature>::MapType const& GetCreatures()
+        // when using this, you must use the hashmapholder's lock of the shard
+        static HashMapHolder<Creature>::MapType const& GetCreatures(uint32 shard)
         {
-            return HashMapHolder<Creature>::GetContainer();
+            return HashMapHolder<Creature>::GetContainer(shard);
         }
 
-        // when using this, you must use the hashmapholder's lock
-        static HashMapHolder<GameObject>::MapType const& GetGameObjects()
+        // when using this, you must use the hashmapholder's lock of the shard
+        static HashMapHolder<GameObject>::MapType const& GetGameObjects(uint32 shard)
         {
-            return HashMapHolder<GameObject>::GetContainer();
+            return HashMapHolder<GameObject>::GetContainer(shard);
         }
 
         template<class T> static void AddObject(T* object)
@@ -206,6 +209,9 @@ class ObjectAccessor
 
         static void SaveAllPlayers();
 
+        /// Time in ms for threads doing operations each on a HashMapHolder like map, with or without shards
+        static uint32 BenchmarkHashMapHolder(uint32 threads, uint32 operations, bool sharded);
+
         //non-static functions
         void AddUpdateObject(Object* obj)
         {
@@ -219,6 +225,19 @@ class ObjectAccessor
             i_objects.erase(obj);
         }
 
+        // objects holding back changes from distant players, updated again once Object::IsLowDetailUpdateDue
+        void AddLowDetailObject(Object* obj)
+        {
+            AXIUM_GUARD(ACE_Thread_Mutex, i_objectLock);
+            i_lowDetailObjects.insert(obj);
+        }
+
+        void RemoveLowDetailObject(Object* obj)
+        {
+            AXIUM_GUARD(ACE_Thread_Mutex, i_objectLock);
+            i_lowDetailObjects.erase(obj);
+        }
+
         //Thread safe
         Corpse* GetCorpseForPlayerGUID(uint64 guid);
         void RemoveCorpse(Corpse* corpse);
@@ -240,6 +259,7 @@ class ObjectAccessor
         typedef UNORDERED_MAP<Player*, UpdateData>::value_type UpdateDataValueType;
 
         std::set<Object*> i_objects;
+        std::set<Object*> i_lowDetailObjects;
         Player2CorpsesMapType i_player2corpse;
 
         ACE_Thread_Mutex i_objectLock;
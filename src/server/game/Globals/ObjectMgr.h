@@ -1313,6 +1313,7 @@ class ObjectMgr
         ItemSetNameMap mItemSetNameMap;
 
         MapObjectGuids mMapObjectGuids;
+        ACE_Thread_Mutex mMapObjectGuidsLock;               // creatures and gameobjects are loaded at the same time
         CreatureDataMap mCreatureDataMap;
         CreatureTemplateContainer CreatureTemplateStore;
         CreatureModelContainer CreatureModelStore;
@@ -0,0 +1,169 @@
+#include "CellIndex.h"
+#include "Object.h"
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(HAVE_SSE2) || defined(_M_X64)
+#include <emmintrin.h>
+#define CELL_INDEX_SSE2
+#endif
+
+// HasInArc() compares atan2 angles, the dot product may differ slightly at the border
+#define CELL_INDEX_ARC_SLACK    0.01f
+
+CellIndexQuery::CellIndexQuery(float x, float y, float radius, uint32 typeMask) : x(x), y(y), radius(radius),
+    range(radius), typeMask(typeMask), lists(CELL_INDEX_ALL_OBJECTS), cone(false), dirX(0.0f), dirY(0.0f), cosHalfArc(-1.0f),
+    innerRange(0.0f)
+{
+}
+
+void CellIndexQuery::SetCone(float orientation, float arc, float innerRange)
+{
+    float halfArc = arc / 2.0f + CELL_INDEX_ARC_SLACK;
+
+    this->cone = halfArc < float(M_PI);
+    this->dirX = std::cos(orientation);
+    this->dirY = std::sin(orientation);
+    this->cosHalfArc = this->cone ? std::cos(halfArc) : -1.0f;
+    this->innerRange = innerRange;
+}
+
+CellIndex::~CellIndex()
+{
+    // objects still linked when the cell goes away only lose their entry
+    for (size_t i = 0; i < m_objects.size(); ++i)
+        m_objects[i]->m_cellIndex = NULL;
+}
+
+void CellIndex::Insert(WorldObject* obj, bool worldObject)
+{
+    ASSERT(!obj->m_cellIndex);
+
+    uint32 slot = uint32(m_objects.size());
+    m_x.push_back(0.0f);
+    m_y.push_back(0.0f);
+    m_size.push_back(0.0f);
+    m_flags.push_back(obj->m_objectType | (worldObject ? CELL_INDEX_WORLD_OBJECT : CELL_INDEX_GRID_OBJECT));
+    m_objects.push_back(obj);
+
+    obj->m_cellIndex = this;
+    obj->m_cellIndexSlot = slot;
+    Set(slot, obj);
+}
+
+void CellIndex::Remove(WorldObject* obj)
+{
+    CellIndex* index = obj->m_cellIndex;
+    if (!index)
+        return;
+
+    uint32 slot = obj->m_cellIndexSlot;
+    uint32 last = uint32(index->m_objects.size() - 1);
+    ASSERT(index->m_objects[slot] == obj);
+
+    // the last entry takes the place of the removed one
+    if (slot != last)
+    {
+        index->m_x[slot] = index->m_x[last];
+        index->m_y[slot] = index->m_y[last];
+        index->m_size[slot] = index->m_size[last];
+        index->m_flags[slot] = index->m_flags[last];
+        index->m_objects[slot] = index->m_objects[last];
+        index->m_objects[slot]->m_cellIndexSlot = slot;
+    }
+
+    index->m_x.pop_back();
+    index->m_y.pop_back();
+    index->m_size.pop_back();
+    index->m_flags.pop_back();
+    index->m_objects.pop_back();
+
+    obj->m_cellIndex = NULL;
+}
+
+void CellIndex::Update(WorldObject* obj)
+{
+    if (CellIndex* index = obj->m_cellIndex)
+        index->Set(obj->m_cellIndexSlot, obj);
+}
+
+void CellIndex::Set(uint32 slot, WorldObject* obj)
+{
+    m_x[slot] = obj->GetPositionX();
+    m_y[slot] = obj->GetPositionY();
+    m_size[slot] = obj->GetObjectSize();
+}
+
+bool CellIndex::Keep(uint32 slot, CellIndexQuery const& query, float range, float innerRange) const
+{
+    if (!(m_flags[slot] & query.typeMask) || !(m_flags[slot] & query.lists))
+        return false;
+
+    float dx = m_x[slot] - query.x;
+    float dy = m_y[slot] - query.y;
+    float dist2 = dx * dx + dy * dy;
+    float maxDist = range + m_size[slot];
+    if (dist2 > maxDist * maxDist)
+        return false;
+
+    if (!query.cone)
+        return true;
+
+    float inner = innerRange + m_size[slot];
+    return dist2 <= inner * inner || dx * query.dirX + dy * query.dirY >= query.cosHalfArc * std::sqrt(dist2);
+}
+
+void CellIndex::Query(CellIndexQuery const& query, std::vector<WorldObject*>& result) const
+{
+    uint32 size = uint32(m_objects.size());
+    uint32 i = 0;
+    float range = query.range + CELL_INDEX_SLACK;
+    float innerRange = query.innerRange + CELL_INDEX_SLACK;
+
+#ifdef CELL_INDEX_SSE2
+    __m128 centerX = _mm_set1_ps(query.x);
+    __m128 centerY = _mm_set1_ps(query.y);
+    __m128 rangeV = _mm_set1_ps(range);
+    __m128 innerV = _mm_set1_ps(innerRange);
+    __m128 dirX = _mm_set1_ps(query.dirX);
+    __m128 dirY = _mm_set1_ps(query.dirY);
+    __m128 cosHalfArc = _mm_set1_ps(query.cosHalfArc);
+
+    for (; i + 4 <= size; i += 4)
+    {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(&m_x[i]), centerX);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(&m_y[i]), centerY);
+        __m128 objectSize = _mm_loadu_ps(&m_size[i]);
+        __m128 dist2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        __m128 maxDist = _mm_add_ps(rangeV, objectSize);
+        __m128 keep = _mm_cmple_ps(dist2, _mm_mul_ps(maxDist, maxDist));
+
+        if (query.cone)
+        {
+            __m128 inner = _mm_add_ps(innerV, objectSize);
+            __m128 inInner = _mm_cmple_ps(dist2, _mm_mul_ps(inner, inner));
+            __m128 dot = _mm_add_ps(_mm_mul_ps(dx, dirX), _mm_mul_ps(dy, dirY));
+            __m128 inArc = _mm_cmpge_ps(dot, _mm_mul_ps(cosHalfArc, _mm_sqrt_ps(dist2)));
+            keep = _mm_and_ps(keep, _mm_or_ps(inInner, inArc));
+        }
+
+        int mask = _mm_movemask_ps(keep);
+        if (!mask)
+            continue;
+
+        for (uint32 j = 0; j < 4; ++j)
+        {
+            if (!(mask & (1 << j)))
+                continue;
+
+            uint32 flags = m_flags[i + j];
+            if ((flags & query.typeMask) && (flags & query.lists))
+                result.push_back(m_objects[i + j]);
+        }
+    }
+#endif
+
+    for (; i < size; ++i)
+        if (Keep(i, query, range, innerRange))
+            result.push_back(m_objects[i]);
+}
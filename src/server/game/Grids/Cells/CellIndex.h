@@ -0,0 +1,82 @@
+#ifndef AXIUM_CELLINDEX_H
+#define AXIUM_CELLINDEX_H
+
+#include "Define.h"
+
+#include <vector>
+
+class WorldObject;
+
+// positions on a transport are compared in transport space by the exact checks
+#define CELL_INDEX_SLACK        0.5f
+
+// which list of the cell holds an object, next to its TYPEMASK_* in the flags of its entry
+#define CELL_INDEX_WORLD_OBJECT 0x10000
+#define CELL_INDEX_GRID_OBJECT  0x20000
+#define CELL_INDEX_ALL_OBJECTS  (CELL_INDEX_WORLD_OBJECT | CELL_INDEX_GRID_OBJECT)
+
+/// What a ranged search of a cell index keeps
+struct CellIndexQuery
+{
+    CellIndexQuery(float x, float y, float radius, uint32 typeMask);
+
+    //! Also keeps only what is in the arc around orientation, or within innerRange of the center
+    void SetCone(float orientation, float arc, float innerRange);
+
+    float x;
+    float y;
+    float radius;                                           // of the cells visited, like Cell::Visit
+    float range;                                            // of the objects kept, their own size is added
+    uint32 typeMask;                                        // TYPEMASK_*, the objects kept have one of these
+    uint32 lists;                                           // CELL_INDEX_*_OBJECT(S), like Map::VisitWorld/VisitGrid
+
+    bool cone;
+    float dirX;
+    float dirY;
+    float cosHalfArc;
+    float innerRange;
+};
+
+/*
+    Positions of the objects of a cell in arrays of their own, next to the GridRefManager
+    lists of the cell. A ranged search filters these arrays first, four objects per step
+    with SSE2, and only reads the objects whose position may pass its check, instead of
+    reading every object of every cell visited. The filter is conservative: it compares
+    2d distances with the range plus the size of each object, the exact checks follow.
+
+    Objects enter with Grid::AddWorldObject/AddGridObject, leave with RemoveFromGrid or
+    their destruction, and WorldObject::Relocate keeps their entry up to date. Cells of
+    a map are only ever written by the thread that may read them (see MapRegionUpdater).
+*/
+class CellIndex
+{
+    public:
+        CellIndex() {}
+        ~CellIndex();
+
+        void Insert(WorldObject* obj, bool worldObject);
+        static void Remove(WorldObject* obj);
+        //! Position or size of the object changed
+        static void Update(WorldObject* obj);
+
+        uint32 GetSize() const { return uint32(m_objects.size()); }
+
+        //! Appends the objects that may pass a check of the query
+        void Query(CellIndexQuery const& query, std::vector<WorldObject*>& result) const;
+
+    private:
+        CellIndex(CellIndex const&);
+        CellIndex& operator=(CellIndex const&);
+
+        void Set(uint32 slot, WorldObject* obj);
+        bool Keep(uint32 slot, CellIndexQuery const& query, float range, float innerRange) const;
+
+        // one entry per object, same order in all arrays
+        std::vector<float> m_x;
+        std::vector<float> m_y;
+        std::vector<float> m_size;
+        std::vector<uint32> m_flags;                        // TYPEMASK_* | CELL_INDEX_*_OBJECT
+        std::vector<WorldObject*> m_objects;
+};
+
+#endif
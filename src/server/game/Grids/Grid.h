@@ -15,6 +15,7 @@
 #include "Define.h"
 #include "TypeContainer.h"
 #include "TypeContainerVisitor.h"
+#include "CellIndex.h"
 
 // forward declaration
 template<class A, class T, class O> class GridLoader;
@@ -42,6 +43,7 @@ class Grid
         {
             i_objects.template insert<SPECIFIC_OBJECT>(obj);
             ASSERT(obj->IsInGrid());
+            i_index.Insert(obj, true);
         }
 
         /** an object of interested exits the grid
@@ -80,6 +82,11 @@ class Grid
             visitor.Visit(i_objects);
         }
 
+        /** Positions of all objects of the grid, for ranged searches
+         */
+        CellIndex& GetIndex() { return i_index; }
+        CellIndex const& GetIndex() const { return i_index; }
+
         /** Returns the number of object within the grid.
          */
         //unsigned int ActiveObjectsInGrid(void) const { return i_objects.template Count<ACTIVE_OBJECT>(); }
@@ -95,6 +102,7 @@ class Grid
         {
             i_container.template insert<SPECIFIC_OBJECT>(obj);
             ASSERT(obj->IsInGrid());
+            i_index.Insert(obj, false);
         }
 
         /** Removes a containter type object from the grid
@@ -119,6 +127,7 @@ class Grid
 
         TypeMapContainer<GRID_OBJECT_TYPES> i_container;
         TypeMapContainer<WORLD_OBJECT_TYPES> i_objects;
+        CellIndex i_index;
         //typedef std::set<void*> ActiveGridObjects;
         //ActiveGridObjects m_activeGridObjects;
 };
@@ -10,27 +10,41 @@
 #include "CellImpl.h"
 #include "SpellInfo.h"
 
+#include <algorithm>
+#include <iterator>
+
 using namespace Axium;
 
 void VisibleNotifier::SendToSelf()
 {
-    // at this moment i_clientGUIDs have guids that not iterate at grid level checks
+    // objects at client that were not visited are out of range
+    std::vector<uint64> outOfRange;
+    if (i_atClient.size() != i_player.m_clientGUIDs.size())
+    {
+        std::sort(i_atClient.begin(), i_atClient.end());
+        std::set_difference(i_player.m_clientGUIDs.begin(), i_player.m_clientGUIDs.end(), i_atClient.begin(), i_atClient.end(),
+            std::back_inserter(outOfRange));
+    }
+
     // but exist one case when this possible and object not out of range: transports
-    if (Transport* transport = i_player.GetTransport())
-        for (Transport::PlayerSet::const_iterator itr = transport->GetPassengers().begin();itr != transport->GetPassengers().end();++itr)
-        {
-            if (vis_guids.find((*itr)->GetGUID()) != vis_guids.end())
+    if (!outOfRange.empty())
+        if (Transport* transport = i_player.GetTransport())
+            for (Transport::PlayerSet::const_iterator itr = transport->GetPassengers().begin();itr != transport->GetPassengers().end();++itr)
             {
-                vis_guids.erase((*itr)->GetGUID());
+                std::vector<uint64>::iterator guid = std::find(outOfRange.begin(), outOfRange.end(), (*itr)->GetGUID());
+                if (guid != outOfRange.end())
+                {
+                    outOfRange.erase(guid);
 
-                i_player.UpdateVisibilityOf((*itr), i_data, i_visibleNow);
+                    ++i_evaluated;
+                    i_player.UpdateVisibilityOf((*itr), i_data, i_visibleNow);
 
-                if (!(*itr)->isNeedNotify(NOTIFY_VISIBILITY_CHANGED))
-                    (*itr)->UpdateVisibilityOf(&i_player);
+                    if (!(*itr)->isNeedNotify(NOTIFY_VISIBILITY_CHANGED))
+                        (*itr)->UpdateVisibilityOf(&i_player);
+                }
             }
-        }
 
-    for (Player::ClientGUIDs::const_iterator it = vis_guids.begin();it != vis_guids.end(); ++it)
+    for (std::vector<uint64>::const_iterator it = outOfRange.begin();it != outOfRange.end(); ++it)
     {
         i_player.m_clientGUIDs.erase(*it);
         i_data.AddOutOfRangeGUID(*it);
@@ -43,6 +57,11 @@ void VisibleNotifier::SendToSelf()
         }
     }
 
+    if (!i_lowDetail.empty())
+        RankLowDetail();
+
+    i_player.GetMap()->AddVisibilityStats(i_evaluated, i_skipped);
+
     if (!i_data.HasData())
         return;
 
@@ -54,6 +73,43 @@ void VisibleNotifier::SendToSelf()
         i_player.SendInitialVisiblePackets(*it);
 }
 
+void VisibleNotifier::RankLowDetail()
+{
+    // places left once every other object at client is counted, the nearest distant units take them
+    uint32 lowDetailAtClient = 0;
+    for (std::vector<std::pair<float, Unit*> >::const_iterator itr = i_lowDetail.begin(); itr != i_lowDetail.end(); ++itr)
+        if (i_player.m_clientGUIDs.find(itr->second->GetGUID()) != i_player.m_clientGUIDs.end())
+            ++lowDetailAtClient;
+
+    uint32 others = uint32(i_player.m_clientGUIDs.size()) - lowDetailAtClient;
+    uint32 places = i_limit > others ? i_limit - others : 0;
+
+    std::sort(i_lowDetail.begin(), i_lowDetail.end());
+
+    for (std::vector<std::pair<float, Unit*> >::const_iterator itr = i_lowDetail.begin(); itr != i_lowDetail.end(); ++itr)
+    {
+        Unit* unit = itr->second;
+        if (places)
+        {
+            ++i_evaluated;
+            if (Player* player = unit->ToPlayer())
+                i_player.UpdateVisibilityOf(player, i_data, i_visibleNow);
+            else
+                i_player.UpdateVisibilityOf(unit->ToCreature(), i_data, i_visibleNow);
+
+            if (i_player.m_clientGUIDs.find(unit->GetGUID()) != i_player.m_clientGUIDs.end())
+                --places;
+        }
+        else if (i_player.m_clientGUIDs.erase(unit->GetGUID()))
+        {
+            unit->BuildOutOfRangeUpdateBlock(&i_data);
+            i_visibleNow.erase(unit);
+        }
+        else
+            ++i_skipped;
+    }
+}
+
 void VisibleChangesNotifier::Visit(PlayerMapType &m)
 {
     for (PlayerMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
@@ -109,9 +165,7 @@ void PlayerRelocationNotifier::Visit(PlayerMapType &m)
         if (!player)
             continue;
 
-        vis_guids.erase(player->GetGUID());
-
-        i_player.UpdateVisibilityOf(player, i_data, i_visibleNow);
+        VisibleNotifier::UpdateVisibilityOf(player);
 
         if (player->m_seer->isNeedNotify(NOTIFY_VISIBILITY_CHANGED))
             continue;
@@ -130,9 +184,7 @@ void PlayerRelocationNotifier::Visit(CreatureMapType &m)
         if (!creature)
             continue;
 
-        vis_guids.erase(creature->GetGUID());
-
-        i_player.UpdateVisibilityOf(creature, i_data, i_visibleNow);
+        VisibleNotifier::UpdateVisibilityOf(creature);
 
         if (relocated_for_ai && !creature->isNeedNotify(NOTIFY_VISIBILITY_CHANGED))
             CreatureUnitRelocationWorker(creature, &i_player);
@@ -23,11 +23,22 @@ namespace Axium
         Player &i_player;
         UpdateData i_data;
         std::set<Unit*> i_visibleNow;
-        Player::ClientGUIDs vis_guids;
-
-        VisibleNotifier(Player &player) : i_player(player), vis_guids(player.m_clientGUIDs) {}
+        std::vector<uint64> i_atClient;                     // visited objects at client after the update
+        bool i_incremental;
+        uint32 i_evaluated;
+        uint32 i_skipped;
+        uint32 i_limit;                                     // Visibility.LOD.MaxVisibleObjects
+        std::vector<std::pair<float, Unit*> > i_lowDetail;  // distant units by distance, ranked in SendToSelf
+
+        // incremental: only evaluate the objects whose visibility may have changed, see UpdateVisibilityOf
+        VisibleNotifier(Player &player, bool incremental = false) : i_player(player), i_incremental(incremental),
+            i_evaluated(0), i_skipped(0), i_limit(player.GetVisibleObjectsLimit()) {}
         template<class T> void Visit(GridRefManager<T> &m);
+        template<class T> void UpdateVisibilityOf(T* target);
         void SendToSelf(void);
+
+    private:
+        void RankLowDetail();
     };
 
     struct VisibleChangesNotifier
@@ -43,7 +54,7 @@ namespace Axium
 
     struct PlayerRelocationNotifier : public VisibleNotifier
     {
-        PlayerRelocationNotifier(Player &player) : VisibleNotifier(player) {}
+        PlayerRelocationNotifier(Player &player) : VisibleNotifier(player, player.StartVisibilityUpdate()) {}
 
         template<class T> void Visit(GridRefManager<T> &m) { VisibleNotifier::Visit(m); }
         void Visit(CreatureMapType &);
@@ -108,10 +119,11 @@ namespace Axium
         float i_distSq;
         uint32 team;
         Player const* skipped_receiver;
+        bool i_nearOnly;                                    // not to the players i_source is low detail for
         MessageDistDeliverer(WorldObject* src, WorldPacket* msg, float dist, bool own_team_only = false, Player const* skipped = NULL)
             : i_source(src), i_message(msg), i_phaseMask(src->GetPhaseMask()), i_distSq(dist * dist)
             , team((own_team_only && src->GetTypeId() == TYPEID_PLAYER) ? ((Player*)src)->GetTeam() : 0)
-            , skipped_receiver(skipped)
+            , skipped_receiver(skipped), i_nearOnly(false)
         {
         }
         void Visit(PlayerMapType &m);
@@ -128,6 +140,9 @@ namespace Axium
             if (!player->HaveAtClient(i_source))
                 return;
 
+            if (i_nearOnly && player->IsLowDetail(i_source))
+                return;
+
             if (WorldSession* session = player->GetSession())
                 session->SendPacket(i_message);
         }
@@ -136,7 +151,8 @@ namespace Axium
     struct ObjectUpdater
     {
         uint32 i_timeDiff;
-        explicit ObjectUpdater(const uint32 diff) : i_timeDiff(diff) {}
+        std::vector<Creature*>* i_deferred;                 // region updates: creatures reaching outside their region
+        explicit ObjectUpdater(const uint32 diff, std::vector<Creature*>* deferred = NULL) : i_timeDiff(diff), i_deferred(deferred) {}
         template<class T> void Visit(GridRefManager<T> &m);
         void Visit(PlayerMapType &) {}
         void Visit(CorpseMapType &) {}
@@ -331,6 +347,7 @@ namespace Axium
 
         void Visit(CreatureMapType &m);
         void Visit(PlayerMapType &m);
+        void VisitObject(WorldObject* obj);                // Map::VisitIndexed
 
         template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED> &) {}
     };
@@ -396,6 +413,7 @@ namespace Axium
             : i_phaseMask(searcher->GetPhaseMask()), i_objects(objects), i_check(check) {}
 
         void Visit(CreatureMapType &m);
+        void VisitObject(WorldObject* obj);                // Map::VisitIndexed
 
         template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED> &) {}
     };
@@ -13,17 +13,58 @@ template<class T>
 inline void Axium::VisibleNotifier::Visit(GridRefManager<T> &m)
 {
     for (typename GridRefManager<T>::iterator iter = m.begin(); iter != m.end(); ++iter)
+        UpdateVisibilityOf(iter->getSource());
+}
+
+template<class T>
+inline void Axium::VisibleNotifier::UpdateVisibilityOf(T* target)
+{
+    if ((WorldObject*)target == &i_player)
+        return;
+
+    uint64 guid = target->GetGUID();
+    bool atClient = i_player.m_clientGUIDs.find(guid) != i_player.m_clientGUIDs.end();
+
+    if (i_limit && i_player.IsLowDetail(target))
     {
-        vis_guids.erase(iter->getSource()->GetGUID());
-        i_player.UpdateVisibilityOf(iter->getSource(), i_data, i_visibleNow);
+        i_lowDetail.push_back(std::make_pair(i_player.m_seer->GetExactDist2dSq(target), (Unit*)target));
+        if (atClient)
+            i_atClient.push_back(guid);
+        return;
     }
+
+    // Changes of anything but the distance notify on their own (UpdateObjectVisibility), so an
+    // object that did not notify keeps its visibility unless it crossed the sight range. Stealth
+    // also depends on distance and facing, it is always evaluated.
+    if (i_incremental && !target->isNeedNotify(NOTIFY_VISIBILITY_CHANGED) && !target->m_stealth.GetFlags() &&
+        atClient == i_player.IsWithinDist(target, i_player.GetSightRange(target), false))
+    {
+        ++i_skipped;
+    }
+    else
+    {
+        ++i_evaluated;
+        i_player.UpdateVisibilityOf(target, i_data, i_visibleNow);
+        atClient = i_player.m_clientGUIDs.find(guid) != i_player.m_clientGUIDs.end();
+    }
+
+    if (atClient)
+        i_atClient.push_back(guid);
 }
 
 inline void Axium::ObjectUpdater::Visit(CreatureMapType &m)
 {
     for (CreatureMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
-        if (iter->getSource()->IsInWorld())
-            iter->getSource()->Update(i_timeDiff);
+    {
+        Creature* creature = iter->getSource();
+        if (!creature->IsInWorld())
+            continue;
+
+        if (i_deferred && Map::ReachesOutsideRegion(creature))
+            i_deferred->push_back(creature);
+        else
+            creature->Update(i_timeDiff);
+    }
 }
 
 // SEARCHERS & LIST SEARCHERS & WORKERS
@@ -282,6 +323,16 @@ void Axium::UnitLastSearcher<Check>::Visit(PlayerMapType &m)
     }
 }
 
+template<class Check>
+void Axium::UnitLastSearcher<Check>::VisitObject(WorldObject* obj)
+{
+    if (!obj->InSamePhase(i_phaseMask))
+        return;
+
+    if (i_check(obj->ToUnit()))
+        i_object = obj->ToUnit();
+}
+
 template<class Check>
 void Axium::UnitListSearcher<Check>::Visit(PlayerMapType &m)
 {
@@ -344,6 +395,14 @@ void Axium::CreatureListSearcher<Check>::Visit(CreatureMapType &m)
                 i_objects.push_back(itr->getSource());
 }
 
+template<class Check>
+void Axium::CreatureListSearcher<Check>::VisitObject(WorldObject* obj)
+{
+    if (obj->InSamePhase(i_phaseMask))
+        if (i_check(obj->ToCreature()))
+            i_objects.push_back(obj->ToCreature());
+}
+
 template<class Check>
 void Axium::PlayerListSearcher<Check>::Visit(PlayerMapType &m)
 {
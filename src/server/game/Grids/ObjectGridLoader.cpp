@@ -58,9 +58,10 @@ template<> void ObjectGridLoader::SetObjectCell(Creature* obj, CellCoord const&
 }
 
 template <class T>
-void AddObjectHelper(CellCoord &cell, GridRefManager<T> &m, uint32 &count, Map* map, T *obj)
+void AddObjectHelper(CellCoord &cell, GridRefManager<T> &m, CellIndex &index, uint32 &count, Map* map, T *obj)
 {
     obj->AddToGrid(m);
+    index.Insert(obj, obj->IsWorldObject());
     ObjectGridLoader::SetObjectCell(obj, cell);
     obj->AddToWorld();
     if (obj->isActiveObject())
@@ -70,7 +71,7 @@ void AddObjectHelper(CellCoord &cell, GridRefManager<T> &m, uint32 &count, Map*
 }
 
 template <class T>
-void LoadHelper(CellGuidSet const& guid_set, CellCoord &cell, GridRefManager<T> &m, uint32 &count, Map* map)
+void LoadHelper(CellGuidSet const& guid_set, CellCoord &cell, GridRefManager<T> &m, CellIndex &index, uint32 &count, Map* map)
 {
     for (CellGuidSet::const_iterator i_guid = guid_set.begin(); i_guid != guid_set.end(); ++i_guid)
     {
@@ -83,11 +84,11 @@ void LoadHelper(CellGuidSet const& guid_set, CellCoord &cell, GridRefManager<T>
             continue;
         }
 
-        AddObjectHelper(cell, m, count, map, obj);
+        AddObjectHelper(cell, m, index, count, map, obj);
     }
 }
 
-void LoadHelper(CellCorpseSet const& cell_corpses, CellCoord &cell, CorpseMapType &m, uint32 &count, Map* map)
+void LoadHelper(CellCorpseSet const& cell_corpses, CellCoord &cell, CorpseMapType &m, CellIndex &index, uint32 &count, Map* map)
 {
     if (cell_corpses.empty())
         return;
@@ -115,7 +116,7 @@ void LoadHelper(CellCorpseSet const& cell_corpses, CellCoord &cell, CorpseMapTyp
             continue;
         }
 
-        AddObjectHelper(cell, m, count, map, obj);
+        AddObjectHelper(cell, m, index, count, map, obj);
     }
 }
 
@@ -123,14 +124,14 @@ void ObjectGridLoader::Visit(GameObjectMapType &m)
 {
     CellCoord cellCoord = i_cell.GetCellCoord();
     CellObjectGuids const& cell_guids = sObjectMgr->GetCellObjectGuids(i_map->GetId(), i_map->GetSpawnMode(), cellCoord.GetId());
-    LoadHelper(cell_guids.gameobjects, cellCoord, m, i_gameObjects, i_map);
+    LoadHelper(cell_guids.gameobjects, cellCoord, m, i_grid.GetGridType(i_cell.CellX(), i_cell.CellY()).GetIndex(), i_gameObjects, i_map);
 }
 
 void ObjectGridLoader::Visit(CreatureMapType &m)
 {
     CellCoord cellCoord = i_cell.GetCellCoord();
     CellObjectGuids const& cell_guids = sObjectMgr->GetCellObjectGuids(i_map->GetId(), i_map->GetSpawnMode(), cellCoord.GetId());
-    LoadHelper(cell_guids.creatures, cellCoord, m, i_creatures, i_map);
+    LoadHelper(cell_guids.creatures, cellCoord, m, i_grid.GetGridType(i_cell.CellX(), i_cell.CellY()).GetIndex(), i_creatures, i_map);
 }
 
 void ObjectWorldLoader::Visit(CorpseMapType &m)
@@ -138,7 +139,7 @@ void ObjectWorldLoader::Visit(CorpseMapType &m)
     CellCoord cellCoord = i_cell.GetCellCoord();
     // corpses are always added to spawn mode 0 and they are spawned by their instance id
     CellObjectGuids const& cell_guids = sObjectMgr->GetCellObjectGuids(i_map->GetId(), 0, cellCoord.GetId());
-    LoadHelper(cell_guids.corpses, cellCoord, m, i_corpses, i_map);
+    LoadHelper(cell_guids.corpses, cellCoord, m, i_grid.GetGridType(i_cell.CellX(), i_cell.CellY()).GetIndex(), i_corpses, i_map);
 }
 
 void ObjectGridLoader::LoadN(void)
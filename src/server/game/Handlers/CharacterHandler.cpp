@@ -230,7 +230,7 @@ void WorldSession::HandleCharEnumOpcode(WorldPacket & /*recv_data*/)
     stmt->setUInt8(0, PET_SAVE_AS_CURRENT);
     stmt->setUInt32(1, GetAccountId());
 
-    _charEnumCallback = CharacterDatabase.AsyncQuery(stmt);
+    _charEnumCallback = CharacterDatabase.AsyncQuery(stmt, DATABASE_LANE_LOGIN);
 
     SetLastCharEnumOpcodeRecievedTime(getMSTime());
 }
@@ -376,7 +376,7 @@ void WorldSession::HandleCharCreateOpcode(WorldPacket & recv_data)
     _charCreateCallback.SetParam(new CharacterCreateInfo(name, race_, class_, gender, skin, face, hairStyle, hairColor, facialHair, outfitId, recv_data));
     PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_SEL_CHECK_NAME);
     stmt->setString(0, name);
-    _charCreateCallback.SetFutureResult(CharacterDatabase.AsyncQuery(stmt));
+    _charCreateCallback.SetFutureResult(CharacterDatabase.AsyncQuery(stmt, DATABASE_LANE_LOGIN));
 }
 
 void WorldSession::HandleCharCreateCallback(PreparedQueryResult result, CharacterCreateInfo* createInfo)
@@ -405,7 +405,7 @@ void WorldSession::HandleCharCreateCallback(PreparedQueryResult result, Characte
             stmt->setUInt32(0, GetAccountId());
 
             _charCreateCallback.FreeResult();
-            _charCreateCallback.SetFutureResult(CharacterDatabase.AsyncQuery(stmt));
+            _charCreateCallback.SetFutureResult(CharacterDatabase.AsyncQuery(stmt, DATABASE_LANE_LOGIN));
             _charCreateCallback.NextStage();
         }
         break;
@@ -437,7 +437,7 @@ void WorldSession::HandleCharCreateCallback(PreparedQueryResult result, Characte
                 PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_SEL_CHAR_CREATE_INFO);
                 stmt->setUInt32(0, GetAccountId());
                 stmt->setUInt32(1, (skipCinematics == 1 || createInfo->Class == CLASS_DEATH_KNIGHT) ? 10 : 1);
-                _charCreateCallback.SetFutureResult(CharacterDatabase.AsyncQuery(stmt));
+                _charCreateCallback.SetFutureResult(CharacterDatabase.AsyncQuery(stmt, DATABASE_LANE_LOGIN));
                 _charCreateCallback.NextStage();
                 return;
             }
@@ -638,8 +638,9 @@ void WorldSession::HandleCharDeleteOpcode(WorldPacket & recv_data)
         return;
     }
 
-    QueryResult result = CharacterDatabase.PQuery("SELECT account, name FROM characters WHERE guid='%u'", GUID_LOPART(guid));
-    if (result)
+    PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_SEL_CHARACTER_ACCOUNT_NAME);
+    stmt->setUInt32(0, GUID_LOPART(guid));
+    if (PreparedQueryResult result = CharacterDatabase.Query(stmt))
     {
         Field* fields = result->Fetch();
         accountId = fields[0].GetUInt32();
@@ -709,7 +710,36 @@ void WorldSession::HandlePlayerLoginOpcode(WorldPacket & recv_data)
         return;
     }
 
-    _charLoginCallback = CharacterDatabase.DelayQueryHolder((SQLQueryHolder*)holder);
+    // the login queries are independent reads, split them over all the asynchronous connections
+    _charLoginCallback = CharacterDatabase.DelayQueryHolder((SQLQueryHolder*)holder, DATABASE_LANE_LOGIN, 0);
+}
+
+uint32 WorldSession::BenchmarkLoginQueries(uint32 accountId, uint64 guid, uint32 count, uint32 parts)
+{
+    std::vector<QueryResultHolderFuture> futures(count);
+
+    uint32 start = getMSTime();
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        LoginQueryHolder* holder = new LoginQueryHolder(accountId, guid);
+        holder->Initialize();
+        futures[i] = CharacterDatabase.DelayQueryHolder(holder, DATABASE_LANE_LOGIN, parts);
+    }
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        SQLQueryHolder* holder = NULL;
+        futures[i].get(holder);
+
+        // results taken are freed with their pointer, the holder only frees the statements
+        for (uint8 j = 0; j < MAX_PLAYER_LOGIN_QUERY; ++j)
+            holder->GetPreparedResult(j);
+
+        delete holder;
+    }
+
+    return GetMSTimeDiffToNow(start);
 }
 
 void WorldSession::HandlePlayerLogin(LoginQueryHolder* holder)
@@ -1086,7 +1116,7 @@ void WorldSession::HandleCharRenameOpcode(WorldPacket& recv_data)
     stmt->setUInt16(3, AT_LOGIN_RENAME);
     stmt->setString(4, newName);
 
-    _charRenameCallback.SetFutureResult(CharacterDatabase.AsyncQuery(stmt));
+    _charRenameCallback.SetFutureResult(CharacterDatabase.AsyncQuery(stmt, DATABASE_LANE_LOGIN));
 }
 
 void WorldSession::HandleChangePlayerNameOpcodeCallBack(PreparedQueryResult result, std::string newName)
@@ -1308,7 +1338,9 @@ void WorldSession::HandleCharCustomize(WorldPacket& recv_data)
     uint8 gender, skin, face, hairStyle, hairColor, facialHair;
     recv_data >> gender >> skin >> hairColor >> hairStyle >> facialHair >> face;
 
-    QueryResult result = CharacterDatabase.PQuery("SELECT at_login FROM characters WHERE guid ='%u'", GUID_LOPART(guid));
+    PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_SEL_CHARACTER_AT_LOGIN);
+    stmt->setUInt32(0, GUID_LOPART(guid));
+    PreparedQueryResult result = CharacterDatabase.Query(stmt);
     if (!result)
     {
         WorldPacket data(SMSG_CHAR_CUSTOMIZE, 1);
@@ -1367,7 +1399,9 @@ void WorldSession::HandleCharCustomize(WorldPacket& recv_data)
         }
     }
 
-    if (QueryResult oldNameResult = CharacterDatabase.PQuery("SELECT name FROM characters WHERE guid ='%u'", GUID_LOPART(guid)))
+    stmt = CharacterDatabase.GetPreparedStatement(CHAR_SEL_CHARACTER_NAME);
+    stmt->setUInt32(0, GUID_LOPART(guid));
+    if (PreparedQueryResult oldNameResult = CharacterDatabase.Query(stmt))
     {
         std::string oldname = oldNameResult->Fetch()[0].GetString();
         std::string IP_str = GetRemoteAddress();
@@ -1375,7 +1409,7 @@ void WorldSession::HandleCharCustomize(WorldPacket& recv_data)
     }
     Player::Customize(guid, gender, skin, face, hairStyle, hairColor, facialHair);
 
-    PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_CHAR_NAME_AT_LOGIN);
+    stmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_CHAR_NAME_AT_LOGIN);
 
     stmt->setString(0, newName);
     stmt->setUInt16(1, uint16(AT_LOGIN_CUSTOMIZE));
@@ -1533,7 +1567,9 @@ void WorldSession::HandleCharFactionOrRaceChange(WorldPacket& recv_data)
     recv_data >> gender >> skin >> hairColor >> hairStyle >> facialHair >> face >> race;
 
     uint32 lowGuid = GUID_LOPART(guid);
-    QueryResult result = CharacterDatabase.PQuery("SELECT class, level, at_login, knownTitles FROM characters WHERE guid ='%u'", lowGuid);
+    PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_SEL_CHARACTER_FACTION_CHANGE_INFO);
+    stmt->setUInt32(0, lowGuid);
+    PreparedQueryResult result = CharacterDatabase.Query(stmt);
     if (!result)
     {
         WorldPacket data(SMSG_CHAR_FACTION_CHANGE, 1);
@@ -1543,8 +1579,8 @@ void WorldSession::HandleCharFactionOrRaceChange(WorldPacket& recv_data)
     }
 
     Field* fields = result->Fetch();
-    uint32 playerClass = fields[0].GetUInt32();
-    uint32 level = fields[1].GetUInt32();
+    uint32 playerClass = fields[0].GetUInt8();
+    uint32 level = fields[1].GetUInt8();
     uint32 at_loginFlags = fields[2].GetUInt16();
     uint32 used_loginFlag = ((recv_data.GetOpcode() == CMSG_CHAR_RACE_CHANGE) ? AT_LOGIN_CHANGE_RACE : AT_LOGIN_CHANGE_FACTION);
     char const* knownTitlesStr = fields[3].GetCString();
@@ -434,7 +434,12 @@ void WorldSession::HandleMovementOpcodes(WorldPacket & recv_data)
     movementInfo.time = getMSTime();
     movementInfo.guid = mover->GetGUID();
     WriteMovementInfo(&data, &movementInfo);
-    mover->SendMessageToSet(&data, _player);
+
+    // distant players only get a heartbeat once per Visibility.LOD.Interval
+    if (opcode == MSG_MOVE_HEARTBEAT && mover == _player && _player->IsLowDetailHeartbeat())
+        mover->SendMessageToNearSet(&data, _player);
+    else
+        mover->SendMessageToSet(&data, _player);
 
     if (plMover) // nothing is charmed, or player charmed
     {
@@ -80,8 +80,11 @@ uint32 LootStore::LoadLootTable()
     // Clearing store (for reloading case)
     Clear();
 
-    //                                                  0     1            2               3         4         5             6
-    QueryResult result = WorldDatabase.PQuery("SELECT entry, item, ChanceOrQuestChance, lootmode, groupid, mincountOrRef, maxcount FROM %s", GetName());
+    //                          0      1     2                    3         4        5              6
+    std::string query = "SELECT entry, item, ChanceOrQuestChance, lootmode, groupid, mincountOrRef, maxcount FROM ";
+    query += GetName();
+
+    QueryResult result = WorldDatabase.SnapshotQuery(query.c_str(), GetName(), sWorld->GetSnapshotFile(GetName()));
 
     if (!result)
     {
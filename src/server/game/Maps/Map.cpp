@@ -14,6 +14,7 @@
 #include "ObjectMgr.h"
 #include "Group.h"
 #include "DynamicTree.h"
+#include "UpdateProfiler.h"
 
 union u_map_magic
 {
@@ -213,8 +214,8 @@ Map::Map(uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnMode, Map* _par
 _creatureToMoveLock(false), i_mapEntry (sMapStore.LookupEntry(id)), i_spawnMode(SpawnMode), i_InstanceId(InstanceId),
 m_unloadTimer(0), m_VisibleDistance(DEFAULT_VISIBILITY_DISTANCE),
 m_VisibilityNotifyPeriod(DEFAULT_VISIBILITY_NOTIFY_PERIOD),
-m_activeNonPlayersIter(m_activeNonPlayers.end()), i_gridExpiry(expiry),
-i_scriptLock(false)
+m_activeNonPlayersIter(m_activeNonPlayers.end()), i_gridExpiry(expiry), m_lastUpdateCost(0),
+i_regionUpdate(false), i_scriptLock(false)
 {
     m_parentMap = (_parent ? _parent : this);
     for (unsigned int idx=0; idx < MAX_NUMBER_OF_GRIDS; ++idx)
@@ -450,6 +451,8 @@ bool Map::AddToMap(T *obj)
         return false; //Should delete object
     }
 
+    RegionGuard guard(*this);
+
     Cell cell(cellCoord);
     if (obj->isActiveObject())
         EnsureGridLoadedForActiveObject(cell, obj);
@@ -508,58 +511,79 @@ void Map::VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<Axium::Objec
 
 void Map::Update(const uint32 t_diff)
 {
+    ProfileZone profile(PROFILE_ZONE_MAP_UPDATE);
+
     _dynamicTree.update(t_diff);
     /// update worldsessions for existing players
-    for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
     {
-        Player* player = m_mapRefIter->getSource();
-        if (player && player->IsInWorld())
+        ProfileZone profileSessions(PROFILE_ZONE_MAP_SESSIONS);
+        for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
         {
-            //player->Update(t_diff);
-            WorldSession* pSession = player->GetSession();
-            MapSessionFilter updater(pSession);
-            pSession->Update(t_diff, updater);
+            Player* player = m_mapRefIter->getSource();
+            if (player && player->IsInWorld())
+            {
+                //player->Update(t_diff);
+                WorldSession* pSession = player->GetSession();
+                MapSessionFilter updater(pSession);
+                pSession->Update(t_diff, updater);
+            }
         }
     }
     /// update active cells around players and active objects
     resetMarkedCells();
 
-    Axium::ObjectUpdater updater(t_diff);
-    // for creature
-    TypeContainerVisitor<Axium::ObjectUpdater, GridTypeMapContainer  > grid_object_update(updater);
-    // for pets
-    TypeContainerVisitor<Axium::ObjectUpdater, WorldTypeMapContainer > world_object_update(updater);
-
-    // the player iterator is stored in the map object
-    // to make sure calls to Map::Remove don't invalidate it
-    for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
+    if (CanUpdateRegionsInParallel())
+        UpdateRegionsInParallel(t_diff);
+    else
     {
-        Player* player = m_mapRefIter->getSource();
+        Axium::ObjectUpdater updater(t_diff);
+        // for creature
+        TypeContainerVisitor<Axium::ObjectUpdater, GridTypeMapContainer  > grid_object_update(updater);
+        // for pets
+        TypeContainerVisitor<Axium::ObjectUpdater, WorldTypeMapContainer > world_object_update(updater);
 
-        if (!player || !player->IsInWorld())
-            continue;
+        ProfileCounter profilePlayers(PROFILE_ZONE_MAP_PLAYERS);
+        ProfileCounter profileCells(PROFILE_ZONE_MAP_CELLS);
 
-        // update players at tick
-        player->Update(t_diff);
+        // the player iterator is stored in the map object
+        // to make sure calls to Map::Remove don't invalidate it
+        for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
+        {
+            Player* player = m_mapRefIter->getSource();
 
-        VisitNearbyCellsOf(player, grid_object_update, world_object_update);
-    }
+            if (!player || !player->IsInWorld())
+                continue;
 
-    // non-player active objects, increasing iterator in the loop in case of object removal
-    for (m_activeNonPlayersIter = m_activeNonPlayers.begin(); m_activeNonPlayersIter != m_activeNonPlayers.end();)
-    {
-        WorldObject* obj = *m_activeNonPlayersIter;
-        ++m_activeNonPlayersIter;
+            // update players at tick
+            profilePlayers.Start();
+            player->Update(t_diff);
+            profilePlayers.Stop();
 
-        if (!obj || !obj->IsInWorld())
-            continue;
+            profileCells.Start();
+            VisitNearbyCellsOf(player, grid_object_update, world_object_update);
+            profileCells.Stop();
+        }
+
+        profileCells.Start();
+
+        // non-player active objects, increasing iterator in the loop in case of object removal
+        for (m_activeNonPlayersIter = m_activeNonPlayers.begin(); m_activeNonPlayersIter != m_activeNonPlayers.end();)
+        {
+            WorldObject* obj = *m_activeNonPlayersIter;
+            ++m_activeNonPlayersIter;
+
+            if (!obj || !obj->IsInWorld())
+                continue;
 
-        VisitNearbyCellsOf(obj, grid_object_update, world_object_update);
+            VisitNearbyCellsOf(obj, grid_object_update, world_object_update);
+        }
+        profileCells.Stop();
     }
 
     ///- Process necessary scripts
     if (!m_scriptSchedule.empty())
     {
+        ProfileZone profileScripts(PROFILE_ZONE_MAP_SCRIPTS);
         i_scriptLock = true;
         ScriptsProcess();
         i_scriptLock = false;
@@ -568,11 +592,218 @@ void Map::Update(const uint32 t_diff)
     MoveAllCreaturesInMoveList();
 
     if (!m_mapRefManager.isEmpty() || !m_activeNonPlayers.empty())
+    {
+        ProfileZone profileRelocation(PROFILE_ZONE_MAP_RELOCATION);
         ProcessRelocationNotifies(t_diff);
+    }
+
+    // one tick of visibility updates
+    long evaluated = m_visibilityEvaluated.value();
+    long skipped = m_visibilitySkipped.value();
+    m_visibilityEvaluated -= evaluated;
+    m_visibilitySkipped -= skipped;
+
+    m_lastTickVisibility.evaluated = uint64(evaluated);
+    m_lastTickVisibility.skipped = uint64(skipped);
+    m_lastTickVisibility.ticks = 1;
+    m_totalVisibility.evaluated += m_lastTickVisibility.evaluated;
+    m_totalVisibility.skipped += m_lastTickVisibility.skipped;
+    ++m_totalVisibility.ticks;
 
     sScriptMgr->OnMapUpdate(this, t_diff);
 }
 
+/*
+    Creature/gameobject update of a crowded continent, split by grid.
+
+    Grids whose coordinates have the same parity are at least one whole grid apart,
+    so the four parities are run one after another and the grids of one parity in
+    parallel, every neighbouring grid being an idle halo. Grid notifiers, spells and
+    auras of an object stay within the visibility range, less than half a grid (see
+    CanUpdateRegionsInParallel), so they never reach another region running at the
+    same time. What does cross regions is handled before the merge:
+
+    - threat and hostile references, victims and attackers of creatures in combat,
+    - owners, charmers and summoners of pets, guardians, charmed units and summons,
+    - vehicles and their passengers:
+        these creatures are not updated by their region but collected and updated
+        one after another once all parities are done (Map::ReachesOutsideRegion).
+    - cell changes and immediate scripts:
+        already deferred to MoveAllCreaturesInMoveList and ScriptsProcess, which run
+        after the regions as the merge step.
+    - map-wide state (adding/removing objects, remove/switch lists, respawn times):
+        serialized by Map::RegionGuard.
+*/
+class MapRegionUpdater : public MapUpdateBatch
+{
+    public:
+        MapRegionUpdater(Map& map, uint32 diff) : _map(map), _diff(diff), _cellCount(0) { }
+
+        void AddCell(CellCoord const& p)
+        {
+            uint32 gx = p.x_coord / MAX_NUMBER_OF_CELLS;
+            uint32 gy = p.y_coord / MAX_NUMBER_OF_CELLS;
+            uint32 gridId = gx * MAX_NUMBER_OF_GRIDS + gy;
+
+            UNORDERED_MAP<uint32, uint32>::const_iterator itr = _regionByGrid.find(gridId);
+            if (itr == _regionByGrid.end())
+            {
+                itr = _regionByGrid.insert(std::make_pair(gridId, uint32(_regions.size()))).first;
+                _regions.push_back(Region((gx & 1) | ((gy & 1) << 1)));
+            }
+
+            _regions[itr->second].cells.push_back(p);
+            ++_cellCount;
+        }
+
+        void Run()
+        {
+            MapUpdater* updater = sMapMgr->GetMapUpdater();
+
+            for (uint32 parity = 0; parity < 4; ++parity)
+            {
+                for (uint32 i = 0; i < _regions.size(); ++i)
+                {
+                    if (_regions[i].parity != parity)
+                        continue;
+
+                    // share the last measured map cost out by cell count so regions compete fairly with whole maps
+                    uint32 cost = uint32(uint64(_map.GetLastUpdateCost()) * _regions[i].cells.size() / _cellCount);
+                    updater->schedule_batch_part(*this, i, cost);
+                }
+
+                updater->wait_batch(*this);
+            }
+
+            // removed objects wait in the remove list until after the update, the pointers stay valid
+            for (uint32 i = 0; i < _regions.size(); ++i)
+            {
+                std::vector<Creature*> const& deferred = _regions[i].deferred;
+                for (std::vector<Creature*>::const_iterator itr = deferred.begin(); itr != deferred.end(); ++itr)
+                    if ((*itr)->IsInWorld())
+                        (*itr)->Update(_diff);
+            }
+        }
+
+        void RunPart(uint32 part)
+        {
+            Region& region = _regions[part];
+            Axium::ObjectUpdater updater(_diff, &region.deferred);
+            TypeContainerVisitor<Axium::ObjectUpdater, GridTypeMapContainer> gridObjectUpdate(updater);
+            TypeContainerVisitor<Axium::ObjectUpdater, WorldTypeMapContainer> worldObjectUpdate(updater);
+
+            for (std::vector<CellCoord>::const_iterator itr = region.cells.begin(); itr != region.cells.end(); ++itr)
+            {
+                Cell cell(*itr);
+                _map.Visit(cell, gridObjectUpdate);
+                _map.Visit(cell, worldObjectUpdate);
+            }
+        }
+
+    private:
+        struct Region
+        {
+            explicit Region(uint32 p) : parity(p) { }
+
+            uint32 parity;
+            std::vector<CellCoord> cells;
+            std::vector<Creature*> deferred;                // Map::ReachesOutsideRegion, updated after all parities
+        };
+
+        Map& _map;
+        uint32 _diff;
+
+        std::vector<Region> _regions;
+        UNORDERED_MAP<uint32, uint32> _regionByGrid;
+        uint32 _cellCount;
+};
+
+bool Map::ReachesOutsideRegion(Creature* creature)
+{
+    return creature->isInCombat() || !creature->getAttackers().empty() || !creature->getThreatManager().isThreatListEmpty()
+        || creature->GetCharmerOrOwnerGUID() || creature->isSummon() || creature->IsVehicle() || creature->GetVehicle();
+}
+
+bool Map::CanUpdateRegionsInParallel() const
+{
+    if (!sWorld->getBoolConfig(CONFIG_MAP_UPDATE_REGIONS) || Instanceable())
+        return false;
+
+    // same parity grids are one grid apart, anything an update reaches has to stay within half of that
+    if (GetVisibilityRange() * 2.0f >= SIZE_OF_GRIDS)
+        return false;
+
+    if (m_mapRefManager.getSize() < sWorld->getIntConfig(CONFIG_MAP_UPDATE_REGIONS_MIN_PLAYERS))
+        return false;
+
+    return sMapMgr->GetMapUpdater()->can_schedule_batches();
+}
+
+void Map::CollectNearbyCellsOf(WorldObject* obj, MapRegionUpdater& regions)
+{
+    // Check for valid position
+    if (!obj->IsPositionValid())
+        return;
+
+    CellArea area = Cell::CalculateCellArea(obj->GetPositionX(), obj->GetPositionY(), obj->GetGridActivationRange());
+
+    for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
+    {
+        for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
+        {
+            uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
+            if (isCellMarked(cell_id))
+                continue;
+
+            markCell(cell_id);
+            CellCoord pair(x, y);
+
+            // grid loading adds objects to the map, do it before the regions run
+            EnsureGridLoaded(Cell(pair));
+            regions.AddCell(pair);
+        }
+    }
+}
+
+void Map::UpdateRegionsInParallel(const uint32 t_diff)
+{
+    MapRegionUpdater regions(*this, t_diff);
+    ProfileCounter profilePlayers(PROFILE_ZONE_MAP_PLAYERS);
+    ProfileCounter profileCells(PROFILE_ZONE_MAP_CELLS);
+
+    // players stay sequential, they touch far too much outside their own region
+    for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
+    {
+        Player* player = m_mapRefIter->getSource();
+
+        if (!player || !player->IsInWorld())
+            continue;
+
+        profilePlayers.Start();
+        player->Update(t_diff);
+        profilePlayers.Stop();
+
+        CollectNearbyCellsOf(player, regions);
+    }
+
+    for (m_activeNonPlayersIter = m_activeNonPlayers.begin(); m_activeNonPlayersIter != m_activeNonPlayers.end();)
+    {
+        WorldObject* obj = *m_activeNonPlayersIter;
+        ++m_activeNonPlayersIter;
+
+        if (!obj || !obj->IsInWorld())
+            continue;
+
+        CollectNearbyCellsOf(obj, regions);
+    }
+
+    profileCells.Start();
+    i_regionUpdate = true;
+    regions.Run();
+    i_regionUpdate = false;
+    profileCells.Stop();
+}
+
 struct ResetNotifier
 {
     template<class T>inline void resetNotify(GridRefManager<T> &m)
@@ -682,6 +913,8 @@ void Map::RemovePlayerFromMap(Player* player, bool remove)
 template<class T>
 void Map::RemoveFromMap(T *obj, bool remove)
 {
+    RegionGuard guard(*this);
+
     obj->RemoveFromWorld();
     if (obj->isActiveObject())
         RemoveFromActive(obj);
@@ -723,7 +956,7 @@ void Map::PlayerRelocation(Player* player, float x, float y, float z, float orie
 
     if (!(player->HasAura(200000) || player->HasAura(200001) || player->HasAura(200002) || player->HasAura(200003)
         || player->HasAura(200004) || player->HasAura(200005) || player->HasAura(200006) || player->HasAura(200007)))
-    player->UpdateObjectVisibility(false);
+    player->AddToNotify(NOTIFY_VISIBILITY_CHANGED);         // only the position changed, see Player::StartVisibilityUpdate
 }
 
 void Map::CreatureRelocation(Creature* creature, float x, float y, float z, float ang, bool respawnRelocationOnFail)
@@ -757,6 +990,8 @@ void Map::CreatureRelocation(Creature* creature, float x, float y, float z, floa
 
 void Map::AddCreatureToMoveList(Creature* c, float x, float y, float z, float ang)
 {
+    RegionGuard guard(*this);
+
     if (_creatureToMoveLock) //can this happen?
         return;
 
@@ -767,6 +1002,8 @@ void Map::AddCreatureToMoveList(Creature* c, float x, float y, float z, float an
 
 void Map::RemoveCreatureFromMoveList(Creature* c)
 {
+    RegionGuard guard(*this);
+
     if (_creatureToMoveLock) //can this happen?
         return;
 
@@ -1887,8 +2124,11 @@ void Map::GetZoneAndAreaIdByAreaFlag(uint32& zoneid, uint32& areaid, uint16 area
 
 bool Map::isInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phasemask) const
 {
-    return VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), x1, y1, z1, x2, y2, z2)
-        && _dynamicTree.isInLineOfSight(x1, y1, z1, x2, y2, z2, phasemask);
+    if (!VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), x1, y1, z1, x2, y2, z2))
+        return false;
+
+    RegionDataGuard guard(*this, false);
+    return _dynamicTree.isInLineOfSight(x1, y1, z1, x2, y2, z2, phasemask);
 }
 
 bool Map::getObjectHitPos(uint32 phasemask, float x1, float y1, float z1, float x2, float y2, float z2, float& rx, float& ry, float& rz, float modifyDist)
@@ -1897,7 +2137,11 @@ bool Map::getObjectHitPos(uint32 phasemask, float x1, float y1, float z1, float
     Vector3 dstPos = Vector3(x2, y2, z2);
 
     Vector3 resultPos;
-    bool result = _dynamicTree.getObjectHitPos(phasemask, startPos, dstPos, resultPos, modifyDist);
+    bool result;
+    {
+        RegionDataGuard guard(*this, false);
+        result = _dynamicTree.getObjectHitPos(phasemask, startPos, dstPos, resultPos, modifyDist);
+    }
 
     rx = resultPos.x;
     ry = resultPos.y;
@@ -1907,7 +2151,10 @@ bool Map::getObjectHitPos(uint32 phasemask, float x1, float y1, float z1, float
 
 float Map::GetHeight(uint32 phasemask, float x, float y, float z, bool vmap/*=true*/, float maxSearchDist/*=DEFAULT_HEIGHT_SEARCH*/) const
 {
-    return std::max<float>(GetHeight(x, y, z, vmap, maxSearchDist), _dynamicTree.getHeight(x, y, z, maxSearchDist, phasemask));
+    float height = GetHeight(x, y, z, vmap, maxSearchDist);
+
+    RegionDataGuard guard(*this, false);
+    return std::max<float>(height, _dynamicTree.getHeight(x, y, z, maxSearchDist, phasemask));
 }
 
 bool Map::IsInWater(float x, float y, float pZ, LiquidData* data) const
@@ -2083,6 +2330,7 @@ void Map::AddObjectToRemoveList(WorldObject* obj)
 
     obj->CleanupsBeforeDelete(false);                            // remove or simplify at least cross referenced links
 
+    RegionGuard guard(*this);
     i_objectsToRemove.insert(obj);
     //sLog->outDebug(LOG_FILTER_MAPS, "Object (GUID: %u TypeId: %u) added to removing list.", obj->GetGUIDLow(), obj->GetTypeId());
 }
@@ -2091,6 +2339,8 @@ void Map::AddObjectToSwitchList(WorldObject* obj, bool on)
 {
     ASSERT(obj->GetMapId() == GetId() && obj->GetInstanceId() == GetInstanceId());
 
+    RegionGuard guard(*this);
+
     std::map<WorldObject*, bool>::iterator itr = i_objectsToSwitch.find(obj);
     if (itr == i_objectsToSwitch.end())
         i_objectsToSwitch.insert(itr, std::make_pair(obj, on));
@@ -2164,6 +2414,7 @@ uint32 Map::GetPlayersCountExceptGMs() const
 
 void Map::SendToPlayers(WorldPacket const* data) const
 {
+    SharedPacketScope shared(data);
     for (MapRefManager::const_iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
         itr->getSource()->GetSession()->SendPacket(data);
 }
@@ -2760,7 +3011,10 @@ void Map::SaveCreatureRespawnTime(uint32 dbGuid, time_t respawnTime)
         return;
     }
 
-    _creatureRespawnTimes[dbGuid] = respawnTime;
+    {
+        RegionDataGuard guard(*this, true);
+        _creatureRespawnTimes[dbGuid] = respawnTime;
+    }
 
     PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_REP_CREATURE_RESPAWN);
     stmt->setUInt32(0, dbGuid);
@@ -2772,7 +3026,10 @@ void Map::SaveCreatureRespawnTime(uint32 dbGuid, time_t respawnTime)
 
 void Map::RemoveCreatureRespawnTime(uint32 dbGuid)
 {
-    _creatureRespawnTimes.erase(dbGuid);
+    {
+        RegionDataGuard guard(*this, true);
+        _creatureRespawnTimes.erase(dbGuid);
+    }
 
     PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_CREATURE_RESPAWN);
     stmt->setUInt32(0, dbGuid);
@@ -2790,7 +3047,10 @@ void Map::SaveGORespawnTime(uint32 dbGuid, time_t respawnTime)
         return;
     }
 
-    _goRespawnTimes[dbGuid] = respawnTime;
+    {
+        RegionDataGuard guard(*this, true);
+        _goRespawnTimes[dbGuid] = respawnTime;
+    }
 
     PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_REP_GO_RESPAWN);
     stmt->setUInt32(0, dbGuid);
@@ -2802,7 +3062,10 @@ void Map::SaveGORespawnTime(uint32 dbGuid, time_t respawnTime)
 
 void Map::RemoveGORespawnTime(uint32 dbGuid)
 {
-    _goRespawnTimes.erase(dbGuid);
+    {
+        RegionDataGuard guard(*this, true);
+        _goRespawnTimes.erase(dbGuid);
+    }
 
     PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_GO_RESPAWN);
     stmt->setUInt32(0, dbGuid);
@@ -4,6 +4,8 @@
 #include "Define.h"
 #include <ace/RW_Thread_Mutex.h>
 #include <ace/Thread_Mutex.h>
+#include <ace/Recursive_Thread_Mutex.h>
+#include <ace/Atomic_Op.h>
 
 #include "DBCStructure.h"
 #include "GridDefines.h"
@@ -35,6 +37,7 @@ class Battleground;
 class MapInstanced;
 class InstanceMap;
 namespace Axium { struct ObjectUpdater; }
+class MapRegionUpdater;
 
 struct ScriptAction
 {
@@ -242,7 +245,27 @@ class Map : public GridRefManager<NGridType>
         void VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<Axium::ObjectUpdater, GridTypeMapContainer> &gridVisitor, TypeContainerVisitor<Axium::ObjectUpdater, WorldTypeMapContainer> &worldVisitor);
         virtual void Update(const uint32);
 
+        // duration of the last Update() in microseconds, measured by the map update scheduler
+        uint32 GetLastUpdateCost() const { return m_lastUpdateCost; }
+        void SetLastUpdateCost(uint32 cost) { m_lastUpdateCost = cost; }
+
         float GetVisibilityRange() const { return m_VisibleDistance; }
+
+        // objects whose visibility for a player was evaluated or known not to have changed, see Axium::VisibleNotifier
+        struct VisibilityStats
+        {
+            VisibilityStats() : evaluated(0), skipped(0), ticks(0) {}
+
+            uint64 evaluated;
+            uint64 skipped;
+            uint32 ticks;
+        };
+
+        void AddVisibilityStats(uint32 evaluated, uint32 skipped) { m_visibilityEvaluated += long(evaluated); m_visibilitySkipped += long(skipped); }
+        VisibilityStats const& GetLastTickVisibilityStats() const { return m_lastTickVisibility; }
+        VisibilityStats const& GetTotalVisibilityStats() const { return m_totalVisibility; }
+        void ResetVisibilityStats() { m_totalVisibility = VisibilityStats(); }
+
         //function for setting up visibility distance for maps on per-type/per-Id basis
         virtual void InitVisibilityDistance();
 
@@ -371,8 +394,8 @@ class Map : public GridRefManager<NGridType>
         uint32 GetPlayersCountExceptGMs() const;
         bool ActiveObjectsNearGrid(NGridType const& ngrid) const;
 
-        void AddWorldObject(WorldObject* obj) { i_worldObjects.insert(obj); }
-        void RemoveWorldObject(WorldObject* obj) { i_worldObjects.erase(obj); }
+        void AddWorldObject(WorldObject* obj) { RegionGuard guard(*this); i_worldObjects.insert(obj); }
+        void RemoveWorldObject(WorldObject* obj) { RegionGuard guard(*this); i_worldObjects.erase(obj); }
 
         void SendToPlayers(WorldPacket const* data) const;
 
@@ -400,6 +423,8 @@ class Map : public GridRefManager<NGridType>
         template<class NOTIFIER> void VisitFirstFound(const float &x, const float &y, float radius, NOTIFIER &notifier);
         template<class NOTIFIER> void VisitWorld(const float &x, const float &y, float radius, NOTIFIER &notifier);
         template<class NOTIFIER> void VisitGrid(const float &x, const float &y, float radius, NOTIFIER &notifier);
+        //! Like VisitAll, but notifier.VisitObject() only gets the objects the cell indexes keep for query
+        template<class NOTIFIER> void VisitIndexed(CellIndexQuery const& query, NOTIFIER &notifier);
         CreatureGroupHolderType CreatureGroupHolder;
 
         void UpdateIteratorBack(Player* player);
@@ -417,10 +442,10 @@ class Map : public GridRefManager<NGridType>
         float GetWaterOrGroundLevel(float x, float y, float z, float* ground = NULL, bool swim = false) const;
         float GetHeight(uint32 phasemask, float x, float y, float z, bool vmap = true, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) const;
         bool isInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phasemask) const;
-        void Balance() { _dynamicTree.balance(); }
-        void RemoveGameObjectModel(const GameObjectModel& model) { _dynamicTree.remove(model); }
-        void InsertGameObjectModel(const GameObjectModel& model) { _dynamicTree.insert(model); }
-        bool ContainsGameObjectModel(const GameObjectModel& model) const { return _dynamicTree.contains(model);}
+        void Balance() { RegionDataGuard guard(*this, true); _dynamicTree.balance(); }
+        void RemoveGameObjectModel(const GameObjectModel& model) { RegionDataGuard guard(*this, true); _dynamicTree.remove(model); }
+        void InsertGameObjectModel(const GameObjectModel& model) { RegionDataGuard guard(*this, true); _dynamicTree.insert(model); }
+        bool ContainsGameObjectModel(const GameObjectModel& model) const { RegionDataGuard guard(*this, false); return _dynamicTree.contains(model);}
         bool getObjectHitPos(uint32 phasemask, float x1, float y1, float z1, float x2, float y2, float z2, float& rx, float &ry, float& rz, float modifyDist);
 
         /*
@@ -429,6 +454,7 @@ class Map : public GridRefManager<NGridType>
         time_t GetLinkedRespawnTime(uint64 guid) const;
         time_t GetCreatureRespawnTime(uint32 dbGuid) const
         {
+            RegionDataGuard guard(*this, false);
             UNORDERED_MAP<uint32 /*dbGUID*/, time_t>::const_iterator itr = _creatureRespawnTimes.find(dbGuid);
             if (itr != _creatureRespawnTimes.end())
                 return itr->second;
@@ -438,6 +464,7 @@ class Map : public GridRefManager<NGridType>
 
         time_t GetGORespawnTime(uint32 dbGuid) const
         {
+            RegionDataGuard guard(*this, false);
             UNORDERED_MAP<uint32 /*dbGUID*/, time_t>::const_iterator itr = _goRespawnTimes.find(dbGuid);
             if (itr != _goRespawnTimes.end())
                 return itr->second;
@@ -454,6 +481,66 @@ class Map : public GridRefManager<NGridType>
 
         static void DeleteRespawnTimesInDB(uint16 mapId, uint32 instanceId);
 
+        // true while creatures and gameobjects of several grid regions are updated concurrently
+        bool IsUpdatingRegions() const { return i_regionUpdate; }
+
+        // the creature's update may touch units anywhere on the map, it waits for the merge step
+        static bool ReachesOutsideRegion(Creature* creature);
+
+        // Serializes map-wide state changes (grid membership, move/remove lists, active objects, ...)
+        // while regions are updated concurrently. A no-op otherwise.
+        class RegionGuard
+        {
+            public:
+                explicit RegionGuard(Map& map) : _lock(map.i_regionUpdate ? &map.i_regionLock : NULL)
+                {
+                    if (_lock)
+                        _lock->acquire();
+                }
+
+                ~RegionGuard()
+                {
+                    if (_lock)
+                        _lock->release();
+                }
+
+            private:
+                RegionGuard(RegionGuard const&);
+                RegionGuard& operator=(RegionGuard const&);
+
+                ACE_Recursive_Thread_Mutex* _lock;
+        };
+
+        // Respawn times and the dynamic tree are read by every region while some change them, readers
+        // share the lock and writers take it alone. Nothing else is locked while holding it. A no-op
+        // outside of region updates.
+        class RegionDataGuard
+        {
+            public:
+                RegionDataGuard(Map const& map, bool write) : _lock(map.i_regionUpdate ? &map.i_regionDataLock : NULL)
+                {
+                    if (!_lock)
+                        return;
+
+                    if (write)
+                        _lock->acquire_write();
+                    else
+                        _lock->acquire_read();
+                }
+
+                ~RegionDataGuard()
+                {
+                    if (_lock)
+                        _lock->release();
+                }
+
+            private:
+                RegionDataGuard(RegionDataGuard const&);
+                RegionDataGuard& operator=(RegionDataGuard const&);
+
+                ACE_RW_Thread_Mutex* _lock;
+        };
+
     private:
         void LoadMapAndVMap(int gx, int gy);
         void LoadVMap(int gx, int gy);
@@ -502,6 +589,10 @@ class Map : public GridRefManager<NGridType>
 
         void UpdateActiveCells(const float &x, const float &y, const uint32 t_diff);
 
+        bool CanUpdateRegionsInParallel() const;
+        void UpdateRegionsInParallel(const uint32 t_diff);
+        void CollectNearbyCellsOf(WorldObject* obj, MapRegionUpdater& regions);
+
     protected:
         void SetUnloadReferenceLock(const GridCoord &p, bool on) { getNGrid(p.x_coord, p.y_coord)->setUnloadReferenceLock(on); }
 
@@ -519,6 +610,12 @@ class Map : public GridRefManager<NGridType>
 
         int32 m_VisibilityNotifyPeriod;
 
+        // notifiers may run on region threads
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_visibilityEvaluated;
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_visibilitySkipped;
+        VisibilityStats m_lastTickVisibility;
+        VisibilityStats m_totalVisibility;
+
         typedef std::set<WorldObject*> ActiveNonPlayers;
         ActiveNonPlayers m_activeNonPlayers;
         ActiveNonPlayers::iterator m_activeNonPlayersIter;
@@ -534,6 +631,11 @@ class Map : public GridRefManager<NGridType>
         GameObject* _FindGameObject(WorldObject* pWorldObject, uint32 guid) const;
 
         time_t i_gridExpiry;
+        uint32 m_lastUpdateCost;
+
+        bool i_regionUpdate;
+        ACE_Recursive_Thread_Mutex i_regionLock;
+        mutable ACE_RW_Thread_Mutex i_regionDataLock;       // see RegionDataGuard
 
         //used for fast base_map (e.g. MapInstanced class object) search for
         //InstanceMaps and BattlegroundMaps...
@@ -565,12 +667,15 @@ class Map : public GridRefManager<NGridType>
         template<class T>
         void AddToActiveHelper(T* obj)
         {
+            RegionGuard guard(*this);
             m_activeNonPlayers.insert(obj);
         }
 
         template<class T>
         void RemoveFromActiveHelper(T* obj)
         {
+            RegionGuard guard(*this);
+
             // Map::Update for active object in proccess
             if (m_activeNonPlayersIter != m_activeNonPlayers.end())
             {
@@ -714,4 +819,31 @@ inline void Map::VisitGrid(const float &x, const float &y, float radius, NOTIFIE
     TypeContainerVisitor<NOTIFIER, GridTypeMapContainer >  grid_object_notifier(notifier);
     cell.Visit(p, grid_object_notifier, *this, radius, x, y);
 }
+
+template<class NOTIFIER>
+inline void Map::VisitIndexed(CellIndexQuery const& query, NOTIFIER& notifier)
+{
+    CellCoord p(Axium::ComputeCellCoord(query.x, query.y));
+    if (!p.IsCoordValid())
+        return;
+
+    CellArea area = Cell::CalculateCellArea(query.x, query.y, std::min(query.radius, SIZE_OF_GRIDS));
+
+    // collected first, the notifier may change the cells
+    std::vector<WorldObject*> objects;
+    for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
+    {
+        for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
+        {
+            Cell cell(CellCoord(x, y));
+            if (!IsGridLoaded(GridCoord(cell.GridX(), cell.GridY())))
+                continue;
+
+            getNGrid(cell.GridX(), cell.GridY())->GetGridType(cell.CellX(), cell.CellY()).GetIndex().Query(query, objects);
+        }
+    }
+
+    for (std::vector<WorldObject*>::const_iterator itr = objects.begin(); itr != objects.end(); ++itr)
+        notifier.VisitObject(*itr);
+}
 #endif
@@ -15,6 +15,7 @@
 #include "Language.h"
 #include "WorldPacket.h"
 #include "Group.h"
+#include "UpdateProfiler.h"
 
 extern GridState* si_GridStates[];                          // debugging code, should be deleted some day
 
@@ -41,7 +42,7 @@ void MapManager::Initialize()
     }
     int num_threads(sWorld->getIntConfig(CONFIG_NUMTHREADS));
     // Start mtmaps if needed.
-    if (num_threads > 0 && m_updater.activate(num_threads) == -1)
+    if (num_threads > 0 && m_updater.activate(num_threads, MapUpdateScheduler(sWorld->getIntConfig(CONFIG_MAP_UPDATE_SCHEDULER))) == -1)
         abort();
 }
 
@@ -196,7 +197,7 @@ bool MapManager::CanPlayerEnter(uint32 mapid, Player* player, bool loginCheck)
 
             if (!corpseMap)
             {
-                WorldPacket data(SMSG_CORPSE_NOT_IN_INSTANCE);
+                WorldPacket data(SMSG_CORPSE_NOT_IN_INSTANCE, 0);
                 player->GetSession()->SendPacket(&data);
                 sLog->outDebug(LOG_FILTER_MAPS, "MAP: Player '%s' does not have a corpse in instance '%s' and cannot enter.", player->GetName(), mapName);
                 return false;
@@ -255,21 +256,31 @@ void MapManager::Update(uint32 diff)
     if (!i_timer.Passed())
         return;
 
+    ProfileZone profile(PROFILE_ZONE_MAP_MANAGER);
+
     MapMapType::iterator iter = i_maps.begin();
-    for (; iter != i_maps.end(); ++iter)
     {
+        ProfileZone profileMaps(PROFILE_ZONE_MAPS);
+        for (; iter != i_maps.end(); ++iter)
+        {
+            if (m_updater.activated())
+                m_updater.schedule_update(*iter->second, uint32(i_timer.GetCurrent()));
+            else
+                iter->second->Update(uint32(i_timer.GetCurrent()));
+        }
         if (m_updater.activated())
-            m_updater.schedule_update(*iter->second, uint32(i_timer.GetCurrent()));
-        else
-            iter->second->Update(uint32(i_timer.GetCurrent()));
+            m_updater.wait();
+
+        for (iter = i_maps.begin(); iter != i_maps.end(); ++iter)
+            iter->second->DelayedUpdate(uint32(i_timer.GetCurrent()));
     }
-    if (m_updater.activated())
-        m_updater.wait();
 
-    for (iter = i_maps.begin(); iter != i_maps.end(); ++iter)
-        iter->second->DelayedUpdate(uint32(i_timer.GetCurrent()));
+    {
+        ProfileZone profileAccessor(PROFILE_ZONE_OBJECT_ACCESSOR);
+        sObjectAccessor->Update(uint32(i_timer.GetCurrent()));
+    }
 
-    sObjectAccessor->Update(uint32(i_timer.GetCurrent()));
+    ProfileZone profileTransports(PROFILE_ZONE_TRANSPORTS);
     for (TransportSet::iterator itr = m_Transports.begin(); itr != m_Transports.end(); ++itr)
         (*itr)->Update(uint32(i_timer.GetCurrent()));
 
@@ -58,7 +58,7 @@ class MapUpdateRequest : public ACE_Method_Request
 };
 
 MapUpdater::MapUpdater():
-m_executor(), m_mutex(), m_condition(m_mutex), pending_requests(0)
+m_scheduler(MAP_UPDATE_SCHEDULER_QUEUE), m_pool(), m_executor(), m_mutex(), m_condition(m_mutex), pending_requests(0)
 {
 }
 
@@ -67,13 +67,21 @@ MapUpdater::~MapUpdater()
     deactivate();
 }
 
-int MapUpdater::activate(size_t num_threads)
+int MapUpdater::activate(size_t num_threads, MapUpdateScheduler scheduler)
 {
+    m_scheduler = scheduler;
+
+    if (m_scheduler == MAP_UPDATE_SCHEDULER_WORK_STEALING)
+        return m_pool.activate(num_threads);
+
     return m_executor.activate((int)num_threads, new WDBThreadStartReq1, new WDBThreadEndReq1);
 }
 
 int MapUpdater::deactivate()
 {
+    if (m_scheduler == MAP_UPDATE_SCHEDULER_WORK_STEALING)
+        return m_pool.deactivate();
+
     wait();
 
     return m_executor.deactivate();
@@ -81,6 +89,12 @@ int MapUpdater::deactivate()
 
 int MapUpdater::wait()
 {
+    if (m_scheduler == MAP_UPDATE_SCHEDULER_WORK_STEALING)
+    {
+        m_pool.waitForCompletion();
+        return 0;
+    }
+
     AXIUM_GUARD(ACE_Thread_Mutex, m_mutex);
 
     while (pending_requests > 0)
@@ -91,6 +105,12 @@ int MapUpdater::wait()
 
 int MapUpdater::schedule_update(Map& map, ACE_UINT32 diff)
 {
+    if (m_scheduler == MAP_UPDATE_SCHEDULER_WORK_STEALING)
+    {
+        m_pool.schedule(map, diff);
+        return 0;
+    }
+
     AXIUM_GUARD(ACE_Thread_Mutex, m_mutex);
 
     ++pending_requests;
@@ -108,9 +128,27 @@ int MapUpdater::schedule_update(Map& map, ACE_UINT32 diff)
 
 bool MapUpdater::activated()
 {
+    if (m_scheduler == MAP_UPDATE_SCHEDULER_WORK_STEALING)
+        return m_pool.activated();
+
     return m_executor.activated();
 }
 
+bool MapUpdater::can_schedule_batches()
+{
+    return m_scheduler == MAP_UPDATE_SCHEDULER_WORK_STEALING && m_pool.activated() && m_pool.GetWorkerCount() > 1;
+}
+
+void MapUpdater::schedule_batch_part(MapUpdateBatch& batch, uint32 part, uint32 cost)
+{
+    m_pool.scheduleBatchPart(batch, part, cost);
+}
+
+void MapUpdater::wait_batch(MapUpdateBatch& batch)
+{
+    m_pool.waitForBatch(batch);
+}
+
 void MapUpdater::update_finished()
 {
     AXIUM_GUARD(ACE_Thread_Mutex, m_mutex);
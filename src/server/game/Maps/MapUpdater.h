@@ -5,9 +5,17 @@
 #include <ace/Condition_Thread_Mutex.h>
 
 #include "DelayExecutor.h"
+#include "MapWorkerPool.h"
 
 class Map;
 
+enum MapUpdateScheduler
+{
+    MAP_UPDATE_SCHEDULER_QUEUE          = 0,    // one shared activation queue (DelayExecutor)
+    MAP_UPDATE_SCHEDULER_WORK_STEALING  = 1,    // per-worker cost ordered deques (MapWorkerPool)
+    MAX_MAP_UPDATE_SCHEDULER
+};
+
 class MapUpdater
 {
     public:
@@ -21,14 +29,24 @@ class MapUpdater
 
         int wait();
 
-        int activate(size_t num_threads);
+        int activate(size_t num_threads, MapUpdateScheduler scheduler = MAP_UPDATE_SCHEDULER_QUEUE);
 
         int deactivate();
 
         bool activated();
 
+        // parallel parts of a single map update, only offered by the work-stealing scheduler
+        bool can_schedule_batches();
+
+        void schedule_batch_part(MapUpdateBatch& batch, uint32 part, uint32 cost);
+
+        void wait_batch(MapUpdateBatch& batch);
+
     private:
 
+        MapUpdateScheduler m_scheduler;
+        MapWorkerPool m_pool;
+
         DelayExecutor m_executor;
         ACE_Thread_Mutex m_mutex;
         ACE_Condition_Thread_Mutex m_condition;
@@ -0,0 +1,251 @@
+#include "MapWorkerPool.h"
+#include "Map.h"
+
+#include <ace/Guard_T.h>
+#include <ace/OS_NS_sys_time.h>
+#include <ace/OS_NS_Thread.h>
+
+#include <algorithm>
+
+MapWorkerPool::MapWorkerPool()
+    : m_wakeup(0), m_pending(0), m_nextWorker(0), m_activated(false), m_dispatching(false), m_shutdown(false)
+{
+}
+
+MapWorkerPool::~MapWorkerPool()
+{
+    deactivate();
+}
+
+int MapWorkerPool::activate(size_t num_threads)
+{
+    if (m_activated || num_threads < 1)
+        return -1;
+
+    for (size_t i = 0; i < num_threads; ++i)
+        m_queues.push_back(new WorkerQueue());
+
+    m_shutdown = false;
+    m_nextWorker = 0;
+
+    if (ACE_Task_Base::activate(THR_NEW_LWP | THR_JOINABLE | THR_INHERIT_SCHED, int(num_threads)) == -1)
+    {
+        for (WorkerQueues::iterator itr = m_queues.begin(); itr != m_queues.end(); ++itr)
+            delete *itr;
+        m_queues.clear();
+        return -1;
+    }
+
+    m_activated = true;
+    return 0;
+}
+
+int MapWorkerPool::deactivate()
+{
+    if (!m_activated)
+        return -1;
+
+    waitForCompletion();
+
+    m_shutdown = true;
+    m_wakeup.release(int(m_queues.size()));
+    ACE_Task_Base::wait();
+
+    for (WorkerQueues::iterator itr = m_queues.begin(); itr != m_queues.end(); ++itr)
+        delete *itr;
+    m_queues.clear();
+
+    m_activated = false;
+    return 0;
+}
+
+void MapWorkerPool::schedule(Map& map, uint32 diff)
+{
+    ++m_pending;
+
+    MapUpdateJob job(&map, diff, map.GetLastUpdateCost());
+
+    // the world thread stages its maps so the whole batch can be ordered by cost,
+    // maps scheduled by workers during the batch go out immediately
+    if (!m_dispatching)
+    {
+        m_staged.push_back(job);
+        return;
+    }
+
+    dispatch(job);
+    m_wakeup.release();
+}
+
+void MapWorkerPool::scheduleBatchPart(MapUpdateBatch& batch, uint32 part, uint32 cost)
+{
+    {
+        AXIUM_GUARD(ACE_Thread_Mutex, batch.m_lock);
+        ++batch.m_pending;
+    }
+
+    dispatch(MapUpdateJob(&batch, part, cost));
+    m_wakeup.release();
+}
+
+void MapWorkerPool::waitForBatch(MapUpdateBatch& batch)
+{
+    // the caller is usually a worker itself, it takes its share of the batch before parking
+    MapUpdateJob job;
+    while (takeBatchPart(batch, job))
+        run(job);
+
+    AXIUM_GUARD(ACE_Thread_Mutex, batch.m_lock);
+    while (batch.m_pending > 0)
+        batch.m_done.wait();
+}
+
+void MapWorkerPool::flush()
+{
+    m_dispatching = true;
+
+    if (m_staged.empty())
+        return;
+
+    std::sort(m_staged.begin(), m_staged.end());
+
+    for (std::vector<MapUpdateJob>::const_iterator itr = m_staged.begin(); itr != m_staged.end(); ++itr)
+        dispatch(*itr);
+
+    m_wakeup.release(int(std::min(m_staged.size(), m_queues.size())));
+    m_staged.clear();
+}
+
+void MapWorkerPool::waitForCompletion()
+{
+    flush();
+
+    while (m_pending.value() > 0)
+        m_finished.wait();
+
+    m_dispatching = false;
+}
+
+void MapWorkerPool::dispatch(MapUpdateJob const& job)
+{
+    WorkerQueue* target = m_queues[0];
+    for (size_t i = 1; i < m_queues.size(); ++i)
+        if (m_queues[i]->queuedCost.value() < target->queuedCost.value())
+            target = m_queues[i];
+
+    AXIUM_GUARD(ACE_Thread_Mutex, target->lock);
+    target->jobs.insert(std::upper_bound(target->jobs.begin(), target->jobs.end(), job), job);
+    // never-measured maps still count, otherwise they would all pile onto one worker
+    target->queuedCost += long(std::max<uint32>(job.cost, 1));
+}
+
+bool MapWorkerPool::take(WorkerQueue& queue, MapUpdateJob& job)
+{
+    AXIUM_GUARD(ACE_Thread_Mutex, queue.lock);
+
+    if (queue.jobs.empty())
+        return false;
+
+    job = queue.jobs.front();
+    queue.jobs.pop_front();
+    queue.queuedCost -= long(std::max<uint32>(job.cost, 1));
+    return true;
+}
+
+bool MapWorkerPool::steal(size_t self, MapUpdateJob& job)
+{
+    // most loaded victim first, then anyone who still has work;
+    // self == m_queues.size() means the caller owns no deque
+    size_t victim = self;
+    long victimCost = 0;
+    for (size_t i = 0; i < m_queues.size(); ++i)
+    {
+        if (i == self)
+            continue;
+
+        long cost = m_queues[i]->queuedCost.value();
+        if (cost > victimCost)
+        {
+            victim = i;
+            victimCost = cost;
+        }
+    }
+
+    if (victim != self && take(*m_queues[victim], job))
+        return true;
+
+    for (size_t i = 0; i < m_queues.size(); ++i)
+        if (i != self && take(*m_queues[i], job))
+            return true;
+
+    return false;
+}
+
+bool MapWorkerPool::takeBatchPart(MapUpdateBatch& batch, MapUpdateJob& job)
+{
+    for (size_t i = 0; i < m_queues.size(); ++i)
+    {
+        WorkerQueue& queue = *m_queues[i];
+        AXIUM_GUARD(ACE_Thread_Mutex, queue.lock);
+
+        for (std::deque<MapUpdateJob>::iterator itr = queue.jobs.begin(); itr != queue.jobs.end(); ++itr)
+        {
+            if (itr->batch != &batch)
+                continue;
+
+            job = *itr;
+            queue.jobs.erase(itr);
+            queue.queuedCost -= long(std::max<uint32>(job.cost, 1));
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void MapWorkerPool::run(MapUpdateJob& job)
+{
+    if (job.batch)
+    {
+        MapUpdateBatch& batch = *job.batch;
+        batch.RunPart(job.part);
+
+        AXIUM_GUARD(ACE_Thread_Mutex, batch.m_lock);
+        if (--batch.m_pending == 0)
+            batch.m_done.broadcast();
+        return;
+    }
+
+    ACE_Time_Value start = ACE_OS::gettimeofday();
+
+    job.map->Update(job.diff);
+
+    ACE_UINT64 elapsed;
+    (ACE_OS::gettimeofday() - start).to_usec(elapsed);
+    job.map->SetLastUpdateCost(uint32(std::min<ACE_UINT64>(elapsed, 0xFFFFFFFF)));
+
+    if (--m_pending == 0)
+        m_finished.signal();
+}
+
+int MapWorkerPool::svc()
+{
+    size_t self = size_t(m_nextWorker++) % m_queues.size();
+
+    for (;;)
+    {
+        MapUpdateJob job;
+        if (take(*m_queues[self], job) || steal(self, job))
+        {
+            run(job);
+            continue;
+        }
+
+        m_wakeup.acquire();
+
+        if (m_shutdown)
+            break;
+    }
+
+    return 0;
+}
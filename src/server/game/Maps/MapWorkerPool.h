@@ -0,0 +1,131 @@
+#ifndef _MAP_WORKER_POOL_H_INCLUDED
+#define _MAP_WORKER_POOL_H_INCLUDED
+
+#include <ace/Task.h>
+#include <ace/Thread_Mutex.h>
+#include <ace/Thread_Semaphore.h>
+#include <ace/Condition_Thread_Mutex.h>
+#include <ace/Auto_Event.h>
+#include <ace/Atomic_Op.h>
+
+#include <deque>
+#include <vector>
+
+#include "Define.h"
+
+class Map;
+
+// A group of parts that is scheduled and waited for from inside a map update,
+// e.g. the grid regions of a continent (see MapRegionUpdater).
+class MapUpdateBatch
+{
+    public:
+        MapUpdateBatch() : m_done(m_lock), m_pending(0) { }
+        virtual ~MapUpdateBatch() { }
+
+        virtual void RunPart(uint32 part) = 0;
+
+    private:
+        friend class MapWorkerPool;
+
+        // the last part signals under m_lock, so the waiter can't destroy the batch while it does
+        ACE_Thread_Mutex m_lock;
+        ACE_Condition_Thread_Mutex m_done;
+        long m_pending;
+};
+
+// One unit of work for the pool, stored by value in the worker deques so that
+// scheduling a map never touches the heap.
+struct MapUpdateJob
+{
+    MapUpdateJob() : map(NULL), batch(NULL), part(0), diff(0), cost(0) { }
+    MapUpdateJob(Map* m, uint32 d, uint32 c) : map(m), batch(NULL), part(0), diff(d), cost(c) { }
+    MapUpdateJob(MapUpdateBatch* b, uint32 p, uint32 c) : map(NULL), batch(b), part(p), diff(0), cost(c) { }
+
+    Map* map;
+    MapUpdateBatch* batch;                              // set instead of map for batch parts
+    uint32 part;
+    uint32 diff;
+    uint32 cost;                                        // last measured Map::Update time (usec)
+
+    // deques are kept ordered most expensive first
+    bool operator<(MapUpdateJob const& right) const { return cost > right.cost; }
+};
+
+/*
+    Work-stealing map update pool.
+
+    Every worker owns a deque of jobs ordered by cost. Maps scheduled from the world
+    thread are staged and handed out in one batch when the tick waits: biggest maps
+    first, each one to the currently least loaded worker (LPT). Maps scheduled from a
+    worker (instances of a MapInstanced) go straight to the least loaded deque.
+    A worker runs its own deque front to back and, once empty, steals the most
+    expensive pending job of the most loaded worker.
+
+    Batch parts are dispatched the same way. The thread that scheduled them runs the
+    parts of its own batch no worker has taken yet, then blocks on the batch until the
+    others are done; it never runs other maps or batches, which would make its tick
+    depend on unrelated maps and nest their updates into its own.
+
+    Completion is tracked by one atomic counter; only the job that brings it to
+    zero signals the waiting world thread.
+*/
+class MapWorkerPool : protected ACE_Task_Base
+{
+    public:
+
+        MapWorkerPool();
+        virtual ~MapWorkerPool();
+
+        int activate(size_t num_threads);
+
+        int deactivate();
+
+        bool activated() const { return m_activated; }
+
+        void schedule(Map& map, uint32 diff);
+
+        void waitForCompletion();
+
+        void scheduleBatchPart(MapUpdateBatch& batch, uint32 part, uint32 cost);
+
+        void waitForBatch(MapUpdateBatch& batch);
+
+        size_t GetWorkerCount() const { return m_queues.size(); }
+
+        virtual int svc();
+
+    private:
+
+        struct WorkerQueue
+        {
+            WorkerQueue() : queuedCost(0) { }
+
+            ACE_Thread_Mutex lock;
+            std::deque<MapUpdateJob> jobs;
+            ACE_Atomic_Op<ACE_Thread_Mutex, long> queuedCost;
+        };
+
+        typedef std::vector<WorkerQueue*> WorkerQueues;
+
+        void flush();
+        void dispatch(MapUpdateJob const& job);
+        bool take(WorkerQueue& queue, MapUpdateJob& job);
+        bool steal(size_t self, MapUpdateJob& job);
+        bool takeBatchPart(MapUpdateBatch& batch, MapUpdateJob& job);
+        void run(MapUpdateJob& job);
+
+        WorkerQueues m_queues;
+        std::vector<MapUpdateJob> m_staged;             // world thread only, until flush()
+
+        ACE_Thread_Semaphore m_wakeup;
+        ACE_Auto_Event m_finished;
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_pending;
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_nextWorker;
+
+        bool m_activated;
+        bool m_dispatching;                             // a batch has been flushed and not yet waited for
+        volatile bool m_shutdown;
+};
+
+#endif //_MAP_WORKER_POOL_H_INCLUDED
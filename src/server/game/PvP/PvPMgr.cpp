@@ -1,6 +1,295 @@
 #include "PvPMgr.h"
 #include "Player.h"
 #include "ObjectAccessor.h"
+#include "DatabaseEnv.h"
+#include "World.h"
+
+PvPStats::PvPStats() : weeklyArenaPoints(0), arenaPointsCap(0), dirty(0)
+{
+    // same as a new row of character_pvp_stats
+    for (uint8 slot = 0; slot < MAX_ARENA_SLOT; ++slot)
+    {
+        matchMakerRating[slot] = sWorld->getIntConfig(CONFIG_ARENA_START_MATCHMAKER_RATING);
+        lifetimeRating[slot] = 1000;
+        lifetimeMMR[slot] = 1500;
+        lifetimeWins[slot] = 0;
+        lifetimeGames[slot] = 0;
+    }
+}
+
+void PvPMgr::LoadFromDB()
+{
+    uint32 oldMSTime = getMSTime();
+
+    AXIUM_WRITE_GUARD(LockType, m_lock);
+
+    m_stats.clear();
+    m_dirtyGuids.clear();
+
+    PreparedQueryResult result = CharacterDatabase.Query(CharacterDatabase.GetPreparedStatement(CHAR_SEL_ALL_ARENA_POINTS));
+    if (result)
+    {
+        do
+        {
+            Field* fields = result->Fetch();
+            PvPStats& stats = m_stats[fields[0].GetUInt32()];
+            stats.weeklyArenaPoints = fields[1].GetUInt32();
+            stats.arenaPointsCap = fields[2].GetUInt32();
+        }
+        while (result->NextRow());
+    }
+
+    result = CharacterDatabase.Query(CharacterDatabase.GetPreparedStatement(CHAR_SEL_ALL_MATCH_MAKER_RATINGS));
+    if (result)
+    {
+        do
+        {
+            Field* fields = result->Fetch();
+            uint8 slot = fields[1].GetUInt8();
+            if (slot >= MAX_ARENA_SLOT)
+                continue;
+
+            PvPStatsMap::iterator itr = m_stats.find(fields[0].GetUInt32());
+            if (itr != m_stats.end())
+                itr->second.matchMakerRating[slot] = fields[2].GetUInt16();
+        }
+        while (result->NextRow());
+    }
+
+    result = CharacterDatabase.Query(CharacterDatabase.GetPreparedStatement(CHAR_SEL_ALL_PVP_STATS));
+    if (result)
+    {
+        do
+        {
+            Field* fields = result->Fetch();
+            PvPStatsMap::iterator itr = m_stats.find(fields[0].GetUInt32());
+            if (itr == m_stats.end())
+                continue;
+
+            // Rating, MMR, Wins, Games for 2v2, 3v3 and 5v5
+            for (uint8 slot = 0; slot < MAX_ARENA_SLOT; ++slot)
+            {
+                itr->second.lifetimeRating[slot] = fields[1 + slot * 4].GetUInt16();
+                itr->second.lifetimeMMR[slot] = fields[2 + slot * 4].GetUInt16();
+                itr->second.lifetimeWins[slot] = fields[3 + slot * 4].GetUInt16();
+                itr->second.lifetimeGames[slot] = fields[4 + slot * 4].GetUInt16();
+            }
+        }
+        while (result->NextRow());
+    }
+
+    sLog->outString(">> Loaded arena stats of %u characters in %u ms", uint32(m_stats.size()), GetMSTimeDiffToNow(oldMSTime));
+    sLog->outString();
+}
+
+uint32 PvPMgr::SaveToDB()
+{
+    SQLTransaction trans = CharacterDatabase.BeginTransaction();
+    uint32 count = 0;
+
+    {
+        AXIUM_WRITE_GUARD(LockType, m_lock);
+
+        for (std::vector<uint32>::const_iterator itr = m_dirtyGuids.begin(); itr != m_dirtyGuids.end(); ++itr)
+        {
+            PvPStatsMap::iterator stats = m_stats.find(*itr);
+            if (stats == m_stats.end() || !stats->second.dirty)
+                continue;
+
+            PvPStats& s = stats->second;
+            PreparedStatement* stmt;
+
+            if (s.dirty & PVP_STATS_DIRTY_POINTS)
+            {
+                stmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_ARENA_POINTS);
+                stmt->setUInt32(0, s.weeklyArenaPoints);
+                stmt->setUInt32(1, s.arenaPointsCap);
+                stmt->setUInt32(2, *itr);
+                trans->Append(stmt);
+            }
+
+            for (uint8 slot = 0; slot < MAX_ARENA_SLOT; ++slot)
+            {
+                if (!(s.dirty & (PVP_STATS_DIRTY_MMR << slot)))
+                    continue;
+
+                stmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_MATCH_MAKER_RATING);
+                stmt->setUInt16(0, s.matchMakerRating[slot]);
+                stmt->setUInt32(1, *itr);
+                stmt->setUInt8(2, slot);
+                trans->Append(stmt);
+            }
+
+            if (s.dirty & PVP_STATS_DIRTY_LIFETIME)
+            {
+                stmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_PVP_STATS);
+                for (uint8 slot = 0; slot < MAX_ARENA_SLOT; ++slot)
+                {
+                    stmt->setUInt16(slot * 4, s.lifetimeRating[slot]);
+                    stmt->setUInt16(slot * 4 + 1, s.lifetimeMMR[slot]);
+                    stmt->setUInt16(slot * 4 + 2, s.lifetimeWins[slot]);
+                    stmt->setUInt16(slot * 4 + 3, s.lifetimeGames[slot]);
+                }
+                stmt->setUInt32(12, *itr);
+                trans->Append(stmt);
+            }
+
+            s.dirty = 0;
+            ++count;
+        }
+
+        m_dirtyGuids.clear();
+    }
+
+    if (!count)
+        return 0;
+
+    // the CHAR_UPD_* statements are only prepared on the asynchronous connections
+    CharacterDatabase.CommitTransaction(trans);
+
+    return count;
+}
+
+void PvPMgr::LoadPlayerStats(Player* player)
+{
+    AXIUM_WRITE_GUARD(LockType, m_lock);
+
+    PvPStatsMap::iterator itr = m_stats.find(player->GetGUIDLow());
+    if (itr == m_stats.end())
+    {
+        // created after startup, the player has loaded the same as is in the database
+        PvPStats& stats = m_stats[player->GetGUIDLow()];
+        stats.weeklyArenaPoints = player->GetWeeklyArenaPoints();
+        stats.arenaPointsCap = player->GetArenaPointsCap();
+        stats.matchMakerRating[0] = player->Get2v2MMR();
+        stats.matchMakerRating[1] = player->Get3v3MMR();
+        stats.matchMakerRating[2] = player->Get5v5MMR();
+        stats.lifetimeRating[0] = player->GetLifetime2v2Rating();
+        stats.lifetimeMMR[0] = player->GetLifetime2v2MMR();
+        stats.lifetimeWins[0] = player->GetLifetime2v2Wins();
+        stats.lifetimeGames[0] = player->GetLifetime2v2Games();
+        stats.lifetimeRating[1] = player->GetLifetime3v3Rating();
+        stats.lifetimeMMR[1] = player->GetLifetime3v3MMR();
+        stats.lifetimeWins[1] = player->GetLifetime3v3Wins();
+        stats.lifetimeGames[1] = player->GetLifetime3v3Games();
+        stats.lifetimeRating[2] = player->GetLifetime5v5Rating();
+        stats.lifetimeMMR[2] = player->GetLifetime5v5MMR();
+        stats.lifetimeWins[2] = player->GetLifetime5v5Wins();
+        stats.lifetimeGames[2] = player->GetLifetime5v5Games();
+        return;
+    }
+
+    PvPStats const& stats = itr->second;
+    player->SetWeeklyArenaPoints(stats.weeklyArenaPoints);
+    player->SetArenaPointsCap(stats.arenaPointsCap);
+    player->Set2v2MMR(stats.matchMakerRating[0]);
+    player->Set3v3MMR(stats.matchMakerRating[1]);
+    player->Set5v5MMR(stats.matchMakerRating[2]);
+    player->SetLifetime2v2Rating(stats.lifetimeRating[0]);
+    player->SetLifetime2v2MMR(stats.lifetimeMMR[0]);
+    player->SetLifetime2v2Wins(stats.lifetimeWins[0]);
+    player->SetLifetime2v2Games(stats.lifetimeGames[0]);
+    player->SetLifetime3v3Rating(stats.lifetimeRating[1]);
+    player->SetLifetime3v3MMR(stats.lifetimeMMR[1]);
+    player->SetLifetime3v3Wins(stats.lifetimeWins[1]);
+    player->SetLifetime3v3Games(stats.lifetimeGames[1]);
+    player->SetLifetime5v5Rating(stats.lifetimeRating[2]);
+    player->SetLifetime5v5MMR(stats.lifetimeMMR[2]);
+    player->SetLifetime5v5Wins(stats.lifetimeWins[2]);
+    player->SetLifetime5v5Games(stats.lifetimeGames[2]);
+}
+
+void PvPMgr::DeletePlayerStats(uint64 guid)
+{
+    AXIUM_WRITE_GUARD(LockType, m_lock);
+    m_stats.erase(GUID_LOPART(guid));
+}
+
+void PvPMgr::ResetWeeklyArenaPoints()
+{
+    {
+        AXIUM_WRITE_GUARD(LockType, m_lock);
+
+        for (PvPStatsMap::iterator itr = m_stats.begin(); itr != m_stats.end(); ++itr)
+        {
+            itr->second.weeklyArenaPoints = 0;
+            itr->second.arenaPointsCap = 0;
+            itr->second.dirty &= ~PVP_STATS_DIRTY_POINTS;
+        }
+    }
+
+    CharacterDatabase.Execute(CharacterDatabase.GetPreparedStatement(CHAR_UPD_RESET_ARENA_POINTS));
+}
+
+uint32 PvPMgr::GetStatsCount() const
+{
+    AXIUM_READ_GUARD(LockType, m_lock);
+    return uint32(m_stats.size());
+}
+
+uint32 PvPMgr::BenchmarkArenaPointsFlush(uint32 count, uint32& setTime, uint32& saveTime)
+{
+    std::vector<uint32> guids;
+
+    {
+        AXIUM_READ_GUARD(LockType, m_lock);
+
+        guids.reserve(std::min(count, uint32(m_stats.size())));
+        for (PvPStatsMap::const_iterator itr = m_stats.begin(); itr != m_stats.end() && guids.size() < count; ++itr)
+            guids.push_back(itr->first);
+    }
+
+    uint32 oldMSTime = getMSTime();
+
+    for (std::vector<uint32>::const_iterator itr = guids.begin(); itr != guids.end(); ++itr)
+    {
+        uint64 guid = MAKE_NEW_GUID(*itr, 0, HIGHGUID_PLAYER);
+        SetArenaPointsCap(guid, GetArenaPointsCap(guid));
+        SetWeeklyArenaPoints(guid, GetWeeklyArenaPoints(guid));
+    }
+
+    setTime = GetMSTimeDiffToNow(oldMSTime);
+    oldMSTime = getMSTime();
+
+    SaveToDB();
+
+    saveTime = GetMSTimeDiffToNow(oldMSTime);
+    return uint32(guids.size());
+}
+
+PvPStats const* PvPMgr::FindStats(uint64 guid) const
+{
+    PvPStatsMap::const_iterator itr = m_stats.find(GUID_LOPART(guid));
+    return itr != m_stats.end() ? &itr->second : NULL;
+}
+
+PvPStats& PvPMgr::GetOrCreateStats(uint64 guid)
+{
+    return m_stats[GUID_LOPART(guid)];
+}
+
+void PvPMgr::MarkDirty(uint64 guid, PvPStats& stats, uint8 flags)
+{
+    if (!stats.dirty)
+        m_dirtyGuids.push_back(GUID_LOPART(guid));
+
+    stats.dirty |= flags;
+}
+
+uint16 PvPMgr::GetSlotStat(uint64 guid, SlotStats field, uint8 slot) const
+{
+    AXIUM_READ_GUARD(LockType, m_lock);
+    PvPStats const* stats = FindStats(guid);
+    return stats ? (stats->*field)[slot] : 0;
+}
+
+void PvPMgr::SetSlotStat(uint64 guid, SlotStats field, uint8 slot, uint16 value, uint8 flags)
+{
+    AXIUM_WRITE_GUARD(LockType, m_lock);
+    PvPStats& stats = GetOrCreateStats(guid);
+    (stats.*field)[slot] = value;
+    MarkDirty(guid, stats, flags);
+}
 
 uint32 PvPMgr::CalculateArenaPointsCap(uint64 guid)
 {
@@ -16,16 +305,9 @@ uint32 PvPMgr::CalculateArenaPointsCap(uint64 guid)
 
 uint32 PvPMgr::GetWeeklyArenaPoints(uint64 guid) const
 {
-    if (Player* player = ObjectAccessor::FindPlayer(guid))
-        return player->GetWeeklyArenaPoints();
-    else
-    {
-        QueryResult result = CharacterDatabase.PQuery("SELECT weeklyArenaPoints FROM characters WHERE guid = '%u'", GUID_LOPART(guid));
-        if (!result)
-            return 0;
-
-        return (*result)[0].GetUInt32();
-    }
+    AXIUM_READ_GUARD(LockType, m_lock);
+    PvPStats const* stats = FindStats(guid);
+    return stats ? stats->weeklyArenaPoints : 0;
 }
 
 void PvPMgr::SetWeeklyArenaPoints(uint64 guid, uint32 arenaPoints)
@@ -33,21 +315,17 @@ void PvPMgr::SetWeeklyArenaPoints(uint64 guid, uint32 arenaPoints)
     if (Player* player = ObjectAccessor::FindPlayer(guid))
         player->SetWeeklyArenaPoints(arenaPoints);
 
-    CharacterDatabase.PExecute("UPDATE characters SET weeklyArenaPoints = '%u' WHERE guid = '%u'", arenaPoints, GUID_LOPART(guid));
+    AXIUM_WRITE_GUARD(LockType, m_lock);
+    PvPStats& stats = GetOrCreateStats(guid);
+    stats.weeklyArenaPoints = arenaPoints;
+    MarkDirty(guid, stats, PVP_STATS_DIRTY_POINTS);
 }
 
 uint32 PvPMgr::GetArenaPointsCap(uint64 guid) const
 {
-    if (Player* player = ObjectAccessor::FindPlayer(guid))
-        return player->GetArenaPointsCap();
-    else
-    {
-        QueryResult result = CharacterDatabase.PQuery("SELECT arenaPointsCap FROM characters WHERE guid = '%u'", GUID_LOPART(guid));
-        if (!result)
-            return 0;
-
-        return (*result)[0].GetUInt32();
-    }
+    AXIUM_READ_GUARD(LockType, m_lock);
+    PvPStats const* stats = FindStats(guid);
+    return stats ? stats->arenaPointsCap : 0;
 }
 
 void PvPMgr::SetArenaPointsCap(uint64 guid, uint32 arenaPointsCap)
@@ -55,21 +333,15 @@ void PvPMgr::SetArenaPointsCap(uint64 guid, uint32 arenaPointsCap)
     if (Player* player = ObjectAccessor::FindPlayer(guid))
         player->SetArenaPointsCap(arenaPointsCap);
 
-    CharacterDatabase.PExecute("UPDATE characters SET arenaPointsCap = '%u' WHERE guid = '%u'", arenaPointsCap, GUID_LOPART(guid));
+    AXIUM_WRITE_GUARD(LockType, m_lock);
+    PvPStats& stats = GetOrCreateStats(guid);
+    stats.arenaPointsCap = arenaPointsCap;
+    MarkDirty(guid, stats, PVP_STATS_DIRTY_POINTS);
 }
 
 uint16 PvPMgr::Get2v2MMR(uint64 guid) const
 {
-    if (Player* player = ObjectAccessor::FindPlayer(guid))
-        return player->Get2v2MMR();
-    else
-    {
-        QueryResult result = CharacterDatabase.PQuery("SELECT matchMakerRating FROM character_arena_stats WHERE slot = 0 AND guid = '%u'", GUID_LOPART(guid));
-        if (!result)
-            return 0;
-
-        return (*result)[0].GetUInt16();
-    }
+    return GetSlotStat(guid, &PvPStats::matchMakerRating, 0);
 }
 
 void PvPMgr::Set2v2MMR(uint64 guid, uint16 mmr)
@@ -77,7 +349,7 @@ void PvPMgr::Set2v2MMR(uint64 guid, uint16 mmr)
     if (Player* player = ObjectAccessor::FindPlayer(guid))
         player->Set2v2MMR(mmr);
 
-    CharacterDatabase.PExecute("UPDATE character_arena_stats SET matchMakerRating = '%u' WHERE slot = 0 AND guid = '%u'", mmr, GUID_LOPART(guid));
+    SetSlotStat(guid, &PvPStats::matchMakerRating, 0, mmr, PVP_STATS_DIRTY_MMR << 0);
 
     if (mmr > GetLifetime2v2MMR(guid))
         SetLifetime2v2MMR(guid, mmr);
@@ -85,16 +357,7 @@ void PvPMgr::Set2v2MMR(uint64 guid, uint16 mmr)
 
 uint16 PvPMgr::Get3v3MMR(uint64 guid) const
 {
-    if (Player* player = ObjectAccessor::FindPlayer(guid))
-        return player->Get3v3MMR();
-    else
-    {
-        QueryResult result = CharacterDatabase.PQuery("SELECT matchMakerRating FROM character_arena_stats WHERE slot = 1 AND guid = '%u'", GUID_LOPART(guid));
-        if (!result)
-            return 0;
-
-        return (*result)[0].GetUInt16();
-    }
+    return GetSlotStat(guid, &PvPStats::matchMakerRating, 1);
 }
 
 void PvPMgr::Set3v3MMR(uint64 guid, uint16 mmr)
@@ -102,7 +365,7 @@ void PvPMgr::Set3v3MMR(uint64 guid, uint16 mmr)
     if (Player* player = ObjectAccessor::FindPlayer(guid))
         player->Set3v3MMR(mmr);
 
-    CharacterDatabase.PExecute("UPDATE character_arena_stats SET matchMakerRating = '%u' WHERE slot = 1 AND guid = '%u'", mmr, GUID_LOPART(guid));
+    SetSlotStat(guid, &PvPStats::matchMakerRating, 1, mmr, PVP_STATS_DIRTY_MMR << 1);
 
     if (mmr > GetLifetime3v3MMR(guid))
         SetLifetime3v3MMR(guid, mmr);
@@ -110,16 +373,7 @@ void PvPMgr::Set3v3MMR(uint64 guid, uint16 mmr)
 
 uint16 PvPMgr::Get5v5MMR(uint64 guid) const
 {
-    if (Player* player = ObjectAccessor::FindPlayer(guid))
-        return player->Get5v5MMR();
-    else
-    {
-        QueryResult result = CharacterDatabase.PQuery("SELECT matchMakerRating FROM character_arena_stats WHERE slot = 2 AND guid = '%u'", GUID_LOPART(guid));
-        if (!result)
-            return 0;
-
-        return (*result)[0].GetUInt16();
-    }
+    return GetSlotStat(guid, &PvPStats::matchMakerRating, 2);
 }
 
 void PvPMgr::Set5v5MMR(uint64 guid, uint16 mmr)
@@ -127,7 +381,7 @@ void PvPMgr::Set5v5MMR(uint64 guid, uint16 mmr)
     if (Player* player = ObjectAccessor::FindPlayer(guid))
         player->Set5v5MMR(mmr);
 
-    CharacterDatabase.PExecute("UPDATE character_arena_stats SET matchMakerRating = '%u' WHERE slot = 2 AND guid = '%u'", mmr, GUID_LOPART(guid));
+    SetSlotStat(guid, &PvPStats::matchMakerRating, 2, mmr, PVP_STATS_DIRTY_MMR << 2);
 
     if (mmr > GetLifetime5v5MMR(guid))
         SetLifetime5v5MMR(guid, mmr);
@@ -135,16 +389,7 @@ void PvPMgr::Set5v5MMR(uint64 guid, uint16 mmr)
 
 uint16 PvPMgr::GetLifetime2v2Rating(uint64 guid) const
 {
-    if (Player* player = ObjectAccessor::FindPlayer(guid))
-        return player->GetLifetime2v2Rating();
-    else
-    {
-        QueryResult result = CharacterDatabase.PQuery("SELECT Lifetime2v2Rating FROM character_pvp_stats WHERE guid = '%u'", GUID_LOPART(guid));
-        if (!result)
-            return 0;
-
-        return (*result)[0].GetUInt16();
-    }
+    return GetSlotStat(guid, &PvPStats::lifetimeRating, 0);
 }
 
 void PvPMgr::SetLifetime2v2Rating(uint64 guid, uint16 rating)
@@ -152,21 +397,12 @@ void PvPMgr::SetLifetime2v2Rating(uint64 guid, uint16 rating)
     if (Player* player = ObjectAccessor::FindPlayer(guid))
         player->SetLifetime2v2Rating(rating);
 
-    CharacterDatabase.PExecute("UPDATE character_pvp_stats SET Lifetime2v2Rating = '%u' WHERE guid = '%u'", rating, GUID_LOPART(guid));
+    SetSlotStat(guid, &PvPStats::lifetimeRating, 0, rating, PVP_STATS_DIRTY_LIFETIME);
 }
 
 uint16 PvPMgr::GetLifetime2v2MMR(uint64 guid) const
 {
-    if (Player* player = ObjectAccessor::FindPlayer(guid))
-        return player->GetLifetime2v2MMR();
-    else
-    {
-        QueryResult result = CharacterDatabase.PQuery("SELECT Lifetime2v2MMR FROM character_pvp_stats WHERE guid = '%u'", GUID_LOPART(guid));
-        if (!result)
-            return 0;
-
-        return (*result)[0].GetUInt16();
-    }
+    return GetSlotStat(guid, &PvPStats::lifetimeMMR, 0);
 }
 
 void PvPMgr::SetLifetime2v2MMR(uint64 guid, uint16 mmr)
@@ -174,21 +410,12 @@ void PvPMgr::SetLifetime2v2MMR(uint64 guid, uint16 mmr)
     if (Player* player = ObjectAccessor::FindPlayer(guid))
         player->SetLifetime2v2MMR(mmr);
 
-    CharacterDatabase.PExecute("UPDATE character_pvp_stats SET Lifetime2v2MMR = '%u' WHERE guid = '%u'", mmr, GUID_LOPART(guid));
+    SetSlotStat(guid, &PvPStats::lifetimeMMR, 0, mmr, PVP_STATS_DIRTY_LIFETIME);
 }
 
 uint16 PvPMgr::GetLifetime2v2Wins(uint64 guid) const
 {
-    if (Player* player = ObjectAccessor::FindPlayer(guid))
-        return player->GetLifetime2v2Wins();
-    else
-    {
-        QueryResult result = CharacterDatabase.PQuery("SELECT Lifetime2v2Wins FROM character_pvp_stats WHERE guid = '%u'", GUID_LOPART(guid));
-        if (!result)
-            return 0;
-
-        return (*result)[0].GetUInt16();
-    }
+    return GetSlotStat(guid, &PvPStats::lifetimeWins, 0);
 }
 
 void PvPMgr::SetLifetime2v2Wins(uint64 guid, uint16 wins)
@@ -196,21 +423,12 @@ void PvPMgr::SetLifetime2v2Wins(uint64 guid, uint16 wins)
     if (Player* player = ObjectAccessor::FindPlayer(guid))
         player->SetLifetime2v2Wins(wins);
 
-    CharacterDatabase.PExecute("UPDATE character_pvp_stats SET Lifetime2v2Wins = '%u' WHERE guid = '%u'", wins, GUID_LOPART(guid));
+    SetSlotStat(guid, &PvPStats::lifetimeWins, 0, wins, PVP_STATS_DIRTY_LIFETIME);
 }
 
 uint16 PvPMgr::GetLifetime2v2Games(uint64 guid) const
 {
-    if (Player* player = ObjectAccessor::FindPlayer(guid))
-        return player->GetLifetime2v2Games();
-    else
-    {
-        QueryResult result = CharacterDatabase.PQuery("SELECT Lifetime2v2Games FROM character_pvp_stats WHERE guid = '%u'", GUID_LOPART(guid));
-        if (!result)
-            return 0;
-
-        return (*result)[0].GetUInt16();
-    }
+    return GetSlotStat(guid, &PvPStats::lifetimeGames, 0);
 }
 
 void PvPMgr::SetLifetime2v2Games(uint64 guid, uint16 games)
@@ -218,21 +436,12 @@ void PvPMgr::SetLifetime2v2Games(uint64 guid, uint16 games)
     if (Player* player = ObjectAccessor::FindPlayer(guid))
         player->SetLifetime2v2Games(games);
 
-    CharacterDatabase.PExecute("UPDATE character_pvp_stats SET Lifetime2v2Games = '%u' WHERE guid = '%u'", games, GUID_LOPART(guid));
+    SetSlotStat(guid, &PvPStats::lifetimeGames, 0, games, PVP_STATS_DIRTY_LIFETIME);
 }
 
 uint16 PvPMgr::GetLifetime3v3Rating(uint64 guid) const
 {
-    if (Player* player = ObjectAccessor::FindPlayer(guid))
-        return player->GetLifetime3v3Rating();
-    else
-    {
-        QueryResult result = CharacterDatabase.PQuery("SELECT Lifetime3v3Rating FROM character_pvp_stats WHERE guid = '%u'", GUID_LOPART(guid));
-        if (!result)
-            return 0;
-
-        return (*result)[0].GetUInt16();
-    }
+    return GetSlotStat(guid, &PvPStats::lifetimeRating, 1);
 }
 
 void PvPMgr::SetLifetime3v3Rating(uint64 guid, uint16 rating)
@@ -240,21 +449,12 @@ void PvPMgr::SetLifetime3v3Rating(uint64 guid, uint16 rating)
     if (Player* player = ObjectAccessor::FindPlayer(guid))
         player->SetLifetime3v3Rating(rating);
 
-    CharacterDatabase.PExecute("UPDATE character_pvp_stats SET Lifetime3v3Rating = '%u' WHERE guid = '%u'", rating, GUID_LOPART(guid));
+    SetSlotStat(guid, &PvPStats::lifetimeRating, 1, rating, PVP_STATS_DIRTY_LIFETIME);
 }
 
 uint16 PvPMgr::GetLifetime3v3MMR(uint64 guid) const
 {
-    if (Player* player = ObjectAccessor::FindPlayer(guid))
-        return player->GetLifetime3v3MMR();
-    else
-    {
-        QueryResult result = CharacterDatabase.PQuery("SELECT Lifetime3v3MMR FROM character_pvp_stats WHERE guid = '%u'", GUID_LOPART(guid));
-        if (!result)
-            return 0;
-
-        return (*result)[0].GetUInt16();
-    }
+    return GetSlotStat(guid, &PvPStats::lifetimeMMR, 1);
 }
 
 void PvPMgr::SetLifetime3v3MMR(uint64 guid, uint16 mmr)
@@ -262,21 +462,12 @@ void PvPMgr::SetLifetime3v3MMR(uint64 guid, uint16 mmr)
     if (Player* player = ObjectAccessor::FindPlayer(guid))
         player->SetLifetime3v3MMR(mmr);
 
-    CharacterDatabase.PExecute("UPDATE character_pvp_stats SET Lifetime3v3MMR = '%u' WHERE guid = '%u'", mmr, GUID_LOPART(guid));
+    SetSlotStat(guid, &PvPStats::lifetimeMMR, 1, mmr, PVP_STATS_DIRTY_LIFETIME);
 }
 
 uint16 PvPMgr::GetLifetime3v3Wins(uint64 guid) const
 {
-    if (Player* player = ObjectAccessor::FindPlayer(guid))
-        return player->GetLifetime3v3Wins();
-    else
-    {
-        QueryResult result = CharacterDatabase.PQuery("SELECT Lifetime3v3Wins FROM character_pvp_stats WHERE guid = '%u'", GUID_LOPART(guid));
-        if (!result)
-            return 0;
-
-        return (*result)[0].GetUInt16();
-    }
+    return GetSlotStat(guid, &PvPStats::lifetimeWins, 1);
 }
 
 void PvPMgr::SetLifetime3v3Wins(uint64 guid, uint16 wins)
@@ -284,21 +475,12 @@ void PvPMgr::SetLifetime3v3Wins(uint64 guid, uint16 wins)
     if (Player* player = ObjectAccessor::FindPlayer(guid))
         player->SetLifetime3v3Wins(wins);
 
-    CharacterDatabase.PExecute("UPDATE character_pvp_stats SET Lifetime3v3Wins = '%u' WHERE guid = '%u'", wins, GUID_LOPART(guid));
+    SetSlotStat(guid, &PvPStats::lifetimeWins, 1, wins, PVP_STATS_DIRTY_LIFETIME);
 }
 
 uint16 PvPMgr::GetLifetime3v3Games(uint64 guid) const
 {
-    if (Player* player = ObjectAccessor::FindPlayer(guid))
-        return player->GetLifetime3v3Games();
-    else
-    {
-        QueryResult result = CharacterDatabase.PQuery("SELECT Lifetime3v3Games FROM character_pvp_stats WHERE guid = '%u'", GUID_LOPART(guid));
-        if (!result)
-            return 0;
-
-        return (*result)[0].GetUInt16();
-    }
+    return GetSlotStat(guid, &PvPStats::lifetimeGames, 1);
 }
 
 void PvPMgr::SetLifetime3v3Games(uint64 guid, uint16 games)
@@ -306,21 +488,12 @@ void PvPMgr::SetLifetime3v3Games(uint64 guid, uint16 games)
     if (Player* player = ObjectAccessor::FindPlayer(guid))
         player->SetLifetime3v3Games(games);
 
-    CharacterDatabase.PExecute("UPDATE character_pvp_stats SET Lifetime3v3Games = '%u' WHERE guid = '%u'", games, GUID_LOPART(guid));
+    SetSlotStat(guid, &PvPStats::lifetimeGames, 1, games, PVP_STATS_DIRTY_LIFETIME);
 }
 
 uint16 PvPMgr::GetLifetime5v5Rating(uint64 guid) const
 {
-    if (Player* player = ObjectAccessor::FindPlayer(guid))
-        return player->GetLifetime5v5Rating();
-    else
-    {
-        QueryResult result = CharacterDatabase.PQuery("SELECT Lifetime5v5Rating FROM character_pvp_stats WHERE guid = '%u'", GUID_LOPART(guid));
-        if (!result)
-            return 0;
-
-        return (*result)[0].GetUInt16();
-    }
+    return GetSlotStat(guid, &PvPStats::lifetimeRating, 2);
 }
 
 void PvPMgr::SetLifetime5v5Rating(uint64 guid, uint16 rating)
@@ -328,21 +501,12 @@ void PvPMgr::SetLifetime5v5Rating(uint64 guid, uint16 rating)
     if (Player* player = ObjectAccessor::FindPlayer(guid))
         player->SetLifetime5v5Rating(rating);
 
-    CharacterDatabase.PExecute("UPDATE character_pvp_stats SET Lifetime5v5Rating = '%u' WHERE guid = '%u'", rating, GUID_LOPART(guid));
+    SetSlotStat(guid, &PvPStats::lifetimeRating, 2, rating, PVP_STATS_DIRTY_LIFETIME);
 }
 
 uint16 PvPMgr::GetLifetime5v5MMR(uint64 guid) const
 {
-    if (Player* player = ObjectAccessor::FindPlayer(guid))
-        return player->GetLifetime5v5MMR();
-    else
-    {
-        QueryResult result = CharacterDatabase.PQuery("SELECT Lifetime5v5MMR FROM character_pvp_stats WHERE guid = '%u'", GUID_LOPART(guid));
-        if (!result)
-            return 0;
-
-        return (*result)[0].GetUInt16();
-    }
+    return GetSlotStat(guid, &PvPStats::lifetimeMMR, 2);
 }
 
 void PvPMgr::SetLifetime5v5MMR(uint64 guid, uint16 mmr)
@@ -350,21 +514,12 @@ void PvPMgr::SetLifetime5v5MMR(uint64 guid, uint16 mmr)
     if (Player* player = ObjectAccessor::FindPlayer(guid))
         player->SetLifetime5v5MMR(mmr);
 
-    CharacterDatabase.PExecute("UPDATE character_pvp_stats SET Lifetime5v5MMR = '%u' WHERE guid = '%u'", mmr, GUID_LOPART(guid));
+    SetSlotStat(guid, &PvPStats::lifetimeMMR, 2, mmr, PVP_STATS_DIRTY_LIFETIME);
 }
 
 uint16 PvPMgr::GetLifetime5v5Wins(uint64 guid) const
 {
-    if (Player* player = ObjectAccessor::FindPlayer(guid))
-        return player->GetLifetime5v5Wins();
-    else
-    {
-        QueryResult result = CharacterDatabase.PQuery("SELECT Lifetime5v5Wins FROM character_pvp_stats WHERE guid = '%u'", GUID_LOPART(guid));
-        if (!result)
-            return 0;
-
-        return (*result)[0].GetUInt16();
-    }
+    return GetSlotStat(guid, &PvPStats::lifetimeWins, 2);
 }
 
 void PvPMgr::SetLifetime5v5Wins(uint64 guid, uint16 wins)
@@ -372,21 +527,12 @@ void PvPMgr::SetLifetime5v5Wins(uint64 guid, uint16 wins)
     if (Player* player = ObjectAccessor::FindPlayer(guid))
         player->SetLifetime5v5Wins(wins);
 
-    CharacterDatabase.PExecute("UPDATE character_pvp_stats SET Lifetime5v5Wins = '%u' WHERE guid = '%u'", wins, GUID_LOPART(guid));
+    SetSlotStat(guid, &PvPStats::lifetimeWins, 2, wins, PVP_STATS_DIRTY_LIFETIME);
 }
 
 uint16 PvPMgr::GetLifetime5v5Games(uint64 guid) const
 {
-    if (Player* player = ObjectAccessor::FindPlayer(guid))
-        return player->GetLifetime5v5Games();
-    else
-    {
-        QueryResult result = CharacterDatabase.PQuery("SELECT Lifetime5v5Games FROM character_pvp_stats WHERE guid = '%u'", GUID_LOPART(guid));
-        if (!result)
-            return 0;
-
-        return (*result)[0].GetUInt16();
-    }
+    return GetSlotStat(guid, &PvPStats::lifetimeGames, 2);
 }
 
 void PvPMgr::SetLifetime5v5Games(uint64 guid, uint16 games)
@@ -394,5 +540,5 @@ void PvPMgr::SetLifetime5v5Games(uint64 guid, uint16 games)
     if (Player* player = ObjectAccessor::FindPlayer(guid))
         player->SetLifetime5v5Games(games);
 
-    CharacterDatabase.PExecute("UPDATE character_pvp_stats SET Lifetime5v5Games = '%u' WHERE guid = '%u'", games, GUID_LOPART(guid));
+    SetSlotStat(guid, &PvPStats::lifetimeGames, 2, games, PVP_STATS_DIRTY_LIFETIME);
 }
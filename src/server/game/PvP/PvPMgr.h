@@ -2,6 +2,11 @@
 #define PVP_MGR_H_
 
 #include <ace/Singleton.h>
+#include <ace/RW_Thread_Mutex.h>
+
+#include "Common.h"
+#include "UnorderedMap.h"
+#include "ArenaTeam.h"
 
 class Player;
 
@@ -37,6 +42,33 @@ enum PvPTitle
     TITLE_H_HIGH_WARLORD         = 28,
 };
 
+enum PvPStatsDirtyFlags
+{
+    PVP_STATS_DIRTY_POINTS       = 0x01,                    // weeklyArenaPoints, arenaPointsCap
+    PVP_STATS_DIRTY_MMR          = 0x02,                    // shifted by the arena slot
+    PVP_STATS_DIRTY_LIFETIME     = 0x10,
+};
+
+/// Arena stats of a character, online or not, indexed by arena slot
+struct PvPStats
+{
+    PvPStats();
+
+    uint32 weeklyArenaPoints;
+    uint32 arenaPointsCap;
+    uint16 matchMakerRating[MAX_ARENA_SLOT];
+    uint16 lifetimeRating[MAX_ARENA_SLOT];
+    uint16 lifetimeMMR[MAX_ARENA_SLOT];
+    uint16 lifetimeWins[MAX_ARENA_SLOT];
+    uint16 lifetimeGames[MAX_ARENA_SLOT];
+    uint8 dirty;                                            // PvPStatsDirtyFlags not saved yet
+};
+
+/*
+    The stats of all characters are loaded at startup and read from memory only, the
+    setters update the online player too. Changes are written back by SaveToDB, every
+    Arena.StatsSaveInterval and at shutdown, as one transaction of prepared statements.
+*/
 class PvPMgr
 {
     friend class ACE_Singleton<PvPMgr, ACE_Null_Mutex>;
@@ -45,7 +77,27 @@ class PvPMgr
         PvPMgr() {}
         ~PvPMgr() {}
 
+        typedef ACE_RW_Thread_Mutex LockType;
+        typedef UNORDERED_MAP<uint32, PvPStats> PvPStatsMap;
+        typedef uint16 (PvPStats::*SlotStats)[MAX_ARENA_SLOT];
+
     public:
+        void LoadFromDB();
+        /// Queues the changed stats as one transaction. Returns the number of characters saved.
+        uint32 SaveToDB();
+
+        /// Called at login, the stats of the cache replace what the player loaded as they may not be saved yet
+        void LoadPlayerStats(Player* player);
+        void DeletePlayerStats(uint64 guid);
+        /// Weekly reset of arena points and caps for everyone, online players are left to the caller
+        void ResetWeeklyArenaPoints();
+
+        uint32 GetStatsCount() const;
+
+        /// Sets the arena points and cap of up to count characters to what they are, like the weekly
+        /// distribution, then queues their save like the periodic one. Returns the number of characters, times in ms.
+        uint32 BenchmarkArenaPointsFlush(uint32 count, uint32& setTime, uint32& saveTime);
+
         uint32 CalculateArenaPointsCap(uint64 guid);
 
         uint32 GetWeeklyArenaPoints(uint64 guid) const;
@@ -86,6 +138,18 @@ class PvPMgr
         void SetLifetime5v5Wins(uint64 guid, uint16 wins);
         uint16 GetLifetime5v5Games(uint64 guid) const;
         void SetLifetime5v5Games(uint64 guid, uint16 games);
+
+    private:
+        PvPStats const* FindStats(uint64 guid) const;
+        PvPStats& GetOrCreateStats(uint64 guid);
+        void MarkDirty(uint64 guid, PvPStats& stats, uint8 flags);
+
+        uint16 GetSlotStat(uint64 guid, SlotStats field, uint8 slot) const;
+        void SetSlotStat(uint64 guid, SlotStats field, uint8 slot, uint16 value, uint8 flags);
+
+        mutable LockType m_lock;                            // m_stats, m_dirtyGuids
+        PvPStatsMap m_stats;
+        std::vector<uint32> m_dirtyGuids;
 };
 
 #define sPvPMgr ACE_Singleton<PvPMgr, ACE_Null_Mutex>::instance()
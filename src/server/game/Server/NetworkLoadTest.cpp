@@ -0,0 +1,263 @@
+#include "NetworkLoadTest.h"
+
+#include <ace/SOCK_Connector.h>
+#include <ace/SOCK_Stream.h>
+#include <ace/OS_NS_sys_time.h>
+
+#include "Config.h"
+#include "Log.h"
+#include "Opcodes.h"
+#include "World.h"
+
+#include <vector>
+
+// seconds a client waits for the server before giving up
+#define NETWORK_LOAD_TEST_TIMEOUT   30
+
+NetworkLoadTest::NetworkLoadTest() : m_running(false), m_hasResult(false), m_barrier(NULL), m_handles(NULL),
+    m_nextThread(0), m_connected(0), m_finished(0)
+{
+    memset(&m_result, 0, sizeof(m_result));
+}
+
+NetworkLoadTest* NetworkLoadTest::instance()
+{
+    // never destroyed, the client threads may outlive the world
+    static NetworkLoadTest* test = new NetworkLoadTest();
+    return test;
+}
+
+bool NetworkLoadTest::Start(uint32 clients, uint32 packets, uint32 threads)
+{
+    NetworkLoadTest* test = instance();
+
+    {
+        AXIUM_GUARD(ACE_Thread_Mutex, test->m_lock);
+
+        if (test->m_running)
+            return false;
+
+        test->m_running = true;
+    }
+
+    // join the threads of the previous test, they are done by now
+    test->wait();
+
+    delete test->m_barrier;
+    delete [] test->m_handles;
+
+    std::string address = ConfigMgr::GetStringDefault("BindIP", "0.0.0.0");
+    if (address == "0.0.0.0")
+        address = "127.0.0.1";
+
+    test->m_address.set(uint16(sWorld->getIntConfig(CONFIG_PORT_WORLD)), address.c_str());
+
+    clients = std::min(clients, uint32(NETWORK_LOAD_TEST_MAX_CLIENTS));
+    threads = std::max(uint32(1), std::min(std::min(threads, clients), uint32(NETWORK_LOAD_TEST_MAX_THREADS)));
+
+    memset(&test->m_result, 0, sizeof(test->m_result));
+    test->m_result.clients = clients;
+    test->m_result.threads = threads;
+    test->m_result.packets = packets;
+
+    test->m_barrier = new ACE_Barrier(threads);
+    test->m_handles = new ACE_HANDLE[clients];
+    for (uint32 i = 0; i < clients; ++i)
+        test->m_handles[i] = ACE_INVALID_HANDLE;
+
+    test->m_nextThread = 0;
+    test->m_connected = 0;
+    test->m_finished = 0;
+
+    if (test->activate(THR_NEW_LWP | THR_JOINABLE, int(threads)) == -1)
+    {
+        sLog->outError("NetworkLoadTest: unable to start the client threads");
+
+        AXIUM_GUARD(ACE_Thread_Mutex, test->m_lock);
+        test->m_running = false;
+        return false;
+    }
+
+    sLog->outString("NetworkLoadTest: %u clients on %u threads connecting to %s:%u", clients, threads, address.c_str(), uint32(test->m_address.get_port_number()));
+    return true;
+}
+
+bool NetworkLoadTest::IsRunning()
+{
+    NetworkLoadTest* test = instance();
+
+    AXIUM_GUARD(ACE_Thread_Mutex, test->m_lock);
+    return test->m_running;
+}
+
+bool NetworkLoadTest::GetLastResult(NetworkLoadResult& result)
+{
+    NetworkLoadTest* test = instance();
+
+    AXIUM_GUARD(ACE_Thread_Mutex, test->m_lock);
+    if (!test->m_hasResult)
+        return false;
+
+    result = test->m_result;
+    return true;
+}
+
+int NetworkLoadTest::svc()
+{
+    uint32 index = uint32(++m_nextThread) - 1;
+    uint32 perThread = (m_result.clients + m_result.threads - 1) / m_result.threads;
+    uint32 first = std::min(index * perThread, m_result.clients);
+    uint32 last = std::min(first + perThread, m_result.clients);
+
+    m_barrier->wait();
+
+    if (index == 0)
+        m_phaseStart = ACE_OS::gettimeofday();
+
+    m_barrier->wait();
+
+    Connect(first, last);
+
+    m_barrier->wait();
+
+    if (index == 0)
+    {
+        ACE_Time_Value now = ACE_OS::gettimeofday();
+        m_result.connectTime = uint32((now - m_phaseStart).msec());
+        m_phaseStart = now;
+    }
+
+    m_barrier->wait();
+
+    SendPackets(first, last);
+
+    m_barrier->wait();
+
+    if (index == 0)
+    {
+        m_result.packetTime = uint32((ACE_OS::gettimeofday() - m_phaseStart).msec());
+        Report();
+    }
+
+    return 0;
+}
+
+void NetworkLoadTest::Connect(uint32 first, uint32 last)
+{
+    ACE_SOCK_Connector connector;
+
+    // connect all clients first, the server answers them meanwhile
+    for (uint32 i = first; i < last; ++i)
+    {
+        ACE_SOCK_Stream stream;
+        ACE_Time_Value timeout(NETWORK_LOAD_TEST_TIMEOUT);
+
+        if (connector.connect(stream, m_address, &timeout) == -1)
+            continue;
+
+        m_handles[i] = stream.get_handle();
+    }
+
+    for (uint32 i = first; i < last; ++i)
+    {
+        if (m_handles[i] == ACE_INVALID_HANDLE)
+            continue;
+
+        ACE_SOCK_Stream stream(m_handles[i]);
+        ACE_Time_Value timeout(NETWORK_LOAD_TEST_TIMEOUT);
+
+        // server header: size (big endian, opcode included) and opcode (little endian)
+        uint8 header[4];
+        uint8 payload[64];
+        if (stream.recv_n(header, sizeof(header), &timeout) == ssize_t(sizeof(header)))
+        {
+            size_t size = (size_t(header[0]) << 8) | header[1];
+            uint16 opcode = uint16(header[2]) | (uint16(header[3]) << 8);
+
+            if (opcode == SMSG_AUTH_CHALLENGE && size >= 2 && size - 2 <= sizeof(payload) &&
+                stream.recv_n(payload, size - 2, &timeout) == ssize_t(size - 2))
+            {
+                ++m_connected;
+                continue;
+            }
+        }
+
+        stream.close();
+        m_handles[i] = ACE_INVALID_HANDLE;
+    }
+}
+
+void NetworkLoadTest::SendPackets(uint32 first, uint32 last)
+{
+    // client header: size (big endian, opcode included) and opcode (little endian), no payload
+    std::vector<uint8> data(size_t(m_result.packets) * 6);
+    for (uint32 i = 0; i < m_result.packets; ++i)
+    {
+        uint8* header = &data[i * 6];
+        header[0] = 0;
+        header[1] = 4;
+        header[2] = uint8(CMSG_KEEP_ALIVE & 0xFF);
+        header[3] = uint8(CMSG_KEEP_ALIVE >> 8);
+        header[4] = 0;
+        header[5] = 0;
+    }
+
+    for (uint32 i = first; i < last; ++i)
+    {
+        if (m_handles[i] == ACE_INVALID_HANDLE)
+            continue;
+
+        ACE_SOCK_Stream stream(m_handles[i]);
+        ACE_Time_Value timeout(NETWORK_LOAD_TEST_TIMEOUT);
+
+        if (!data.empty() && stream.send_n(&data[0], data.size(), &timeout) != ssize_t(data.size()))
+        {
+            stream.close();
+            m_handles[i] = ACE_INVALID_HANDLE;
+            continue;
+        }
+
+        // the server closes the connection once it has read everything
+        stream.close_writer();
+    }
+
+    for (uint32 i = first; i < last; ++i)
+    {
+        if (m_handles[i] == ACE_INVALID_HANDLE)
+            continue;
+
+        ACE_SOCK_Stream stream(m_handles[i]);
+        ACE_Time_Value timeout(NETWORK_LOAD_TEST_TIMEOUT);
+
+        char buf[256];
+        ssize_t n;
+        do
+            n = stream.recv(buf, sizeof(buf), &timeout);
+        while (n > 0);
+
+        if (n == 0)
+            ++m_finished;
+
+        stream.close();
+        m_handles[i] = ACE_INVALID_HANDLE;
+    }
+}
+
+void NetworkLoadTest::Report()
+{
+    AXIUM_GUARD(ACE_Thread_Mutex, m_lock);
+
+    m_result.connected = uint32(m_connected.value());
+    m_result.finished = uint32(m_finished.value());
+    m_running = false;
+    m_hasResult = true;
+
+    sLog->outString("NetworkLoadTest: %u/%u clients connected in %u ms (%u connections/sec)",
+        m_result.connected, m_result.clients, m_result.connectTime,
+        m_result.connectTime ? uint32(uint64(m_result.connected) * 1000 / m_result.connectTime) : m_result.connected);
+
+    uint64 packets = uint64(m_result.finished) * m_result.packets;
+    sLog->outString("NetworkLoadTest: " UI64FMTD " packets from %u clients read in %u ms (" UI64FMTD " packets/sec)",
+        packets, m_result.finished, m_result.packetTime,
+        m_result.packetTime ? packets * 1000 / m_result.packetTime : packets);
+}
@@ -0,0 +1,70 @@
+#ifndef __NETWORK_LOAD_TEST_H
+#define __NETWORK_LOAD_TEST_H
+
+#include "Common.h"
+
+#include <ace/Task.h>
+#include <ace/Barrier.h>
+#include <ace/Atomic_Op.h>
+#include <ace/Thread_Mutex.h>
+#include <ace/INET_Addr.h>
+
+// limits of one test, the clients are real connections to the world port
+#define NETWORK_LOAD_TEST_MAX_CLIENTS   2000
+#define NETWORK_LOAD_TEST_MAX_THREADS   16
+
+struct NetworkLoadResult
+{
+    uint32 clients;
+    uint32 threads;
+    uint32 packets;                                         // per client
+    uint32 connected;                                       // clients that got their SMSG_AUTH_CHALLENGE
+    uint32 finished;                                        // clients whose packets were all read by the server
+    uint32 connectTime;                                     // ms
+    uint32 packetTime;                                      // ms
+};
+
+/*
+    Synthetic load on the local world port.
+
+    Fake clients connect and wait for SMSG_AUTH_CHALLENGE, which measures how fast the
+    network threads accept and open sockets (connections/sec). Each client then sends
+    its packets (CMSG_KEEP_ALIVE, allowed before authentication) and closes its side; the
+    server closes the connection once it has read them all (packets/sec). The clients
+    are spread over their own threads, the results go to the server log and .debug bench netload.
+    Only available with Debug.Benchmarks.Enable.
+*/
+class NetworkLoadTest : protected ACE_Task_Base
+{
+    public:
+        /// Starts a test unless one is running already, clients and threads are capped
+        static bool Start(uint32 clients, uint32 packets, uint32 threads);
+        static bool IsRunning();
+        static bool GetLastResult(NetworkLoadResult& result);
+
+    private:
+        NetworkLoadTest();
+
+        virtual int svc();
+
+        void Connect(uint32 first, uint32 last);
+        void SendPackets(uint32 first, uint32 last);
+        void Report();
+
+        static NetworkLoadTest* instance();
+
+        ACE_Thread_Mutex m_lock;                            // m_running, m_result
+        bool m_running;
+        bool m_hasResult;
+        NetworkLoadResult m_result;
+
+        ACE_INET_Addr m_address;
+        ACE_Barrier* m_barrier;
+        ACE_HANDLE* m_handles;
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_nextThread;
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_connected;
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_finished;
+        ACE_Time_Value m_phaseStart;
+};
+
+#endif
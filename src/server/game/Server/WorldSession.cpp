@@ -27,6 +27,7 @@
 #include "Transport.h"
 #include "WardenWin.h"
 #include "WardenMac.h"
+#include "UpdateProfiler.h"
 
 bool MapSessionFilter::Process(WorldPacket* packet)
 {
@@ -216,31 +217,41 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
         m_Socket->CloseSocket();
 
     ///- Retrieve packets from the receive queue and call the appropriate handlers
-    /// not process packets if socket already closed
-    WorldPacket* packet = NULL;
-    //! Delete packet after processing by default
-    bool deletePacket = true;
-    //! To prevent infinite loop
-    WorldPacket* firstDelayedPacket = NULL;
-    //! If _recvQueue.peek() == firstDelayedPacket it means that in this Update call, we've processed all
-    //! *properly timed* packets, and we're now at the part of the queue where we find
-    //! delayed packets that were re-enqueued due to improper timing. To prevent an infinite
-    //! loop caused by re-enqueueing the same packets over and over again, we stop updating this session
-    //! and continue updating others. The re-enqueued packets will be handled in the next Update call for this session.
-    while (m_Socket && !m_Socket->IsClosed() &&
-            !_recvQueue.empty() && _recvQueue.peek(true) != firstDelayedPacket &&
-            _recvQueue.next(packet, updater))
+    /// All packets the filter accepts are taken from the queue at once. Packets re-enqueued
+    /// while handling them (see STATUS_LOGGEDIN) go behind the batch and wait for the next
+    /// Update call, so they can't cause an infinite loop.
+    std::deque<WorldPacket*> batch;
+    _recvQueue.next_all(batch, updater);
+
+    ///- Packets sent meanwhile are written together when the batch is done
+    WorldSocket* socket = m_Socket;
+    if (socket)
+        socket->HoldOutput();
+
+    while (!batch.empty())
     {
+        WorldPacket* packet = batch.front();
+
+        /// not process packets if socket already closed, and recheck the filter as handlers may change the player state
+        if (!m_Socket || m_Socket->IsClosed() || !updater.Process(packet))
+            break;
+
+        batch.pop_front();
+
+        //! Delete packet after processing by default
+        bool deletePacket = true;
+
         if (packet->GetOpcode() >= NUM_MSG_TYPES)
         {
             sLog->outDetail("SESSION: received non-existed opcode %s (0x%.4X)", LookupOpcodeName(packet->GetOpcode()), packet->GetOpcode());
-            sScriptMgr->OnUnknownPacketReceive(m_Socket, WorldPacket(*packet));
+            sScriptMgr->OnUnknownPacketReceive(m_Socket, *packet);
         }
         else
         {
             OpcodeHandler &opHandle = opcodeTable[packet->GetOpcode()];
             try
             {
+                ProfileZone profile(ProfileOpcodeZone(packet->GetOpcode()));
                 switch (opHandle.status)
                 {
                     case STATUS_LOGGEDIN:
@@ -251,9 +262,6 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
                             //! the client to be in world yet. We will re-add the packets to the bottom of the queue and process them later.
                             if (!m_playerRecentlyLogout)
                             {
-                                //! Prevent infinite loop
-                                if (!firstDelayedPacket)
-                                    firstDelayedPacket = packet;
                                 //! Because checking a bool is faster than reallocating memory
                                 deletePacket = false;
                                 QueuePacket(packet);
@@ -264,7 +272,7 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
                         }
                         else if (_player->IsInWorld())
                         {
-                            sScriptMgr->OnPacketReceive(m_Socket, WorldPacket(*packet));
+                            sScriptMgr->OnPacketReceive(m_Socket, *packet);
                             (this->*opHandle.handler)(*packet);
                             if (sLog->IsOutDebug() && packet->rpos() < packet->wpos())
                                 LogUnprocessedTail(packet);
@@ -278,7 +286,7 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
                         else
                         {
                             // not expected _player or must checked in packet handler
-                            sScriptMgr->OnPacketReceive(m_Socket, WorldPacket(*packet));
+                            sScriptMgr->OnPacketReceive(m_Socket, *packet);
                             (this->*opHandle.handler)(*packet);
                             if (sLog->IsOutDebug() && packet->rpos() < packet->wpos())
                                 LogUnprocessedTail(packet);
@@ -291,7 +299,7 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
                             LogUnexpectedOpcode(packet, "STATUS_TRANSFER", "the player is still in world");
                         else
                         {
-                            sScriptMgr->OnPacketReceive(m_Socket, WorldPacket(*packet));
+                            sScriptMgr->OnPacketReceive(m_Socket, *packet);
                             (this->*opHandle.handler)(*packet);
                             if (sLog->IsOutDebug() && packet->rpos() < packet->wpos())
                                 LogUnprocessedTail(packet);
@@ -310,7 +318,7 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
                         if (packet->GetOpcode() == CMSG_CHAR_ENUM)
                             m_playerRecentlyLogout = false;
 
-                        sScriptMgr->OnPacketReceive(m_Socket, WorldPacket(*packet));
+                        sScriptMgr->OnPacketReceive(m_Socket, *packet);
                         (this->*opHandle.handler)(*packet);
                         if (sLog->IsOutDebug() && packet->rpos() < packet->wpos())
                             LogUnprocessedTail(packet);
@@ -343,11 +351,18 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
             delete packet;
     }
 
+    //! Packets left over are processed first next time
+    if (!batch.empty())
+        _recvQueue.add_front(batch.begin(), batch.end());
+
     if (m_Socket && !m_Socket->IsClosed() && _warden)
         _warden->Update();
 
     ProcessQueryCallbacks();
 
+    if (socket)
+        socket->ReleaseOutput();
+
     //check if we are safe to proceed with logout
     //logout procedure should happen only in World::UpdateSessions() method!!!
     if (updater.ProcessLogout())
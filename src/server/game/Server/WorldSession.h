@@ -382,6 +382,8 @@ class WorldSession
         void HandlePlayerLoginOpcode(WorldPacket& recvPacket);
         void HandleCharEnum(PreparedQueryResult result);
         void HandlePlayerLogin(LoginQueryHolder * holder);
+        /// Runs the login queries of guid count times at once, each split in parts (0: one per connection), returns ms
+        static uint32 BenchmarkLoginQueries(uint32 accountId, uint64 guid, uint32 count, uint32 parts);
         void HandleCharFactionOrRaceChange(WorldPacket& recv_data);
 
         // played time
@@ -5,6 +5,8 @@
 #include <ace/os_include/netinet/os_tcp.h>
 #include <ace/os_include/sys/os_types.h>
 #include <ace/os_include/sys/os_socket.h>
+#include <ace/os_include/sys/os_uio.h>
+#include <ace/OS_NS_sys_socket.h>
 #include <ace/OS_NS_string.h>
 #include <ace/Reactor.h>
 #include <ace/Auto_Ptr.h>
@@ -81,24 +83,36 @@ struct ClientPktHeader
 #pragma pack(pop)
 #endif
 
+// bytes a socket may have queued for output before it is closed
+#define WORLDSOCKET_MAX_OUTPUT_QUEUE    (8 * 1024 * 1024)
+// buffers gathered into one write
+#define WORLDSOCKET_MAX_IOV             64
+// full buffers read in one input event
+#define WORLDSOCKET_MAX_READS           16
+
+// movement is sent as soon as possible, even while the session holds back its output
+static bool IsMovementOpcode(uint16 opcode)
+{
+    return (opcode >= MSG_MOVE_START_FORWARD && opcode <= MSG_MOVE_KNOCK_BACK) ||
+        (opcode >= SMSG_SPLINE_SET_RUN_SPEED && opcode <= SMSG_SPLINE_MOVE_SET_WALK_MODE) ||
+        opcode == SMSG_MONSTER_MOVE_TRANSPORT;
+}
+
 WorldSocket::WorldSocket (void): WorldHandler(),
 m_LastPingTime(ACE_Time_Value::zero), m_OverSpeedPings(0), m_Session(0),
 m_RecvWPct(0), m_RecvPct(), m_Header(sizeof (ClientPktHeader)),
-m_OutBuffer(0), m_OutBufferSize(65536), m_OutActive(false),
+m_OutQueueSize(0), m_OutBufferSize(65536), m_Opened(false), m_OutActive(false),
+m_OutHeld(0), m_OutUrgent(false), m_CoalesceSize(0), m_CoalesceMovement(false),
 m_Seed(static_cast<uint32> (rand32()))
 {
     reference_counting_policy().value (ACE_Event_Handler::Reference_Counting_Policy::ENABLED);
-
-    msg_queue()->high_water_mark(8*1024*1024);
-    msg_queue()->low_water_mark(8*1024*1024);
 }
 
 WorldSocket::~WorldSocket (void)
 {
     delete m_RecvWPct;
 
-    if (m_OutBuffer)
-        m_OutBuffer->release();
+    clear_output_queue();
 
     closing_ = true;
 
@@ -135,6 +149,16 @@ const std::string& WorldSocket::GetRemoteAddress (void) const
 }
 
 int WorldSocket::SendPacket (const WorldPacket& pct)
+{
+    // Shared packets are not changed by queuing them, others are copied as the caller keeps them.
+    if (pct.IsShared())
+        return SendPacket (const_cast<WorldPacket&>(pct));
+
+    WorldPacket copy (pct);
+    return SendPacket (copy);
+}
+
+int WorldSocket::SendPacket (WorldPacket& pct)
 {
     ACE_GUARD_RETURN (LockType, Guard, m_OutBufferLock, -1);
 
@@ -161,45 +185,76 @@ int WorldSocket::SendPacket (const WorldPacket& pct)
         sWorldLog->outLog("\n");
     }
 
-    // Create a copy of the original packet; this is to avoid issues if a hook modifies it.
-    sScriptMgr->OnPacketSend(this, WorldPacket(pct));
+    // Scripts get a copy of the original packet, to avoid issues if a hook modifies it.
+    sScriptMgr->OnPacketSend(this, pct);
 
     ServerPktHeader header(pct.size()+2, pct.GetOpcode());
-    m_Crypt.EncryptSend ((uint8*)header.header, header.getHeaderLength());
 
-    if (m_OutBuffer->space() >= pct.size() + header.getHeaderLength() && msg_queue()->is_empty())
+    if (m_OutQueueSize + pct.size() + header.getHeaderLength() > WORLDSOCKET_MAX_OUTPUT_QUEUE)
     {
-        // Put the packet on the buffer.
-        if (m_OutBuffer->copy((char*) header.header, header.getHeaderLength()) == -1)
-            ACE_ASSERT (false);
-
-        if (!pct.empty())
-            if (m_OutBuffer->copy((char*) pct.contents(), pct.size()) == -1)
-                ACE_ASSERT (false);
+        sLog->outError("WorldSocket::SendPacket output queue of %s is full", GetRemoteAddress().c_str());
+        return -1;
     }
-    else
-    {
-        // Enqueue the packet.
-        ACE_Message_Block* mb;
 
-        ACE_NEW_RETURN(mb, ACE_Message_Block(pct.size() + header.getHeaderLength()), -1);
+    m_Crypt.EncryptSend ((uint8*)header.header, header.getHeaderLength());
 
-        mb->copy((char*) header.header, header.getHeaderLength());
+    // Enqueue the packet, the payload takes its contents or is shared with all other sockets it goes to.
+    OutPacket out;
+    memcpy(out.header, header.header, header.getHeaderLength());
+    out.headerSize = header.getHeaderLength();
+    out.sent = 0;
 
-        if (!pct.empty())
-            mb->copy((const char*)pct.contents(), pct.size());
+    m_OutQueueSize += pct.size() + out.headerSize;
+    out.payload = pct.empty() ? NULL : pct.AcquirePayload();
 
-        if (msg_queue()->enqueue_tail(mb, (ACE_Time_Value*)&ACE_Time_Value::zero) == -1)
-        {
-            sLog->outError("WorldSocket::SendPacket enqueue_tail failed");
-            mb->release();
-            return -1;
-        }
-    }
+    m_OutQueue.push_back(out);
+
+    // Held output still goes out on the next update once large enough, or for movement.
+    if (m_OutHeld && !m_OutUrgent)
+        m_OutUrgent = m_OutQueueSize >= m_CoalesceSize || (!m_CoalesceMovement && IsMovementOpcode(pct.GetOpcode()));
 
     return 0;
 }
 
+void WorldSocket::HoldOutput (void)
+{
+    if (!m_CoalesceSize)
+        return;
+
+    ACE_GUARD (LockType, Guard, m_OutBufferLock);
+    ++m_OutHeld;
+}
+
+void WorldSocket::ReleaseOutput (void)
+{
+    if (!m_CoalesceSize)
+        return;
+
+    ACE_GUARD (LockType, Guard, m_OutBufferLock);
+
+    if (!m_OutHeld || --m_OutHeld)
+        return;
+
+    m_OutUrgent = false;
+
+    if (closing_ || m_OutQueue.empty())
+        return;
+
+    // Let the network thread write it as soon as the socket is writable
+    // instead of waiting for its next update.
+    schedule_wakeup_output (Guard);
+}
+
+void WorldSocket::clear_output_queue (void)
+{
+    for (std::deque<OutPacket>::iterator itr = m_OutQueue.begin(); itr != m_OutQueue.end(); ++itr)
+        if (itr->payload)
+            itr->payload->RemoveReference();
+
+    m_OutQueue.clear();
+    m_OutQueueSize = 0;
+}
+
 long WorldSocket::AddReference (void)
 {
     return static_cast<long> (add_reference());
@@ -215,9 +270,11 @@ int WorldSocket::open (void *a)
     ACE_UNUSED_ARG (a);
 
     // Prevent double call to this func.
-    if (m_OutBuffer)
+    if (m_Opened)
         return -1;
 
+    m_Opened = true;
+
     // This will also prevent the socket from being Updated
     // while we are initializing it.
     m_OutActive = true;
@@ -226,9 +283,6 @@ int WorldSocket::open (void *a)
     if (sWorldSocketMgr->OnSocketOpen(this) == -1)
         return -1;
 
-    // Allocate the buffer.
-    ACE_NEW_RETURN (m_OutBuffer, ACE_Message_Block (m_OutBufferSize), -1);
-
     // Store peer address.
     ACE_INET_Addr remote_addr;
 
@@ -285,32 +339,39 @@ int WorldSocket::handle_input (ACE_HANDLE)
     if (closing_)
         return -1;
 
-    switch (handle_input_missing_data())
+    // Read until the socket is drained, but give the other sockets a turn after a while.
+    for (uint32 reads = 1; ; ++reads)
     {
-        case -1 :
+        switch (handle_input_missing_data())
         {
-            if ((errno == EWOULDBLOCK) ||
-                (errno == EAGAIN))
+            case -1 :
             {
-                return Update();                           // interesting line, isn't it ?
-            }
+                if ((errno == EWOULDBLOCK) ||
+                    (errno == EAGAIN))
+                {
+                    return Update();                       // interesting line, isn't it ?
+                }
 
-            sLog->outStaticDebug("WorldSocket::handle_input: Peer error closing connection errno = %s", ACE_OS::strerror (errno));
+                sLog->outStaticDebug("WorldSocket::handle_input: Peer error closing connection errno = %s", ACE_OS::strerror (errno));
 
-            errno = ECONNRESET;
-            return -1;
-        }
-        case 0:
-        {
-            sLog->outStaticDebug("WorldSocket::handle_input: Peer has closed connection");
+                errno = ECONNRESET;
+                return -1;
+            }
+            case 0:
+            {
+                sLog->outStaticDebug("WorldSocket::handle_input: Peer has closed connection");
 
-            errno = ECONNRESET;
-            return -1;
+                errno = ECONNRESET;
+                return -1;
+            }
+            case 1:
+                if (reads < WORLDSOCKET_MAX_READS)
+                    continue;
+
+                return 1;
+            default:
+                return Update();                           // another interesting line ;)
         }
-        case 1:
-            return 1;
-        default:
-            return Update();                               // another interesting line ;)
     }
 
     ACE_NOTREACHED(return -1);
@@ -323,104 +384,82 @@ int WorldSocket::handle_output (ACE_HANDLE)
     if (closing_)
         return -1;
 
-    size_t send_len = m_OutBuffer->length();
-
-    if (send_len == 0)
-        return handle_output_queue(Guard);
+    if (m_OutQueue.empty())
+        return cancel_wakeup_output(Guard);
 
-#ifdef MSG_NOSIGNAL
-    ssize_t n = peer().send (m_OutBuffer->rd_ptr(), send_len, MSG_NOSIGNAL);
-#else
-    ssize_t n = peer().send (m_OutBuffer->rd_ptr(), send_len);
-#endif // MSG_NOSIGNAL
+    // Gather as much of the queue as one write may take.
+    iovec iov[WORLDSOCKET_MAX_IOV];
+    int iovcnt = 0;
+    size_t send_len = 0;
 
-    if (n == 0)
-        return -1;
-    else if (n == -1)
+    for (std::deque<OutPacket>::const_iterator itr = m_OutQueue.begin(); itr != m_OutQueue.end(); ++itr)
     {
-        if (errno == EWOULDBLOCK || errno == EAGAIN)
-            return schedule_wakeup_output (Guard);
+        if (iovcnt + 2 > WORLDSOCKET_MAX_IOV || send_len >= m_OutBufferSize)
+            break;
 
-        return -1;
-    }
-    else if (n < (ssize_t)send_len) //now n > 0
-    {
-        m_OutBuffer->rd_ptr (static_cast<size_t> (n));
-
-        // move the data to the base of the buffer
-        m_OutBuffer->crunch();
-
-        return schedule_wakeup_output (Guard);
-    }
-    else //now n == send_len
-    {
-        m_OutBuffer->reset();
-
-        return handle_output_queue (Guard);
-    }
-
-    ACE_NOTREACHED (return 0);
-}
-
-int WorldSocket::handle_output_queue (GuardType& g)
-{
-    if (msg_queue()->is_empty())
-        return cancel_wakeup_output(g);
-
-    ACE_Message_Block* mblk;
+        size_t skip = itr->sent;
+        if (skip < itr->headerSize)
+        {
+            iov[iovcnt].iov_base = (char*)itr->header + skip;
+            iov[iovcnt].iov_len = itr->headerSize - skip;
+            send_len += iov[iovcnt++].iov_len;
+            skip = 0;
+        }
+        else
+            skip -= itr->headerSize;
 
-    if (msg_queue()->dequeue_head(mblk, (ACE_Time_Value*)&ACE_Time_Value::zero) == -1)
-    {
-        sLog->outError("WorldSocket::handle_output_queue dequeue_head");
-        return -1;
+        if (itr->payload && skip < itr->payload->size())
+        {
+            iov[iovcnt].iov_base = (char*)itr->payload->contents() + skip;
+            iov[iovcnt].iov_len = itr->payload->size() - skip;
+            send_len += iov[iovcnt++].iov_len;
+        }
     }
 
-    const size_t send_len = mblk->length();
-
 #ifdef MSG_NOSIGNAL
-    ssize_t n = peer().send (mblk->rd_ptr(), send_len, MSG_NOSIGNAL);
+    msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = iovcnt;
+    ssize_t n = ACE_OS::sendmsg (get_handle(), &msg, MSG_NOSIGNAL);
 #else
-    ssize_t n = peer().send (mblk->rd_ptr(), send_len);
+    ssize_t n = peer().sendv (iov, iovcnt);
 #endif // MSG_NOSIGNAL
 
     if (n == 0)
-    {
-        mblk->release();
-
         return -1;
-    }
     else if (n == -1)
     {
         if (errno == EWOULDBLOCK || errno == EAGAIN)
-        {
-            msg_queue()->enqueue_head(mblk, (ACE_Time_Value*) &ACE_Time_Value::zero);
-            return schedule_wakeup_output (g);
-        }
+            return schedule_wakeup_output (Guard);
 
-        mblk->release();
         return -1;
     }
-    else if (n < (ssize_t)send_len) //now n > 0
+
+    // Drop what has been written, remember where a partially written packet stopped.
+    m_OutQueueSize -= size_t(n);
+    size_t written = size_t(n);
+    while (written)
     {
-        mblk->rd_ptr(static_cast<size_t> (n));
+        OutPacket& out = m_OutQueue.front();
+        size_t left = out.headerSize + (out.payload ? out.payload->size() : 0) - out.sent;
 
-        if (msg_queue()->enqueue_head(mblk, (ACE_Time_Value*) &ACE_Time_Value::zero) == -1)
+        if (written < left)
         {
-            sLog->outError("WorldSocket::handle_output_queue enqueue_head");
-            mblk->release();
-            return -1;
+            out.sent += written;
+            break;
         }
 
-        return schedule_wakeup_output (g);
+        written -= left;
+        if (out.payload)
+            out.payload->RemoveReference();
+        m_OutQueue.pop_front();
     }
-    else //now n == send_len
-    {
-        mblk->release();
 
-        return msg_queue()->is_empty() ? cancel_wakeup_output(g) : ACE_Event_Handler::WRITE_MASK;
-    }
+    if (n < (ssize_t)send_len)
+        return schedule_wakeup_output (Guard);
 
-    ACE_NOTREACHED(return -1);
+    return m_OutQueue.empty() ? cancel_wakeup_output(Guard) : ACE_Event_Handler::WRITE_MASK;
 }
 
 int WorldSocket::handle_close (ACE_HANDLE h, ACE_Reactor_Mask)
@@ -456,8 +495,10 @@ int WorldSocket::Update (void)
 
     {
          ACE_GUARD_RETURN (LockType, Guard, m_OutBufferLock, 0);
-         if (m_OutBuffer->length() == 0 && msg_queue()->is_empty())
+         if (m_OutQueue.empty() || (m_OutHeld && !m_OutUrgent))
              return 0;
+
+         m_OutUrgent = false;
     }
 
     int ret;
@@ -724,11 +765,11 @@ int WorldSocket::ProcessIncoming (WorldPacket* new_pct)
                     return -1;
                 }
 
-                sScriptMgr->OnPacketReceive(this, WorldPacket(*new_pct));
+                sScriptMgr->OnPacketReceive(this, *new_pct);
                 return HandleAuthSession (*new_pct);
             case CMSG_KEEP_ALIVE:
                 sLog->outStaticDebug ("CMSG_KEEP_ALIVE, size: " UI64FMTD, uint64(new_pct->size()));
-                sScriptMgr->OnPacketReceive(this, WorldPacket(*new_pct));
+                sScriptMgr->OnPacketReceive(this, *new_pct);
                 return 0;
             default:
             {
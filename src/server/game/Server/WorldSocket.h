@@ -16,6 +16,8 @@
 #include <ace/Unbounded_Queue.h>
 #include <ace/Message_Block.h>
 
+#include <deque>
+
 #if !defined (ACE_LACKS_PRAGMA_ONCE)
 #pragma once
 #endif /* ACE_LACKS_PRAGMA_ONCE */
@@ -25,6 +27,7 @@
 
 class ACE_Message_Block;
 class WorldPacket;
+class PacketPayload;
 class WorldSession;
 
 /// Handler that can communicate over stream sockets.
@@ -38,12 +41,13 @@ typedef ACE_Svc_Handler<ACE_SOCK_STREAM, ACE_NULL_SYNCH> WorldHandler;
  * Most methods return -1 on failure.
  * The class uses reference counting.
  *
- * For output the class uses one buffer (64K usually) and
- * a queue where it stores packet if there is no place on
- * the queue. The reason this is done, is because the server
- * does really a lot of small-size writes to it, and it doesn't
- * scale well to allocate memory for every. When something is
- * written to the output buffer the socket is not immediately
+ * For output the class uses a queue of packets, each one being
+ * its encrypted header and a refcounted payload, so that a
+ * packet broadcast to many sockets is not copied for each of
+ * them (see SharedPacketScope). The queue is flushed with gather
+ * writes of up to m_OutBufferSize bytes, the server does really
+ * a lot of small-size writes and this keeps them to one system
+ * call. When something is queued the socket is not immediately
  * activated for output (again for the same reason), there
  * is 10ms celling (thats why there is Update() method).
  * This concept is similar to TCP_CORK, but TCP_CORK
@@ -88,10 +92,21 @@ class WorldSocket : public WorldHandler
         const std::string& GetRemoteAddress (void) const;
 
         /// Send A packet on the socket, this function is reentrant.
-        /// @param pct packet to send
+        /// @param pct packet to send, copied unless shared (see SharedPacketScope)
         /// @return -1 of failure
         int SendPacket (const WorldPacket& pct);
 
+        /// Same, the contents are moved to the output queue and pct is left empty.
+        int SendPacket (WorldPacket& pct);
+
+        /// Hold back output until ReleaseOutput(), so the packets sent meanwhile
+        /// go out in one write. Calls may be nested.
+        void HoldOutput (void);
+
+        /// Schedule the output held since HoldOutput() to be written by the
+        /// network thread.
+        void ReleaseOutput (void);
+
         /// Add reference to this object.
         long AddReference (void);
 
@@ -130,8 +145,8 @@ class WorldSocket : public WorldHandler
         int cancel_wakeup_output (GuardType& g);
         int schedule_wakeup_output (GuardType& g);
 
-        /// Drain the queue if its not empty.
-        int handle_output_queue (GuardType& g);
+        /// Drop all queued output.
+        void clear_output_queue (void);
 
         /// process one incoming packet.
         /// @param new_pct received packet, note that you need to delete it.
@@ -176,15 +191,42 @@ class WorldSocket : public WorldHandler
         /// Mutex for protecting output related data.
         LockType m_OutBufferLock;
 
-        /// Buffer used for writing output.
-        ACE_Message_Block* m_OutBuffer;
+        /// One queued outgoing packet.
+        struct OutPacket
+        {
+            uint8 header[5];                                // already encrypted
+            uint8 headerSize;
+            PacketPayload* payload;                         // NULL for empty packets
+            size_t sent;                                    // bytes of header and payload already written
+        };
+
+        /// Packets waiting to be written.
+        std::deque<OutPacket> m_OutQueue;
+
+        /// Bytes waiting in m_OutQueue.
+        size_t m_OutQueueSize;
 
-        /// Size of the m_OutBuffer.
+        /// Maximum number of bytes written by one gather write.
         size_t m_OutBufferSize;
 
+        /// Set once open() has been called.
+        bool m_Opened;
+
         /// True if the socket is registered with the reactor for output
         bool m_OutActive;
 
+        /// Number of HoldOutput() calls not released yet.
+        uint32 m_OutHeld;
+
+        /// Set if held output must go out on the next update anyway.
+        bool m_OutUrgent;
+
+        /// Bytes of held output after which it is written anyway, 0 disables holding.
+        size_t m_CoalesceSize;
+
+        /// If set, movement packets are held like any other.
+        bool m_CoalesceMovement;
+
         uint32 m_Seed;
 
 };
@@ -13,14 +13,43 @@
 
 #include "WorldSocket.h"
 
-class WorldSocketAcceptor : public ACE_Acceptor<WorldSocket, ACE_SOCK_Acceptor>
+#if defined(SO_REUSEPORT)
+/// Listening socket that may share its port with the listeners of the other network threads
+class WorldSocketReusePortAcceptor : public ACE_SOCK_Acceptor
 {
 public:
-    WorldSocketAcceptor(void) { }
-    virtual ~WorldSocketAcceptor(void)
+    int open(const ACE_Addr& local_sap, int reuse_addr = 0, int protocol_family = PF_UNSPEC, int backlog = ACE_DEFAULT_BACKLOG, int protocol = 0)
     {
-        if (reactor())
-            reactor()->cancel_timer(this, 1);
+        if (local_sap != ACE_Addr::sap_any)
+            protocol_family = local_sap.get_type();
+        else if (protocol_family == PF_UNSPEC)
+            protocol_family = PF_INET;
+
+        if (ACE_SOCK::open(SOCK_STREAM, protocol_family, protocol, reuse_addr) == -1)
+            return -1;
+
+        // the kernel spreads the incoming connections over all listeners of the port
+        int one = 1;
+        if (set_option(SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) == -1)
+        {
+            close();
+            return -1;
+        }
+
+        return shared_open(local_sap, protocol_family, backlog);
+    }
+};
+#endif
+
+template<class PEER_ACCEPTOR>
+class WorldSocketAcceptorBase : public ACE_Acceptor<WorldSocket, PEER_ACCEPTOR>
+{
+public:
+    WorldSocketAcceptorBase(void) { }
+    virtual ~WorldSocketAcceptorBase(void)
+    {
+        if (this->reactor())
+            this->reactor()->cancel_timer(this, 1);
     }
 
 protected:
@@ -28,8 +57,8 @@ protected:
     virtual int handle_timeout(const ACE_Time_Value& /*current_time*/, const void* /*act = 0*/)
     {
         sLog->outBasic("Resuming acceptor");
-        reactor()->cancel_timer(this, 1);
-        return reactor()->register_handler(this, ACE_Event_Handler::ACCEPT_MASK);
+        this->reactor()->cancel_timer(this, 1);
+        return this->reactor()->register_handler(this, ACE_Event_Handler::ACCEPT_MASK);
     }
 
     virtual int handle_accept_error(void)
@@ -38,13 +67,20 @@ protected:
         if (errno == ENFILE || errno == EMFILE)
         {
             sLog->outError("Out of file descriptors, suspending incoming connections for 10 seconds");
-            reactor()->remove_handler(this, ACE_Event_Handler::ACCEPT_MASK | ACE_Event_Handler::DONT_CALL);
-            reactor()->schedule_timer(this, NULL, ACE_Time_Value(10));
+            this->reactor()->remove_handler(this, ACE_Event_Handler::ACCEPT_MASK | ACE_Event_Handler::DONT_CALL);
+            this->reactor()->schedule_timer(this, NULL, ACE_Time_Value(10));
         }
 #endif
         return 0;
     }
 };
 
+class WorldSocketAcceptor : public WorldSocketAcceptorBase<ACE_SOCK_Acceptor> { };
+
+#if defined(SO_REUSEPORT)
+/// Acceptor of one network thread for NETWORK_ENGINE_SHARDED
+class WorldSocketShardAcceptor : public WorldSocketAcceptorBase<WorldSocketReusePortAcceptor> { };
+#endif
+
 #endif /* __WORLDSOCKETACCEPTOR_H_ */
 /// @}
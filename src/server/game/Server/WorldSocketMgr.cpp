@@ -194,12 +194,26 @@ WorldSocketMgr::WorldSocketMgr() :
     m_SockOutKBuff(-1),
     m_SockOutUBuff(65536),
     m_UseNoDelay(true),
-    m_Acceptor (0)
+    m_CoalesceSize(16384),
+    m_CoalesceMovement(false),
+    m_Engine(NETWORK_ENGINE_REACTOR),
+    m_Acceptor (0),
+    m_ShardAcceptors (0)
 {
 }
 
 WorldSocketMgr::~WorldSocketMgr()
 {
+#if defined(SO_REUSEPORT)
+    if (m_ShardAcceptors)
+    {
+        for (size_t i = 0; i < m_NetThreadsCount; ++i)
+            delete m_ShardAcceptors[i];
+
+        delete [] m_ShardAcceptors;
+    }
+#endif
+
     delete [] m_NetThreads;
     delete m_Acceptor;
 }
@@ -217,7 +231,26 @@ WorldSocketMgr::StartReactiveIO (ACE_UINT16 port, const char* address)
         return -1;
     }
 
-    m_NetThreadsCount = static_cast<size_t> (num_threads + 1);
+    int engine = ConfigMgr::GetIntDefault ("Network.Engine", NETWORK_ENGINE_REACTOR);
+
+    if (engine != NETWORK_ENGINE_REACTOR && engine != NETWORK_ENGINE_SHARDED)
+    {
+        sLog->outError ("Network.Engine is wrong in your config file");
+        return -1;
+    }
+
+    m_Engine = NetworkEngine (engine);
+
+#if !defined(SO_REUSEPORT)
+    if (m_Engine == NETWORK_ENGINE_SHARDED)
+    {
+        sLog->outError ("Network.Engine = 1 needs SO_REUSEPORT, which is not supported on this system. Using Network.Engine = 0.");
+        m_Engine = NETWORK_ENGINE_REACTOR;
+    }
+#endif
+
+    // the reactor engine has an extra thread for the acceptor
+    m_NetThreadsCount = static_cast<size_t> (m_Engine == NETWORK_ENGINE_SHARDED ? num_threads : num_threads + 1);
 
     m_NetThreads = new ReactorRunnable[m_NetThreadsCount];
 
@@ -234,14 +267,45 @@ WorldSocketMgr::StartReactiveIO (ACE_UINT16 port, const char* address)
         return -1;
     }
 
-    m_Acceptor = new WorldSocketAcceptor;
+    // 0 means write every packet on the next network update
+    m_CoalesceSize = ConfigMgr::GetIntDefault ("Network.CoalesceSize", 16384);
+
+    if (m_CoalesceSize < 0)
+        m_CoalesceSize = 0;
+
+    m_CoalesceMovement = ConfigMgr::GetBoolDefault ("Network.CoalesceMovement", false);
 
     ACE_INET_Addr listen_addr (port, address);
 
-    if (m_Acceptor->open(listen_addr, m_NetThreads[0].GetReactor(), ACE_NONBLOCK) == -1)
+#if defined(SO_REUSEPORT)
+    if (m_Engine == NETWORK_ENGINE_SHARDED)
     {
-        sLog->outError ("Failed to open acceptor, check if the port is free");
-        return -1;
+        m_ShardAcceptors = new WorldSocketShardAcceptor*[m_NetThreadsCount];
+
+        for (size_t i = 0; i < m_NetThreadsCount; ++i)
+            m_ShardAcceptors[i] = NULL;
+
+        for (size_t i = 0; i < m_NetThreadsCount; ++i)
+        {
+            m_ShardAcceptors[i] = new WorldSocketShardAcceptor;
+
+            if (m_ShardAcceptors[i]->open(listen_addr, m_NetThreads[i].GetReactor(), ACE_NONBLOCK) == -1)
+            {
+                sLog->outError ("Failed to open acceptor, check if the port is free");
+                return -1;
+            }
+        }
+    }
+    else
+#endif
+    {
+        m_Acceptor = new WorldSocketAcceptor;
+
+        if (m_Acceptor->open(listen_addr, m_NetThreads[0].GetReactor(), ACE_NONBLOCK) == -1)
+        {
+            sLog->outError ("Failed to open acceptor, check if the port is free");
+            return -1;
+        }
     }
 
     for (size_t i = 0; i < m_NetThreadsCount; ++i)
@@ -272,6 +336,15 @@ WorldSocketMgr::StopNetwork()
         m_Acceptor->close();
     }
 
+#if defined(SO_REUSEPORT)
+    if (m_ShardAcceptors)
+    {
+        for (size_t i = 0; i < m_NetThreadsCount; ++i)
+            if (m_ShardAcceptors[i])
+                m_ShardAcceptors[i]->close();
+    }
+#endif
+
     if (m_NetThreadsCount != 0)
     {
         for (size_t i = 0; i < m_NetThreadsCount; ++i)
@@ -325,6 +398,18 @@ WorldSocketMgr::OnSocketOpen (WorldSocket* sock)
     }
 
     sock->m_OutBufferSize = static_cast<size_t> (m_SockOutUBuff);
+    sock->m_CoalesceSize = static_cast<size_t> (m_CoalesceSize);
+    sock->m_CoalesceMovement = m_CoalesceMovement;
+
+    // the socket stays with the network thread that accepted it
+    if (m_Engine == NETWORK_ENGINE_SHARDED)
+    {
+        for (size_t i = 0; i < m_NetThreadsCount; ++i)
+            if (m_NetThreads[i].GetReactor() == sock->reactor())
+                return m_NetThreads[i].AddSocket (sock);
+
+        return -1;
+    }
 
     // we skip the Acceptor Thread
     size_t min = 1;
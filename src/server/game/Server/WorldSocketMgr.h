@@ -15,6 +15,13 @@ class WorldSocket;
 class ReactorRunnable;
 class ACE_Event_Handler;
 
+/// How connections are accepted, see Network.Engine in worldserver.conf
+enum NetworkEngine
+{
+    NETWORK_ENGINE_REACTOR  = 0,                            // one acceptor thread hands the sockets out to the others
+    NETWORK_ENGINE_SHARDED  = 1                             // every network thread accepts on its own SO_REUSEPORT listener
+};
+
 /// Manages all sockets connected to peers and network threads
 class WorldSocketMgr
 {
@@ -46,8 +53,13 @@ private:
     int m_SockOutKBuff;
     int m_SockOutUBuff;
     bool m_UseNoDelay;
+    int m_CoalesceSize;
+    bool m_CoalesceMovement;
+
+    NetworkEngine m_Engine;
 
     class WorldSocketAcceptor* m_Acceptor;
+    class WorldSocketShardAcceptor** m_ShardAcceptors;      // one per network thread, NETWORK_ENGINE_SHARDED only
 };
 
 #define sWorldSocketMgr ACE_Singleton<WorldSocketMgr, ACE_Thread_Mutex>::instance()
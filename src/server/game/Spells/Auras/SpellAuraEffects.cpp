@@ -383,6 +383,16 @@ void AuraEffect::GetTargetList(std::list<Unit*> & targetList) const
     }
 }
 
+void AuraEffect::_SetAmount(int32 amount)
+{
+    m_amount = amount;
+
+    // aggregated modifiers of the targets include the old amount
+    Aura::ApplicationMap const & targetMap = GetBase()->GetApplicationMap();
+    for (Aura::ApplicationMap::const_iterator appIter = targetMap.begin(); appIter != targetMap.end(); ++appIter)
+        appIter->second->GetTarget()->_UpdateAuraModifierCache(GetAuraType());
+}
+
 void AuraEffect::GetApplicationList(std::list<AuraApplication*> & applicationList) const
 {
     Aura::ApplicationMap const & targetMap = GetBase()->GetApplicationMap();
@@ -930,7 +940,7 @@ void AuraEffect::ChangeAmount(int32 newAmount, bool mark, bool onStackOrReapply)
     if (handleMask & AURA_EFFECT_HANDLE_CHANGE_AMOUNT)
     {
         if (!mark)
-            m_amount = newAmount;
+            _SetAmount(newAmount);
         else
             SetAmount(newAmount);
         CalculateSpellMod();
@@ -35,7 +35,7 @@ class AuraEffect
         int32 GetMiscValue() const { return m_spellInfo->Effects[m_effIndex].MiscValue; }
         AuraType GetAuraType() const { return (AuraType)m_spellInfo->Effects[m_effIndex].ApplyAuraName; }
         int32 GetAmount() const { return m_amount; }
-        void SetAmount(int32 amount) { m_amount = amount; m_canBeRecalculated = false;}
+        void SetAmount(int32 amount) { _SetAmount(amount); m_canBeRecalculated = false;}
 
         int32 GetPeriodicTimer() const { return m_periodicTimer; }
         void SetPeriodicTimer(int32 periodicTimer) { m_periodicTimer = periodicTimer; }
@@ -94,6 +94,7 @@ class AuraEffect
         uint32 m_tickNumber;
     private:
         bool IsPeriodicTickCrit(Unit* target, Unit const* caster) const;
+        void _SetAmount(int32 amount);
 
     public:
         // aura effect apply/remove handlers
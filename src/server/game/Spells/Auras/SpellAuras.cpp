@@ -155,6 +155,15 @@ void AuraApplication::_HandleEffect(uint8 effIndex, bool apply)
     SetNeedClientUpdate();
 }
 
+void AuraApplication::SetNeedClientUpdate()
+{
+    // the slot may have changed or the mask been flushed since the flag was set
+    if (m_slot < MAX_AURAS)
+        GetTarget()->_AddVisibleAuraUpdate(m_slot);
+
+    m_needClientUpdate = true;
+}
+
 void AuraApplication::BuildUpdatePacket(ByteBuffer& data, bool remove) const
 {
     data << uint8(m_slot);
@@ -192,7 +201,7 @@ void AuraApplication::ClientUpdate(bool remove)
 {
     m_needClientUpdate = false;
 
-    WorldPacket data(SMSG_AURA_UPDATE);
+    WorldPacket data(SMSG_AURA_UPDATE, 8 + 25);
     data.append(GetTarget()->GetPackGUID());
     BuildUpdatePacket(data, remove);
 
@@ -2417,6 +2426,7 @@ UnitAura::UnitAura(SpellInfo const* spellproto, uint8 effMask, WorldObject* owne
     : Aura(spellproto, owner, caster, castItem, casterGUID)
 {
     m_AuraDRGroup = DIMINISHING_NONE;
+    m_ownerSlot = 0;
     LoadScripts();
     _InitEffects(effMask, caster, baseAmount);
     GetUnitOwner()->_AddAura(this, caster);
@@ -57,7 +57,7 @@ class AuraApplication
         void SetRemoveMode(AuraRemoveMode mode) { m_removeMode = mode; }
         AuraRemoveMode GetRemoveMode() const {return m_removeMode;}
 
-        void SetNeedClientUpdate() { m_needClientUpdate = true;}
+        void SetNeedClientUpdate();
         bool IsNeedClientUpdate() const { return m_needClientUpdate;}
         void BuildUpdatePacket(ByteBuffer& data, bool remove) const;
         void ClientUpdate(bool remove = false);
@@ -248,8 +248,13 @@ class UnitAura : public Aura
         void SetDiminishGroup(DiminishingGroup group) { m_AuraDRGroup = group; }
         DiminishingGroup GetDiminishGroup() const { return m_AuraDRGroup; }
 
+        // position in the update list of the owner, see Unit::_UpdateSpells
+        uint32 GetOwnerSlot() const { return m_ownerSlot; }
+        void SetOwnerSlot(uint32 slot) { m_ownerSlot = slot; }
+
     private:
         DiminishingGroup m_AuraDRGroup:8;               // Diminishing
+        uint32 m_ownerSlot;
 };
 
 class DynObjAura : public Aura
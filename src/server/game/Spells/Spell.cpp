@@ -2213,11 +2213,31 @@ void Spell::SearchAreaTarget(std::list<Unit*> &TagUnitMap, float radius, SpellNo
             break;
     }
 
-    Axium::SpellNotifierCreatureAndPlayer notifier(m_caster, TagUnitMap, radius, type, TargetType, pos, entry, m_spellInfo);
+    // the checks of the notifier reach the radius plus the size of the caster and the target,
+    // and at least the size of the caster plus one yard in front and in back
+    CellIndexQuery query(pos->m_positionX, pos->m_positionY, radius, TYPEMASK_UNIT);
+    query.range = std::max(radius, 1.0f) + m_caster->GetObjectSize();
     if ((m_spellInfo->AttributesEx3 & SPELL_ATTR3_ONLY_TARGET_PLAYERS) || (TargetType == SPELL_TARGETS_ENTRY && !entry))
-        m_caster->GetMap()->VisitWorld(pos->m_positionX, pos->m_positionY, radius, notifier);
-    else
-        m_caster->GetMap()->VisitAll(pos->m_positionX, pos->m_positionY, radius, notifier);
+        query.lists = CELL_INDEX_WORLD_OBJECT;
+
+    switch (type)
+    {
+        case PUSH_IN_FRONT:
+            query.SetCone(m_caster->GetOrientation(), static_cast<float>(M_PI/2), m_caster->GetObjectSize() + 1.0f);
+            break;
+        case PUSH_IN_BACK:
+            query.SetCone(m_caster->GetOrientation() + static_cast<float>(M_PI), static_cast<float>(M_PI/2), m_caster->GetObjectSize() + 1.0f);
+            break;
+        case PUSH_IN_LINE:
+        case PUSH_IN_THIN_LINE:
+            query.SetCone(pos->GetOrientation(), static_cast<float>(M_PI), 0.0f);
+            break;
+        default:
+            break;
+    }
+
+    Axium::SpellNotifierCreatureAndPlayer notifier(m_caster, TagUnitMap, radius, type, TargetType, pos, entry, m_spellInfo);
+    m_caster->GetMap()->VisitIndexed(query, notifier);
 }
 
 void Spell::SearchGOAreaTarget(std::list<GameObject*> &TagGOMap, float radius, SpellNotifyPushType type, SpellTargets TargetType, uint32 entry)
@@ -106,7 +106,7 @@ void GmTicket::WritePacket(WorldPacket& data) const
 
 void GmTicket::SendResponse(WorldSession* session) const
 {
-    WorldPacket data(SMSG_GMRESPONSE_RECEIVED);
+    WorldPacket data(SMSG_GMRESPONSE_RECEIVED, 4 + 4 + _message.size() + 1 + _response.size() + 1 + 3);
     data << uint32(1); // unk? Zor says "hasActiveTicket"
     data << uint32(0); // can-edit - always 1 or 0, not flags
     data << _message.c_str();
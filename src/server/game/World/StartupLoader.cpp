@@ -0,0 +1,111 @@
+#include "StartupLoader.h"
+#include "Log.h"
+#include "Timer.h"
+
+StartupLoader::StartupLoader(char const* name, uint32 threads) : m_name(name), m_threads(std::max(threads, uint32(1))),
+    m_ready(m_lock), m_done(0)
+{
+}
+
+StartupLoader::~StartupLoader()
+{
+    for (size_t i = 0; i < m_loaders.size(); ++i)
+        delete m_loaders[i].call;
+}
+
+uint32 StartupLoader::Add(char const* name, void (*load)())
+{
+    return AddLoader(name, new FunctionCall(load));
+}
+
+uint32 StartupLoader::AddLoader(char const* name, Call* call)
+{
+    Loader loader;
+    loader.name = name;
+    loader.call = call;
+    loader.waiting = 0;
+    loader.time = 0;
+
+    m_loaders.push_back(loader);
+    return uint32(m_loaders.size() - 1);
+}
+
+void StartupLoader::After(uint32 loader, uint32 dependency)
+{
+    // added in order, so there are no cycles
+    ASSERT(dependency < loader && loader < m_loaders.size());
+
+    m_loaders[dependency].dependents.push_back(loader);
+    ++m_loaders[loader].waiting;
+}
+
+void StartupLoader::Run()
+{
+    uint32 start = getMSTime();
+
+    for (uint32 i = 0; i < m_loaders.size(); ++i)
+        if (!m_loaders[i].waiting)
+            m_queue.push_back(i);
+
+    uint32 threads = std::min(m_threads, uint32(m_loaders.size()));
+    if (threads <= 1 || activate(THR_NEW_LWP | THR_JOINABLE, int(threads)) == -1)
+        Work();                                             // one after another in this thread
+    else
+        wait();
+
+    uint32 total = 0;
+    for (uint32 i = 0; i < m_loaders.size(); ++i)
+    {
+        sLog->outString(">> %-48s %6u ms", m_loaders[i].name.c_str(), m_loaders[i].time);
+        total += m_loaders[i].time;
+    }
+
+    sLog->outString(">> %s: %u loaders in %u ms on %u threads (%u ms one after another)", m_name.c_str(), uint32(m_loaders.size()),
+        GetMSTimeDiffToNow(start), std::max(threads, uint32(1)), total);
+    sLog->outString();
+}
+
+int StartupLoader::svc()
+{
+    Work();
+    return 0;
+}
+
+void StartupLoader::Work()
+{
+    m_lock.acquire();
+
+    while (m_done < m_loaders.size())
+    {
+        if (m_queue.empty())
+        {
+            m_ready.wait();
+            continue;
+        }
+
+        uint32 index = m_queue.front();
+        m_queue.pop_front();
+
+        Loader& loader = m_loaders[index];
+
+        m_lock.release();
+
+        sLog->outString("Loading %s...", loader.name.c_str());
+
+        uint32 start = getMSTime();
+        loader.call->Load();
+        loader.time = GetMSTimeDiffToNow(start);
+
+        m_lock.acquire();
+
+        ++m_done;
+        for (size_t i = 0; i < loader.dependents.size(); ++i)
+            if (!--m_loaders[loader.dependents[i]].waiting)
+                m_queue.push_back(loader.dependents[i]);
+
+        // also wakes up the threads waiting for the end
+        m_ready.broadcast();
+    }
+
+    m_lock.release();
+}
@@ -0,0 +1,87 @@
+#ifndef __STARTUP_LOADER_H
+#define __STARTUP_LOADER_H
+
+#include "Common.h"
+
+#include <ace/Task.h>
+#include <ace/Thread_Mutex.h>
+#include <ace/Condition_Thread_Mutex.h>
+
+/*
+    Runs startup loaders on several threads. Every loader declares the loaders it needs
+    with After(), those must have been added before it. A loader starts once all of them
+    are done; the others run at the same time, each query on its own WorldDatabase
+    synch connection. Run() returns when all are done and logs the time of each one.
+*/
+class StartupLoader : protected ACE_Task_Base
+{
+    public:
+        explicit StartupLoader(char const* name, uint32 threads);
+        ~StartupLoader();
+
+        /// Returns the id to use with After()
+        uint32 Add(char const* name, void (*load)());
+
+        template <class T>
+        uint32 Add(char const* name, T* object, void (T::*load)())
+        {
+            return AddLoader(name, new MemberCall<T>(object, load));
+        }
+
+        /// loader waits for dependency, which must be added before it
+        void After(uint32 loader, uint32 dependency);
+
+        void Run();
+
+    private:
+        struct Call
+        {
+            virtual ~Call() {}
+            virtual void Load() = 0;
+        };
+
+        struct FunctionCall : public Call
+        {
+            explicit FunctionCall(void (*load)()) : _load(load) {}
+            void Load() { _load(); }
+
+            void (*_load)();
+        };
+
+        template <class T>
+        struct MemberCall : public Call
+        {
+            MemberCall(T* object, void (T::*load)()) : _object(object), _load(load) {}
+            void Load() { (_object->*_load)(); }
+
+            T* _object;
+            void (T::*_load)();
+        };
+
+        struct Loader
+        {
+            std::string name;
+            Call* call;
+            std::vector<uint32> dependents;
+            uint32 waiting;                                 // dependencies not done yet
+            uint32 time;                                    // ms
+        };
+
+        uint32 AddLoader(char const* name, Call* call);
+
+        virtual int svc();
+
+        /// Runs the ready loaders until all are done
+        void Work();
+
+        std::string m_name;
+        uint32 m_threads;
+        std::vector<Loader> m_loaders;
+
+        ACE_Thread_Mutex m_lock;                            // everything below, Loader::waiting
+        ACE_Condition_Thread_Mutex m_ready;
+        std::deque<uint32> m_queue;
+        uint32 m_done;
+};
+
+#endif
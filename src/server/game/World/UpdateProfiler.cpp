@@ -0,0 +1,363 @@
+#include "UpdateProfiler.h"
+#include "Config.h"
+#include "Log.h"
+#include "Opcodes.h"
+
+#include <ace/TSS_T.h>
+#include <ace/Atomic_Op.h>
+#include <ace/OS_NS_sys_time.h>
+#include <ace/OS_NS_unistd.h>
+
+#include <algorithm>
+
+struct ProfileZoneInfo
+{
+    char const* name;
+    int32 parent;
+};
+
+static ProfileZoneInfo const ProfileZoneInfos[MAX_PROFILE_ZONES] =
+{
+    { "World::Update",          -1                              },
+    { "Sessions",               PROFILE_ZONE_WORLD_UPDATE       },
+    { "MapManager::Update",     PROFILE_ZONE_WORLD_UPDATE       },
+    { "Maps",                   PROFILE_ZONE_MAP_MANAGER        },
+    { "Map::Update",            PROFILE_ZONE_MAPS               },
+    { "Sessions",               PROFILE_ZONE_MAP_UPDATE         },
+    { "Players",                PROFILE_ZONE_MAP_UPDATE         },
+    { "Cells",                  PROFILE_ZONE_MAP_UPDATE         },
+    { "Scripts",                PROFILE_ZONE_MAP_UPDATE         },
+    { "Relocation notifies",    PROFILE_ZONE_MAP_UPDATE         },
+    { "ObjectAccessor::Update", PROFILE_ZONE_MAP_MANAGER        },
+    { "Transports",             PROFILE_ZONE_MAP_MANAGER        },
+    { "Battlegrounds",          PROFILE_ZONE_WORLD_UPDATE       },
+    { "OutdoorPvP",             PROFILE_ZONE_WORLD_UPDATE       },
+    { "Instance saves",         PROFILE_ZONE_WORLD_UPDATE       },
+    { "CLI commands",           PROFILE_ZONE_WORLD_UPDATE       },
+    { "World scripts",          PROFILE_ZONE_WORLD_UPDATE       },
+};
+
+#define MAX_PROFILE_ZONE_ID     (PROFILE_ZONE_OPCODE_FIRST + NUM_MSG_TYPES)
+
+// log-linear histogram over microseconds: exact below 8, then 4 buckets per power of two
+#define PROFILE_LINEAR_BUCKETS  8
+#define PROFILE_BUCKETS         (PROFILE_LINEAR_BUCKETS + 29 * 4)
+
+static uint32 ProfileBucket(uint32 usec)
+{
+    if (usec < PROFILE_LINEAR_BUCKETS)
+        return usec;
+
+    uint32 msb = 3;
+    while (msb < 31 && (usec >> (msb + 1)))
+        ++msb;
+
+    return PROFILE_LINEAR_BUCKETS + (msb - 3) * 4 + ((usec >> (msb - 2)) & 3);
+}
+
+static uint32 ProfileBucketUpperBound(uint32 bucket)
+{
+    if (bucket < PROFILE_LINEAR_BUCKETS)
+        return bucket;
+
+    uint32 msb = 3 + (bucket - PROFILE_LINEAR_BUCKETS) / 4;
+    uint32 step = uint32(1) << (msb - 2);
+    return (uint32(1) << msb) + ((bucket - PROFILE_LINEAR_BUCKETS) % 4 + 1) * step - 1;
+}
+
+struct UpdateProfiler::ZoneStats
+{
+    ZoneStats() : count(0), totalUsec(0), maxUsec(0)
+    {
+        memset(buckets, 0, sizeof(buckets));
+    }
+
+    uint32 Percentile(float pct) const
+    {
+        uint64 wanted = uint64(count * pct / 100.0f);
+        uint64 seen = 0;
+        for (uint32 i = 0; i < PROFILE_BUCKETS; ++i)
+        {
+            seen += buckets[i];
+            if (seen > wanted)
+                return std::min(ProfileBucketUpperBound(i), maxUsec);
+        }
+
+        return maxUsec;
+    }
+
+    uint64 count;
+    uint64 totalUsec;
+    uint32 maxUsec;
+    uint32 buckets[PROFILE_BUCKETS];
+};
+
+struct ProfileSample
+{
+    uint32 zone;
+    uint64 cycles;
+};
+
+/// Single producer (owning thread), single consumer (world thread) sample queue
+class ProfileRing
+{
+    public:
+        enum { SIZE = 8192 };                           // power of two
+
+        ProfileRing() : m_head(0), m_tail(0), m_dropped(0)
+        {
+            sUpdateProfiler->RegisterRing(this);
+        }
+
+        ~ProfileRing()
+        {
+            sUpdateProfiler->UnregisterRing(this);
+        }
+
+        void Push(uint32 zone, uint64 cycles)
+        {
+            long head = m_head.value();
+            if (head - m_tail.value() >= SIZE)
+            {
+                ++m_dropped;
+                return;
+            }
+
+            ProfileSample& sample = m_samples[head & (SIZE - 1)];
+            sample.zone = zone;
+            sample.cycles = cycles;
+            m_head = head + 1;                          // publishes the sample
+        }
+
+    private:
+        friend class UpdateProfiler;
+
+        ProfileSample m_samples[SIZE];
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_head;
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_tail;
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_dropped;
+};
+
+typedef ACE_TSS<ProfileRing> ProfileRingTSS;
+static ProfileRingTSS profileRing;
+
+volatile bool UpdateProfiler::s_enabled = false;
+
+UpdateProfiler::UpdateProfiler() : m_zones(MAX_PROFILE_ZONE_ID, (ZoneStats*)NULL), m_dropped(0),
+    m_cyclesPerUsec(0.0), m_windowTime(0), m_dumpInterval(0), m_dumpTimer(0)
+{
+}
+
+UpdateProfiler::~UpdateProfiler()
+{
+    for (std::vector<ZoneStats*>::iterator itr = m_zones.begin(); itr != m_zones.end(); ++itr)
+        delete *itr;
+}
+
+void UpdateProfiler::LoadConfig(bool reload)
+{
+    m_dumpInterval = uint32(ConfigMgr::GetIntDefault("Profiler.DumpInterval", 0)) * IN_MILLISECONDS;
+    m_dumpFile = ConfigMgr::GetStringDefault("Profiler.DumpFile", "UpdateProfile.log");
+
+    std::string logsDir = ConfigMgr::GetStringDefault("LogsDir", "");
+    if (!logsDir.empty() && logsDir[logsDir.length() - 1] != '/' && logsDir[logsDir.length() - 1] != '\\')
+        logsDir.push_back('/');
+    m_dumpFile = logsDir + m_dumpFile;
+
+    if (!reload)
+        SetEnabled(ConfigMgr::GetBoolDefault("Profiler.Enable", false));
+}
+
+void UpdateProfiler::SetEnabled(bool enable)
+{
+    if (enable && m_cyclesPerUsec == 0.0)
+        Calibrate();
+
+    s_enabled = enable;
+}
+
+void UpdateProfiler::Calibrate()
+{
+    ACE_Time_Value start = ACE_OS::gettimeofday();
+    uint64 startCycles = ReadCycleCounter();
+
+    ACE_OS::sleep(ACE_Time_Value(0, 20 * 1000));
+
+    ACE_UINT64 elapsed;
+    (ACE_OS::gettimeofday() - start).to_usec(elapsed);
+    uint64 cycles = ReadCycleCounter() - startCycles;
+
+    m_cyclesPerUsec = elapsed ? double(cycles) / double(elapsed) : 1.0;
+    sLog->outString("UpdateProfiler: %.0f cycles per microsecond.", m_cyclesPerUsec);
+}
+
+void UpdateProfiler::Record(uint32 zone, uint64 cycles)
+{
+    profileRing->Push(zone, cycles);
+}
+
+void UpdateProfiler::RegisterRing(ProfileRing* ring)
+{
+    AXIUM_GUARD(ACE_Thread_Mutex, m_lock);
+    m_rings.push_back(ring);
+}
+
+void UpdateProfiler::UnregisterRing(ProfileRing* ring)
+{
+    AXIUM_GUARD(ACE_Thread_Mutex, m_lock);
+    m_rings.erase(std::remove(m_rings.begin(), m_rings.end(), ring), m_rings.end());
+}
+
+void UpdateProfiler::Drain(ProfileRing& ring)
+{
+    long tail = ring.m_tail.value();
+    long head = ring.m_head.value();
+
+    for (; tail != head; ++tail)
+    {
+        ProfileSample const& sample = ring.m_samples[tail & (ProfileRing::SIZE - 1)];
+        if (sample.zone >= MAX_PROFILE_ZONE_ID)
+            continue;
+
+        ZoneStats*& stats = m_zones[sample.zone];
+        if (!stats)
+            stats = new ZoneStats();
+
+        uint64 usec = uint64(sample.cycles / m_cyclesPerUsec);
+        uint32 usec32 = uint32(std::min<uint64>(usec, 0xFFFFFFFF));
+
+        ++stats->count;
+        stats->totalUsec += usec;
+        stats->maxUsec = std::max(stats->maxUsec, usec32);
+        ++stats->buckets[ProfileBucket(usec32)];
+    }
+
+    ring.m_tail = head;
+
+    if (long dropped = ring.m_dropped.value())
+    {
+        m_dropped += uint32(dropped);
+        ring.m_dropped -= dropped;
+    }
+}
+
+void UpdateProfiler::Update(uint32 diff)
+{
+    if (!s_enabled)
+        return;
+
+    {
+        AXIUM_GUARD(ACE_Thread_Mutex, m_lock);
+
+        for (std::vector<ProfileRing*>::iterator itr = m_rings.begin(); itr != m_rings.end(); ++itr)
+            Drain(**itr);
+
+        m_windowTime += diff;
+    }
+
+    if (!m_dumpInterval)
+        return;
+
+    m_dumpTimer += diff;
+    if (m_dumpTimer >= m_dumpInterval)
+    {
+        m_dumpTimer = 0;
+        Dump();
+        Reset();
+    }
+}
+
+void UpdateProfiler::Reset()
+{
+    AXIUM_GUARD(ACE_Thread_Mutex, m_lock);
+
+    for (std::vector<ZoneStats*>::iterator itr = m_zones.begin(); itr != m_zones.end(); ++itr)
+    {
+        delete *itr;
+        *itr = NULL;
+    }
+
+    m_dropped = 0;
+    m_windowTime = 0;
+}
+
+char const* UpdateProfiler::GetZoneName(uint32 zone)
+{
+    if (zone < MAX_PROFILE_ZONES)
+        return ProfileZoneInfos[zone].name;
+
+    return LookupOpcodeName(uint16(zone - PROFILE_ZONE_OPCODE_FIRST));
+}
+
+static bool ProfileReportByTotal(ProfileZoneReport const& left, ProfileZoneReport const& right)
+{
+    return left.totalMs > right.totalMs;
+}
+
+void UpdateProfiler::GetReports(std::vector<ProfileZoneReport>& reports, bool opcodes)
+{
+    AXIUM_GUARD(ACE_Thread_Mutex, m_lock);
+
+    uint32 first = opcodes ? PROFILE_ZONE_OPCODE_FIRST : 0;
+    uint32 last = opcodes ? MAX_PROFILE_ZONE_ID : MAX_PROFILE_ZONES;
+
+    for (uint32 zone = first; zone < last; ++zone)
+    {
+        ZoneStats const* stats = m_zones[zone];
+        if (!stats || !stats->count)
+            continue;
+
+        ProfileZoneReport report;
+        report.zone = zone;
+        report.name = GetZoneName(zone);
+        report.depth = 0;
+        if (!opcodes)
+            for (int32 parent = ProfileZoneInfos[zone].parent; parent >= 0; parent = ProfileZoneInfos[parent].parent)
+                ++report.depth;
+
+        report.count = stats->count;
+        report.totalMs = stats->totalUsec / 1000.0;
+        report.avgMs = report.totalMs / stats->count;
+        report.p50Ms = stats->Percentile(50.0f) / 1000.0;
+        report.p95Ms = stats->Percentile(95.0f) / 1000.0;
+        report.p99Ms = stats->Percentile(99.0f) / 1000.0;
+        report.maxMs = stats->maxUsec / 1000.0;
+        reports.push_back(report);
+    }
+
+    if (opcodes)
+        std::sort(reports.begin(), reports.end(), ProfileReportByTotal);
+}
+
+void UpdateProfiler::Dump()
+{
+    FILE* file = fopen(m_dumpFile.c_str(), "a");
+    if (!file)
+    {
+        sLog->outError("UpdateProfiler: can't open %s for writing.", m_dumpFile.c_str());
+        return;
+    }
+
+    std::vector<ProfileZoneReport> zones;
+    GetReports(zones, false);
+    std::vector<ProfileZoneReport> opcodes;
+    GetReports(opcodes, true);
+
+    time_t now = time(NULL);
+    tm* aTm = localtime(&now);
+    fprintf(file, "==== %04d-%02d-%02d %02d:%02d:%02d, %u ms window, %u samples dropped\n",
+        aTm->tm_year + 1900, aTm->tm_mon + 1, aTm->tm_mday, aTm->tm_hour, aTm->tm_min, aTm->tm_sec,
+        m_windowTime, m_dropped);
+
+    fprintf(file, "%-40s %10s %12s %9s %9s %9s %9s %9s\n", "zone", "count", "total ms", "avg", "p50", "p95", "p99", "max");
+
+    for (std::vector<ProfileZoneReport>::const_iterator itr = zones.begin(); itr != zones.end(); ++itr)
+        fprintf(file, "%*s%-*s %10u %12.2f %9.3f %9.3f %9.3f %9.3f %9.3f\n", itr->depth * 2, "", 40 - itr->depth * 2, itr->name.c_str(),
+            uint32(itr->count), itr->totalMs, itr->avgMs, itr->p50Ms, itr->p95Ms, itr->p99Ms, itr->maxMs);
+
+    for (std::vector<ProfileZoneReport>::const_iterator itr = opcodes.begin(); itr != opcodes.end(); ++itr)
+        fprintf(file, "%-40s %10u %12.2f %9.3f %9.3f %9.3f %9.3f %9.3f\n", itr->name.c_str(),
+            uint32(itr->count), itr->totalMs, itr->avgMs, itr->p50Ms, itr->p95Ms, itr->p99Ms, itr->maxMs);
+
+    fclose(file);
+}
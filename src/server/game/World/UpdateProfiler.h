@@ -0,0 +1,183 @@
+#ifndef __UPDATE_PROFILER_H
+#define __UPDATE_PROFILER_H
+
+#include "Common.h"
+#include <ace/Singleton.h>
+#include <ace/Thread_Mutex.h>
+
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <ace/OS_NS_time.h>
+#endif
+
+/// Timed zones of the world tick, listed depth first (see ProfileZoneInfos)
+enum ProfileZones
+{
+    PROFILE_ZONE_WORLD_UPDATE = 0,
+    PROFILE_ZONE_WORLD_SESSIONS,
+    PROFILE_ZONE_MAP_MANAGER,
+    PROFILE_ZONE_MAPS,
+    PROFILE_ZONE_MAP_UPDATE,
+    PROFILE_ZONE_MAP_SESSIONS,
+    PROFILE_ZONE_MAP_PLAYERS,
+    PROFILE_ZONE_MAP_CELLS,
+    PROFILE_ZONE_MAP_SCRIPTS,
+    PROFILE_ZONE_MAP_RELOCATION,
+    PROFILE_ZONE_OBJECT_ACCESSOR,
+    PROFILE_ZONE_TRANSPORTS,
+    PROFILE_ZONE_BATTLEGROUNDS,
+    PROFILE_ZONE_OUTDOOR_PVP,
+    PROFILE_ZONE_INSTANCE_SAVES,
+    PROFILE_ZONE_CLI_COMMANDS,
+    PROFILE_ZONE_WORLD_SCRIPTS,
+    MAX_PROFILE_ZONES,
+
+    // packet handlers, one zone per opcode
+    PROFILE_ZONE_OPCODE_FIRST = MAX_PROFILE_ZONES
+};
+
+inline uint32 ProfileOpcodeZone(uint16 opcode) { return PROFILE_ZONE_OPCODE_FIRST + opcode; }
+
+inline uint64 ReadCycleCounter()
+{
+#if defined(_MSC_VER)
+    return __rdtsc();
+#elif defined(__i386__) || defined(__x86_64__)
+    uint32 lo, hi;
+    __asm__ __volatile__ ("rdtsc" : "=a" (lo), "=d" (hi));
+    return (uint64(hi) << 32) | lo;
+#else
+    return uint64(ACE_OS::gethrtime());
+#endif
+}
+
+struct ProfileZoneReport
+{
+    uint32 zone;
+    std::string name;
+    uint8 depth;
+    uint64 count;
+    double totalMs;
+    double avgMs;
+    double p50Ms;
+    double p95Ms;
+    double p99Ms;
+    double maxMs;
+};
+
+class ProfileRing;
+
+/*
+    Low overhead timing of the world tick.
+
+    Timed scopes write (zone, cycles) samples into a ring buffer owned by the calling
+    thread; nothing is shared on that path. Once per world tick the world thread drains
+    all rings into per-zone histograms, which are read by .debug perf and, every
+    Profiler.DumpInterval seconds, appended to Profiler.DumpFile.
+*/
+class UpdateProfiler
+{
+    friend class ACE_Singleton<UpdateProfiler, ACE_Thread_Mutex>;
+    friend class ProfileRing;
+
+    public:
+        //! Profiler.Enable only applies at startup, .debug perf on/off switches it afterwards
+        void LoadConfig(bool reload);
+
+        static bool IsEnabled() { return s_enabled; }
+        void SetEnabled(bool enable);
+
+        // producer side, any thread
+        static void Record(uint32 zone, uint64 cycles);
+
+        // world thread, once per tick
+        void Update(uint32 diff);
+
+        void Reset();
+        void GetReports(std::vector<ProfileZoneReport>& reports, bool opcodes);
+        uint32 GetDroppedSamples() const { return m_dropped; }
+        uint32 GetWindowDuration() const { return m_windowTime; }
+        void Dump();
+
+        static char const* GetZoneName(uint32 zone);
+
+    private:
+        UpdateProfiler();
+        ~UpdateProfiler();
+
+        struct ZoneStats;
+
+        void RegisterRing(ProfileRing* ring);
+        void UnregisterRing(ProfileRing* ring);
+        void Drain(ProfileRing& ring);
+        void Calibrate();
+
+        static volatile bool s_enabled;
+
+        ACE_Thread_Mutex m_lock;                        // rings and stats
+        std::vector<ProfileRing*> m_rings;
+        std::vector<ZoneStats*> m_zones;                // allocated on first sample
+        uint32 m_dropped;
+
+        double m_cyclesPerUsec;
+        uint32 m_windowTime;
+        uint32 m_dumpInterval;
+        uint32 m_dumpTimer;
+        std::string m_dumpFile;
+};
+
+#define sUpdateProfiler ACE_Singleton<UpdateProfiler, ACE_Thread_Mutex>::instance()
+
+/// Times the enclosing scope
+class ProfileZone
+{
+    public:
+        explicit ProfileZone(uint32 zone) : _zone(zone), _start(UpdateProfiler::IsEnabled() ? ReadCycleCounter() : 0) { }
+
+        ~ProfileZone()
+        {
+            if (_start)
+                UpdateProfiler::Record(_zone, ReadCycleCounter() - _start);
+        }
+
+    private:
+        uint32 _zone;
+        uint64 _start;
+};
+
+/// Sums up several timed sections (e.g. per player in a loop) into one sample
+class ProfileCounter
+{
+    public:
+        explicit ProfileCounter(uint32 zone) : _zone(zone), _enabled(UpdateProfiler::IsEnabled()), _start(0), _total(0) { }
+
+        ~ProfileCounter()
+        {
+            if (_total)
+                UpdateProfiler::Record(_zone, _total);
+        }
+
+        void Start()
+        {
+            if (_enabled)
+                _start = ReadCycleCounter();
+        }
+
+        void Stop()
+        {
+            if (_enabled)
+                _total += ReadCycleCounter() - _start;
+        }
+
+    private:
+        uint32 _zone;
+        bool _enabled;
+        uint64 _start;
+        uint64 _total;
+};
+
+#endif
@@ -33,6 +33,7 @@
 #include "CreatureAIRegistry.h"
 #include "BattlegroundMgr.h"
 #include "OutdoorPvPMgr.h"
+#include "PvPMgr.h"
 #include "TemporarySummon.h"
 #include "WaypointMovementGenerator.h"
 #include "VMapFactory.h"
@@ -58,6 +59,10 @@
 #include "Channel.h"
 #include "WardenCheckMgr.h"
 #include "Warden.h"
+#include "UpdateProfiler.h"
+#include "StartupLoader.h"
+
+#include <ace/OS_NS_sys_stat.h>
 
 volatile bool World::m_stopEvent = false;
 uint8 World::m_ExitCode = SHUTDOWN_EXIT_CODE;
@@ -92,6 +97,7 @@ World::World()
     m_availableDbcLocaleMask = 0;
 
     m_isClosed = false;
+    m_characterDatabaseBusy = false;
 
     m_CleaningFlags = 0;
 }
@@ -569,6 +575,7 @@ void World::LoadConfigSettings(bool reload)
     m_int_configs[CONFIG_PRESERVE_CUSTOM_CHANNEL_DURATION] = ConfigMgr::GetIntDefault("PreserveCustomChannelDuration", 14);
     m_bool_configs[CONFIG_GRID_UNLOAD] = ConfigMgr::GetBoolDefault("GridUnload", true);
     m_int_configs[CONFIG_INTERVAL_SAVE] = ConfigMgr::GetIntDefault("PlayerSaveInterval", 15 * MINUTE * IN_MILLISECONDS);
+    m_int_configs[CONFIG_SAVE_QUEUE_LIMIT] = ConfigMgr::GetIntDefault("PlayerSave.QueueLimit", 200);
     m_int_configs[CONFIG_INTERVAL_DISCONNECT_TOLERANCE] = ConfigMgr::GetIntDefault("DisconnectToleranceInterval", 0);
     m_bool_configs[CONFIG_STATS_SAVE_ONLY_ON_LOGOUT] = ConfigMgr::GetBoolDefault("PlayerSave.Stats.SaveOnlyOnLogout", true);
 
@@ -1007,6 +1014,17 @@ void World::LoadConfigSettings(bool reload)
     m_bool_configs[CONFIG_ARENA_LOG_EXTENDED_INFO]                   = ConfigMgr::GetBoolDefault("ArenaLog.ExtendedInfo", false);
     m_int_configs[CONFIG_ARENA_PROGRESSIVE_MMR_TIMER]                = ConfigMgr::GetIntDefault ("Arena.ProgressiveMMRTimer", 30000);
     m_int_configs[CONFIG_ARENA_PROGRESSIVE_MMR_STEPSIZE]             = ConfigMgr::GetIntDefault ("Arena.ProgressiveMMRStepSize", 50);
+    m_int_configs[CONFIG_ARENA_STATS_SAVE_INTERVAL]                  = ConfigMgr::GetIntDefault ("Arena.StatsSaveInterval", 60);
+    if (int32(m_int_configs[CONFIG_ARENA_STATS_SAVE_INTERVAL]) <= 0)
+    {
+        sLog->outError("Arena.StatsSaveInterval (%i) must be > 0, set to default 60.", m_int_configs[CONFIG_ARENA_STATS_SAVE_INTERVAL]);
+        m_int_configs[CONFIG_ARENA_STATS_SAVE_INTERVAL] = 60;
+    }
+    if (reload)
+    {
+        m_timers[WUPDATE_PVPSTATS].SetInterval(m_int_configs[CONFIG_ARENA_STATS_SAVE_INTERVAL] * IN_MILLISECONDS);
+        m_timers[WUPDATE_PVPSTATS].Reset();
+    }
 
     m_bool_configs[CONFIG_OFFHAND_CHECK_AT_SPELL_UNLEARN]            = ConfigMgr::GetBoolDefault("OffhandCheckAtSpellUnlearn", true);
 
@@ -1072,6 +1090,11 @@ void World::LoadConfigSettings(bool reload)
     m_visibility_notify_periodInInstances = ConfigMgr::GetIntDefault("Visibility.Notify.Period.InInstances",   DEFAULT_VISIBILITY_NOTIFY_PERIOD);
     m_visibility_notify_periodInBGArenas = ConfigMgr::GetIntDefault("Visibility.Notify.Period.InBGArenas",    DEFAULT_VISIBILITY_NOTIFY_PERIOD);
 
+    m_bool_configs[CONFIG_VISIBILITY_LOD] = ConfigMgr::GetBoolDefault("Visibility.LOD.Enable", false);
+    m_float_configs[CONFIG_VISIBILITY_LOD_NEAR_DISTANCE] = ConfigMgr::GetFloatDefault("Visibility.LOD.NearDistance", 30.0f);
+    m_int_configs[CONFIG_VISIBILITY_LOD_INTERVAL] = ConfigMgr::GetIntDefault("Visibility.LOD.Interval", 1000);
+    m_int_configs[CONFIG_VISIBILITY_LOD_MAX_OBJECTS] = ConfigMgr::GetIntDefault("Visibility.LOD.MaxVisibleObjects", 0);
+
     ///- Load the CharDelete related config options
     m_int_configs[CONFIG_CHARDELETE_METHOD] = ConfigMgr::GetIntDefault("CharDelete.Method", 0);
     m_int_configs[CONFIG_CHARDELETE_MIN_LEVEL] = ConfigMgr::GetIntDefault("CharDelete.MinLevel", 0);
@@ -1093,6 +1116,16 @@ void World::LoadConfigSettings(bool reload)
         sLog->outString("Using DataDir %s", m_dataPath.c_str());
     }
 
+    // Snapshots of world tables
+    if (ConfigMgr::GetBoolDefault("WorldSnapshot.Enable", false))
+    {
+        m_snapshotPath = m_dataPath + "cache/";
+        ACE_OS::mkdir(m_snapshotPath.c_str());
+        sLog->outString("WORLD: Snapshot directory is: %s", m_snapshotPath.c_str());
+    }
+    else
+        m_snapshotPath.clear();
+
     // MMaps
     m_bool_configs[CONFIG_ENABLE_MMAPS] = ConfigMgr::GetBoolDefault("mmap.enablePathFinding", true);
     sLog->outString("WORLD: MMap data directory is: %smmaps", m_dataPath.c_str());
@@ -1134,6 +1167,19 @@ void World::LoadConfigSettings(bool reload)
     m_int_configs[CONFIG_INTERVAL_LOG_UPDATE] = ConfigMgr::GetIntDefault("RecordUpdateTimeDiffInterval", 60000);
     m_int_configs[CONFIG_MIN_LOG_UPDATE] = ConfigMgr::GetIntDefault("MinRecordUpdateTimeDiff", 100);
     m_int_configs[CONFIG_NUMTHREADS] = ConfigMgr::GetIntDefault("MapUpdate.Threads", 1);
+    m_int_configs[CONFIG_STARTUP_LOADER_THREADS] = ConfigMgr::GetIntDefault("Startup.LoaderThreads", 4);
+    m_int_configs[CONFIG_MAP_UPDATE_SCHEDULER] = ConfigMgr::GetIntDefault("MapUpdate.Scheduler", 0);
+    if (m_int_configs[CONFIG_MAP_UPDATE_SCHEDULER] >= MAX_MAP_UPDATE_SCHEDULER)
+    {
+        sLog->outError("MapUpdate.Scheduler (%u) must be 0 (queue) or 1 (work-stealing). Using 0 instead.", m_int_configs[CONFIG_MAP_UPDATE_SCHEDULER]);
+        m_int_configs[CONFIG_MAP_UPDATE_SCHEDULER] = MAP_UPDATE_SCHEDULER_QUEUE;
+    }
+    m_bool_configs[CONFIG_MAP_UPDATE_REGIONS] = ConfigMgr::GetBoolDefault("MapUpdate.Regions.Enable", false);
+    m_bool_configs[CONFIG_DEBUG_BENCHMARKS] = ConfigMgr::GetBoolDefault("Debug.Benchmarks.Enable", false);
+    m_int_configs[CONFIG_MAP_UPDATE_REGIONS_MIN_PLAYERS] = ConfigMgr::GetIntDefault("MapUpdate.Regions.MinPlayers", 50);
+
+    sUpdateProfiler->LoadConfig(reload);
+
     m_int_configs[CONFIG_MAX_RESULTS_LOOKUP_COMMANDS] = ConfigMgr::GetIntDefault("Command.LookupMaxResults", 0);
 
     // chat logging
@@ -1427,24 +1473,25 @@ void World::SetInitialWorldSettings()
     sLog->outString("Loading instances...");
     sInstanceSaveMgr->LoadInstances();
 
-    sLog->outString("Loading Localization strings...");
-    uint32 oldMSTime = getMSTime();
-    sObjectMgr->LoadCreatureLocales();
-    sObjectMgr->LoadGameObjectLocales();
-    sObjectMgr->LoadItemLocales();
-    sObjectMgr->LoadItemSetNameLocales();
-    sObjectMgr->LoadQuestLocales();
-    sObjectMgr->LoadNpcTextLocales();
-    sObjectMgr->LoadPageTextLocales();
-    sObjectMgr->LoadGossipMenuItemsLocales();
-    sObjectMgr->LoadPointOfInterestLocales();
+    uint32 loaderThreads = getIntConfig(CONFIG_STARTUP_LOADER_THREADS);
+    {
+        // every locale loader fills its own map
+        StartupLoader loader("Localization strings and texts", loaderThreads);
+        loader.Add("Creature Locales", sObjectMgr, &ObjectMgr::LoadCreatureLocales);
+        loader.Add("Gameobject Locales", sObjectMgr, &ObjectMgr::LoadGameObjectLocales);
+        loader.Add("Item Locales", sObjectMgr, &ObjectMgr::LoadItemLocales);
+        loader.Add("Item Set Name Locales", sObjectMgr, &ObjectMgr::LoadItemSetNameLocales);
+        loader.Add("Quest Locales", sObjectMgr, &ObjectMgr::LoadQuestLocales);
+        loader.Add("NPC Text Locales", sObjectMgr, &ObjectMgr::LoadNpcTextLocales);
+        loader.Add("Page Text Locales", sObjectMgr, &ObjectMgr::LoadPageTextLocales);
+        loader.Add("Gossip Menu Item Locales", sObjectMgr, &ObjectMgr::LoadGossipMenuItemsLocales);
+        loader.Add("Point Of Interest Locales", sObjectMgr, &ObjectMgr::LoadPointOfInterestLocales);
+        loader.Add("Page Texts", sObjectMgr, &ObjectMgr::LoadPageTexts);
+        loader.Add("NPC Texts", sObjectMgr, &ObjectMgr::LoadGossipText);
+        loader.Run();
+    }
 
     sObjectMgr->SetDBCLocaleIndex(GetDefaultDbcLocale());        // Get once for all the locale index of DBC language (console/broadcasts)
-    sLog->outString(">> Localization strings loaded in %u ms", GetMSTimeDiffToNow(oldMSTime));
-    sLog->outString();
-
-    sLog->outString("Loading Page Texts...");
-    sObjectMgr->LoadPageTexts();
 
     sLog->outString("Loading Game Object Templates...");         // must be after LoadPageTexts
     sObjectMgr->LoadGameObjectTemplate();
@@ -1479,9 +1526,6 @@ void World::SetInitialWorldSettings()
     sLog->outString("Loading Spell Group Stack Rules...");
     sSpellMgr->LoadSpellGroupStackRules();
 
-    sLog->outString("Loading NPC Texts...");
-    sObjectMgr->LoadGossipText();
-
     sLog->outString("Loading Enchant Spells Proc datas...");
     sSpellMgr->LoadSpellEnchantProcData();
 
@@ -1524,32 +1568,25 @@ void World::SetInitialWorldSettings()
     sLog->outString("Loading Creature Base Stats...");
     sObjectMgr->LoadCreatureClassLevelStats();
 
-    sLog->outString("Loading Creature Data...");
-    sObjectMgr->LoadCreatures();
-
-    sLog->outString("Loading pet levelup spells...");
-    sSpellMgr->LoadPetLevelupSpellMap();
-
-    sLog->outString("Loading pet default spells additional to levelup spells...");
-    sSpellMgr->LoadPetDefaultSpells();
-
-    sLog->outString("Loading Creature Addon Data...");
-    sObjectMgr->LoadCreatureAddons();                            // must be after LoadCreatureTemplates() and LoadCreatures()
-
-    sLog->outString("Loading Gameobject Data...");
-    sObjectMgr->LoadGameobjects();
-
-    sLog->outString("Loading Creature Linked Respawn...");
-    sObjectMgr->LoadLinkedRespawn();                             // must be after LoadCreatures(), LoadGameObjects()
-
-    sLog->outString("Loading Weather Data...");
-    WeatherMgr::LoadWeatherData();
-
-    sLog->outString("Loading Quests...");
-    sObjectMgr->LoadQuests();                                    // must be loaded after DBCs, creature_template, item_template, gameobject tables
-
-    sLog->outString("Checking Quest Disables");
-    DisableMgr::CheckQuestDisables();                           // must be after loading quests
+    {
+        // creatures and gameobjects share only the grid guid store, which is locked
+        StartupLoader loader("Spawns and quests", loaderThreads);
+        uint32 creatures = loader.Add("Creature Data", sObjectMgr, &ObjectMgr::LoadCreatures);
+        uint32 petLevelup = loader.Add("pet levelup spells", sSpellMgr, &SpellMgr::LoadPetLevelupSpellMap);
+        uint32 petDefault = loader.Add("pet default spells additional to levelup spells", sSpellMgr, &SpellMgr::LoadPetDefaultSpells);
+        loader.After(petDefault, petLevelup);                    // reads mPetLevelupSpellMap
+        uint32 addons = loader.Add("Creature Addon Data", sObjectMgr, &ObjectMgr::LoadCreatureAddons);
+        loader.After(addons, creatures);                         // must be after LoadCreatureTemplates() and LoadCreatures()
+        uint32 gameobjects = loader.Add("Gameobject Data", sObjectMgr, &ObjectMgr::LoadGameobjects);
+        uint32 linkedRespawn = loader.Add("Creature Linked Respawn", sObjectMgr, &ObjectMgr::LoadLinkedRespawn);
+        loader.After(linkedRespawn, creatures);                  // must be after LoadCreatures(), LoadGameObjects()
+        loader.After(linkedRespawn, gameobjects);
+        loader.Add("Weather Data", &WeatherMgr::LoadWeatherData);
+        uint32 quests = loader.Add("Quests", sObjectMgr, &ObjectMgr::LoadQuests);   // must be loaded after DBCs, creature_template, item_template, gameobject tables
+        uint32 questDisables = loader.Add("Quest Disables", &DisableMgr::CheckQuestDisables);
+        loader.After(questDisables, quests);                     // must be after loading quests
+        loader.Run();
+    }
 
     sLog->outString("Loading Quest POI");
     sObjectMgr->LoadQuestPOI();
@@ -1631,8 +1668,26 @@ void World::SetInitialWorldSettings()
     sLog->outString("Loading Player level dependent mail rewards...");
     sObjectMgr->LoadMailLevelRewards();
 
-    // Loot tables
-    LoadLootTables();
+    {
+        // every loot store is filled by its own loader, references are checked against all of them
+        StartupLoader loader("Loot tables", loaderThreads);
+        uint32 stores[11];
+        stores[0] = loader.Add("Creature Loot", &LoadLootTemplates_Creature);
+        stores[1] = loader.Add("Fishing Loot", &LoadLootTemplates_Fishing);
+        stores[2] = loader.Add("Gameobject Loot", &LoadLootTemplates_Gameobject);
+        stores[3] = loader.Add("Item Loot", &LoadLootTemplates_Item);
+        stores[4] = loader.Add("Mail Loot", &LoadLootTemplates_Mail);
+        stores[5] = loader.Add("Milling Loot", &LoadLootTemplates_Milling);
+        stores[6] = loader.Add("Pickpocketing Loot", &LoadLootTemplates_Pickpocketing);
+        stores[7] = loader.Add("Skinning Loot", &LoadLootTemplates_Skinning);
+        stores[8] = loader.Add("Disenchanting Loot", &LoadLootTemplates_Disenchant);
+        stores[9] = loader.Add("Prospecting Loot", &LoadLootTemplates_Prospecting);
+        stores[10] = loader.Add("Spell Loot", &LoadLootTemplates_Spell);
+        uint32 reference = loader.Add("Reference Loot", &LoadLootTemplates_Reference);
+        for (uint8 i = 0; i < 11; ++i)
+            loader.After(reference, stores[i]);
+        loader.Run();
+    }
 
     sLog->outString("Loading Skill Discovery Table...");
     LoadSkillDiscoveryTable();
@@ -1643,18 +1698,18 @@ void World::SetInitialWorldSettings()
     sLog->outString("Loading Skill Fishing base level requirements...");
     sObjectMgr->LoadFishingBaseSkillLevel();
 
-    sLog->outString("Loading Achievements...");
-    sAchievementMgr->LoadAchievementReferenceList();
-    sLog->outString("Loading Achievement Criteria Lists...");
-    sAchievementMgr->LoadAchievementCriteriaList();
-    sLog->outString("Loading Achievement Criteria Data...");
-    sAchievementMgr->LoadAchievementCriteriaData();
-    sLog->outString("Loading Achievement Rewards...");
-    sAchievementMgr->LoadRewards();
-    sLog->outString("Loading Achievement Reward Locales...");
-    sAchievementMgr->LoadRewardLocales();
-    sLog->outString("Loading Completed Achievements...");
-    sAchievementMgr->LoadCompletedAchievements();
+    {
+        StartupLoader loader("Achievements", loaderThreads);
+        loader.Add("Achievements", sAchievementMgr, &AchievementGlobalMgr::LoadAchievementReferenceList);
+        uint32 criteria = loader.Add("Achievement Criteria Lists", sAchievementMgr, &AchievementGlobalMgr::LoadAchievementCriteriaList);
+        uint32 criteriaData = loader.Add("Achievement Criteria Data", sAchievementMgr, &AchievementGlobalMgr::LoadAchievementCriteriaData);
+        loader.After(criteriaData, criteria);
+        uint32 rewards = loader.Add("Achievement Rewards", sAchievementMgr, &AchievementGlobalMgr::LoadRewards);
+        uint32 rewardLocales = loader.Add("Achievement Reward Locales", sAchievementMgr, &AchievementGlobalMgr::LoadRewardLocales);
+        loader.After(rewardLocales, rewards);
+        loader.Add("Completed Achievements", sAchievementMgr, &AchievementGlobalMgr::LoadCompletedAchievements);
+        loader.Run();
+    }
 
     ///- Load dynamic data tables from the database
     sGuildMgr->LoadGuilds();
@@ -1662,6 +1717,9 @@ void World::SetInitialWorldSettings()
     sLog->outString("Loading ArenaTeams...");
     sArenaTeamMgr->LoadArenaTeams();
 
+    sLog->outString("Loading Arena Stats...");
+    sPvPMgr->LoadFromDB();
+
     sLog->outString("Loading Groups...");
     sGroupMgr->LoadGroups();
 
@@ -1701,20 +1759,15 @@ void World::SetInitialWorldSettings()
     sLog->outString("Loading Conditions...");
     sConditionMgr->LoadConditions();
 
-    sLog->outString("Loading faction change achievement pairs...");
-    sObjectMgr->LoadFactionChangeAchievements();
-
-    sLog->outString("Loading faction change spell pairs...");
-    sObjectMgr->LoadFactionChangeSpells();
-
-    sLog->outString("Loading faction change item pairs...");
-    sObjectMgr->LoadFactionChangeItems();
-
-    sLog->outString("Loading faction change reputation pairs...");
-    sObjectMgr->LoadFactionChangeReputations();
-
-    sLog->outString("Loading faction change title pairs...");
-    sObjectMgr->LoadFactionChangeTitles();
+    {
+        StartupLoader loader("Faction change pairs", loaderThreads);
+        loader.Add("faction change achievement pairs", sObjectMgr, &ObjectMgr::LoadFactionChangeAchievements);
+        loader.Add("faction change spell pairs", sObjectMgr, &ObjectMgr::LoadFactionChangeSpells);
+        loader.Add("faction change item pairs", sObjectMgr, &ObjectMgr::LoadFactionChangeItems);
+        loader.Add("faction change reputation pairs", sObjectMgr, &ObjectMgr::LoadFactionChangeReputations);
+        loader.Add("faction change title pairs", sObjectMgr, &ObjectMgr::LoadFactionChangeTitles);
+        loader.Run();
+    }
 
     sLog->outString("Loading GM tickets...");
     sTicketMgr->LoadTickets();
@@ -1808,6 +1861,8 @@ void World::SetInitialWorldSettings()
 
     m_timers[WUPDATE_DELETE_EXPIRED_BANS].SetInterval(10*MINUTE*IN_MILLISECONDS); // Delete expired bans every 10 minutes
 
+    m_timers[WUPDATE_PVPSTATS].SetInterval(getIntConfig(CONFIG_ARENA_STATS_SAVE_INTERVAL)*IN_MILLISECONDS);
+
     ///- Initilize static helper structures
     AIRegistry::Initialize();
     Player::InitVisibleBits();
@@ -1978,6 +2033,10 @@ void World::Update(uint32 diff)
             m_timers[i].SetCurrent(0);
     }
 
+    ///- Hold back periodic writes while the character database is behind
+    m_characterDatabaseBusy = m_int_configs[CONFIG_SAVE_QUEUE_LIMIT] &&
+        CharacterDatabase.GetQueued(DATABASE_LANE_WRITE) >= m_int_configs[CONFIG_SAVE_QUEUE_LIMIT];
+
     ///- Update the game time and check for shutdown time
     _UpdateGameTime();
 
@@ -1995,7 +2054,10 @@ void World::Update(uint32 diff)
         ResetRandomBG();
 
     /// <li> Handle session updates when the timer has passed
-    UpdateSessions(diff);
+    {
+        ProfileZone profile(PROFILE_ZONE_WORLD_SESSIONS);
+        UpdateSessions(diff);
+    }
 
     /// <li> Handle weather updates when the timer has passed
     if (m_timers[WUPDATE_WEATHERS].Passed())
@@ -2051,9 +2113,15 @@ void World::Update(uint32 diff)
         }
     }
 
-    sBattlegroundMgr->Update(diff);
+    {
+        ProfileZone profile(PROFILE_ZONE_BATTLEGROUNDS);
+        sBattlegroundMgr->Update(diff);
+    }
 
-    sOutdoorPvPMgr->Update(diff);
+    {
+        ProfileZone profile(PROFILE_ZONE_OUTDOOR_PVP);
+        sOutdoorPvPMgr->Update(diff);
+    }
 
     ///- Delete all characters which have been deleted X days before
     if (m_timers[WUPDATE_DELETECHARS].Passed())
@@ -2105,12 +2173,26 @@ void World::Update(uint32 diff)
         CharacterDatabase.Execute(CharacterDatabase.GetPreparedStatement(CHAR_DEL_EXPIRED_BANS));
     }
 
+    ///- Write the changed arena stats back
+    if (m_timers[WUPDATE_PVPSTATS].Passed() && !m_characterDatabaseBusy)
+    {
+        m_timers[WUPDATE_PVPSTATS].Reset();
+        sPvPMgr->SaveToDB();
+    }
+
     // update the instance reset times
-    sInstanceSaveMgr->Update();
+    {
+        ProfileZone profile(PROFILE_ZONE_INSTANCE_SAVES);
+        sInstanceSaveMgr->Update();
+    }
 
     // And last, but not least handle the issued cli commands
-    ProcessCliCommands();
+    {
+        ProfileZone profile(PROFILE_ZONE_CLI_COMMANDS);
+        ProcessCliCommands();
+    }
 
+    ProfileZone profile(PROFILE_ZONE_WORLD_SCRIPTS);
     sScriptMgr->OnWorldUpdate(diff);
 }
 
@@ -2125,6 +2207,7 @@ void World::ForceGameEventUpdate()
 /// Send a packet to all players (except self if mentioned)
 void World::SendGlobalMessage(WorldPacket* packet, WorldSession* self, uint32 team)
 {
+    SharedPacketScope shared(packet);
     SessionMap::const_iterator itr;
     for (itr = m_sessions.begin(); itr != m_sessions.end(); ++itr)
     {
@@ -59,6 +59,7 @@ enum WorldTimers
     WUPDATE_PINGDB,
     WUPDATE_MAILQUEUE,
     WUPDATE_DELETE_EXPIRED_BANS,
+    WUPDATE_PVPSTATS,
     WUPDATE_COUNT
 };
 
@@ -152,6 +153,9 @@ enum WorldBoolConfigs
     CONFIG_HEALER_ONLY_BAUBLE,
     CONFIG_GLOBAL_ADJUSTMENT,
     CONFIG_DBCHATLOG_ENABLED,
+    CONFIG_MAP_UPDATE_REGIONS,
+    CONFIG_VISIBILITY_LOD,
+    CONFIG_DEBUG_BENCHMARKS,
     BOOL_CONFIG_VALUE_COUNT
 };
 
@@ -248,6 +252,7 @@ enum WorldFloatConfigs
     CONFIG_HEAL_ADJ_WARLOCK_AFFI,
     CONFIG_HEAL_ADJ_WARLOCK_DEMO,
     CONFIG_HEAL_ADJ_WARLOCK_DESTRO,
+    CONFIG_VISIBILITY_LOD_NEAR_DISTANCE,
     FLOAT_CONFIG_VALUE_COUNT
 };
 
@@ -255,6 +260,7 @@ enum WorldIntConfigs
 {
     CONFIG_COMPRESSION = 0,
     CONFIG_INTERVAL_SAVE,
+    CONFIG_SAVE_QUEUE_LIMIT,
     CONFIG_INTERVAL_GRIDCLEAN,
     CONFIG_INTERVAL_CHANGEWEATHER,
     CONFIG_INTERVAL_DISCONNECT_TOLERANCE,
@@ -360,6 +366,9 @@ enum WorldIntConfigs
     CONFIG_ENABLE_SINFO_LOGIN,
     CONFIG_PLAYER_ALLOW_COMMANDS,
     CONFIG_NUMTHREADS,
+    CONFIG_MAP_UPDATE_SCHEDULER,
+    CONFIG_MAP_UPDATE_REGIONS_MIN_PLAYERS,
+    CONFIG_STARTUP_LOADER_THREADS,
     CONFIG_LOGDB_CLEARINTERVAL,
     CONFIG_LOGDB_CLEARTIME,
     CONFIG_CLIENTCACHE_VERSION,
@@ -385,6 +394,7 @@ enum WorldIntConfigs
     CONFIG_WARDEN_NUM_OTHER_CHECKS,
     CONFIG_ARENA_PROGRESSIVE_MMR_TIMER,
     CONFIG_ARENA_PROGRESSIVE_MMR_STEPSIZE,
+    CONFIG_ARENA_STATS_SAVE_INTERVAL,
     CONFIG_MAIL_QUEUE_TIMER,
     CONFIG_STEALTH_DETECTION_VALUE,
     CONFIG_DBCHATLOG_MINGMLEVEL,
@@ -401,6 +411,8 @@ enum WorldIntConfigs
     CONFIG_REQUIRED_5V5_CHARTER_SIGNATURES,
     CONFIG_ARENA_POINTS_CAP_MINIMUM_CAP,
     CONFIG_ARENA_POINTS_CAP_REQUIRED_GAMES,
+    CONFIG_VISIBILITY_LOD_INTERVAL,
+    CONFIG_VISIBILITY_LOD_MAX_OBJECTS,
     INT_CONFIG_VALUE_COUNT
 };
 
@@ -692,6 +704,11 @@ class World
 
         /// Get the path where data (dbc, maps) are stored on disk
         std::string GetDataPath() const { return m_dataPath; }
+        /// Get the file keeping the snapshot of a world table, empty when snapshots are disabled
+        std::string GetSnapshotFile(char const* name) const { return m_snapshotPath.empty() ? m_snapshotPath : m_snapshotPath + name + ".snapshot"; }
+
+        /// Writes queued for the character database reached PlayerSave.QueueLimit, periodic saves should wait
+        bool IsCharacterDatabaseBusy() const { return m_characterDatabaseBusy; }
 
         /// When server started?
         time_t const& GetStartTime() const { return m_startTime; }
@@ -849,6 +866,7 @@ class World
         uint32 m_CleaningFlags;
 
         bool m_isClosed;
+        bool m_characterDatabaseBusy;
 
         time_t m_startTime;
         time_t m_gameTime;
@@ -881,6 +899,7 @@ class World
         bool m_allowMovement;
         std::string m_motd;
         std::string m_dataPath;
+        std::string m_snapshotPath;
 
         // for max speed access
         static float m_MaxVisibleDistanceOnContinents;
@@ -14,9 +14,186 @@ EndScriptData */
 #include "GridNotifiers.h"
 #include "GridNotifiersImpl.h"
 #include "GossipDef.h"
+#include "SpellAuraEffects.h"
+#include "UpdateProfiler.h"
+#include "NetworkLoadTest.h"
+#include "PvPMgr.h"
 
 #include <fstream>
 
+/// Benchmarks that don't touch world objects run on a thread of their own, so the
+/// world keeps updating meanwhile; they report to the server log. One runs at a time.
+class DebugBenchmarkTask : public ACE_Task_Base
+{
+    public:
+        //! False if another one is still running, the task is deleted then
+        static bool Start(DebugBenchmarkTask* task)
+        {
+            if (++_running != 1 || task->activate(THR_NEW_LWP | THR_DETACHED) == -1)
+            {
+                --_running;
+                delete task;
+                return false;
+            }
+
+            return true;
+        }
+
+        int svc()
+        {
+            Run();
+            return 0;
+        }
+
+        int close(u_long /*flags*/)
+        {
+            --_running;
+            delete this;
+            return 0;
+        }
+
+    protected:
+        virtual ~DebugBenchmarkTask() { }
+        virtual void Run() = 0;
+
+    private:
+        static ACE_Atomic_Op<ACE_Thread_Mutex, long> _running;
+};
+
+ACE_Atomic_Op<ACE_Thread_Mutex, long> DebugBenchmarkTask::_running;
+
+/// Login queries of a character, in one part and split over the asynchronous connections
+class LoginBenchmarkTask : public DebugBenchmarkTask
+{
+    public:
+        LoginBenchmarkTask(uint32 accountId, uint64 guid, std::string const& name, uint32 count)
+            : _accountId(accountId), _guid(guid), _name(name), _count(count) { }
+
+    protected:
+        void Run()
+        {
+            uint32 connections = CharacterDatabase.GetAsyncConnectionCount();
+            uint32 serial = WorldSession::BenchmarkLoginQueries(_accountId, _guid, _count, 1);
+            uint32 split = WorldSession::BenchmarkLoginQueries(_accountId, _guid, _count, 0);
+
+            sLog->outString("Login benchmark: %u logins of %s: %u ms in one part (%.2f ms each), %u ms split over %u connections (%.2f ms each)",
+                _count, _name.c_str(), serial, double(serial) / _count, split, connections, double(split) / _count);
+        }
+
+    private:
+        uint32 _accountId;
+        uint64 _guid;
+        std::string _name;
+        uint32 _count;
+};
+
+/// Reads whole world tables as text results, like the startup loaders
+class LoadBenchmarkTask : public DebugBenchmarkTask
+{
+    protected:
+        void Run()
+        {
+            static char const* tables[] = { "creature", "gameobject", "item_template" };
+
+            for (uint8 i = 0; i < 3; ++i)
+            {
+                uint64 rows = 0;
+                uint32 sum = 0;                 // read a value of every row, like a loader does
+
+                uint32 start = getMSTime();
+                if (QueryResult result = WorldDatabase.PQuery("SELECT * FROM %s", tables[i]))
+                {
+                    do
+                    {
+                        sum += result->Fetch()[0].GetUInt32();
+                        ++rows;
+                    }
+                    while (result->NextRow());
+                }
+
+                sLog->outString("Load benchmark: %s: " UI64FMTD " rows in %u ms (checksum %u)", tables[i], rows, GetMSTimeDiffToNow(start), sum);
+            }
+        }
+};
+
+class CompressBenchmarkTask : public DebugBenchmarkTask
+{
+    public:
+        CompressBenchmarkTask(ByteBuffer const& blocks, uint32 count) : _blocks(blocks), _count(count) { }
+
+    protected:
+        void Run()
+        {
+            uint32 fresh = UpdateData::BenchmarkCompression(_blocks, _count, false);
+            uint32 pooled = UpdateData::BenchmarkCompression(_blocks, _count, true);
+
+            sLog->outString("Compression benchmark: %u packets of %u bytes: new stream %u ms (%.0f/s), reused stream %u ms (%.0f/s)",
+                _count, uint32(_blocks.wpos()), fresh / 1000, fresh ? _count * 1000000.0 / fresh : 0.0, pooled / 1000, pooled ? _count * 1000000.0 / pooled : 0.0);
+        }
+
+    private:
+        ByteBuffer _blocks;
+        uint32 _count;
+};
+
+class ObjectMapBenchmarkTask : public DebugBenchmarkTask
+{
+    public:
+        ObjectMapBenchmarkTask(uint32 threads, uint32 operations) : _threads(threads), _operations(operations) { }
+
+    protected:
+        void Run()
+        {
+            uint32 single = ObjectAccessor::BenchmarkHashMapHolder(_threads, _operations, false);
+            uint32 sharded = ObjectAccessor::BenchmarkHashMapHolder(_threads, _operations, true);
+
+            sLog->outString("Object map benchmark: %u threads x %u operations: one lock %u ms (%.0f/s), %u shards %u ms (%.0f/s)", _threads, _operations,
+                single, single ? double(_threads) * _operations * 1000.0 / single : 0.0,
+                uint32(HASHMAPHOLDER_SHARDS), sharded, sharded ? double(_threads) * _operations * 1000.0 / sharded : 0.0);
+        }
+
+    private:
+        uint32 _threads;
+        uint32 _operations;
+};
+
+class LogBenchmarkTask : public DebugBenchmarkTask
+{
+    public:
+        LogBenchmarkTask(uint32 threads, uint32 lines) : _threads(threads), _lines(lines) { }
+
+    protected:
+        void Run()
+        {
+            uint32 syncPost, syncTotal;
+            if (!sLog->Benchmark(_threads, _lines, false, syncPost, syncTotal))
+            {
+                sLog->outError("Log benchmark: could not open the benchmark log file.");
+                return;
+            }
+
+            sLog->outString("Log benchmark: %u lines from %u threads written directly: %u ms", _lines * _threads, _threads, syncTotal);
+
+            if (!sLog->IsAsync())
+            {
+                sLog->outString("Log benchmark: Log.Async is disabled.");
+                return;
+            }
+
+            uint64 dropped = sLog->GetDroppedLines();
+            uint32 asyncPost, asyncTotal;
+            if (!sLog->Benchmark(_threads, _lines, true, asyncPost, asyncTotal))
+                return;
+
+            sLog->outString("Log benchmark: %u lines from %u threads buffered: %u ms to log, %u ms until written, " UI64FMTD " dropped",
+                _lines * _threads, _threads, asyncPost, asyncTotal, sLog->GetDroppedLines() - dropped);
+        }
+
+    private:
+        uint32 _threads;
+        uint32 _lines;
+};
+
 class debug_commandscript : public CommandScript
 {
 public:
@@ -47,6 +224,21 @@ public:
             { "loginfailed",    SEC_ADMINISTRATOR,  false, &HandleDebugSendLoginFailedCommand,      "", NULL },
             { NULL,             0,                  false, NULL,                                   "", NULL }
         };
+        static ChatCommand debugBenchCommandTable[] =
+        {
+            { "arenaflush",     SEC_ADMINISTRATOR,  true,  &HandleDebugBenchArenaFlushCommand,  "", NULL },
+            { "aura",           SEC_ADMINISTRATOR,  false, &HandleDebugBenchAuraCommand,        "", NULL },
+            { "cell",           SEC_ADMINISTRATOR,  true,  &HandleDebugBenchCellCommand,        "", NULL },
+            { "combat",         SEC_ADMINISTRATOR,  false, &HandleDebugBenchCombatCommand,      "", NULL },
+            { "compress",       SEC_ADMINISTRATOR,  false, &HandleDebugBenchCompressCommand,    "", NULL },
+            { "load",           SEC_ADMINISTRATOR,  true,  &HandleDebugBenchLoadCommand,        "", NULL },
+            { "log",            SEC_ADMINISTRATOR,  true,  &HandleDebugBenchLogCommand,         "", NULL },
+            { "login",          SEC_ADMINISTRATOR,  false, &HandleDebugBenchLoginCommand,       "", NULL },
+            { "netload",        SEC_ADMINISTRATOR,  true,  &HandleDebugBenchNetLoadCommand,     "", NULL },
+            { "objectmap",      SEC_ADMINISTRATOR,  true,  &HandleDebugBenchObjectMapCommand,   "", NULL },
+            { "save",           SEC_ADMINISTRATOR,  true,  &HandleDebugBenchSaveCommand,        "", NULL },
+            { NULL,             0,                  false, NULL,                                "", NULL }
+        };
         static ChatCommand debugCommandTable[] =
         {
             { "setbit",         SEC_ADMINISTRATOR,  false, &HandleDebugSet32BitCommand,         "", NULL },
@@ -62,6 +254,7 @@ public:
             { "Mod32Value",     SEC_ADMINISTRATOR,  false, &HandleDebugMod32ValueCommand,       "", NULL },
             { "play",           SEC_ADMINISTRATOR,  false, NULL,               "", debugPlayCommandTable },
             { "send",           SEC_ADMINISTRATOR,  false, NULL,               "", debugSendCommandTable },
+            { "bench",          SEC_ADMINISTRATOR,  true,  NULL,               "", debugBenchCommandTable },
             { "setaurastate",   SEC_ADMINISTRATOR,  false, &HandleDebugSetAuraStateCommand,     "", NULL },
             { "setitemvalue",   SEC_ADMINISTRATOR,  false, &HandleDebugSetItemValueCommand,     "", NULL },
             { "setvalue",       SEC_ADMINISTRATOR,  false, &HandleDebugSetValueCommand,         "", NULL },
@@ -74,6 +267,10 @@ public:
             { "areatriggers",   SEC_ADMINISTRATOR,  false, &HandleDebugAreaTriggersCommand,     "", NULL },
             { "los",            SEC_ADMINISTRATOR,  false, &HandleDebugLoSCommand,              "", NULL },
             { "visibility",     SEC_ADMINISTRATOR,  false, &HandleDebugVisibilityCommand,       "", NULL },
+            { "perf",           SEC_ADMINISTRATOR,  true,  &HandleDebugPerfCommand,             "", NULL },
+            { "dbpool",         SEC_ADMINISTRATOR,  true,  &HandleDebugDatabasePoolCommand,     "", NULL },
+            { "sqlstats",       SEC_ADMINISTRATOR,  true,  &HandleDebugSqlStatsCommand,         "", NULL },
+            { "visstats",       SEC_ADMINISTRATOR,  false, &HandleDebugVisibilityStatsCommand,  "", NULL },
             { NULL,             0,                  false, NULL,                                "", NULL }
         };
         static ChatCommand commandTable[] =
@@ -1061,6 +1258,738 @@ public:
         return true;
     }
 
+    // USAGE: .debug perf [on|off|reset|dump|opcodes [#count]]
+    static bool HandleDebugPerfCommand(ChatHandler* handler, char const* args)
+    {
+        char* mode = strtok((char*)args, " ");
+        std::string param = mode ? mode : "";
+
+        if (param == "on" || param == "off")
+        {
+            sUpdateProfiler->SetEnabled(param == "on");
+            handler->PSendSysMessage("Update profiler %s.", param == "on" ? "enabled" : "disabled");
+            return true;
+        }
+
+        if (param == "reset")
+        {
+            sUpdateProfiler->Reset();
+            handler->SendSysMessage("Update profiler statistics reset.");
+            return true;
+        }
+
+        if (param == "dump")
+        {
+            sUpdateProfiler->Dump();
+            handler->SendSysMessage("Update profiler statistics written.");
+            return true;
+        }
+
+        bool opcodes = param == "opcodes";
+        if (!opcodes && !param.empty())
+            return false;
+
+        uint32 count = 20;
+        if (opcodes)
+            if (char* countStr = strtok(NULL, " "))
+                count = uint32(atoi(countStr));
+
+        if (!UpdateProfiler::IsEnabled())
+            handler->SendSysMessage("Update profiler is disabled, use .debug perf on to start it.");
+
+        std::vector<ProfileZoneReport> reports;
+        sUpdateProfiler->GetReports(reports, opcodes);
+
+        handler->PSendSysMessage("Last %u ms, %u samples dropped (count / avg / p50 / p95 / p99 / max ms):",
+            sUpdateProfiler->GetWindowDuration(), sUpdateProfiler->GetDroppedSamples());
+
+        for (uint32 i = 0; i < reports.size() && (!opcodes || i < count); ++i)
+        {
+            ProfileZoneReport const& report = reports[i];
+            handler->PSendSysMessage("%s%s: %u / %.3f / %.3f / %.3f / %.3f / %.3f", std::string(report.depth * 2, ' ').c_str(),
+                report.name.c_str(), uint32(report.count), report.avgMs, report.p50Ms, report.p95Ms, report.p99Ms, report.maxMs);
+        }
+
+        return true;
+    }
+
+    // the .debug bench commands load the server, only allowed with Debug.Benchmarks.Enable
+    static bool CheckBenchmarksEnabled(ChatHandler* handler)
+    {
+        if (sWorld->getBoolConfig(CONFIG_DEBUG_BENCHMARKS))
+            return true;
+
+        handler->SendSysMessage("Benchmarks are disabled, see Debug.Benchmarks.Enable");
+        handler->SetSentErrorMessage(true);
+        return false;
+    }
+
+    // USAGE: .debug bench compress [#count]
+    // compresses the create blocks of the player and the selected unit count times (1000 by default),
+    // once with the per thread deflate streams and once with a new stream per packet, on a thread of its own
+    static bool HandleDebugBenchCompressCommand(ChatHandler* handler, char const* args)
+    {
+        if (!CheckBenchmarksEnabled(handler))
+            return false;
+
+        uint32 count = *args ? uint32(atoi(args)) : 1000;
+        if (!count)
+            return false;
+
+        Player* player = handler->GetSession()->GetPlayer();
+
+        UpdateData data;
+        player->BuildCreateUpdateBlockForPlayer(&data, player);
+        if (Unit* target = handler->getSelectedUnit())
+            if (target != player)
+                target->BuildCreateUpdateBlockForPlayer(&data, player);
+
+        if (!DebugBenchmarkTask::Start(new CompressBenchmarkTask(data.GetBlockData(), count)))
+        {
+            handler->SendSysMessage("A benchmark is running already");
+            handler->SetSentErrorMessage(true);
+            return false;
+        }
+
+        handler->SendSysMessage("Compression benchmark started, see the server log for the results");
+        return true;
+    }
+
+    // USAGE: .debug bench netload [#clients [#packets [#threads]]]
+    // connects fake clients to the world port and measures connections/sec and packets/sec,
+    // without arguments shows the result of the last run
+    static bool HandleDebugBenchNetLoadCommand(ChatHandler* handler, char const* args)
+    {
+        if (!CheckBenchmarksEnabled(handler))
+            return false;
+
+        if (!*args)
+        {
+            NetworkLoadResult result;
+            if (NetworkLoadTest::IsRunning())
+                handler->SendSysMessage("Network load test is running");
+            else if (!NetworkLoadTest::GetLastResult(result))
+                handler->SendSysMessage("No network load test has been run yet");
+            else
+            {
+                handler->PSendSysMessage("%u/%u clients connected in %u ms (%.0f connections/s)", result.connected, result.clients,
+                    result.connectTime, result.connectTime ? result.connected * 1000.0 / result.connectTime : 0.0);
+                handler->PSendSysMessage("%u packets from %u clients read in %u ms (%.0f packets/s)", result.finished * result.packets,
+                    result.finished, result.packetTime, result.packetTime ? double(result.finished) * result.packets * 1000.0 / result.packetTime : 0.0);
+            }
+            return true;
+        }
+
+        char* clientsStr = strtok((char*)args, " ");
+        char* packetsStr = strtok(NULL, " ");
+        char* threadsStr = strtok(NULL, " ");
+
+        uint32 clients = clientsStr ? uint32(atoi(clientsStr)) : 0;
+        uint32 packets = packetsStr ? uint32(atoi(packetsStr)) : 100;
+        uint32 threads = threadsStr ? uint32(atoi(threadsStr)) : 4;
+        if (!clients || !threads)
+            return false;
+
+        if (!NetworkLoadTest::Start(clients, packets, threads))
+        {
+            handler->SendSysMessage("Network load test is running already");
+            handler->SetSentErrorMessage(true);
+            return false;
+        }
+
+        handler->PSendSysMessage("Network load test started with %u clients, see .debug bench netload or the server log for the results",
+            std::min(clients, uint32(NETWORK_LOAD_TEST_MAX_CLIENTS)));
+        return true;
+    }
+
+    // USAGE: .debug bench objectmap [#threads [#operations]]
+    // runs Find/Insert/Remove from several threads on a map like HashMapHolder, with and without shards, started from a thread of its own
+    static bool HandleDebugBenchObjectMapCommand(ChatHandler* handler, char const* args)
+    {
+        if (!CheckBenchmarksEnabled(handler))
+            return false;
+
+        char* threadsStr = strtok((char*)args, " ");
+        char* operationsStr = strtok(NULL, " ");
+
+        uint32 threads = threadsStr ? uint32(atoi(threadsStr)) : 4;
+        uint32 operations = operationsStr ? uint32(atoi(operationsStr)) : 1000000;
+        if (!threads || !operations)
+            return false;
+
+        if (!DebugBenchmarkTask::Start(new ObjectMapBenchmarkTask(threads, operations)))
+        {
+            handler->SendSysMessage("A benchmark is running already");
+            handler->SetSentErrorMessage(true);
+            return false;
+        }
+
+        handler->SendSysMessage("Object map benchmark started, see the server log for the results");
+        return true;
+    }
+
+    template<class T>
+    static void SendDatabasePoolStats(ChatHandler* handler, DatabaseWorkerPool<T>& database, bool reset)
+    {
+        if (reset)
+        {
+            database.ResetSynchStats();
+            database.ResetQueueStats();
+            return;
+        }
+
+        DatabasePoolStats stats;
+        database.GetSynchStats(stats);
+
+        handler->PSendSysMessage("%s: %u/%u connections, %u idle, " UI64FMTD " queries, avg wait %.2f ms, max wait %.2f ms", database.GetDatabaseName(),
+            stats.connections, stats.maxConnections, stats.idle, stats.requests,
+            stats.requests ? stats.totalWait / 1000.0 / stats.requests : 0.0, stats.maxWait / 1000.0);
+
+        std::ostringstream waits;
+        waits << "  no wait " << stats.waits[0];
+        for (uint8 i = 1; i < DATABASE_WAIT_BUCKETS - 1; ++i)
+            waits << ", <" << DatabaseWaitBucketLimits[i - 1] << "ms " << stats.waits[i];
+        waits << ", more " << stats.waits[DATABASE_WAIT_BUCKETS - 1];
+        handler->SendSysMessage(waits.str().c_str());
+
+        static char const* laneNames[MAX_DATABASE_LANES] = { "login", "callback", "write" };
+
+        DatabaseLaneStats lanes[MAX_DATABASE_LANES];
+        database.GetQueueStats(lanes);
+
+        for (uint8 i = 0; i < MAX_DATABASE_LANES; ++i)
+            handler->PSendSysMessage("  %s: %u queued (max %u), " UI64FMTD " run, avg wait %.2f ms, max wait %.2f ms, avg run %.2f ms", laneNames[i],
+                lanes[i].queued, lanes[i].maxQueued, lanes[i].executed,
+                lanes[i].executed ? lanes[i].totalWait / 1000.0 / lanes[i].executed : 0.0, lanes[i].maxWait / 1000.0,
+                lanes[i].executed ? lanes[i].totalTime / 1000.0 / lanes[i].executed : 0.0);
+    }
+
+    // USAGE: .debug dbpool [reset]
+    // shows how long direct queries waited for a synchronous connection and asynchronous ones in their queue, per database
+    static bool HandleDebugDatabasePoolCommand(ChatHandler* handler, char const* args)
+    {
+        bool reset = *args && strncmp(args, "reset", strlen(args)) == 0;
+        if (*args && !reset)
+            return false;
+
+        SendDatabasePoolStats(handler, WorldDatabase, reset);
+        SendDatabasePoolStats(handler, CharacterDatabase, reset);
+        SendDatabasePoolStats(handler, LoginDatabase, reset);
+
+        if (reset)
+            handler->SendSysMessage("Database pool statistics reset");
+        return true;
+    }
+
+    // USAGE: .debug bench arenaflush [#characters]
+    // sets the arena points of that many characters (all by default) the way the weekly distribution does and queues their save
+    static bool HandleDebugBenchArenaFlushCommand(ChatHandler* handler, char const* args)
+    {
+        if (!CheckBenchmarksEnabled(handler))
+            return false;
+
+        uint32 count = *args ? uint32(atoi(args)) : sPvPMgr->GetStatsCount();
+        if (!count)
+            return false;
+
+        uint32 setTime, saveTime;
+        uint32 characters = sPvPMgr->BenchmarkArenaPointsFlush(count, setTime, saveTime);
+
+        handler->PSendSysMessage("Arena points of %u characters: set in %u ms, save built and queued in %u ms (%.0f characters/s)", characters,
+            setTime, saveTime, saveTime ? double(characters) * 1000.0 / saveTime : 0.0);
+        return true;
+    }
+
+    // USAGE: .debug bench save [#saves]
+    // Saves the online characters one after another and times building and writing the transactions
+    static bool HandleDebugBenchSaveCommand(ChatHandler* handler, char const* args)
+    {
+        if (!CheckBenchmarksEnabled(handler))
+            return false;
+
+        SessionMap const& sessions = sWorld->GetAllSessions();
+
+        std::vector<Player*> players;
+        for (SessionMap::const_iterator itr = sessions.begin(); itr != sessions.end(); ++itr)
+            if (Player* player = itr->second->GetPlayer())
+                if (player->IsInWorld())
+                    players.push_back(player);
+
+        if (players.empty())
+        {
+            handler->SendSysMessage("No characters online to save");
+            handler->SetSentErrorMessage(true);
+            return false;
+        }
+
+        uint32 count = *args ? uint32(atoi(args)) : uint32(players.size());
+        if (!count)
+            return false;
+
+        uint32 start = getMSTime();
+        for (uint32 i = 0; i < count; ++i)
+            players[i % players.size()]->SaveToDB();
+
+        uint32 buildTime = GetMSTimeDiffToNow(start);
+
+        // queued behind the transactions, done when they are written (on a single async connection)
+        QueryResultFuture done = CharacterDatabase.AsyncQuery("SELECT 1");
+        QueryResult result;
+        done.get(result);
+
+        uint32 totalTime = GetMSTimeDiffToNow(start);
+
+        handler->PSendSysMessage("%u saves of %u characters: built in %u ms, written after %u ms (%.0f saves/s)", count, uint32(players.size()),
+            buildTime, totalTime, totalTime ? double(count) * 1000.0 / totalTime : 0.0);
+        return true;
+    }
+
+    // USAGE: .debug bench load
+    // loads the creature, gameobject and item_template tables the way the startup loaders do, on a thread of its own
+    static bool HandleDebugBenchLoadCommand(ChatHandler* handler, char const* /*args*/)
+    {
+        if (!CheckBenchmarksEnabled(handler))
+            return false;
+
+        if (!DebugBenchmarkTask::Start(new LoadBenchmarkTask()))
+        {
+            handler->SendSysMessage("A benchmark is running already");
+            handler->SetSentErrorMessage(true);
+            return false;
+        }
+
+        handler->SendSysMessage("Load benchmark started, see the server log for the results");
+        return true;
+    }
+
+    typedef std::pair<uint64, StatementStats::ShapeMap::const_iterator> StatementShapeUses;
+
+    static bool CompareStatementShapeUses(StatementShapeUses const& a, StatementShapeUses const& b)
+    {
+        return a.first > b.first;
+    }
+
+    template<class T>
+    static void SendStatementStats(ChatHandler* handler, DatabaseWorkerPool<T>& database, uint32 count)
+    {
+        if (!database.IsStatementStatsEnabled())
+        {
+            handler->PSendSysMessage("%s: statement statistics are disabled, see StatementStats in the config", database.GetDatabaseName());
+            return;
+        }
+
+        StatementStats::ShapeMap adhoc;
+        std::vector<uint64> prepared;
+        database.GetStatementStats(adhoc, prepared);
+
+        uint64 preparedTotal = 0;
+        uint32 preparedUsed = 0;
+        for (size_t i = 0; i < prepared.size(); ++i)
+        {
+            preparedTotal += prepared[i];
+            if (prepared[i])
+                ++preparedUsed;
+        }
+
+        uint64 text = 0;
+        uint64 cached = 0;
+        std::vector<StatementShapeUses> shapes;
+        for (StatementStats::ShapeMap::const_iterator itr = adhoc.begin(); itr != adhoc.end(); ++itr)
+        {
+            text += itr->second.text;
+            cached += itr->second.cached;
+            shapes.push_back(StatementShapeUses(itr->second.text + itr->second.cached, itr));
+        }
+
+        std::sort(shapes.begin(), shapes.end(), CompareStatementShapeUses);
+
+        handler->PSendSysMessage("%s: " UI64FMTD " prepared (%u statements), " UI64FMTD " ad-hoc as text, " UI64FMTD " through the statement cache (%s), %u shapes",
+            database.GetDatabaseName(), preparedTotal, preparedUsed, text, cached, database.IsStatementCacheEnabled() ? "on" : "off", uint32(shapes.size()));
+
+        for (uint32 i = 0; i < count && i < shapes.size(); ++i)
+        {
+            std::string shape = shapes[i].second->first.substr(0, 200);
+            handler->PSendSysMessage("  " UI64FMTD " text, " UI64FMTD " cached: %s", shapes[i].second->second.text, shapes[i].second->second.cached, shape.c_str());
+        }
+    }
+
+    // USAGE: .debug sqlstats [#shapes|reset]
+    // lists the ad-hoc statements run most by shape (literals replaced by ?), per database, the next ones to prepare
+    static bool HandleDebugSqlStatsCommand(ChatHandler* handler, char const* args)
+    {
+        if (*args && strncmp(args, "reset", strlen(args)) == 0)
+        {
+            WorldDatabase.ResetStatementStats();
+            CharacterDatabase.ResetStatementStats();
+            LoginDatabase.ResetStatementStats();
+            handler->SendSysMessage("Statement statistics reset");
+            return true;
+        }
+
+        uint32 count = *args ? uint32(atoi(args)) : 5;
+
+        SendStatementStats(handler, WorldDatabase, count);
+        SendStatementStats(handler, CharacterDatabase, count);
+        SendStatementStats(handler, LoginDatabase, count);
+        return true;
+    }
+
+    // USAGE: .debug bench login [#logins]
+    // runs the login queries of the selected character that many times at once (100 by default), in one part and split
+    // over the connections, on a thread of its own
+    static bool HandleDebugBenchLoginCommand(ChatHandler* handler, char const* args)
+    {
+        if (!CheckBenchmarksEnabled(handler))
+            return false;
+
+        Player* player = handler->getSelectedPlayer();
+        if (!player)
+            player = handler->GetSession()->GetPlayer();
+
+        uint32 count = *args ? uint32(atoi(args)) : 100;
+        if (!count)
+            return false;
+
+        if (!DebugBenchmarkTask::Start(new LoginBenchmarkTask(player->GetSession()->GetAccountId(), player->GetGUID(), player->GetName(), count)))
+        {
+            handler->SendSysMessage("A benchmark is running already");
+            handler->SetSentErrorMessage(true);
+            return false;
+        }
+
+        handler->PSendSysMessage("Login benchmark started with %u logins of %s, see the server log for the results", count, player->GetName());
+        return true;
+    }
+
+    // USAGE: .debug bench log [#lines] [#threads]
+    // logs that many lines from each thread (10000 and 4 by default), written by the logging threads and by the log writer,
+    // started from a thread of its own
+    static bool HandleDebugBenchLogCommand(ChatHandler* handler, char const* args)
+    {
+        if (!CheckBenchmarksEnabled(handler))
+            return false;
+
+        char* linesStr = strtok((char*)args, " ");
+        char* threadsStr = strtok(NULL, " ");
+
+        uint32 lines = linesStr ? uint32(atoi(linesStr)) : 10000;
+        uint32 threads = threadsStr ? uint32(atoi(threadsStr)) : 4;
+        if (!lines || !threads)
+            return false;
+
+        if (!DebugBenchmarkTask::Start(new LogBenchmarkTask(threads, lines)))
+        {
+            handler->SendSysMessage("A benchmark is running already");
+            handler->SetSentErrorMessage(true);
+            return false;
+        }
+
+        handler->SendSysMessage("Log benchmark started, see the server log for the results");
+        return true;
+    }
+
+    // USAGE: .debug bench cell [#queries]
+    // Ranged searches of one cell by walking its creature list and by filtering its CellIndex first
+    static bool HandleDebugBenchCellCommand(ChatHandler* handler, char const* args)
+    {
+        if (!CheckBenchmarksEnabled(handler))
+            return false;
+
+        uint32 queries = *args ? uint32(atoi(args)) : 10000;
+        if (!queries)
+            return false;
+
+        uint32 const counts[] = { 50, 500, 5000 };
+        float const range = 10.0f;
+
+        for (uint8 n = 0; n < 3; ++n)
+        {
+            CreatureMapType list;
+            CellIndex index;
+            std::vector<Creature*> creatures;
+
+            for (uint32 i = 0; i < counts[n]; ++i)
+            {
+                Creature* creature = new Creature();
+                creature->_Create(i + 1, HIGHGUID_UNIT, PHASEMASK_NORMAL);
+                creature->Relocate(frand(0.0f, SIZE_OF_GRID_CELL), frand(0.0f, SIZE_OF_GRID_CELL), 0.0f);
+                creature->AddToGrid(list);
+                index.Insert(creature, false);
+                creatures.push_back(creature);
+            }
+
+            std::vector<float> x(queries), y(queries);
+            for (uint32 i = 0; i < queries; ++i)
+            {
+                x[i] = frand(0.0f, SIZE_OF_GRID_CELL);
+                y[i] = frand(0.0f, SIZE_OF_GRID_CELL);
+            }
+
+            uint64 listFound = 0;
+            uint32 start = getMSTime();
+            for (uint32 i = 0; i < queries; ++i)
+                for (CreatureMapType::iterator itr = list.begin(); itr != list.end(); ++itr)
+                    if (itr->getSource()->IsWithinDist2d(x[i], y[i], range))
+                        ++listFound;
+            uint32 listTime = GetMSTimeDiffToNow(start);
+
+            uint64 indexFound = 0;
+            std::vector<WorldObject*> candidates;
+            start = getMSTime();
+            for (uint32 i = 0; i < queries; ++i)
+            {
+                candidates.clear();
+                index.Query(CellIndexQuery(x[i], y[i], range, TYPEMASK_UNIT), candidates);
+                for (std::vector<WorldObject*>::const_iterator itr = candidates.begin(); itr != candidates.end(); ++itr)
+                    if ((*itr)->IsWithinDist2d(x[i], y[i], range))
+                        ++indexFound;
+            }
+            uint32 indexTime = GetMSTimeDiffToNow(start);
+
+            handler->PSendSysMessage("%u creatures, %u queries of %.0f yards: list %u ms, index %u ms (" UI64FMTD "/" UI64FMTD " found)",
+                counts[n], queries, range, listTime, indexTime, listFound, indexFound);
+
+            for (std::vector<Creature*>::iterator itr = creatures.begin(); itr != creatures.end(); ++itr)
+            {
+                (*itr)->RemoveFromGrid();
+                delete *itr;
+            }
+        }
+
+        return true;
+    }
+
+    // USAGE: .debug visstats [reset]
+    // Objects whose visibility for a player was evaluated or skipped on the current map, last tick and per tick
+    static bool HandleDebugVisibilityStatsCommand(ChatHandler* handler, char const* args)
+    {
+        Map* map = handler->GetSession()->GetPlayer()->GetMap();
+
+        if (*args)
+        {
+            if (strcmp(args, "reset"))
+                return false;
+
+            map->ResetVisibilityStats();
+            handler->SendSysMessage("Visibility statistics reset.");
+            return true;
+        }
+
+        Map::VisibilityStats const& last = map->GetLastTickVisibilityStats();
+        Map::VisibilityStats const& total = map->GetTotalVisibilityStats();
+
+        handler->PSendSysMessage("Map %u, last tick: " UI64FMTD " evaluated, " UI64FMTD " skipped", map->GetId(), last.evaluated, last.skipped);
+        if (total.ticks)
+            handler->PSendSysMessage("%u ticks: %.1f evaluated, %.1f skipped per tick", total.ticks,
+                double(total.evaluated) / total.ticks, double(total.skipped) / total.ticks);
+        return true;
+    }
+
+    // USAGE: .debug bench combat [#rounds]
+    // Living creatures within 50 yards swing at each other without dealing damage, then their aura
+    // modifier queries are answered once from the cache and once by walking the effect lists
+    static bool HandleDebugBenchCombatCommand(ChatHandler* handler, char const* args)
+    {
+        if (!CheckBenchmarksEnabled(handler))
+            return false;
+
+        uint32 rounds = *args ? uint32(atoi(args)) : 100;
+        if (!rounds)
+            return false;
+
+        Player* player = handler->GetSession()->GetPlayer();
+        std::list<Unit*> units;
+        Axium::AnyUnitInObjectRangeCheck check(player, 50.0f);
+        Axium::UnitListSearcher<Axium::AnyUnitInObjectRangeCheck> searcher(player, units, check);
+        player->VisitNearbyObject(50.0f, searcher);
+
+        std::vector<Unit*> creatures;
+        std::vector<std::pair<Unit*, AuraType> > queries;
+        uint32 effects = 0;
+        for (std::list<Unit*>::const_iterator itr = units.begin(); itr != units.end(); ++itr)
+        {
+            if ((*itr)->GetTypeId() != TYPEID_UNIT)
+                continue;
+
+            creatures.push_back(*itr);
+            for (uint16 type = 0; type < TOTAL_AURAS; ++type)
+            {
+                Unit::AuraEffectList const& list = (*itr)->GetAuraEffectsByType(AuraType(type));
+                if (list.empty())
+                    continue;
+
+                effects += uint32(list.size());
+                queries.push_back(std::make_pair(*itr, AuraType(type)));
+            }
+        }
+
+        if (creatures.size() < 2)
+        {
+            handler->SendSysMessage("At least two living creatures within 50 yards are needed.");
+            handler->SetSentErrorMessage(true);
+            return false;
+        }
+
+        uint32 count = uint32(creatures.size());
+        uint32 hits = 0;
+        uint64 damage = 0;
+        uint32 start = getMSTime();
+        for (uint32 round = 0; round < rounds; ++round)
+        {
+            for (uint32 i = 0; i < count; ++i)
+            {
+                Unit* attacker = creatures[i];
+                Unit* victim = creatures[(i + round % (count - 1) + 1) % count];
+
+                if (attacker->RollMeleeOutcomeAgainst(victim, BASE_ATTACK) == MELEE_HIT_MISS)
+                    continue;
+
+                uint32 amount = attacker->CalculateDamage(BASE_ATTACK, false, true);
+                amount = attacker->MeleeDamageBonusDone(victim, amount, BASE_ATTACK);
+                amount = victim->MeleeDamageBonusTaken(attacker, amount, BASE_ATTACK);
+                damage += attacker->CalcArmorReducedDamage(victim, amount, NULL, BASE_ATTACK);
+                ++hits;
+            }
+        }
+        uint32 swingTime = GetMSTimeDiffToNow(start);
+
+        handler->PSendSysMessage("%u creatures with %u aura effects: %u swings, %u hits in %u ms (%.0f hits/s, " UI64FMTD " damage)",
+            count, effects, rounds * count, hits, swingTime, hits * 1000.0 / std::max<uint32>(swingTime, 1), damage);
+
+        if (queries.empty())
+            return true;
+
+        int64 cachedTotal = 0;
+        start = getMSTime();
+        for (uint32 round = 0; round < rounds; ++round)
+            for (std::vector<std::pair<Unit*, AuraType> >::const_iterator itr = queries.begin(); itr != queries.end(); ++itr)
+                cachedTotal += itr->first->GetTotalAuraModifier(itr->second);
+        uint32 cachedTime = GetMSTimeDiffToNow(start);
+
+        int64 walkedTotal = 0;
+        start = getMSTime();
+        for (uint32 round = 0; round < rounds; ++round)
+        {
+            for (std::vector<std::pair<Unit*, AuraType> >::const_iterator itr = queries.begin(); itr != queries.end(); ++itr)
+            {
+                Unit::AuraEffectList const& list = itr->first->GetAuraEffectsByType(itr->second);
+                for (Unit::AuraEffectList::const_iterator effect = list.begin(); effect != list.end(); ++effect)
+                    walkedTotal += (*effect)->GetAmount();
+            }
+        }
+        uint32 walkedTime = GetMSTimeDiffToNow(start);
+
+        handler->PSendSysMessage("%u x %u totals by aura type: cache %u ms, list walk %u ms (" SI64FMTD "/" SI64FMTD ")",
+            rounds, uint32(queries.size()), cachedTime, walkedTime, cachedTotal, walkedTotal);
+        return true;
+    }
+
+    // USAGE: .debug bench aura #creature_entry [#creatures] [#ticks]
+    // Summons creatures around the player with 10-30 timed stat/resistance buffs each and times their updates
+    static bool HandleDebugBenchAuraCommand(ChatHandler* handler, char const* args)
+    {
+        if (!CheckBenchmarksEnabled(handler))
+            return false;
+
+        char* entryStr = strtok((char*)args, " ");
+        char* countStr = strtok(NULL, " ");
+        char* ticksStr = strtok(NULL, " ");
+
+        uint32 entry = entryStr ? uint32(atoi(entryStr)) : 0;
+        uint32 count = countStr ? uint32(atoi(countStr)) : 2000;
+        uint32 ticks = ticksStr ? uint32(atoi(ticksStr)) : 100;
+        if (!entry || !count || !ticks)
+            return false;
+
+        if (!sObjectMgr->GetCreatureTemplate(entry))
+        {
+            handler->PSendSysMessage(LANG_COMMAND_INVALIDCREATUREID, entry);
+            handler->SetSentErrorMessage(true);
+            return false;
+        }
+
+        // positive timed auras without area effects that only change stats, no scripts expected
+        std::vector<uint32> spells;
+        for (uint32 id = 0; id < sSpellMgr->GetSpellInfoStoreSize() && spells.size() < 64; ++id)
+        {
+            SpellInfo const* spellInfo = sSpellMgr->GetSpellInfo(id);
+            if (!spellInfo || spellInfo->IsPassive() || !spellInfo->IsPositive() || spellInfo->HasAreaAuraEffect()
+                || spellInfo->GetMaxDuration() < 60 * IN_MILLISECONDS)
+                continue;
+
+            bool statOnly = true;
+            bool hasAura = false;
+            for (uint8 i = 0; i < MAX_SPELL_EFFECTS && statOnly; ++i)
+            {
+                if (!spellInfo->Effects[i].Effect)
+                    continue;
+
+                switch (spellInfo->Effects[i].ApplyAuraName)
+                {
+                    case SPELL_AURA_MOD_STAT:
+                    case SPELL_AURA_MOD_RESISTANCE:
+                    case SPELL_AURA_MOD_ATTACK_POWER:
+                        hasAura = spellInfo->Effects[i].Effect == SPELL_EFFECT_APPLY_AURA;
+                        statOnly = hasAura;
+                        break;
+                    default:
+                        statOnly = false;
+                        break;
+                }
+            }
+
+            if (statOnly && hasAura)
+                spells.push_back(id);
+        }
+
+        if (spells.size() < 30)
+        {
+            handler->PSendSysMessage("Only %u suitable spells found, 30 needed.", uint32(spells.size()));
+            handler->SetSentErrorMessage(true);
+            return false;
+        }
+
+        Player* player = handler->GetSession()->GetPlayer();
+        std::vector<Creature*> creatures;
+        uint32 auras = 0;
+        for (uint32 i = 0; i < count; ++i)
+        {
+            float angle = frand(0.0f, 2.0f * float(M_PI));
+            float dist = frand(5.0f, 40.0f);
+            float x = player->GetPositionX() + dist * std::cos(angle);
+            float y = player->GetPositionY() + dist * std::sin(angle);
+
+            TempSummon* summon = player->SummonCreature(entry, x, y, player->GetPositionZ(), angle);
+            if (!summon)
+                continue;
+
+            std::random_shuffle(spells.begin(), spells.end());
+            uint32 wanted = urand(10, 30);
+            for (uint32 j = 0; j < wanted; ++j)
+                if (summon->AddAura(spells[j], summon))
+                    ++auras;
+
+            creatures.push_back(summon);
+        }
+
+        // the first update sends every new aura to the client
+        for (std::vector<Creature*>::const_iterator itr = creatures.begin(); itr != creatures.end(); ++itr)
+            (*itr)->Update(100);
+
+        uint32 start = getMSTime();
+        for (uint32 tick = 0; tick < ticks; ++tick)
+            for (std::vector<Creature*>::const_iterator itr = creatures.begin(); itr != creatures.end(); ++itr)
+                (*itr)->Update(100);
+        uint32 updateTime = GetMSTimeDiffToNow(start);
+
+        handler->PSendSysMessage("%u creatures with %u auras: %u ticks in %u ms (%.2f ms per tick)",
+            uint32(creatures.size()), auras, ticks, updateTime, double(updateTime) / ticks);
+
+        for (std::vector<Creature*>::const_iterator itr = creatures.begin(); itr != creatures.end(); ++itr)
+            (*itr)->ToTempSummon()->UnSummon();
+        return true;
+    }
+
     static bool HandleDebugSendLoginFailedCommand(ChatHandler* handler, char const* args)
     {
         if (!*args)
@@ -66,32 +66,35 @@ public:
         bool first = true;
         bool footer = false;
 
-        AXIUM_READ_GUARD(HashMapHolder<Player>::LockType, *HashMapHolder<Player>::GetLock());
-        HashMapHolder<Player>::MapType const& m = sObjectAccessor->GetPlayers();
-        for (HashMapHolder<Player>::MapType::const_iterator itr = m.begin(); itr != m.end(); ++itr)
+        for (uint32 shard = 0; shard < HashMapHolder<Player>::SHARDS; ++shard)
         {
-            AccountTypes itrSec = itr->second->GetSession()->GetSecurity();
-
-            if (!handler->GetSession())
-                continue;
-
-            if (itrSec <= SEC_VIP)
-                continue;
-
-            if (first)
+            AXIUM_READ_GUARD(HashMapHolder<Player>::LockType, *HashMapHolder<Player>::GetLock(shard));
+            HashMapHolder<Player>::MapType const& m = sObjectAccessor->GetPlayers(shard);
+            for (HashMapHolder<Player>::MapType::const_iterator itr = m.begin(); itr != m.end(); ++itr)
             {
-                first = false;
-                footer = true;
-                handler->SendSysMessage(LANG_GMS_ON_SRV);
-                handler->SendSysMessage("========================");
+                AccountTypes itrSec = itr->second->GetSession()->GetSecurity();
+
+                if (!handler->GetSession())
+                    continue;
+
+                if (itrSec <= SEC_VIP)
+                    continue;
+
+                if (first)
+                {
+                    first = false;
+                    footer = true;
+                    handler->SendSysMessage(LANG_GMS_ON_SRV);
+                    handler->SendSysMessage("========================");
+                }
+                char const* name = itr->second->GetName();
+                uint8 security = itrSec;
+                uint8 max = ((16 - strlen(name)) / 2);
+                uint8 max2 = max;
+                if ((max + max2 + strlen(name)) == 16)
+                    max2 = max - 1;
+                handler->PSendSysMessage("|    %s GMLevel %u", name, security);
             }
-            char const* name = itr->second->GetName();
-            uint8 security = itrSec;
-            uint8 max = ((16 - strlen(name)) / 2);
-            uint8 max2 = max;
-            if ((max + max2 + strlen(name)) == 16)
-                max2 = max - 1;
-            handler->PSendSysMessage("|    %s GMLevel %u", name, security);
         }
         if (footer)
             handler->SendSysMessage("========================");
@@ -0,0 +1,135 @@
+#include "DatabaseQueue.h"
+#include "SQLOperation.h"
+
+#include <ace/OS_NS_sys_time.h>
+
+DatabaseQueue::DatabaseQueue() : m_ready(m_lock), m_sequence(0), m_running(0), m_writing(false),
+    m_closed(false)
+{
+    memset(m_stats, 0, sizeof(m_stats));
+}
+
+DatabaseQueue::~DatabaseQueue()
+{
+    for (uint8 i = 0; i < MAX_DATABASE_LANES; ++i)
+        for (size_t j = 0; j < m_lanes[i].size(); ++j)
+            delete m_lanes[i][j].op;
+}
+
+void DatabaseQueue::Enqueue(SQLOperation* op, DatabaseLane lane)
+{
+    Entry entry;
+    entry.op = op;
+    entry.time = ACE_OS::gettimeofday();
+
+    AXIUM_GUARD(ACE_Thread_Mutex, m_lock);
+
+    entry.sequence = m_sequence++;
+    m_lanes[lane].push_back(entry);
+
+    DatabaseLaneStats& stats = m_stats[lane];
+    ++stats.queued;
+    stats.maxQueued = std::max(stats.maxQueued, stats.queued);
+
+    m_ready.signal();
+}
+
+SQLOperation* DatabaseQueue::Dequeue(DatabaseLane& lane)
+{
+    AXIUM_GUARD(ACE_Thread_Mutex, m_lock);
+
+    while ((lane = GetNextLane()) == MAX_DATABASE_LANES)
+    {
+        if (m_closed && IsEmpty())
+            return NULL;
+
+        m_ready.wait();
+    }
+
+    Entry entry = m_lanes[lane].front();
+    m_lanes[lane].pop_front();
+
+    ++m_running;
+    if (lane == DATABASE_LANE_WRITE)
+        m_writing = true;
+
+    ACE_Time_Value diff = ACE_OS::gettimeofday() - entry.time;
+    uint64 wait = uint64(diff.sec()) * 1000000 + diff.usec();
+
+    DatabaseLaneStats& stats = m_stats[lane];
+    --stats.queued;
+    ++stats.executed;
+    stats.totalWait += wait;
+    stats.maxWait = std::max(stats.maxWait, uint32(std::min(wait, uint64(0xFFFFFFFF))));
+
+    return entry.op;
+}
+
+void DatabaseQueue::Done(DatabaseLane lane, uint64 time)
+{
+    AXIUM_GUARD(ACE_Thread_Mutex, m_lock);
+    m_stats[lane].totalTime += time;
+
+    --m_running;
+    if (lane == DATABASE_LANE_WRITE)
+        m_writing = false;
+
+    // a write may wait for the others to finish, or the others for a write
+    m_ready.broadcast();
+}
+
+void DatabaseQueue::Close()
+{
+    AXIUM_GUARD(ACE_Thread_Mutex, m_lock);
+    m_closed = true;
+    m_ready.broadcast();
+}
+
+uint32 DatabaseQueue::GetQueued(DatabaseLane lane)
+{
+    AXIUM_GUARD(ACE_Thread_Mutex, m_lock);
+    return m_stats[lane].queued;
+}
+
+void DatabaseQueue::GetStats(DatabaseLaneStats (&stats)[MAX_DATABASE_LANES])
+{
+    AXIUM_GUARD(ACE_Thread_Mutex, m_lock);
+    memcpy(stats, m_stats, sizeof(m_stats));
+}
+
+void DatabaseQueue::ResetStats()
+{
+    AXIUM_GUARD(ACE_Thread_Mutex, m_lock);
+    for (uint8 i = 0; i < MAX_DATABASE_LANES; ++i)
+    {
+        uint32 queued = m_stats[i].queued;
+        memset(&m_stats[i], 0, sizeof(DatabaseLaneStats));
+        m_stats[i].queued = queued;
+        m_stats[i].maxQueued = queued;
+    }
+}
+
+DatabaseLane DatabaseQueue::GetNextLane() const
+{
+    if (m_writing)
+        return MAX_DATABASE_LANES;
+
+    std::deque<Entry> const& writes = m_lanes[DATABASE_LANE_WRITE];
+
+    // queries in the order of the lanes, as long as they were queued before the next write
+    for (uint8 i = 0; i < DATABASE_LANE_WRITE; ++i)
+        if (!m_lanes[i].empty() && (writes.empty() || m_lanes[i].front().sequence < writes.front().sequence))
+            return DatabaseLane(i);
+
+    // and a write once the operations started before it are done
+    return writes.empty() || m_running ? MAX_DATABASE_LANES : DATABASE_LANE_WRITE;
+}
+
+bool DatabaseQueue::IsEmpty() const
+{
+    for (uint8 i = 0; i < MAX_DATABASE_LANES; ++i)
+        if (!m_lanes[i].empty())
+            return false;
+
+    return true;
+}
@@ -0,0 +1,78 @@
+#ifndef _DATABASEQUEUE_H
+#define _DATABASEQUEUE_H
+
+#include "Common.h"
+
+#include <ace/Thread_Mutex.h>
+#include <ace/Condition_Thread_Mutex.h>
+#include <ace/Time_Value.h>
+
+class SQLOperation;
+
+enum DatabaseLane
+{
+    DATABASE_LANE_LOGIN,                                    // queries a player waits for at the character screen
+    DATABASE_LANE_CALLBACK,                                 // other asynchronous queries
+    DATABASE_LANE_WRITE,                                    // one-way statements and transactions
+    MAX_DATABASE_LANES
+};
+
+struct DatabaseLaneStats
+{
+    uint32 queued;                                          // waiting now
+    uint32 maxQueued;
+    uint64 executed;
+    uint64 totalWait;                                       // us from Enqueue() to the start
+    uint32 maxWait;                                         // us
+    uint64 totalTime;                                       // us of execution
+};
+
+/*
+    Asynchronous operations of a pool, one FIFO per lane. Queued queries of the login lane
+    start before those of the callback lane, but nothing passes an older write and writes
+    pass nothing, so the database still sees every write in the order of the callers and
+    every query after the writes queued before it. Queries behind a burst of writes wait
+    for it; the length of the write lane tells the callers to hold back what can wait.
+    With several workers, queries run side by side but a write runs alone.
+*/
+class DatabaseQueue
+{
+    public:
+        DatabaseQueue();
+        ~DatabaseQueue();
+
+        void Enqueue(SQLOperation* op, DatabaseLane lane);
+        //! Blocks until an operation may start, NULL once closed and empty
+        SQLOperation* Dequeue(DatabaseLane& lane);
+        //! The operation taken from lane ran for time (us)
+        void Done(DatabaseLane lane, uint64 time);
+        //! The workers stop once they ran what is queued
+        void Close();
+
+        uint32 GetQueued(DatabaseLane lane);
+        void GetStats(DatabaseLaneStats (&stats)[MAX_DATABASE_LANES]);
+        void ResetStats();
+
+    private:
+        struct Entry
+        {
+            SQLOperation* op;
+            uint64 sequence;
+            ACE_Time_Value time;
+        };
+
+        //! Lane to take from next, MAX_DATABASE_LANES if nothing may start now. m_lock must be held.
+        DatabaseLane GetNextLane() const;
+        bool IsEmpty() const;
+
+        ACE_Thread_Mutex m_lock;                            // everything below
+        ACE_Condition_Thread_Mutex m_ready;
+        std::deque<Entry> m_lanes[MAX_DATABASE_LANES];
+        DatabaseLaneStats m_stats[MAX_DATABASE_LANES];
+        uint64 m_sequence;
+        uint32 m_running;                                   // operations taken and not done yet
+        bool m_writing;                                     // one of them is a write
+        bool m_closed;
+};
+
+#endif
@@ -4,7 +4,9 @@
 #include "MySQLConnection.h"
 #include "MySQLThreading.h"
 
-DatabaseWorker::DatabaseWorker(ACE_Activation_Queue* new_queue, MySQLConnection* con) :
+#include <ace/OS_NS_sys_time.h>
+
+DatabaseWorker::DatabaseWorker(DatabaseQueue* new_queue, MySQLConnection* con) :
 m_queue(new_queue),
 m_conn(con)
 {
@@ -18,16 +20,22 @@ int DatabaseWorker::svc()
         return -1;
 
     SQLOperation *request = NULL;
+    DatabaseLane lane;
     while (1)
     {
-        request = (SQLOperation*)(m_queue->dequeue());
+        request = m_queue->Dequeue(lane);
         if (!request)
             break;
 
+        ACE_Time_Value start = ACE_OS::gettimeofday();
+
         request->SetConnection(m_conn);
         request->call();
 
         delete request;
+
+        ACE_Time_Value time = ACE_OS::gettimeofday() - start;
+        m_queue->Done(lane, uint64(time.sec()) * 1000000 + time.usec());
     }
 
     return 0;
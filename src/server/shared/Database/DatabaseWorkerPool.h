@@ -2,12 +2,15 @@
 #define _DATABASEWORKERPOOL_H
 
 #include <ace/Thread_Mutex.h>
+#include <ace/Condition_Thread_Mutex.h>
+#include <ace/OS_NS_sys_time.h>
 
 #include "Common.h"
 #include "Callback.h"
 #include "MySQLConnection.h"
 #include "Transaction.h"
 #include "DatabaseWorker.h"
+#include "DatabaseQueue.h"
 #include "PreparedStatement.h"
 #include "Log.h"
 #include "QueryResult.h"
@@ -30,15 +33,37 @@ class PingOperation : public SQLOperation
     }
 };
 
+#define DATABASE_WAIT_BUCKETS 8
+
+/// Upper bounds (ms) of the wait buckets of synchronous connection requests; bucket 0 counts
+/// requests served without waiting, the last one everything above the last bound
+static uint32 const DatabaseWaitBucketLimits[DATABASE_WAIT_BUCKETS - 2] = { 1, 5, 10, 50, 100, 500 };
+
+struct DatabasePoolStats
+{
+    uint32 connections;                                     // synchronous connections open
+    uint32 maxConnections;
+    uint32 idle;
+    uint64 requests;
+    uint64 waits[DATABASE_WAIT_BUCKETS];
+    uint64 totalWait;                                       // us
+    uint32 maxWait;                                         // us
+};
+
 template <class T>
 class DatabaseWorkerPool
 {
     public:
         /* Activity state */
         DatabaseWorkerPool() :
-        m_queue(new ACE_Activation_Queue())
+        m_queue(new DatabaseQueue()),
+        m_synchCondition(m_synchLock),
+        m_synchMax(0),
+        m_statementCache(false),
+        m_statementStats(false)
         {
             memset(m_connectionCount, 0, sizeof(m_connectionCount));
+            memset(&m_synchStats, 0, sizeof(m_synchStats));
             m_connections.resize(IDX_SIZE);
 
             WPFatal (mysql_thread_safe(), "Used MySQL library isn't thread-safe.");
@@ -48,30 +73,40 @@ class DatabaseWorkerPool
         {
         }
 
-        bool Open(const std::string& infoString, uint8 async_threads, uint8 synch_threads)
+        //! synch_threads_max allows to open more synchronous connections on demand, 0 means synch_threads.
+        //! statement_cache prepares ad-hoc INSERT, REPLACE, UPDATE and DELETE statements seen more than once.
+        //! statement_stats counts executions by statement shape and prepared statement index for .debug sqlstats.
+        bool Open(const std::string& infoString, uint8 async_threads, uint8 synch_threads, uint8 synch_threads_max = 0, bool statement_cache = false, bool statement_stats = false)
         {
             bool res = true;
             m_connectionInfo = MySQLConnectionInfo(infoString);
+            m_synchMax = std::max(synch_threads, synch_threads_max);
+            m_statementCache = statement_cache;
+            m_statementStats = statement_stats;
 
-            sLog->outSQLDriver("Opening databasepool '%s'. Async threads: %u, synch threads: %u", m_connectionInfo.database.c_str(), async_threads, synch_threads);
+            sLog->outSQLDriver("Opening databasepool '%s'. Async threads: %u, synch threads: %u (max %u)", m_connectionInfo.database.c_str(), async_threads, synch_threads, m_synchMax);
 
             /// Open asynchronous connections (delayed operations)
             m_connections[IDX_ASYNC].resize(async_threads);
             for (uint8 i = 0; i < async_threads; ++i)
             {
                 T* t = new T(m_queue, m_connectionInfo);
+                SetupConnection(t);
                 res &= t->Open();
                 m_connections[IDX_ASYNC][i] = t;
                 ++m_connectionCount[IDX_ASYNC];
             }
 
             /// Open synchronous connections (direct, blocking operations)
-            m_connections[IDX_SYNCH].resize(synch_threads);
+            /// Never reallocated, EscapeString reads the first connection without lock
+            m_connections[IDX_SYNCH].reserve(m_synchMax);
             for (uint8 i = 0; i < synch_threads; ++i)
             {
                 T* t = new T(m_connectionInfo);
+                SetupConnection(t);
                 res &= t->Open();
-                m_connections[IDX_SYNCH][i] = t;
+                m_connections[IDX_SYNCH].push_back(t);
+                m_freeSynch.push_back(t);
                 ++m_connectionCount[IDX_SYNCH];
             }
 
@@ -83,13 +118,13 @@ class DatabaseWorkerPool
         {
             sLog->outSQLDriver("Closing down databasepool '%s'.", m_connectionInfo.database.c_str());
 
-            /// Shuts down delaythreads for this connection pool by underlying deactivate()
-            m_queue->queue()->close();
+            /// Shuts down delaythreads for this connection pool once they ran what is queued
+            m_queue->Close();
 
             for (uint8 i = 0; i < m_connectionCount[IDX_ASYNC]; ++i)
             {
                 /// TODO: Better way. probably should flip a boolean and check it on low level code before doing anything on the mysql ctx
-                /// Now we just wait until m_queue gives the signal to the worker threads to stop
+                /// Now we just wait until m_queue is empty and gives the signal to the worker threads to stop
                 T* t = m_connections[IDX_ASYNC][i];
                 DatabaseWorker* worker = t->m_worker;
                 worker->wait();
@@ -100,7 +135,7 @@ class DatabaseWorkerPool
             sLog->outSQLDriver("Asynchronous connections on databasepool '%s' terminated. Proceeding with synchronous connections.", m_connectionInfo.database.c_str());
 
             /// Shut down the synchronous connections
-            for (uint8 i = 0; i < m_connectionCount[IDX_SYNCH]; ++i)
+            for (size_t i = 0; i < m_connections[IDX_SYNCH].size(); ++i)
             {
                 T* t = m_connections[IDX_SYNCH][i];
                 //while (1)
@@ -123,7 +158,7 @@ class DatabaseWorkerPool
                 return;
 
             BasicStatementTask* task = new BasicStatementTask(sql);
-            Enqueue(task);
+            Enqueue(task, DATABASE_LANE_WRITE);
         }
 
         //! Enqueues a one-way SQL operation in string format -with variable args- that will be executed asynchronously.
@@ -146,7 +181,7 @@ class DatabaseWorkerPool
         void Execute(PreparedStatement* stmt)
         {
             PreparedStatementTask* task = new PreparedStatementTask(stmt);
-            Enqueue(task);
+            Enqueue(task, DATABASE_LANE_WRITE);
         }
 
         /**
@@ -161,7 +196,7 @@ class DatabaseWorkerPool
 
             T* t = GetFreeConnection();
             t->Execute(sql);
-            t->Unlock();
+            ReleaseConnection(t);
         }
 
         //! Directly executes a one-way SQL operation in string format -with variable args-, that will block the calling thread until finished.
@@ -185,7 +220,7 @@ class DatabaseWorkerPool
         {
             T* t = GetFreeConnection();
             t->Execute(stmt);
-            t->Unlock();
+            ReleaseConnection(t);
 
             //! Delete proxy-class. Not needed anymore
             delete stmt;
@@ -197,13 +232,19 @@ class DatabaseWorkerPool
 
         //! Directly executes an SQL query in string format that will block the calling thread until finished.
         //! Returns reference counted auto pointer, no need for manual memory management in upper level code.
+        //! A connection passed in stays locked by the caller.
         QueryResult Query(const char* sql, MySQLConnection* conn = NULL)
         {
+            ResultSet* result;
             if (!conn)
-                conn = GetFreeConnection();
+            {
+                T* t = GetFreeConnection();
+                result = t->Query(sql);
+                ReleaseConnection(t);
+            }
+            else
+                result = conn->Query(sql);
 
-            ResultSet* result = conn->Query(sql);
-            conn->Unlock();
             if (!result || !result->GetRowCount())
             {
                 delete result;
@@ -253,7 +294,7 @@ class DatabaseWorkerPool
         {
             T* t = GetFreeConnection();
             PreparedResultSet* ret = t->Query(stmt);
-            t->Unlock();
+            ReleaseConnection(t);
 
             //! Delete proxy-class. Not needed anymore
             delete stmt;
@@ -267,17 +308,52 @@ class DatabaseWorkerPool
             return PreparedQueryResult(ret);
         }
 
+        //! Like Query(), but the rows are also written to file and read from there the next time,
+        //! as long as neither the query nor the live checksums of its tables (comma separated) changed.
+        //! Tables without a live checksum (only MyISAM tables with CHECKSUM=1 keep one) are always queried.
+        //! An empty file name just runs the query.
+        QueryResult SnapshotQuery(const char* sql, const char* tables, std::string const& file)
+        {
+            if (file.empty())
+                return Query(sql);
+
+            uint32 key = GetSnapshotKey(sql, tables);
+            if (!key)
+                sLog->outSQLDriver("Databasepool '%s': no live checksum for %s, not using a snapshot.", m_connectionInfo.database.c_str(), tables);
+
+            ResultSet* result = key ? ResultSnapshot::Load(file, key) : NULL;
+            if (!result)
+            {
+                T* t = GetFreeConnection();
+                result = t->Query(sql);
+                ReleaseConnection(t);
+
+                if (key && result && result->GetRowCount())
+                    result = ResultSnapshot::Save(file, key, result);
+            }
+
+            if (!result || !result->GetRowCount())
+            {
+                delete result;
+                return QueryResult(NULL);
+            }
+
+            result->NextRow();
+            return QueryResult(result);
+        }
+
         /**
             Asynchronous query (with resultset) methods.
         */
 
         //! Enqueues a query in string format that will set the value of the QueryResultFuture return object as soon as the query is executed.
         //! The return value is then processed in ProcessQueryCallback methods.
-        QueryResultFuture AsyncQuery(const char* sql)
+        //! Queries a player waits for at the character screen go to DATABASE_LANE_LOGIN.
+        QueryResultFuture AsyncQuery(const char* sql, DatabaseLane lane = DATABASE_LANE_CALLBACK)
         {
             QueryResultFuture res;
             BasicStatementTask* task = new BasicStatementTask(sql, res);
-            Enqueue(task);
+            Enqueue(task, lane);
             return res;         //! Actual return value has no use yet
         }
 
@@ -297,11 +373,11 @@ class DatabaseWorkerPool
         //! Enqueues a query in prepared format that will set the value of the PreparedQueryResultFuture return object as soon as the query is executed.
         //! The return value is then processed in ProcessQueryCallback methods.
         //! Statement must be prepared with CONNECTION_ASYNC flag.
-        PreparedQueryResultFuture AsyncQuery(PreparedStatement* stmt)
+        PreparedQueryResultFuture AsyncQuery(PreparedStatement* stmt, DatabaseLane lane = DATABASE_LANE_CALLBACK)
         {
             PreparedQueryResultFuture res;
             PreparedStatementTask* task = new PreparedStatementTask(stmt, res);
-            Enqueue(task);
+            Enqueue(task, lane);
             return res;
         }
 
@@ -309,12 +385,27 @@ class DatabaseWorkerPool
         //! return object as soon as the query is executed.
         //! The return value is then processed in ProcessQueryCallback methods.
         //! Any prepared statements added to this holder need to be prepared with the CONNECTION_ASYNC flag.
-        QueryResultHolderFuture DelayQueryHolder(SQLQueryHolder* holder)
+        //! With parts above 1 (0 is one per asynchronous connection) the queries are split in parts that run
+        //! side by side, so they must not depend on each other.
+        QueryResultHolderFuture DelayQueryHolder(SQLQueryHolder* holder, DatabaseLane lane = DATABASE_LANE_CALLBACK, uint32 parts = 1)
         {
             QueryResultHolderFuture res;
-            SQLQueryHolderTask* task = new SQLQueryHolderTask(holder, res);
-            Enqueue(task);
-            return res;     //! Fool compiler, has no use yet
+
+            if (!parts)
+                parts = m_connectionCount[IDX_ASYNC];
+            parts = std::min(parts, uint32(holder->GetSize()));
+
+            if (parts <= 1)
+            {
+                Enqueue(new SQLQueryHolderTask(holder, res), lane);
+                return res;     //! Fool compiler, has no use yet
+            }
+
+            SQLQueryHolderParts* pending = new SQLQueryHolderParts(parts);
+            for (uint32 i = 0; i < parts; ++i)
+                Enqueue(new SQLQueryHolderTask(holder, res, i, parts, pending), lane);
+
+            return res;
         }
 
         /**
@@ -346,34 +437,28 @@ class DatabaseWorkerPool
                 }
             }
 
-            Enqueue(new TransactionTask(transaction));
+            Enqueue(new TransactionTask(transaction), DATABASE_LANE_WRITE);
         }
 
         //! Directly executes a collection of one-way SQL operations (can be both adhoc and prepared). The order in which these operations
         //! were appended to the transaction will be respected during execution.
         void DirectCommitTransaction(SQLTransaction& transaction)
         {
-            MySQLConnection* con = GetFreeConnection();
-            if (con->ExecuteTransaction(transaction))
-            {
-                con->Unlock();      // OK, operation succesful
-                return;
-            }
+            T* con = GetFreeConnection();
+            bool committed = con->ExecuteTransaction(transaction);
 
-            if (con->GetLastError() == 1213)
+            if (!committed && con->GetLastError() == 1213)
             {
                 uint8 loopBreaker = 5;  // Handle MySQL Errno 1213 without extending deadlock to the core itself
-                for (uint8 i = 0; i < loopBreaker; ++i)
-                {
-                    if (con->ExecuteTransaction(transaction))
-                        break;
-                }
+                for (uint8 i = 0; i < loopBreaker && !committed; ++i)
+                    committed = con->ExecuteTransaction(transaction);
             }
 
             // Clean up now.
             transaction->Cleanup();
+            transaction->SetState(committed ? TRANSACTION_COMMITTED : TRANSACTION_FAILED);
 
-            con->Unlock();
+            ReleaseConnection(con);
         }
 
         //! Method used to execute prepared statements in a diverse context.
@@ -422,25 +507,156 @@ class DatabaseWorkerPool
         //! Keeps all our MySQL connections alive, prevent the server from disconnecting us.
         void KeepAlive()
         {
-            /// Ping synchronous connections
-            for (uint8 i = 0; i < m_connectionCount[IDX_SYNCH]; ++i)
+            /// Ping idle synchronous connections, the others are busy anyway.
+            /// One at a time, the least recently used first, so the others stay available meanwhile.
+            size_t idle;
             {
-                T* t = m_connections[IDX_SYNCH][i];
-                if (t->LockIfReady())
+                AXIUM_GUARD(ACE_Thread_Mutex, m_synchLock);
+                idle = m_freeSynch.size();
+            }
+
+            for (size_t i = 0; i < idle; ++i)
+            {
+                T* t;
                 {
-                    t->Ping();
-                    t->Unlock();
+                    AXIUM_GUARD(ACE_Thread_Mutex, m_synchLock);
+                    if (m_freeSynch.empty())
+                        break;
+
+                    t = m_freeSynch.front();
+                    m_freeSynch.erase(m_freeSynch.begin());
                 }
+
+                t->Ping();
+                ReleaseConnection(t);
             }
 
             /// Assuming all worker threads are free, every worker thread will receive 1 ping operation request
             /// If one or more worker threads are busy, the ping operations will not be split evenly, but this doesn't matter
             /// as the sole purpose is to prevent connections from idling.
             for (size_t i = 0; i < m_connections[IDX_ASYNC].size(); ++i)
-                Enqueue(new PingOperation);
+                Enqueue(new PingOperation, DATABASE_LANE_CALLBACK);
+        }
+
+        //! Usage of the synchronous connections, to size SynchThreads.
+        void GetSynchStats(DatabasePoolStats& stats)
+        {
+            AXIUM_GUARD(ACE_Thread_Mutex, m_synchLock);
+            stats = m_synchStats;
+            stats.connections = m_connectionCount[IDX_SYNCH];
+            stats.maxConnections = m_synchMax;
+            stats.idle = uint32(m_freeSynch.size());
+        }
+
+        void ResetSynchStats()
+        {
+            AXIUM_GUARD(ACE_Thread_Mutex, m_synchLock);
+            memset(&m_synchStats, 0, sizeof(m_synchStats));
+        }
+
+        //! Operations waiting in lane. A long write lane delays every query queued after it,
+        //! so writes that can wait (periodic saves) should be held back while it is.
+        uint32 GetQueued(DatabaseLane lane)
+        {
+            return m_queue->GetQueued(lane);
+        }
+
+        //! Depth and latency of the asynchronous operations, per lane.
+        void GetQueueStats(DatabaseLaneStats (&stats)[MAX_DATABASE_LANES])
+        {
+            m_queue->GetStats(stats);
+        }
+
+        void ResetQueueStats()
+        {
+            m_queue->ResetStats();
+        }
+
+        uint32 GetAsyncConnectionCount() const { return m_connectionCount[IDX_ASYNC]; }
+
+        char const* GetDatabaseName() const { return m_connectionInfo.database.c_str(); }
+
+        //! Executions of ad-hoc statements by shape and of prepared statements by index, to find what to migrate.
+        //! Sums the counters of every connection, empty unless opened with statement_stats.
+        void GetStatementStats(StatementStats::ShapeMap& adhoc, std::vector<uint64>& prepared)
+        {
+            adhoc.clear();
+            prepared.clear();
+
+            if (!m_statementStats)
+                return;
+
+            for (uint32 i = 0; i < m_connectionCount[IDX_ASYNC]; ++i)
+                m_connections[IDX_ASYNC][i]->m_statementStats.MergeInto(adhoc, prepared);
+
+            AXIUM_GUARD(ACE_Thread_Mutex, m_synchLock);
+            for (size_t i = 0; i < m_connections[IDX_SYNCH].size(); ++i)
+                m_connections[IDX_SYNCH][i]->m_statementStats.MergeInto(adhoc, prepared);
+        }
+
+        void ResetStatementStats()
+        {
+            if (!m_statementStats)
+                return;
+
+            for (uint32 i = 0; i < m_connectionCount[IDX_ASYNC]; ++i)
+                m_connections[IDX_ASYNC][i]->m_statementStats.Reset();
+
+            AXIUM_GUARD(ACE_Thread_Mutex, m_synchLock);
+            for (size_t i = 0; i < m_connections[IDX_SYNCH].size(); ++i)
+                m_connections[IDX_SYNCH][i]->m_statementStats.Reset();
+        }
+
+        bool IsStatementCacheEnabled() const { return m_statementCache; }
+        bool IsStatementStatsEnabled() const { return m_statementStats; }
+
+        //! SQL of a prepared statement, NULL for an unknown index
+        char const* GetPreparedQuery(uint32 index)
+        {
+            PreparedStatementMap const& queries = m_connections[IDX_SYNCH][0]->m_queries;
+            PreparedStatementMap::const_iterator itr = queries.find(index);
+            return itr != queries.end() ? itr->second.first : NULL;
         }
 
     private:
+        void SetupConnection(T* t)
+        {
+            t->m_statementCache = m_statementCache;
+            t->m_statementStatsEnabled = m_statementStats;
+        }
+
+        //! Hash of the query and the checksums the server keeps up to date for its tables, 0 if a table has
+        //! none. CHECKSUM TABLE ... QUICK never reads the rows, it returns NULL unless the table maintains
+        //! a live checksum, which MyISAM does with CHECKSUM=1 and InnoDB never does.
+        uint32 GetSnapshotKey(const char* sql, const char* tables)
+        {
+            uint32 count = 1;
+            for (const char* c = tables; *c; ++c)
+                if (*c == ',')
+                    ++count;
+
+            QueryResult result = PQuery("CHECKSUM TABLE %s QUICK", tables);
+            if (!result || result->GetRowCount() != count)
+                return 0;
+
+            uint32 key = 2166136261u;                       // FNV-1a
+            for (const char* c = sql; *c; ++c)
+                key = (key ^ uint8(*c)) * 16777619u;
+
+            do
+            {
+                Field* fields = result->Fetch();
+                if (fields[1].IsNull())
+                    return 0;
+
+                uint64 checksum = fields[1].GetUInt64();
+                for (uint8 i = 0; i < 8; ++i)
+                    key = (key ^ uint8(checksum >> (i * 8))) * 16777619u;
+            } while (result->NextRow());
+
+            return key ? key : 1;
+        }
+
         unsigned long EscapeString(char *to, const char *from, unsigned long length)
         {
             if (!to || !from || !length)
@@ -449,24 +665,92 @@ class DatabaseWorkerPool
             return mysql_real_escape_string(m_connections[IDX_SYNCH][0]->GetHandle(), to, from, length);
         }
 
-        void Enqueue(SQLOperation* op)
+        void Enqueue(SQLOperation* op, DatabaseLane lane)
         {
-            m_queue->enqueue(op);
+            m_queue->Enqueue(op, lane);
         }
 
+        //! Takes an idle synchronous connection, the most recently used first as it is likely the warmest.
+        //! If none is idle, opens another one while below the maximum or sleeps until one is released.
+        //! Must be matched with ReleaseConnection().
         T* GetFreeConnection()
         {
-            uint8 i = 0;
-            size_t num_cons = m_connectionCount[IDX_SYNCH];
-            for (;;)    /// Block forever until a connection is free
+            ACE_Time_Value start = ACE_OS::gettimeofday();
+            bool waited = false;
+
+            m_synchLock.acquire();
+
+            while (m_freeSynch.empty())
             {
-                T* t = m_connections[IDX_SYNCH][++i % num_cons ];
-                if (t->LockIfReady())   /// Must be matched with t->Unlock() or you will get deadlocks
-                    return t;
+                if (m_connectionCount[IDX_SYNCH] < m_synchMax)
+                {
+                    /// Count it right away so other threads don't open one too, but connect outside of the lock
+                    ++m_connectionCount[IDX_SYNCH];
+                    m_synchLock.release();
+
+                    T* t = new T(m_connectionInfo);
+                    SetupConnection(t);
+                    bool opened = t->Open();
+
+                    m_synchLock.acquire();
+
+                    if (opened)
+                    {
+                        sLog->outSQLDriver("Databasepool '%s': opened synchronous connection %u of %u.", m_connectionInfo.database.c_str(), m_connectionCount[IDX_SYNCH], m_synchMax);
+                        m_connections[IDX_SYNCH].push_back(t);
+                        RecordWait(start, true);
+                        m_synchLock.release();
+                        return t;
+                    }
+
+                    /// Stay with what we have
+                    delete t;
+                    --m_connectionCount[IDX_SYNCH];
+                    m_synchMax = m_connectionCount[IDX_SYNCH];
+                    sLog->outError("Databasepool '%s': could not open another synchronous connection, keeping %u.", m_connectionInfo.database.c_str(), m_synchMax);
+                    continue;
+                }
+
+                waited = true;
+                m_synchCondition.wait();
             }
 
-            // This will be called when Celine Dion learns to sing
-            return NULL;
+            T* t = m_freeSynch.back();
+            m_freeSynch.pop_back();
+            RecordWait(start, waited);
+
+            m_synchLock.release();
+            return t;
+        }
+
+        void ReleaseConnection(T* t)
+        {
+            AXIUM_GUARD(ACE_Thread_Mutex, m_synchLock);
+            m_freeSynch.push_back(t);
+            m_synchCondition.signal();
+        }
+
+        //! m_synchLock must be held
+        void RecordWait(ACE_Time_Value const& start, bool waited)
+        {
+            ++m_synchStats.requests;
+
+            if (!waited)
+            {
+                ++m_synchStats.waits[0];
+                return;
+            }
+
+            ACE_Time_Value diff = ACE_OS::gettimeofday() - start;
+            uint64 wait = uint64(diff.sec()) * 1000000 + diff.usec();
+
+            uint8 bucket = 1;
+            while (bucket < DATABASE_WAIT_BUCKETS - 1 && wait >= uint64(DatabaseWaitBucketLimits[bucket - 1]) * 1000)
+                ++bucket;
+
+            ++m_synchStats.waits[bucket];
+            m_synchStats.totalWait += wait;
+            m_synchStats.maxWait = std::max(m_synchStats.maxWait, uint32(std::min(wait, uint64(0xFFFFFFFF))));
         }
 
     private:
@@ -477,10 +761,17 @@ class DatabaseWorkerPool
             IDX_SIZE,
         };
 
-        ACE_Activation_Queue*           m_queue;             //! Queue shared by async worker threads.
+        DatabaseQueue*                  m_queue;             //! Queue shared by async worker threads.
         std::vector< std::vector<T*> >  m_connections;
         uint32                          m_connectionCount[2];       //! Counter of MySQL connections;
         MySQLConnectionInfo             m_connectionInfo;
+        ACE_Thread_Mutex                m_synchLock;         //! Guards m_freeSynch, m_synchStats and opening synchronous connections.
+        ACE_Condition_Thread_Mutex      m_synchCondition;    //! Signaled when a synchronous connection is released.
+        std::vector<T*>                 m_freeSynch;         //! Idle synchronous connections, most recently released last.
+        uint32                          m_synchMax;          //! Synchronous connections may grow up to this.
+        DatabasePoolStats               m_synchStats;
+        bool                            m_statementCache;    //! Do connections prepare repeated ad-hoc statements?
+        bool                            m_statementStats;    //! Do connections count executions for .debug sqlstats?
 };
 
 #endif
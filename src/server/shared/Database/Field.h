@@ -10,6 +10,7 @@ class Field
 {
     friend class ResultSet;
     friend class PreparedResultSet;
+    friend class ResultSnapshot;
 
     public:
 
@@ -218,6 +219,11 @@ class Field
             return std::string((char*)data.value);
         }
 
+        bool IsNull() const
+        {
+            return data.value == NULL;
+        }
+
     protected:
         Field();
         ~Field();
@@ -240,14 +246,9 @@ class Field
         #pragma pack(pop)
         #endif
 
-        void SetByteValue(const void* newValue, const size_t newSize, enum_field_types newType, uint32 length);
-        void SetStructuredValue(char* newValue, enum_field_types newType);
-
-        void CleanUp()
-        {
-            delete[] ((char*)data.value);
-            data.value = NULL;
-        }
+        //! Values are not copied, they belong to the result set and stay valid as long as the field is read
+        void SetByteValue(void* newValue, enum_field_types newType, uint32 length);
+        void SetStructuredValue(char* newValue, enum_field_types newType, uint32 length);
 
         static size_t SizeForType(MYSQL_FIELD* field)
         {
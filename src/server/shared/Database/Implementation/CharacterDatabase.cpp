@@ -111,6 +111,12 @@ void CharacterDatabaseConnection::DoPrepareStatements()
     PREPARE_STATEMENT(CHAR_DEL_ACCOUNT_INSTANCE_LOCK_TIMES, "DELETE FROM account_instance_times WHERE accountId = ?", CONNECTION_ASYNC)
     PREPARE_STATEMENT(CHAR_INS_ACCOUNT_INSTANCE_LOCK_TIMES, "INSERT INTO account_instance_times (accountId, instanceId, releaseTime) VALUES (?, ?, ?)", CONNECTION_ASYNC)
     PREPARE_STATEMENT(CHAR_SEL_CHARACTER_NAME_CLASS, "SELECT name, class FROM characters WHERE guid = ?", CONNECTION_SYNCH);
+    PREPARE_STATEMENT(CHAR_SEL_CHARACTER_NAME, "SELECT name FROM characters WHERE guid = ?", CONNECTION_SYNCH);
+    PREPARE_STATEMENT(CHAR_SEL_CHARACTER_ACCOUNT_NAME, "SELECT account, name FROM characters WHERE guid = ?", CONNECTION_SYNCH);
+    PREPARE_STATEMENT(CHAR_SEL_CHARACTER_LEVEL, "SELECT level FROM characters WHERE guid = ?", CONNECTION_SYNCH);
+    PREPARE_STATEMENT(CHAR_SEL_CHARACTER_AT_LOGIN, "SELECT at_login FROM characters WHERE guid = ?", CONNECTION_SYNCH);
+    PREPARE_STATEMENT(CHAR_SEL_CHARACTER_FACTION_CHANGE_INFO, "SELECT class, level, at_login, knownTitles FROM characters WHERE guid = ?", CONNECTION_SYNCH);
+    PREPARE_STATEMENT(CHAR_SEL_MAIL_COUNT, "SELECT COUNT(*) FROM mail WHERE receiver = ?", CONNECTION_SYNCH);
     PREPARE_STATEMENT(CHAR_SEL_MATCH_MAKER_RATING, "SELECT slot, matchMakerRating FROM character_arena_stats WHERE guid = ?", CONNECTION_SYNCH);
     PREPARE_STATEMENT(CHAR_SEL_MATCH_MAKER_RATING_BY_SLOT, "SELECT matchMakerRating FROM character_arena_stats WHERE guid = ? AND slot = ?", CONNECTION_SYNCH);
     PREPARE_STATEMENT(CHAR_SEL_CHARACTER_COUNT, "SELECT account, COUNT(guid) FROM characters WHERE account = ? GROUP BY account", CONNECTION_ASYNC);
@@ -258,6 +264,20 @@ void CharacterDatabaseConnection::DoPrepareStatements()
     PREPARE_STATEMENT(CHAR_REP_CHARACTER_ARENA_STATS, "REPLACE INTO character_arena_stats (guid, slot, matchMakerRating) VALUES (?, ?, ?)", CONNECTION_ASYNC);
     PREPARE_STATEMENT(CHAR_SEL_PLAYER_ARENA_TEAMS, "SELECT arena_team_member.arenaTeamId FROM arena_team_member JOIN arena_team ON arena_team_member.arenaTeamId = arena_team.arenaTeamId WHERE guid = ?", CONNECTION_SYNCH);
 
+    // Arena stats of all characters, see PvPMgr
+    PREPARE_STATEMENT(CHAR_SEL_ALL_ARENA_POINTS, "SELECT guid, weeklyArenaPoints, arenaPointsCap FROM characters", CONNECTION_SYNCH);
+    PREPARE_STATEMENT(CHAR_SEL_ALL_MATCH_MAKER_RATINGS, "SELECT guid, slot, matchMakerRating FROM character_arena_stats", CONNECTION_SYNCH);
+    PREPARE_STATEMENT(CHAR_SEL_ALL_PVP_STATS, "SELECT guid, Lifetime2v2Rating, Lifetime2v2MMR, Lifetime2v2Wins, Lifetime2v2Games, Lifetime3v3Rating, Lifetime3v3MMR, Lifetime3v3Wins, Lifetime3v3Games, "
+    "Lifetime5v5Rating, Lifetime5v5MMR, Lifetime5v5Wins, Lifetime5v5Games FROM character_pvp_stats", CONNECTION_SYNCH);
+    PREPARE_STATEMENT(CHAR_UPD_ARENA_POINTS, "UPDATE characters SET weeklyArenaPoints = ?, arenaPointsCap = ? WHERE guid = ?", CONNECTION_ASYNC);
+    PREPARE_STATEMENT(CHAR_UPD_RESET_ARENA_POINTS, "UPDATE characters SET weeklyArenaPoints = 0, arenaPointsCap = 0", CONNECTION_ASYNC);
+    PREPARE_STATEMENT(CHAR_UPD_MATCH_MAKER_RATING, "UPDATE character_arena_stats SET matchMakerRating = ? WHERE guid = ? AND slot = ?", CONNECTION_ASYNC);
+    PREPARE_STATEMENT(CHAR_UPD_PVP_STATS, "UPDATE character_pvp_stats SET Lifetime2v2Rating = ?, Lifetime2v2MMR = ?, Lifetime2v2Wins = ?, Lifetime2v2Games = ?, Lifetime3v3Rating = ?, Lifetime3v3MMR = ?, "
+    "Lifetime3v3Wins = ?, Lifetime3v3Games = ?, Lifetime5v5Rating = ?, Lifetime5v5MMR = ?, Lifetime5v5Wins = ?, Lifetime5v5Games = ? WHERE guid = ?", CONNECTION_ASYNC);
+    PREPARE_STATEMENT(CHAR_SEL_PVP_STATS, "SELECT Lifetime2v2Rating, Lifetime2v2MMR, Lifetime2v2Wins, Lifetime2v2Games, Lifetime3v3Rating, Lifetime3v3MMR, Lifetime3v3Wins, Lifetime3v3Games, "
+    "Lifetime5v5Rating, Lifetime5v5MMR, Lifetime5v5Wins, Lifetime5v5Games FROM character_pvp_stats WHERE guid = ?", CONNECTION_SYNCH);
+    PREPARE_STATEMENT(CHAR_INS_PVP_STATS, "INSERT INTO character_pvp_stats (guid) VALUES (?)", CONNECTION_ASYNC);
+
     // Character battleground data
     PREPARE_STATEMENT(CHAR_INS_PLAYER_BGDATA, "INSERT INTO character_battleground_data (guid, instanceId, team, joinX, joinY, joinZ, joinO, joinMapId, taxiStart, taxiEnd, mountSpell) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)", CONNECTION_ASYNC)
     PREPARE_STATEMENT(CHAR_DEL_PLAYER_BGDATA, "DELETE FROM character_battleground_data WHERE guid = ?", CONNECTION_ASYNC)
@@ -370,4 +390,18 @@ void CharacterDatabaseConnection::DoPrepareStatements()
     PREPARE_STATEMENT(CHAR_UPD_CHAR_TITLES_FACTION_CHANGE, "UPDATE characters SET knownTitles = ? WHERE guid = ?", CONNECTION_ASYNC);
     PREPARE_STATEMENT(CHAR_RES_CHAR_TITLES_FACTION_CHANGE, "UPDATE characters SET chosenTitle = 0 WHERE guid = ?", CONNECTION_ASYNC);
 
+    // Player::SaveToDB, repeated statements in a row are merged into multi-row ones by the connection
+    PREPARE_STATEMENT(CHAR_REP_CHARACTER_QUESTSTATUS, "REPLACE INTO character_queststatus (guid, quest, status, explored, timer, mobcount1, mobcount2, mobcount3, mobcount4, "
+    "itemcount1, itemcount2, itemcount3, itemcount4, playercount) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)", CONNECTION_ASYNC);
+    PREPARE_STATEMENT(CHAR_DEL_CHARACTER_QUESTSTATUS_BY_QUEST, "DELETE FROM character_queststatus WHERE guid = ? AND quest = ?", CONNECTION_ASYNC);
+    PREPARE_STATEMENT(CHAR_INS_CHARACTER_QUESTSTATUS_REWARDED, "INSERT IGNORE INTO character_queststatus_rewarded (guid, quest) VALUES (?, ?)", CONNECTION_ASYNC);
+    PREPARE_STATEMENT(CHAR_DEL_CHARACTER_QUESTSTATUS_REWARDED_BY_QUEST, "DELETE FROM character_queststatus_rewarded WHERE guid = ? AND quest = ?", CONNECTION_ASYNC);
+    PREPARE_STATEMENT(CHAR_INS_CHARACTER_SKILL, "INSERT INTO character_skills (guid, skill, value, max) VALUES (?, ?, ?, ?)", CONNECTION_ASYNC);
+    PREPARE_STATEMENT(CHAR_UPD_CHARACTER_SKILL, "UPDATE character_skills SET value = ?, max = ? WHERE guid = ? AND skill = ?", CONNECTION_ASYNC);
+    PREPARE_STATEMENT(CHAR_INS_CHARACTER_SPELL, "INSERT INTO character_spell (guid, spell, active, disabled) VALUES (?, ?, ?, ?)", CONNECTION_ASYNC);
+    PREPARE_STATEMENT(CHAR_DEL_CHARACTER_SPELL_BY_SPELL, "DELETE FROM character_spell WHERE guid = ? AND spell = ?", CONNECTION_ASYNC);
+    PREPARE_STATEMENT(CHAR_INS_CHARACTER_TALENT, "INSERT INTO character_talent (guid, spell, spec) VALUES (?, ?, ?)", CONNECTION_ASYNC);
+    PREPARE_STATEMENT(CHAR_DEL_CHARACTER_TALENT_BY_SPELL_SPEC, "DELETE FROM character_talent WHERE guid = ? AND spell = ? AND spec = ?", CONNECTION_ASYNC);
+    PREPARE_STATEMENT(CHAR_UPD_ITEM_INSTANCE_TRANSMOG, "UPDATE item_instance SET TransmogEntry = ?, TransmogEnchant = ? WHERE guid = ?", CONNECTION_ASYNC);
+
 }
@@ -9,7 +9,7 @@ class CharacterDatabaseConnection : public MySQLConnection
     public:
         //- Constructors for sync and async connections
         CharacterDatabaseConnection(MySQLConnectionInfo& connInfo) : MySQLConnection(connInfo) {}
-        CharacterDatabaseConnection(ACE_Activation_Queue* q, MySQLConnectionInfo& connInfo) : MySQLConnection(q, connInfo) {}
+        CharacterDatabaseConnection(DatabaseQueue* q, MySQLConnectionInfo& connInfo) : MySQLConnection(q, connInfo) {}
 
         //- Loads database type specific prepared statements
         void DoPrepareStatements();
@@ -119,6 +119,12 @@ enum CharacterDatabaseStatements
     CHAR_DEL_ACCOUNT_INSTANCE_LOCK_TIMES,
     CHAR_INS_ACCOUNT_INSTANCE_LOCK_TIMES,
     CHAR_SEL_CHARACTER_NAME_CLASS,
+    CHAR_SEL_CHARACTER_NAME,
+    CHAR_SEL_CHARACTER_ACCOUNT_NAME,
+    CHAR_SEL_CHARACTER_LEVEL,
+    CHAR_SEL_CHARACTER_AT_LOGIN,
+    CHAR_SEL_CHARACTER_FACTION_CHANGE_INFO,
+    CHAR_SEL_MAIL_COUNT,
     CHAR_SEL_MATCH_MAKER_RATING,
     CHAR_SEL_MATCH_MAKER_RATING_BY_SLOT,
     CHAR_SEL_CHARACTER_COUNT,
@@ -235,6 +241,16 @@ enum CharacterDatabaseStatements
     CHAR_REP_CHARACTER_ARENA_STATS,
     CHAR_SEL_PLAYER_ARENA_TEAMS,
 
+    CHAR_SEL_ALL_ARENA_POINTS,
+    CHAR_SEL_ALL_MATCH_MAKER_RATINGS,
+    CHAR_SEL_ALL_PVP_STATS,
+    CHAR_UPD_ARENA_POINTS,
+    CHAR_UPD_RESET_ARENA_POINTS,
+    CHAR_UPD_MATCH_MAKER_RATING,
+    CHAR_UPD_PVP_STATS,
+    CHAR_SEL_PVP_STATS,
+    CHAR_INS_PVP_STATS,
+
     CHAR_SEL_PETITION,
     CHAR_SEL_PETITION_SIGNATURE,
     CHAR_DEL_ALL_PETITION_SIGNATURES,
@@ -330,6 +346,17 @@ enum CharacterDatabaseStatements
     CHAR_UPD_CHARACTER_POSITION,
     CHAR_UPD_CHAR_TITLES_FACTION_CHANGE,
     CHAR_RES_CHAR_TITLES_FACTION_CHANGE,
+    CHAR_REP_CHARACTER_QUESTSTATUS,
+    CHAR_DEL_CHARACTER_QUESTSTATUS_BY_QUEST,
+    CHAR_INS_CHARACTER_QUESTSTATUS_REWARDED,
+    CHAR_DEL_CHARACTER_QUESTSTATUS_REWARDED_BY_QUEST,
+    CHAR_INS_CHARACTER_SKILL,
+    CHAR_UPD_CHARACTER_SKILL,
+    CHAR_INS_CHARACTER_SPELL,
+    CHAR_DEL_CHARACTER_SPELL_BY_SPELL,
+    CHAR_INS_CHARACTER_TALENT,
+    CHAR_DEL_CHARACTER_TALENT_BY_SPELL_SPEC,
+    CHAR_UPD_ITEM_INSTANCE_TRANSMOG,
 
     MAX_CHARACTERDATABASE_STATEMENTS,
 };
@@ -9,7 +9,7 @@ class LogDatabaseConnection : public MySQLConnection
     public:
         //- Constructors for sync and async connections
         LogDatabaseConnection(MySQLConnectionInfo& connInfo) : MySQLConnection(connInfo) {}
-        LogDatabaseConnection(ACE_Activation_Queue* q, MySQLConnectionInfo& connInfo) : MySQLConnection(q, connInfo) {}
+        LogDatabaseConnection(DatabaseQueue* q, MySQLConnectionInfo& connInfo) : MySQLConnection(q, connInfo) {}
 
         //- Loads database type specific prepared statements
         void DoPrepareStatements();
@@ -15,9 +15,13 @@
 #include "Timer.h"
 #include "Log.h"
 
+#include <algorithm>
+
 MySQLConnection::MySQLConnection(MySQLConnectionInfo& connInfo) :
 m_reconnecting(false),
 m_prepareError(false),
+m_statementCache(false),
+m_statementStatsEnabled(false),
 m_queue(NULL),
 m_worker(NULL),
 m_Mysql(NULL),
@@ -26,9 +30,11 @@ m_connectionFlags(CONNECTION_SYNCH)
 {
 }
 
-MySQLConnection::MySQLConnection(ACE_Activation_Queue* queue, MySQLConnectionInfo& connInfo) :
+MySQLConnection::MySQLConnection(DatabaseQueue* queue, MySQLConnectionInfo& connInfo) :
 m_reconnecting(false),
 m_prepareError(false),
+m_statementCache(false),
+m_statementStatsEnabled(false),
 m_queue(queue),
 m_Mysql(NULL),
 m_connectionInfo(connInfo),
@@ -45,6 +51,9 @@ MySQLConnection::~MySQLConnection()
     for (size_t i = 0; i < m_stmts.size(); ++i)
         delete m_stmts[i];
 
+    ClearBatchStatements();
+    ClearAdhocStatements();
+
     for (PreparedStatementMap::const_iterator itr = m_queries.begin(); itr != m_queries.end(); ++itr)
         free((void *)m_queries[itr->first].first);
 
@@ -124,17 +133,328 @@ bool MySQLConnection::Open()
 
 bool MySQLConnection::PrepareStatements()
 {
+    // For reconnection case, multi-row and ad-hoc statements are prepared again when used
+    ClearBatchStatements();
+    ClearAdhocStatements();
+
     DoPrepareStatements();
+    m_batchable.assign(m_stmts.size(), false);
     for (PreparedStatementMap::const_iterator itr = m_queries.begin(); itr != m_queries.end(); ++itr)
         PrepareStatement(itr->first, itr->second.first, itr->second.second);
     return !m_prepareError;
 }
 
+//- Builds the query writing rows of the statement at once: INSERT and REPLACE repeat the row after VALUES,
+//- DELETE joins the conditions with OR. Anything else, like ON DUPLICATE KEY UPDATE or LIMIT, can't be merged.
+static bool BuildBatchQuery(std::string const& sql, uint32 rows, std::string& batch)
+{
+    std::string upper(sql);
+    std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+
+    size_t end = upper.find_last_not_of(" \t\r\n;");
+    if (end == std::string::npos)
+        return false;
+    ++end;
+
+    if (upper.compare(0, 7, "INSERT ") == 0 || upper.compare(0, 8, "REPLACE ") == 0)
+    {
+        size_t values = upper.find(" VALUES");
+        if (values == std::string::npos)
+            return false;
+
+        size_t open = upper.find_first_not_of(" \t\r\n", values + 7);
+        if (open == std::string::npos || upper[open] != '(')
+            return false;
+
+        // the row must end the query
+        int32 depth = 0;
+        size_t close = std::string::npos;
+        for (size_t i = open; i < end && close == std::string::npos; ++i)
+        {
+            if (upper[i] == '(')
+                ++depth;
+            else if (upper[i] == ')' && --depth == 0)
+                close = i;
+        }
+
+        if (close != end - 1)
+            return false;
+
+        std::string row = sql.substr(open, end - open);
+        batch = sql.substr(0, open);
+        for (uint32 i = 0; i < rows; ++i)
+        {
+            if (i)
+                batch += ", ";
+            batch += row;
+        }
+        return true;
+    }
+
+    if (upper.compare(0, 12, "DELETE FROM ") == 0)
+    {
+        size_t where = upper.find(" WHERE ");
+        if (where == std::string::npos || upper.find(" LIMIT ") != std::string::npos || upper.find(" ORDER ") != std::string::npos ||
+            upper.find(" USING ") != std::string::npos || upper.find(" JOIN ") != std::string::npos || upper.find("SELECT ") != std::string::npos)
+            return false;
+
+        where += 7;
+        std::string condition = sql.substr(where, end - where);
+        batch = sql.substr(0, where);
+        for (uint32 i = 0; i < rows; ++i)
+        {
+            if (i)
+                batch += " OR ";
+            batch += '(' + condition + ')';
+        }
+        return true;
+    }
+
+    return false;
+}
+
+void StatementStats::AddAdhoc(std::string const& shape, bool cached)
+{
+    AXIUM_GUARD(ACE_Thread_Mutex, m_lock);
+
+    ShapeMap::iterator itr = m_adhoc.find(shape);
+    if (itr == m_adhoc.end())
+    {
+        // statements built without format, like IN lists, would grow it forever
+        StatementShapeStats empty = { 0, 0 };
+        itr = m_adhoc.insert(std::make_pair(m_adhoc.size() < 4096 ? shape : std::string("(other shapes)"), empty)).first;
+    }
+
+    if (cached)
+        ++itr->second.cached;
+    else
+        ++itr->second.text;
+}
+
+void StatementStats::AddPrepared(uint32 index, uint32 count)
+{
+    AXIUM_GUARD(ACE_Thread_Mutex, m_lock);
+
+    if (index >= m_prepared.size())
+        m_prepared.resize(index + 1, 0);
+    m_prepared[index] += count;
+}
+
+void StatementStats::MergeInto(ShapeMap& adhoc, std::vector<uint64>& prepared)
+{
+    AXIUM_GUARD(ACE_Thread_Mutex, m_lock);
+
+    for (ShapeMap::const_iterator itr = m_adhoc.begin(); itr != m_adhoc.end(); ++itr)
+    {
+        StatementShapeStats& stats = adhoc[itr->first];
+        stats.text += itr->second.text;
+        stats.cached += itr->second.cached;
+    }
+
+    if (prepared.size() < m_prepared.size())
+        prepared.resize(m_prepared.size(), 0);
+    for (size_t i = 0; i < m_prepared.size(); ++i)
+        prepared[i] += m_prepared[i];
+}
+
+void StatementStats::Reset()
+{
+    AXIUM_GUARD(ACE_Thread_Mutex, m_lock);
+    m_adhoc.clear();
+    m_prepared.clear();
+}
+
+static bool IsIdentifierChar(char c)
+{
+    return isalnum(uint8(c)) || c == '_' || c == '$' || uint8(c) >= 0x80;
+}
+
+//- Replaces the numbers and quoted strings of an ad-hoc statement by ?, keeping their values in literals.
+//- Identifiers and double quoted text stay as they are. Returns false for comments or several statements.
+static bool BuildStatementShape(const char* sql, std::string& shape, std::vector<StatementLiteral>& literals)
+{
+    shape.clear();
+    literals.clear();
+
+    for (const char* c = sql; *c;)
+    {
+        if (*c == '\'')
+        {
+            StatementLiteral literal;
+            literal.type = MYSQL_TYPE_STRING;
+            literal.isUnsigned = false;
+            literal.number = 0;
+
+            bool closed = false;
+            for (++c; *c && !closed;)
+            {
+                if (*c == '\\' && c[1])
+                {
+                    // undoes mysql_real_escape_string, \% and \_ keep their backslash
+                    switch (c[1])
+                    {
+                        case '0': literal.text += '\0'; break;
+                        case 'n': literal.text += '\n'; break;
+                        case 'r': literal.text += '\r'; break;
+                        case 't': literal.text += '\t'; break;
+                        case 'b': literal.text += '\b'; break;
+                        case 'Z': literal.text += '\x1A'; break;
+                        case '%':
+                        case '_': literal.text += '\\'; literal.text += c[1]; break;
+                        default: literal.text += c[1]; break;
+                    }
+                    c += 2;
+                }
+                else if (*c == '\'' && c[1] == '\'')
+                {
+                    literal.text += '\'';
+                    c += 2;
+                }
+                else if (*c == '\'')
+                {
+                    closed = true;
+                    ++c;
+                }
+                else
+                    literal.text += *c++;
+            }
+
+            if (!closed)
+                return false;
+
+            shape += '?';
+            literals.push_back(literal);
+            continue;
+        }
+
+        if (*c == '"' || *c == '`')
+        {
+            char quote = *c;
+            shape += *c++;
+            while (*c && *c != quote)
+            {
+                if (*c == '\\' && quote == '"' && c[1])
+                    shape += *c++;
+                shape += *c++;
+            }
+
+            if (!*c)
+                return false;
+
+            shape += *c++;
+            continue;
+        }
+
+        if (*c == '#' || (*c == '-' && c[1] == '-') || (*c == '/' && c[1] == '*'))
+            return false;
+
+        if (*c == ';')
+        {
+            for (const char* rest = c + 1; *rest; ++rest)
+                if (!isspace(uint8(*rest)))
+                    return false;
+            break;
+        }
+
+        if (isdigit(uint8(*c)))
+        {
+            // a whole token, identifiers are skipped below so this is never the middle of one
+            const char* end = c;
+            uint32 dots = 0;
+            bool digits = true;
+            for (; IsIdentifierChar(*end) || *end == '.'; ++end)
+            {
+                if (*end == '.')
+                    ++dots;
+                else if (!isdigit(uint8(*end)))
+                    digits = false;
+            }
+
+            std::string token(c, end);
+            c = end;
+
+            StatementLiteral literal;
+            literal.isUnsigned = false;
+            literal.number = 0;
+            if (digits && !dots && token.length() <= 19)
+            {
+                literal.type = MYSQL_TYPE_LONGLONG;
+                literal.number = strtoull(token.c_str(), NULL, 10);
+            }
+            else if (digits && dots == 1 && token[token.length() - 1] != '.')
+            {
+                literal.type = MYSQL_TYPE_NEWDECIMAL;
+                literal.text = token;
+            }
+            else
+            {
+                shape += token;                             // hexadecimal, exponent, too long...
+                continue;
+            }
+
+            shape += '?';
+            literals.push_back(literal);
+            continue;
+        }
+
+        if (IsIdentifierChar(*c))
+        {
+            while (IsIdentifierChar(*c))
+                shape += *c++;
+            continue;
+        }
+
+        shape += *c++;
+    }
+
+    return literals.size() <= MAX_ADHOC_LITERALS;
+}
+
+//- Only these are worth keeping prepared, they run again and again with other values
+static bool IsCacheableShape(std::string const& shape)
+{
+    size_t start = shape.find_first_not_of(" \t\r\n");
+    if (start == std::string::npos)
+        return false;
+
+    std::string verb = shape.substr(start, 8);
+    std::transform(verb.begin(), verb.end(), verb.begin(), ::toupper);
+
+    static char const* const verbs[] = { "INSERT ", "REPLACE ", "UPDATE ", "DELETE " };
+    for (uint8 i = 0; i < 4; ++i)
+        if (verb.compare(0, strlen(verbs[i]), verbs[i]) == 0)
+            return true;
+
+    return false;
+}
+
 bool MySQLConnection::Execute(const char* sql)
 {
     if (!m_Mysql)
         return false;
 
+    std::string shape;
+    std::vector<StatementLiteral> literals;
+    bool shaped = (m_statementStatsEnabled || m_statementCache) && BuildStatementShape(sql, shape, literals);
+
+    if (shaped && m_statementCache && IsCacheableShape(shape))
+    {
+        if (MYSQL_STMT* stmt = GetAdhocStatement(shape))
+        {
+            bool retry = false;
+            bool done = ExecuteAdhoc(stmt, shape, literals, sql, retry);
+            if (!retry)
+            {
+                if (m_statementStatsEnabled)
+                    m_statementStats.AddAdhoc(shape, true);
+                return done;
+            }
+        }
+    }
+
+    if (shaped && m_statementStatsEnabled)
+        m_statementStats.AddAdhoc(shape, false);
+
     {
         uint32 _s = 0;
         if (sLog->GetSQLDriverQueryLogging())
@@ -165,6 +485,9 @@ bool MySQLConnection::Execute(PreparedStatement* stmt)
         return false;
 
     uint32 index = stmt->m_index;
+    if (m_statementStatsEnabled)
+        m_statementStats.AddPrepared(index, 1);
+
     {
         MySQLPreparedStatement* m_mStmt = GetPreparedStatement(index);
         ASSERT(m_mStmt);            // Can only be null if preparation failed, server side error or bad query
@@ -218,6 +541,9 @@ bool MySQLConnection::_Query(PreparedStatement* stmt, MYSQL_RES **pResult, uint6
         return false;
 
     uint32 index = stmt->m_index;
+    if (m_statementStatsEnabled)
+        m_statementStats.AddPrepared(index, 1);
+
     {
         MySQLPreparedStatement* m_mStmt = GetPreparedStatement(index);
         ASSERT(m_mStmt);            // Can only be null if preparation failed, server side error or bad query
@@ -292,6 +618,14 @@ bool MySQLConnection::_Query(const char *sql, MYSQL_RES **pResult, MYSQL_FIELD *
     if (!m_Mysql)
         return false;
 
+    if (m_statementStatsEnabled)
+    {
+        std::string shape;
+        std::vector<StatementLiteral> literals;
+        if (BuildStatementShape(sql, shape, literals))
+            m_statementStats.AddAdhoc(shape, false);
+    }
+
     {
         uint32 _s = 0;
         if (sLog->GetSQLDriverQueryLogging())
@@ -353,6 +687,8 @@ bool MySQLConnection::ExecuteTransaction(SQLTransaction& transaction)
 
     BeginTransaction();
 
+    std::vector<PreparedStatement*> batch;
+
     std::list<SQLElementData>::const_iterator itr;
     for (itr = queries.begin(); itr != queries.end(); ++itr)
     {
@@ -363,7 +699,20 @@ bool MySQLConnection::ExecuteTransaction(SQLTransaction& transaction)
             {
                 PreparedStatement* stmt = data.element.stmt;
                 ASSERT(stmt);
-                if (!Execute(stmt))
+
+                // the same statement following in a row is sent as few multi-row statements
+                batch.assign(1, stmt);
+                if (stmt->m_index < m_batchable.size() && m_batchable[stmt->m_index])
+                {
+                    std::list<SQLElementData>::const_iterator next = itr;
+                    for (++next; next != queries.end() && next->type == SQL_ELEMENT_PREPARED && next->element.stmt->m_index == stmt->m_index; ++next)
+                    {
+                        batch.push_back(next->element.stmt);
+                        itr = next;
+                    }
+                }
+
+                if (!Execute(&batch[0], uint32(batch.size())))
                 {
                     sLog->outSQLDriver("[Warning] Transaction aborted. %u queries not executed.", (uint32)queries.size());
                     RollbackTransaction();
@@ -441,10 +790,237 @@ void MySQLConnection::PrepareStatement(uint32 index, const char* sql, Connection
         {
             MySQLPreparedStatement* mStmt = new MySQLPreparedStatement(stmt);
             m_stmts[index] = mStmt;
+
+            std::string batch;
+            m_batchable[index] = BuildBatchQuery(sql, 2, batch);
         }
     }
 }
 
+MySQLPreparedStatement* MySQLConnection::GetBatchStatement(uint32 index, uint32 rows)
+{
+    std::pair<uint32, uint32> key(index, rows);
+    std::map<std::pair<uint32, uint32>, MySQLPreparedStatement*>::const_iterator itr = m_batchStmts.find(key);
+    if (itr != m_batchStmts.end())
+        return itr->second;
+
+    MySQLPreparedStatement* mStmt = NULL;
+    std::string sql;
+    if (BuildBatchQuery(m_queries[index].first, rows, sql))
+    {
+        if (MYSQL_STMT* stmt = mysql_stmt_init(m_Mysql))
+        {
+            if (mysql_stmt_prepare(stmt, sql.c_str(), static_cast<unsigned long>(sql.length())))
+            {
+                sLog->outSQLDriver("[ERROR]: In mysql_stmt_prepare() id: %u, rows: %u, sql: \"%s\"", index, rows, sql.c_str());
+                sLog->outSQLDriver("[ERROR]: %s", mysql_stmt_error(stmt));
+                mysql_stmt_close(stmt);
+            }
+            else
+                mStmt = new MySQLPreparedStatement(stmt);
+        }
+    }
+
+    // also remembers the failures, those rows are executed one by one
+    m_batchStmts[key] = mStmt;
+    return mStmt;
+}
+
+void MySQLConnection::ClearBatchStatements()
+{
+    for (std::map<std::pair<uint32, uint32>, MySQLPreparedStatement*>::const_iterator itr = m_batchStmts.begin(); itr != m_batchStmts.end(); ++itr)
+        delete itr->second;
+
+    m_batchStmts.clear();
+}
+
+MYSQL_STMT* MySQLConnection::GetAdhocStatement(std::string const& shape)
+{
+    std::map<std::string, AdhocStatement>::iterator itr = m_adhocStmts.find(shape);
+    if (itr == m_adhocStmts.end())
+    {
+        if (m_adhocStmts.size() >= MAX_ADHOC_STATEMENTS)
+        {
+            // make room by forgetting the shapes seen once, the prepared ones stay
+            for (std::map<std::string, AdhocStatement>::iterator next = m_adhocStmts.begin(); next != m_adhocStmts.end();)
+            {
+                if (!next->second.stmt && next->second.uses < 2)
+                    m_adhocStmts.erase(next++);
+                else
+                    ++next;
+            }
+
+            if (m_adhocStmts.size() >= MAX_ADHOC_STATEMENTS)
+                return NULL;
+        }
+
+        AdhocStatement adhoc;
+        adhoc.stmt = NULL;
+        adhoc.uses = 1;
+        m_adhocStmts[shape] = adhoc;
+        return NULL;
+    }
+
+    AdhocStatement& adhoc = itr->second;
+    if (adhoc.stmt || ++adhoc.uses != 2)
+        return adhoc.stmt;
+
+    // second time the shape is seen, from now on it runs prepared
+    if (MYSQL_STMT* stmt = mysql_stmt_init(m_Mysql))
+    {
+        if (mysql_stmt_prepare(stmt, shape.c_str(), static_cast<unsigned long>(shape.length())))
+        {
+            sLog->outSQLDriver("Statement cache: can't prepare \"%s\": %s", shape.c_str(), mysql_stmt_error(stmt));
+            mysql_stmt_close(stmt);
+        }
+        else
+            adhoc.stmt = stmt;
+    }
+
+    return adhoc.stmt;
+}
+
+bool MySQLConnection::ExecuteAdhoc(MYSQL_STMT* stmt, std::string const& shape, std::vector<StatementLiteral>& literals, const char* sql, bool& retry)
+{
+    if (mysql_stmt_param_count(stmt) != literals.size())
+    {
+        retry = true;
+        return false;
+    }
+
+    std::vector<MYSQL_BIND> binds(std::max(literals.size(), size_t(1)));
+    memset(&binds[0], 0, sizeof(MYSQL_BIND) * binds.size());
+    for (size_t i = 0; i < literals.size(); ++i)
+    {
+        binds[i].buffer_type = literals[i].type;
+        if (literals[i].type == MYSQL_TYPE_LONGLONG)
+        {
+            binds[i].buffer = &literals[i].number;
+            binds[i].is_unsigned = literals[i].number > uint64(0x7FFFFFFFFFFFFFFFLL);
+        }
+        else
+        {
+            binds[i].buffer = const_cast<char*>(literals[i].text.c_str());
+            binds[i].buffer_length = static_cast<unsigned long>(literals[i].text.length());
+        }
+    }
+
+    uint32 _s = 0;
+    if (sLog->GetSQLDriverQueryLogging())
+        _s = getMSTime();
+
+    if (mysql_stmt_bind_param(stmt, &binds[0]) || mysql_stmt_execute(stmt))
+    {
+        uint32 lErrno = mysql_stmt_errno(stmt);
+        if (lErrno == 1615)         // "Prepared statement needs to be re-prepared"
+        {
+            mysql_stmt_close(stmt);
+            m_adhocStmts.erase(shape);
+            retry = true;
+            return false;
+        }
+
+        sLog->outSQLDriver("SQL(c): %s", sql);
+        sLog->outSQLDriver("ERROR: [%u] %s", lErrno, mysql_stmt_error(stmt));
+
+        if (_HandleMySQLErrno(lErrno))  // reconnected, the statement cache is empty again
+            retry = true;
+
+        return false;
+    }
+
+    if (sLog->GetSQLDriverQueryLogging())
+        sLog->outSQLDriver("[%u ms] SQL(c): %s", getMSTimeDiff(_s, getMSTime()), sql);
+
+    return true;
+}
+
+void MySQLConnection::ClearAdhocStatements()
+{
+    for (std::map<std::string, AdhocStatement>::const_iterator itr = m_adhocStmts.begin(); itr != m_adhocStmts.end(); ++itr)
+        if (itr->second.stmt)
+            mysql_stmt_close(itr->second.stmt);
+
+    m_adhocStmts.clear();
+}
+
+bool MySQLConnection::Execute(PreparedStatement** stmts, uint32 count)
+{
+    uint32 done = 0;
+    while (done < count)
+    {
+        // as few statements as possible, but only MAX_BATCH_ROWS, MAX_BATCH_ROWS / 2, ... rows each
+        uint32 rows = MAX_BATCH_ROWS;
+        while (rows > count - done)
+            rows >>= 1;
+
+        if (rows == 1 ? !Execute(stmts[done]) : !ExecuteBatch(stmts + done, rows))
+            return false;
+
+        done += rows;
+    }
+
+    return true;
+}
+
+bool MySQLConnection::ExecuteBatch(PreparedStatement** stmts, uint32 rows)
+{
+    if (!m_Mysql)
+        return false;
+
+    uint32 index = stmts[0]->m_index;
+    MySQLPreparedStatement* m_mStmt = GetBatchStatement(index, rows);
+    if (!m_mStmt)
+    {
+        for (uint32 i = 0; i < rows; ++i)
+            if (!Execute(stmts[i]))
+                return false;
+
+        return true;
+    }
+
+    if (m_statementStatsEnabled)
+        m_statementStats.AddPrepared(index, rows);
+
+    m_mStmt->m_stmt = stmts[0];     // for the warnings of the binding
+
+    uint32 params = m_mStmt->m_paramCount / rows;
+    for (uint32 i = 0; i < rows; ++i)
+    {
+        stmts[i]->m_stmt = m_mStmt;
+        stmts[i]->BindParameters(m_mStmt, i * params);
+    }
+
+    MYSQL_STMT* msql_STMT = m_mStmt->GetSTMT();
+    MYSQL_BIND* msql_BIND = m_mStmt->GetBind();
+
+    uint32 _s = 0;
+    if (sLog->GetSQLDriverQueryLogging())
+        _s = getMSTime();
+
+    if (mysql_stmt_bind_param(msql_STMT, msql_BIND) || mysql_stmt_execute(msql_STMT))
+    {
+        uint32 lErrno = mysql_errno(m_Mysql);
+        m_stmts[index]->m_stmt = stmts[0];
+        sLog->outSQLDriver("SQL(p): %s (first of %u rows)\n [ERROR]: [%u] %s", m_stmts[index]->getQueryString(m_queries[index].first).c_str(), rows, lErrno, mysql_stmt_error(msql_STMT));
+
+        if (_HandleMySQLErrno(lErrno))      // If it returns true, an error was handled successfully (i.e. reconnection)
+            return ExecuteBatch(stmts, rows);   // Try again
+
+        m_mStmt->ClearParameters();
+        return false;
+    }
+
+    if (sLog->GetSQLDriverQueryLogging())
+    {
+        m_stmts[index]->m_stmt = stmts[0];
+        sLog->outSQLDriver("[%u ms] SQL(p): %s (first of %u rows)", getMSTimeDiff(_s, getMSTime()), m_stmts[index]->getQueryString(m_queries[index].first).c_str(), rows);
+    }
+
+    m_mStmt->ClearParameters();
+    return true;
+}
+
 PreparedResultSet* MySQLConnection::Query(PreparedStatement* stmt)
 {
     MYSQL_RES *result = NULL;
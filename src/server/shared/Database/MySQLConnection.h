@@ -8,6 +8,7 @@
 #define _MYSQLCONNECTION_H
 
 class DatabaseWorker;
+class DatabaseQueue;
 class PreparedStatement;
 class MySQLPreparedStatement;
 class PingOperation;
@@ -56,6 +57,49 @@ typedef std::map<uint32 /*index*/, std::pair<const char* /*query*/, ConnectionFl
 
 #define PREPARE_STATEMENT(a, b, c) m_queries[a] = std::make_pair(strdup(b), c);
 
+//! Most rows a transaction merges into one statement, a power of two
+#define MAX_BATCH_ROWS 64
+
+//! Ad-hoc statement shapes a connection keeps prepared, and the most literals one may have
+#define MAX_ADHOC_STATEMENTS 256
+#define MAX_ADHOC_LITERALS 256
+
+//! Executions of one ad-hoc statement shape, the SQL with its literals replaced by ?
+struct StatementShapeStats
+{
+    uint64 text;                                            // sent as SQL text
+    uint64 cached;                                          // run through the statement cache
+};
+
+//! Executions of ad-hoc statements by shape and of prepared statements by index, counted by each connection
+//! and merged by the pool when read. A shape mostly stands for one call site, so the most used ones are the next to become prepared statements.
+class StatementStats
+{
+    public:
+        typedef std::map<std::string, StatementShapeStats> ShapeMap;
+
+        void AddAdhoc(std::string const& shape, bool cached);
+        void AddPrepared(uint32 index, uint32 count);
+
+        //! Adds these counters to adhoc and prepared
+        void MergeInto(ShapeMap& adhoc, std::vector<uint64>& prepared);
+        void Reset();
+
+    private:
+        ACE_Thread_Mutex m_lock;
+        ShapeMap m_adhoc;
+        std::vector<uint64> m_prepared;
+};
+
+//! A literal taken out of an ad-hoc statement
+struct StatementLiteral
+{
+    enum_field_types type;                                  // MYSQL_TYPE_LONGLONG, MYSQL_TYPE_NEWDECIMAL or MYSQL_TYPE_STRING
+    bool isUnsigned;
+    uint64 number;
+    std::string text;                                       // decimals and strings, unescaped
+};
+
 class MySQLConnection
 {
     template <class T> friend class DatabaseWorkerPool;
@@ -63,7 +107,7 @@ class MySQLConnection
 
     public:
         MySQLConnection(MySQLConnectionInfo& connInfo);                               //! Constructor for synchronous connections.
-        MySQLConnection(ACE_Activation_Queue* queue, MySQLConnectionInfo& connInfo);  //! Constructor for asynchronous connections.
+        MySQLConnection(DatabaseQueue* queue, MySQLConnectionInfo& connInfo);  //! Constructor for asynchronous connections.
         virtual ~MySQLConnection();
 
         virtual bool Open();
@@ -72,6 +116,7 @@ class MySQLConnection
     public:
         bool Execute(const char* sql);
         bool Execute(PreparedStatement* stmt);
+        bool Execute(PreparedStatement** stmts, uint32 count);
         ResultSet* Query(const char* sql);
         PreparedResultSet* Query(PreparedStatement* stmt);
         bool _Query(const char *sql, MYSQL_RES **pResult, MYSQL_FIELD **pFields, uint64* pRowCount, uint32* pFieldCount);
@@ -108,17 +153,40 @@ class MySQLConnection
         bool PrepareStatements();
         virtual void DoPrepareStatements() = 0;
 
+        bool ExecuteBatch(PreparedStatement** stmts, uint32 rows);
+        MySQLPreparedStatement* GetBatchStatement(uint32 index, uint32 rows);
+        void ClearBatchStatements();
+
+        //! Prepared statement of an ad-hoc shape once it was seen before, NULL otherwise or if it can't be prepared
+        MYSQL_STMT* GetAdhocStatement(std::string const& shape);
+        //! Runs the shape with its literals, false on error; sets retry when it should run as text instead
+        bool ExecuteAdhoc(MYSQL_STMT* stmt, std::string const& shape, std::vector<StatementLiteral>& literals, const char* sql, bool& retry);
+        void ClearAdhocStatements();
+
     protected:
         std::vector<MySQLPreparedStatement*> m_stmts;         //! PreparedStatements storage
         PreparedStatementMap                 m_queries;       //! Query storage
         bool                                 m_reconnecting;  //! Are we reconnecting?
         bool                                 m_prepareError;  //! Was there any error while preparing statements?
+        std::vector<bool>                    m_batchable;     //! Statements a transaction may merge into multi-row ones
+        std::map<std::pair<uint32, uint32>, MySQLPreparedStatement*> m_batchStmts;    //! Multi-row statements by index and rows
+
+        struct AdhocStatement
+        {
+            MYSQL_STMT* stmt;                                //! NULL until used twice, or if preparing failed
+            uint32 uses;
+        };
+
+        std::map<std::string, AdhocStatement> m_adhocStmts;  //! Statement cache of ad-hoc SQL by shape
+        bool                                 m_statementCache;  //! Is the statement cache used?
+        bool                                 m_statementStatsEnabled;  //! Are executions counted in m_statementStats?
+        StatementStats                       m_statementStats;  //! Only locked by this connection and by the pool reading it
 
     private:
         bool _HandleMySQLErrno(uint32 errNo);
 
     private:
-        ACE_Activation_Queue* m_queue;                      //! Queue shared with other asynchronous connections.
+        DatabaseQueue*        m_queue;                      //! Queue shared with other asynchronous connections.
         DatabaseWorker*       m_worker;                     //! Core worker task.
         MYSQL *               m_Mysql;                      //! MySQL Handle.
         MySQLConnectionInfo&  m_connectionInfo;             //! Connection info (used for logging)
@@ -16,45 +16,90 @@ void PreparedStatement::BindParameters()
 {
     ASSERT (m_stmt);
 
-    uint32 i = 0;
-    for (; i < statement_data.size(); i++)
+    BindParameters(m_stmt, 0);
+
+    #ifdef _DEBUG
+    if (statement_data.size() < m_stmt->m_paramCount)
+        sLog->outSQLDriver("[WARNING]: BindParameters() for statement %u did not bind all allocated parameters", m_index);
+    #endif
+}
+
+void PreparedStatement::BindParameters(MySQLPreparedStatement* stmt, uint32 offset)
+{
+    for (uint32 i = 0; i < statement_data.size(); i++)
     {
         switch (statement_data[i].type)
         {
             case TYPE_BOOL:
-                m_stmt->setBool(i, statement_data[i].data.boolean);
+                stmt->setBool(offset + i, statement_data[i].data.boolean);
                 break;
             case TYPE_UI8:
             case TYPE_UI16:
             case TYPE_UI32:
-                m_stmt->setUInt32(i, statement_data[i].data.ui32);
+                stmt->setUInt32(offset + i, statement_data[i].data.ui32);
                 break;
             case TYPE_I8:
             case TYPE_I16:
             case TYPE_I32:
-                m_stmt->setInt32(i, statement_data[i].data.i32);
+                stmt->setInt32(offset + i, statement_data[i].data.i32);
                 break;
             case TYPE_UI64:
-                m_stmt->setUInt64(i, statement_data[i].data.ui64);
+                stmt->setUInt64(offset + i, statement_data[i].data.ui64);
                 break;
             case TYPE_I64:
-                m_stmt->setInt64(i, statement_data[i].data.i64);
+                stmt->setInt64(offset + i, statement_data[i].data.i64);
                 break;
             case TYPE_FLOAT:
-                m_stmt->setFloat(i, statement_data[i].data.f);
+                stmt->setFloat(offset + i, statement_data[i].data.f);
                 break;
             case TYPE_DOUBLE:
-                m_stmt->setDouble(i, statement_data[i].data.d);
+                stmt->setDouble(offset + i, statement_data[i].data.d);
                 break;
             case TYPE_STRING:
-                m_stmt->setString(i, statement_data[i].str.c_str());
+                stmt->setString(offset + i, statement_data[i].str.c_str());
                 break;
         }
     }
-    #ifdef _DEBUG
-    if (i < m_stmt->m_paramCount)
-        sLog->outSQLDriver("[WARNING]: BindParameters() for statement %u did not bind all allocated parameters", m_index);
-    #endif
+}
+
+void PreparedStatement::GetContent(std::string& content) const
+{
+    uint32 header[2] = { m_index, uint32(statement_data.size()) };
+    content.append(reinterpret_cast<char const*>(header), sizeof(header));
+
+    for (uint32 i = 0; i < statement_data.size(); i++)
+    {
+        PreparedStatementData const& data = statement_data[i];
+
+        uint8 const* bytes;
+        size_t size;
+        switch (data.type)
+        {
+            case TYPE_STRING:
+                bytes = reinterpret_cast<uint8 const*>(data.str.c_str());
+                size = data.str.size();
+                break;
+            case TYPE_BOOL:
+                bytes = reinterpret_cast<uint8 const*>(&data.data.boolean);
+                size = 1;
+                break;
+            case TYPE_UI64:
+            case TYPE_I64:
+            case TYPE_DOUBLE:
+                bytes = reinterpret_cast<uint8 const*>(&data.data);
+                size = 8;
+                break;
+            default:
+                bytes = reinterpret_cast<uint8 const*>(&data.data);
+                size = 4;
+                break;
+        }
+
+        // type and size first, so parameters can't run into each other
+        uint32 prefix[2] = { uint32(data.type), uint32(size) };
+        content.append(reinterpret_cast<char const*>(prefix), sizeof(prefix));
+        content.append(reinterpret_cast<char const*>(bytes), size);
+    }
 }
 
 //- Bind to buffer
@@ -206,7 +251,7 @@ void MySQLPreparedStatement::ClearParameters()
 }
 
 //- Bind on mysql level
-bool MySQLPreparedStatement::CheckValidIndex(uint8 index)
+bool MySQLPreparedStatement::CheckValidIndex(uint32 index)
 {
     if (index >= m_paramCount)
         return false;
@@ -216,22 +261,22 @@ bool MySQLPreparedStatement::CheckValidIndex(uint8 index)
     return true;
 }
 
-void MySQLPreparedStatement::setBool(const uint8 index, const bool value)
+void MySQLPreparedStatement::setBool(const uint32 index, const bool value)
 {
     setUInt32(index, value);
 }
 
-void MySQLPreparedStatement::setUInt8(const uint8 index, const uint8 value)
+void MySQLPreparedStatement::setUInt8(const uint32 index, const uint8 value)
 {
     setUInt32(index, value);
 }
 
-void MySQLPreparedStatement::setUInt16(const uint8 index, const uint16 value)
+void MySQLPreparedStatement::setUInt16(const uint32 index, const uint16 value)
 {
     setUInt32(index, value);
 }
 
-void MySQLPreparedStatement::setUInt32(const uint8 index, const uint32 value)
+void MySQLPreparedStatement::setUInt32(const uint32 index, const uint32 value)
 {
     CheckValidIndex(index);
     m_paramsSet[index] = true;
@@ -239,7 +284,7 @@ void MySQLPreparedStatement::setUInt32(const uint8 index, const uint32 value)
     setValue(param, MYSQL_TYPE_LONG, &value, sizeof(uint32), true);
 }
 
-void MySQLPreparedStatement::setUInt64(const uint8 index, const uint64 value)
+void MySQLPreparedStatement::setUInt64(const uint32 index, const uint64 value)
 {
     CheckValidIndex(index);
     m_paramsSet[index] = true;
@@ -247,17 +292,17 @@ void MySQLPreparedStatement::setUInt64(const uint8 index, const uint64 value)
     setValue(param, MYSQL_TYPE_LONGLONG, &value, sizeof(uint64), true);
 }
 
-void MySQLPreparedStatement::setInt8(const uint8 index, const int8 value)
+void MySQLPreparedStatement::setInt8(const uint32 index, const int8 value)
 {
     setInt32(index, value);
 }
 
-void MySQLPreparedStatement::setInt16(const uint8 index, const int16 value)
+void MySQLPreparedStatement::setInt16(const uint32 index, const int16 value)
 {
     setInt32(index, value);
 }
 
-void MySQLPreparedStatement::setInt32(const uint8 index, const int32 value)
+void MySQLPreparedStatement::setInt32(const uint32 index, const int32 value)
 {
     CheckValidIndex(index);
     m_paramsSet[index] = true;
@@ -265,7 +310,7 @@ void MySQLPreparedStatement::setInt32(const uint8 index, const int32 value)
     setValue(param, MYSQL_TYPE_LONG, &value, sizeof(int32), false);
 }
 
-void MySQLPreparedStatement::setInt64(const uint8 index, const int64 value)
+void MySQLPreparedStatement::setInt64(const uint32 index, const int64 value)
 {
     CheckValidIndex(index);
     m_paramsSet[index] = true;
@@ -273,7 +318,7 @@ void MySQLPreparedStatement::setInt64(const uint8 index, const int64 value)
     setValue(param, MYSQL_TYPE_LONGLONG, &value, sizeof(int64), false);
 }
 
-void MySQLPreparedStatement::setFloat(const uint8 index, const float value)
+void MySQLPreparedStatement::setFloat(const uint32 index, const float value)
 {
     CheckValidIndex(index);
     m_paramsSet[index] = true;
@@ -281,7 +326,7 @@ void MySQLPreparedStatement::setFloat(const uint8 index, const float value)
     setValue(param, MYSQL_TYPE_FLOAT, &value, sizeof(float), (value > 0.0f));
 }
 
-void MySQLPreparedStatement::setDouble(const uint8 index, const double value)
+void MySQLPreparedStatement::setDouble(const uint32 index, const double value)
 {
     CheckValidIndex(index);
     m_paramsSet[index] = true;
@@ -289,7 +334,7 @@ void MySQLPreparedStatement::setDouble(const uint8 index, const double value)
     setValue(param, MYSQL_TYPE_DOUBLE, &value, sizeof(double), (value > 0.0f));
 }
 
-void MySQLPreparedStatement::setString(const uint8 index, const char* value)
+void MySQLPreparedStatement::setString(const uint32 index, const char* value)
 {
     CheckValidIndex(index);
     m_paramsSet[index] = true;
@@ -71,8 +71,14 @@ class PreparedStatement
         void setDouble(const uint8 index, const double value);
         void setString(const uint8 index, const std::string& value);
 
+        uint32 GetIndex() const { return m_index; }
+        //! Appends the index and the parameters to content, statements with equal content write the same
+        void GetContent(std::string& content) const;
+
     protected:
         void BindParameters();
+        //! Binds the parameters as the row at offset of a multi-row statement
+        void BindParameters(MySQLPreparedStatement* stmt, uint32 offset);
 
     protected:
         MySQLPreparedStatement* m_stmt;
@@ -92,25 +98,25 @@ class MySQLPreparedStatement
         MySQLPreparedStatement(MYSQL_STMT* stmt);
         ~MySQLPreparedStatement();
 
-        void setBool(const uint8 index, const bool value);
-        void setUInt8(const uint8 index, const uint8 value);
-        void setUInt16(const uint8 index, const uint16 value);
-        void setUInt32(const uint8 index, const uint32 value);
-        void setUInt64(const uint8 index, const uint64 value);
-        void setInt8(const uint8 index, const int8 value);
-        void setInt16(const uint8 index, const int16 value);
-        void setInt32(const uint8 index, const int32 value);
-        void setInt64(const uint8 index, const int64 value);
-        void setFloat(const uint8 index, const float value);
-        void setDouble(const uint8 index, const double value);
-        void setString(const uint8 index, const char* value);
+        void setBool(const uint32 index, const bool value);
+        void setUInt8(const uint32 index, const uint8 value);
+        void setUInt16(const uint32 index, const uint16 value);
+        void setUInt32(const uint32 index, const uint32 value);
+        void setUInt64(const uint32 index, const uint64 value);
+        void setInt8(const uint32 index, const int8 value);
+        void setInt16(const uint32 index, const int16 value);
+        void setInt32(const uint32 index, const int32 value);
+        void setInt64(const uint32 index, const int64 value);
+        void setFloat(const uint32 index, const float value);
+        void setDouble(const uint32 index, const double value);
+        void setString(const uint32 index, const char* value);
 
     protected:
         MYSQL_STMT* GetSTMT() { return m_Mstmt; }
         MYSQL_BIND* GetBind() { return m_bind; }
         PreparedStatement* m_stmt;
         void ClearParameters();
-        bool CheckValidIndex(uint8 index);
+        bool CheckValidIndex(uint32 index);
         std::string getQueryString(const char *query);
 
     private:
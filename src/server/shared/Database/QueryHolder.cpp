@@ -158,7 +158,7 @@ bool SQLQueryHolderTask::Execute()
     /// we can do this, we are friends
     std::vector<SQLQueryHolder::SQLResultPair> &queries = m_holder->m_queries;
 
-    for (size_t i = 0; i < queries.size(); i++)
+    for (size_t i = m_first; i < queries.size(); i += m_step)
     {
         /// execute all queries in the holder and pass the results
         if (SQLElementData* data = &queries[i].first)
@@ -183,6 +183,11 @@ bool SQLQueryHolderTask::Execute()
         }
     }
 
+    /// the results of the other parts are in the holder once they are done too
+    if (m_pending && --(*m_pending))
+        return true;
+
+    delete m_pending;
     m_result.set(m_holder);
     return true;
 }
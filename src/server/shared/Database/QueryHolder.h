@@ -2,6 +2,7 @@
 #define _QUERYHOLDER_H
 
 #include <ace/Future.h>
+#include <ace/Atomic_Op.h>
 
 class SQLQueryHolder
 {
@@ -12,6 +13,7 @@ class SQLQueryHolder
     public:
         SQLQueryHolder() {}
         ~SQLQueryHolder();
+        size_t GetSize() const { return m_queries.size(); }
         bool SetQuery(size_t index, const char *sql);
         bool SetPQuery(size_t index, const char *format, ...) ATTR_PRINTF(3, 4);
         bool SetPreparedQuery(size_t index, PreparedStatement* stmt);
@@ -24,15 +26,24 @@ class SQLQueryHolder
 
 typedef ACE_Future<SQLQueryHolder*> QueryResultHolderFuture;
 
+typedef ACE_Atomic_Op<ACE_Thread_Mutex, uint32> SQLQueryHolderParts;
+
 class SQLQueryHolderTask : public SQLOperation
 {
     private:
         SQLQueryHolder * m_holder;
         QueryResultHolderFuture m_result;
+        uint32 m_first;
+        uint32 m_step;
+        SQLQueryHolderParts* m_pending;
 
     public:
         SQLQueryHolderTask(SQLQueryHolder *holder, QueryResultHolderFuture res)
-            : m_holder(holder), m_result(res){};
+            : m_holder(holder), m_result(res), m_first(0), m_step(1), m_pending(NULL) {};
+        //! Runs every step-th query from first, so the parts of a holder can run on several
+        //! connections at once. pending counts the parts not done, the last one sets the result.
+        SQLQueryHolderTask(SQLQueryHolder *holder, QueryResultHolderFuture res, uint32 first, uint32 step, SQLQueryHolderParts* pending)
+            : m_holder(holder), m_result(res), m_first(first), m_step(step), m_pending(pending) {};
         bool Execute();
 
 };
@@ -5,7 +5,19 @@ ResultSet::ResultSet(MYSQL_RES *result, MYSQL_FIELD *fields, uint64 rowCount, ui
 m_rowCount(rowCount),
 m_fieldCount(fieldCount),
 m_result(result),
-m_fields(fields)
+m_fields(fields),
+m_snapshot(NULL)
+{
+    m_currentRow = new Field[m_fieldCount];
+    ASSERT(m_currentRow);
+}
+
+ResultSet::ResultSet(ResultSnapshot* snapshot, uint64 rowCount, uint32 fieldCount) :
+m_rowCount(rowCount),
+m_fieldCount(fieldCount),
+m_result(NULL),
+m_fields(NULL),
+m_snapshot(snapshot)
 {
     m_currentRow = new Field[m_fieldCount];
     ASSERT(m_currentRow);
@@ -15,11 +27,14 @@ PreparedResultSet::PreparedResultSet(MYSQL_STMT* stmt, MYSQL_RES *result, uint64
 m_rowCount(rowCount),
 m_rowPosition(0),
 m_fieldCount(fieldCount),
+m_currentRow(NULL),
 m_rBind(NULL),
 m_stmt(stmt),
 m_res(result),
 m_isNull(NULL),
-m_length(NULL)
+m_length(NULL),
+m_bindBuffer(NULL),
+m_nullOffset(0)
 {
     if (!m_res)
         return;
@@ -42,27 +57,57 @@ m_length(NULL)
     if (mysql_stmt_store_result(m_stmt))
     {
         sLog->outSQLDriver("%s:mysql_stmt_store_result, cannot bind result from MySQL server. Error: %s", __FUNCTION__, mysql_stmt_error(m_stmt));
+        m_rowCount = 0;
         return;
     }
 
-    //- This is where we prepare the buffer based on metadata
-    uint32 i = 0;
-    MYSQL_FIELD* field = mysql_fetch_field(m_res);
-    while (field)
+    //- This is where we prepare the buffer based on metadata, one for all columns
+    m_columns.resize(m_fieldCount);
+
+    size_t bindSize = 0;
+    for (uint32 i = 0; i < m_fieldCount; ++i)
     {
+        MYSQL_FIELD* field = mysql_fetch_field(m_res);
+        ASSERT(field);
+
         size_t size = Field::SizeForType(field);
 
         m_rBind[i].buffer_type = field->type;
-        m_rBind[i].buffer = malloc(size);
-        memset(m_rBind[i].buffer, 0, size);
         m_rBind[i].buffer_length = size;
         m_rBind[i].length = &m_length[i];
         m_rBind[i].is_null = &m_isNull[i];
         m_rBind[i].error = NULL;
         m_rBind[i].is_unsigned = field->flags & UNSIGNED_FLAG;
 
-        ++i;
-        field = mysql_fetch_field(m_res);
+        m_columns[i].type = field->type;
+        switch (field->type)
+        {
+            case MYSQL_TYPE_TINY_BLOB:
+            case MYSQL_TYPE_MEDIUM_BLOB:
+            case MYSQL_TYPE_LONG_BLOB:
+            case MYSQL_TYPE_BLOB:
+            case MYSQL_TYPE_STRING:
+            case MYSQL_TYPE_VAR_STRING:
+                m_columns[i].isString = true;
+                m_columns[i].size = 2 * sizeof(uint32);
+                break;
+            default:
+                m_columns[i].isString = false;
+                m_columns[i].size = size;
+                break;
+        }
+
+        bindSize += (size + 7) & ~size_t(7);
+    }
+
+    m_bindBuffer = new char[std::max(bindSize, size_t(1))];
+    memset(m_bindBuffer, 0, std::max(bindSize, size_t(1)));
+
+    bindSize = 0;
+    for (uint32 i = 0; i < m_fieldCount; ++i)
+    {
+        m_rBind[i].buffer = m_bindBuffer + bindSize;
+        bindSize += (m_rBind[i].buffer_length + 7) & ~size_t(7);
     }
 
     //- This is where we bind the bind the buffer to the statement
@@ -72,51 +117,106 @@ m_length(NULL)
         delete[] m_rBind;
         delete[] m_isNull;
         delete[] m_length;
+        delete[] m_bindBuffer;
+        m_rBind = NULL;
+        m_bindBuffer = NULL;
+        m_rowCount = 0;
         return;
     }
 
     m_rowCount = mysql_stmt_num_rows(m_stmt);
 
-    m_rows.resize(uint32(m_rowCount));
+    //- One arena for all rows: the columns one after another, then the null flags
+    size_t arenaSize = 0;
+    for (uint32 i = 0; i < m_fieldCount; ++i)
+    {
+        m_columns[i].offset = arenaSize;
+        arenaSize += (size_t(m_rowCount) * m_columns[i].size + 7) & ~size_t(7);
+    }
+
+    m_nullOffset = arenaSize;
+    arenaSize += size_t(m_rowCount) * m_fieldCount;
+
+    m_arena.resize(std::max(arenaSize / sizeof(uint64) + 1, size_t(1)));
+
+    uint32 row = 0;
     while (_NextRow())
     {
-        m_rows[uint32(m_rowPosition)] = new Field[m_fieldCount];
-        for (uint64 fIndex = 0; fIndex < m_fieldCount; ++fIndex)
-        {
-            if (!*m_rBind[fIndex].is_null)
-                m_rows[uint32(m_rowPosition)][fIndex].SetByteValue( m_rBind[fIndex].buffer,
-                                                            m_rBind[fIndex].buffer_length,
-                                                            m_rBind[fIndex].buffer_type,
-                                                           *m_rBind[fIndex].length );
-            else
-                switch (m_rBind[fIndex].buffer_type)
-                {
-                    case MYSQL_TYPE_TINY_BLOB:
-                    case MYSQL_TYPE_MEDIUM_BLOB:
-                    case MYSQL_TYPE_LONG_BLOB:
-                    case MYSQL_TYPE_BLOB:
-                    case MYSQL_TYPE_STRING:
-                    case MYSQL_TYPE_VAR_STRING:
-                    m_rows[uint32(m_rowPosition)][fIndex].SetByteValue( "",
-                                                            m_rBind[fIndex].buffer_length,
-                                                            m_rBind[fIndex].buffer_type,
-                                                           *m_rBind[fIndex].length );
-                    break;
-                    default:
-                    m_rows[uint32(m_rowPosition)][fIndex].SetByteValue( 0,
-                                                            m_rBind[fIndex].buffer_length,
-                                                            m_rBind[fIndex].buffer_type,
-                                                           *m_rBind[fIndex].length );
-                }
-        }
-        m_rowPosition++;
+        StoreRow(row);
+        ++m_rowPosition;
+        ++row;
     }
+
+    // fetching stops early on errors, never show the rows not stored
+    m_rowCount = row;
     m_rowPosition = 0;
 
+    m_currentRow = new Field[m_fieldCount];
+    if (m_rowCount)
+        SetCurrentRow();
+
     /// All data is buffered, let go of mysql c api structures
     CleanUp();
 }
 
+void PreparedResultSet::StoreRow(uint32 row)
+{
+    my_bool* nulls = reinterpret_cast<my_bool*>(reinterpret_cast<char*>(&m_arena[0]) + m_nullOffset) + size_t(row) * m_fieldCount;
+
+    for (uint32 i = 0; i < m_fieldCount; ++i)
+    {
+        nulls[i] = *m_rBind[i].is_null;
+        if (nulls[i])
+            continue;
+
+        char* value = GetValue(row, i);
+        if (!m_columns[i].isString)
+        {
+            memcpy(value, m_rBind[i].buffer, m_columns[i].size);
+            continue;
+        }
+
+        // strings go to the blob, kept null terminated for Field::GetCString()
+        uint32 length = uint32(std::min(*m_rBind[i].length, m_rBind[i].buffer_length ? m_rBind[i].buffer_length - 1 : 0));
+        uint32 offset = uint32(m_strings.size());
+        m_strings.insert(m_strings.end(), static_cast<char*>(m_rBind[i].buffer), static_cast<char*>(m_rBind[i].buffer) + length);
+        m_strings.push_back('\0');
+
+        memcpy(value, &offset, sizeof(uint32));
+        memcpy(value + sizeof(uint32), &length, sizeof(uint32));
+    }
+}
+
+void PreparedResultSet::SetCurrentRow()
+{
+    static char empty[1] = { '\0' };
+
+    uint32 row = uint32(m_rowPosition);
+    my_bool const* nulls = reinterpret_cast<my_bool const*>(reinterpret_cast<char const*>(&m_arena[0]) + m_nullOffset) + size_t(row) * m_fieldCount;
+
+    for (uint32 i = 0; i < m_fieldCount; ++i)
+    {
+        Column const& column = m_columns[i];
+        if (!column.isString)
+        {
+            m_currentRow[i].SetByteValue(nulls[i] ? NULL : GetValue(row, i), column.type, uint32(column.size));
+            continue;
+        }
+
+        // null strings read as empty ones
+        if (nulls[i])
+        {
+            m_currentRow[i].SetByteValue(empty, column.type, 0);
+            continue;
+        }
+
+        uint32 offset, length;
+        memcpy(&offset, GetValue(row, i), sizeof(uint32));
+        memcpy(&length, GetValue(row, i) + sizeof(uint32), sizeof(uint32));
+        m_currentRow[i].SetByteValue(&m_strings[offset], column.type, length);
+    }
+}
+
 ResultSet::~ResultSet()
 {
     CleanUp();
@@ -124,14 +224,23 @@ ResultSet::~ResultSet()
 
 PreparedResultSet::~PreparedResultSet()
 {
-    for (uint32 i = 0; i < uint32(m_rowCount); ++i)
-        delete[] m_rows[i];
+    delete[] m_currentRow;
 }
 
 bool ResultSet::NextRow()
 {
     MYSQL_ROW row;
 
+    if (m_snapshot)
+    {
+        if (!m_snapshot->ReadRow(m_currentRow, m_fieldCount))
+        {
+            CleanUp();
+            return false;
+        }
+        return true;
+    }
+
     if (!m_result)
         return false;
 
@@ -142,8 +251,10 @@ bool ResultSet::NextRow()
         return false;
     }
 
+    // the fields point into the row, valid until the next one is fetched
+    unsigned long* lengths = mysql_fetch_lengths(m_result);
     for (uint32 i = 0; i < m_fieldCount; i++)
-        m_currentRow[i].SetStructuredValue(row[i], m_fields[i].type);
+        m_currentRow[i].SetStructuredValue(row[i], m_fields[i].type, uint32(lengths[i]));
 
     return true;
 }
@@ -155,6 +266,7 @@ bool PreparedResultSet::NextRow()
     if (++m_rowPosition >= m_rowCount)
         return false;
 
+    SetCurrentRow();
     return true;
 }
 
@@ -189,6 +301,9 @@ void ResultSet::CleanUp()
         mysql_free_result(m_result);
         m_result = NULL;
     }
+
+    delete m_snapshot;
+    m_snapshot = NULL;
 }
 
 void PreparedResultSet::CleanUp()
@@ -197,14 +312,10 @@ void PreparedResultSet::CleanUp()
     if (m_res)
         mysql_free_result(m_res);
 
-    FreeBindBuffer();
     mysql_stmt_free_result(m_stmt);
 
     delete[] m_rBind;
-}
-
-void PreparedResultSet::FreeBindBuffer()
-{
-    for (uint32 i = 0; i < m_fieldCount; ++i)
-        free (m_rBind[i].buffer);
+    delete[] m_bindBuffer;
+    m_rBind = NULL;
+    m_bindBuffer = NULL;
 }
@@ -6,6 +6,7 @@
 
 #include "Field.h"
 #include "Log.h"
+#include "ResultSnapshot.h"
 
 #ifdef _WIN32
   #include <winsock2.h>
@@ -14,6 +15,8 @@
 
 class ResultSet
 {
+    friend class ResultSnapshot;
+
     public:
         ResultSet(MYSQL_RES *result, MYSQL_FIELD *fields, uint64 rowCount, uint32 fieldCount);
         ~ResultSet();
@@ -35,13 +38,22 @@ class ResultSet
         uint32 m_fieldCount;
 
     private:
+        //! Reads the rows from a snapshot instead of the server, takes ownership of it
+        ResultSet(ResultSnapshot* snapshot, uint64 rowCount, uint32 fieldCount);
+
         void CleanUp();
         MYSQL_RES *m_result;
         MYSQL_FIELD *m_fields;
+        ResultSnapshot* m_snapshot;
 };
 
 typedef ACE_Refcounted_Auto_Ptr<ResultSet, ACE_Null_Mutex> QueryResult;
 
+/*
+    All rows are buffered in one arena allocated once the row count is known: each column is
+    an array of its fixed width values (strings are an offset and length into one shared blob),
+    followed by the null flags. Fetch() returns the fields of the current row pointing into it.
+*/
 class PreparedResultSet
 {
     public:
@@ -55,31 +67,48 @@ class PreparedResultSet
         Field* Fetch() const
         {
             ASSERT(m_rowPosition < m_rowCount);
-            return m_rows[uint32(m_rowPosition)];
+            return m_currentRow;
         }
 
         const Field & operator [] (uint32 index) const
         {
             ASSERT(m_rowPosition < m_rowCount);
             ASSERT(index < m_fieldCount);
-            return m_rows[uint32(m_rowPosition)][index];
+            return m_currentRow[index];
         }
 
     protected:
         uint64 m_rowCount;
         uint64 m_rowPosition;
-        std::vector<Field*> m_rows;
         uint32 m_fieldCount;
+        Field* m_currentRow;
 
     private:
+        struct Column
+        {
+            size_t offset;                  // of the values in the arena
+            size_t size;                    // of one value, 2 * uint32 for strings
+            enum_field_types type;
+            bool isString;
+        };
+
         MYSQL_BIND* m_rBind;
         MYSQL_STMT* m_stmt;
         MYSQL_RES* m_res;
 
         my_bool* m_isNull;
         unsigned long* m_length;
+        char* m_bindBuffer;
+
+        std::vector<Column> m_columns;
+        std::vector<uint64> m_arena;        // uint64 keeps the columns aligned
+        std::vector<char> m_strings;
+        size_t m_nullOffset;
+
+        char* GetValue(uint32 row, uint32 index) { return reinterpret_cast<char*>(&m_arena[0]) + m_columns[index].offset + row * m_columns[index].size; }
+        void StoreRow(uint32 row);
+        void SetCurrentRow();
 
-        void FreeBindBuffer();
         void CleanUp();
         bool _NextRow();
 
@@ -0,0 +1,163 @@
+#include "ResultSnapshot.h"
+#include "QueryResult.h"
+#include "Log.h"
+
+#include <ace/OS_NS_stdio.h>
+#include <ace/OS_NS_unistd.h>
+
+#define SNAPSHOT_MAGIC      0x4E535841              // "AXSN"
+#define SNAPSHOT_VERSION    1
+#define SNAPSHOT_NULL       0xFFFFFFFF              // length of a NULL value
+
+struct SnapshotHeader
+{
+    uint32 magic;
+    uint32 version;
+    uint32 key;
+    uint32 fieldCount;
+    uint64 rowCount;
+    uint64 size;                                    // of the whole file, tells if it was cut off
+};
+
+// followed by the field types (uint32 each), then for every field of every row
+// its length (uint32) and its text with a terminating zero
+
+ResultSnapshot::ResultSnapshot() : m_position(NULL), m_end(NULL)
+{
+}
+
+ResultSnapshot::~ResultSnapshot()
+{
+}
+
+ResultSet* ResultSnapshot::Load(std::string const& file, uint32 key)
+{
+    ResultSnapshot* snapshot = new ResultSnapshot();
+    if (snapshot->m_map.map(file.c_str(), static_cast<size_t>(-1), O_RDONLY, ACE_DEFAULT_FILE_PERMS, PROT_READ, ACE_MAP_PRIVATE) == -1 ||
+        snapshot->m_map.size() < sizeof(SnapshotHeader))
+    {
+        delete snapshot;
+        return NULL;
+    }
+
+    char const* data = static_cast<char const*>(snapshot->m_map.addr());
+
+    SnapshotHeader header;
+    memcpy(&header, data, sizeof(SnapshotHeader));
+
+    size_t rowsOffset = sizeof(SnapshotHeader) + size_t(header.fieldCount) * sizeof(uint32);
+    if (header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION || header.key != key ||
+        header.size != snapshot->m_map.size() || rowsOffset > header.size)
+    {
+        delete snapshot;
+        return NULL;
+    }
+
+    snapshot->m_types.resize(header.fieldCount);
+    for (uint32 i = 0; i < header.fieldCount; ++i)
+    {
+        uint32 type;
+        memcpy(&type, data + sizeof(SnapshotHeader) + i * sizeof(uint32), sizeof(uint32));
+        snapshot->m_types[i] = enum_field_types(type);
+    }
+
+    snapshot->m_position = data + rowsOffset;
+    snapshot->m_end = data + header.size;
+    return new ResultSet(snapshot, header.rowCount, header.fieldCount);
+}
+
+ResultSet* ResultSnapshot::Save(std::string const& file, uint32 key, ResultSet* result)
+{
+    ResultSnapshot* snapshot = new ResultSnapshot();
+    std::vector<char>& buffer = snapshot->m_buffer;
+
+    SnapshotHeader header;
+    header.magic = SNAPSHOT_MAGIC;
+    header.version = SNAPSHOT_VERSION;
+    header.key = key;
+    header.fieldCount = result->GetFieldCount();
+    header.rowCount = 0;
+
+    size_t rowsOffset = sizeof(SnapshotHeader) + size_t(header.fieldCount) * sizeof(uint32);
+    buffer.resize(rowsOffset);
+
+    snapshot->m_types.resize(header.fieldCount);
+    for (uint32 i = 0; i < header.fieldCount; ++i)
+    {
+        uint32 type = result->m_fields[i].type;
+        snapshot->m_types[i] = result->m_fields[i].type;
+        memcpy(&buffer[sizeof(SnapshotHeader) + i * sizeof(uint32)], &type, sizeof(uint32));
+    }
+
+    while (result->NextRow())
+    {
+        Field* fields = result->Fetch();
+        for (uint32 i = 0; i < header.fieldCount; ++i)
+        {
+            uint32 length = fields[i].data.value ? fields[i].data.length : SNAPSHOT_NULL;
+            size_t offset = buffer.size();
+            buffer.resize(offset + sizeof(uint32) + (fields[i].data.value ? length + 1 : 0));
+            memcpy(&buffer[offset], &length, sizeof(uint32));
+            if (fields[i].data.value)
+            {
+                memcpy(&buffer[offset + sizeof(uint32)], fields[i].data.value, length);
+                buffer[offset + sizeof(uint32) + length] = '\0';
+            }
+        }
+
+        ++header.rowCount;
+    }
+
+    delete result;
+
+    header.size = buffer.size();
+    memcpy(&buffer[0], &header, sizeof(SnapshotHeader));
+
+    // written aside and renamed, so a crash never leaves half a file behind
+    std::string temp = file + ".tmp";
+    bool written = false;
+    if (FILE* out = ACE_OS::fopen(temp.c_str(), "wb"))
+    {
+        written = ACE_OS::fwrite(&buffer[0], 1, buffer.size(), out) == buffer.size();
+        written = ACE_OS::fclose(out) == 0 && written;
+    }
+
+    ACE_OS::unlink(file.c_str());
+    if (!written || ACE_OS::rename(temp.c_str(), file.c_str()) != 0)
+    {
+        sLog->outError("ResultSnapshot: could not write %s, the query will run again next time.", file.c_str());
+        ACE_OS::unlink(temp.c_str());
+    }
+
+    snapshot->m_position = &buffer[0] + rowsOffset;
+    snapshot->m_end = &buffer[0] + buffer.size();
+    return new ResultSet(snapshot, header.rowCount, header.fieldCount);
+}
+
+bool ResultSnapshot::ReadRow(Field* row, uint32 fieldCount)
+{
+    for (uint32 i = 0; i < fieldCount; ++i)
+    {
+        if (size_t(m_end - m_position) < sizeof(uint32))
+            return false;
+
+        uint32 length;
+        memcpy(&length, m_position, sizeof(uint32));
+        m_position += sizeof(uint32);
+
+        if (length == SNAPSHOT_NULL)
+        {
+            row[i].SetStructuredValue(NULL, m_types[i], 0);
+            continue;
+        }
+
+        if (size_t(m_end - m_position) <= length)
+            return false;
+
+        // the values are only read, the mapping itself is read only
+        row[i].SetStructuredValue(const_cast<char*>(m_position), m_types[i], length);
+        m_position += length + 1;
+    }
+
+    return true;
+}
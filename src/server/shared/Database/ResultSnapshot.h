@@ -0,0 +1,48 @@
+#ifndef _RESULTSNAPSHOT_H
+#define _RESULTSNAPSHOT_H
+
+#include "Common.h"
+
+#include <ace/Mem_Map.h>
+
+#ifdef _WIN32
+  #include <winsock2.h>
+#endif
+#include <mysql.h>
+
+class Field;
+class ResultSet;
+
+/*
+    The rows of a query result kept in a file, so they can be read again without asking
+    the database. The file is mapped and the fields point straight into it, with the values
+    in the text format of the server. A file is only used while its key matches the one
+    it was written with (hash of the query and of the live checksums of its tables).
+*/
+class ResultSnapshot
+{
+    friend class ResultSet;
+
+    public:
+        ~ResultSnapshot();
+
+        //! Maps the file, NULL if missing, broken or written for another key
+        static ResultSet* Load(std::string const& file, uint32 key);
+        //! Writes all rows of result to the file, result is consumed and deleted.
+        //! Returns the rows read back from memory, even if the file could not be written.
+        static ResultSet* Save(std::string const& file, uint32 key, ResultSet* result);
+
+    private:
+        ResultSnapshot();
+
+        //! Points row to the next fields, false at the end or if the file is cut off
+        bool ReadRow(Field* row, uint32 fieldCount);
+
+        ACE_Mem_Map m_map;
+        std::vector<char> m_buffer;                         // when not mapped, after Save()
+        char const* m_position;
+        char const* m_end;
+        std::vector<enum_field_types> m_types;
+};
+
+#endif
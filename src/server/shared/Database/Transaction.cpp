@@ -30,6 +30,46 @@ void Transaction::Append(PreparedStatement* stmt)
     m_queries.push_back(data);
 }
 
+void Transaction::GetContent(size_t size, std::string& content) const
+{
+    std::list<SQLElementData>::const_iterator itr = m_queries.begin();
+    std::advance(itr, std::min(size, m_queries.size()));
+
+    for (; itr != m_queries.end(); ++itr)
+    {
+        switch (itr->type)
+        {
+            case SQL_ELEMENT_PREPARED:
+                itr->element.stmt->GetContent(content);
+            break;
+            case SQL_ELEMENT_RAW:
+                // a raw query never contains a nul, it ends the query in the content
+                content.append(itr->element.query);
+                content.push_back('\0');
+            break;
+        }
+    }
+}
+
+void Transaction::Truncate(size_t size)
+{
+    while (m_queries.size() > size)
+    {
+        SQLElementData const &data = m_queries.back();
+        switch (data.type)
+        {
+            case SQL_ELEMENT_PREPARED:
+                delete data.element.stmt;
+            break;
+            case SQL_ELEMENT_RAW:
+                free((void*)(data.element.query));
+            break;
+        }
+
+        m_queries.pop_back();
+    }
+}
+
 void Transaction::Cleanup()
 {
     // This might be called by explicit calls to Cleanup or by the auto-destructor
@@ -57,19 +97,18 @@ void Transaction::Cleanup()
 
 bool TransactionTask::Execute()
 {
-    if (m_conn->ExecuteTransaction(m_trans))
-        return true;
+    bool committed = m_conn->ExecuteTransaction(m_trans);
 
-    if (m_conn->GetLastError() == 1213)
+    if (!committed && m_conn->GetLastError() == 1213)
     {
         uint8 loopBreaker = 5;  // Handle MySQL Errno 1213 without extending deadlock to the core itself
-        for (uint8 i = 0; i < loopBreaker; ++i)
-            if (m_conn->ExecuteTransaction(m_trans))
-                return true;
+        for (uint8 i = 0; i < loopBreaker && !committed; ++i)
+            committed = m_conn->ExecuteTransaction(m_trans);
     }
 
-    // Clean up now.
+    // Clean up now, the caller may keep the transaction to look at its state
     m_trans->Cleanup();
+    m_trans->SetState(committed ? TRANSACTION_COMMITTED : TRANSACTION_FAILED);
 
-    return false;
+    return committed;
 }
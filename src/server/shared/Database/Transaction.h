@@ -3,17 +3,30 @@
 
 #include "SQLOperation.h"
 
+#include <ace/Atomic_Op.h>
+#include <ace/Thread_Mutex.h>
+
+#include <string>
+
 //- Forward declare (don't include header to prevent circular includes)
 class PreparedStatement;
 
+enum TransactionState
+{
+    TRANSACTION_PENDING,
+    TRANSACTION_COMMITTED,
+    TRANSACTION_FAILED
+};
+
 /*! Transactions, high level class. */
 class Transaction
 {
     friend class TransactionTask;
+    template <class T> friend class DatabaseWorkerPool;
     friend class MySQLConnection;
 
     public:
-        Transaction() : _cleanedUp(false) {}
+        Transaction() : _cleanedUp(false), _state(TRANSACTION_PENDING) {}
         ~Transaction() { Cleanup(); }
 
         void Append(PreparedStatement* statement);
@@ -22,12 +35,22 @@ class Transaction
 
         size_t GetSize() const { return m_queries.size(); }
 
+        //! Appends what the queries after the first size ones write to content, equal content writes the same, see Truncate
+        void GetContent(size_t size, std::string& content) const;
+        //! Drops the queries appended after the first size ones, e.g. when they would write what is stored already
+        void Truncate(size_t size);
+
+        //! Set once the transaction has been executed, from the thread that executed it
+        TransactionState GetState() const { return TransactionState(_state.value()); }
+
     protected:
         void Cleanup();
+        void SetState(TransactionState state) { _state = long(state); }
         std::list<SQLElementData> m_queries;
 
     private:
         bool _cleanedUp;
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> _state;
 
 };
 typedef ACE_Refcounted_Auto_Ptr<Transaction, ACE_Thread_Mutex> SQLTransaction;
@@ -0,0 +1,64 @@
+#ifndef AXIUM_FLATSET_H
+#define AXIUM_FLATSET_H
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+/*
+    Set of values kept sorted in one vector. Lookups are a binary search over contiguous
+    memory and iterating is a linear walk, both much cheaper than in a std::set of the
+    same size; inserting or erasing moves the values behind the position. Meant for
+    sets of a few hundred values that are searched far more often than they change.
+
+    Iterators are read only and, like with a vector, invalidated by inserting or erasing.
+*/
+template <class T>
+class FlatSet
+{
+    public:
+        typedef T value_type;
+        typedef typename std::vector<T>::const_iterator iterator;
+        typedef typename std::vector<T>::const_iterator const_iterator;
+        typedef typename std::vector<T>::size_type size_type;
+
+        const_iterator begin() const { return _values.begin(); }
+        const_iterator end() const { return _values.end(); }
+        size_type size() const { return _values.size(); }
+        bool empty() const { return _values.empty(); }
+        void clear() { _values.clear(); }
+        void reserve(size_type size) { _values.reserve(size); }
+
+        const_iterator find(T const& value) const
+        {
+            const_iterator itr = std::lower_bound(_values.begin(), _values.end(), value);
+            return (itr != _values.end() && !(value < *itr)) ? itr : _values.end();
+        }
+
+        size_type count(T const& value) const { return find(value) != end() ? 1 : 0; }
+
+        std::pair<const_iterator, bool> insert(T const& value)
+        {
+            typename std::vector<T>::iterator itr = std::lower_bound(_values.begin(), _values.end(), value);
+            if (itr != _values.end() && !(value < *itr))
+                return std::make_pair(const_iterator(itr), false);
+
+            itr = _values.insert(itr, value);
+            return std::make_pair(const_iterator(itr), true);
+        }
+
+        size_type erase(T const& value)
+        {
+            typename std::vector<T>::iterator itr = std::lower_bound(_values.begin(), _values.end(), value);
+            if (itr == _values.end() || value < *itr)
+                return 0;
+
+            _values.erase(itr);
+            return 1;
+        }
+
+    private:
+        std::vector<T> _values;
+};
+
+#endif
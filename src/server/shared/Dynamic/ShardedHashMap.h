@@ -0,0 +1,79 @@
+#ifndef AXIUM_SHARDEDHASHMAP_H
+#define AXIUM_SHARDEDHASHMAP_H
+
+#include "Common.h"
+#include "UnorderedMap.h"
+
+#include <ace/RW_Thread_Mutex.h>
+
+/*
+    Map of guids to objects, split into SHARDS parts with a lock each. Threads looking
+    up different guids mostly take different locks, which only share a cache line with
+    nothing else. Iterating means visiting the shards one by one under their own lock.
+*/
+template <class T, uint32 SHARDS>
+class ShardedHashMap
+{
+    typedef char ShardCountMustBePowerOfTwo[(SHARDS & (SHARDS - 1)) == 0 ? 1 : -1];
+
+    public:
+
+        typedef UNORDERED_MAP<uint64, T*> MapType;
+        typedef ACE_RW_Thread_Mutex LockType;
+
+        void Insert(uint64 guid, T* o)
+        {
+            Shard& shard = _shards[GetShardIndex(guid)];
+            AXIUM_WRITE_GUARD(LockType, shard.lock);
+            shard.objects[guid] = o;
+        }
+
+        void Remove(uint64 guid)
+        {
+            Shard& shard = _shards[GetShardIndex(guid)];
+            AXIUM_WRITE_GUARD(LockType, shard.lock);
+            shard.objects.erase(guid);
+        }
+
+        T* Find(uint64 guid)
+        {
+            Shard& shard = _shards[GetShardIndex(guid)];
+            AXIUM_READ_GUARD(LockType, shard.lock);
+            typename MapType::const_iterator itr = shard.objects.find(guid);
+            return (itr != shard.objects.end()) ? itr->second : NULL;
+        }
+
+        size_t Size()
+        {
+            size_t size = 0;
+            for (uint32 i = 0; i < SHARDS; ++i)
+            {
+                AXIUM_READ_GUARD(LockType, _shards[i].lock);
+                size += _shards[i].objects.size();
+            }
+            return size;
+        }
+
+        MapType& GetContainer(uint32 shard) { return _shards[shard].objects; }
+
+        LockType* GetLock(uint32 shard) { return &_shards[shard].lock; }
+
+        static uint32 GetShardIndex(uint64 guid)
+        {
+            // the counter is in the low part, fold the high part in for keys that are not guids
+            return (uint32(guid) ^ uint32(guid >> 32)) & (SHARDS - 1);
+        }
+
+    private:
+
+        struct Shard
+        {
+            LockType lock;
+            MapType objects;
+            char pad[64];                                   // keeps the locks of neighbour shards on different cache lines
+        };
+
+        Shard _shards[SHARDS];
+};
+
+#endif
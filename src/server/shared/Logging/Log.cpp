@@ -2,6 +2,7 @@
 #include "Log.h"
 #include "Configuration/Config.h"
 #include "Util.h"
+#include "Timer.h"
 
 #include "Implementation/LoginDatabase.h" // For authserver logging
 extern LoginDatabaseWorkerPool LoginDatabase;
@@ -12,17 +13,133 @@ extern LogDatabaseWorkerPool LogDatabase;
 #include <stdarg.h>
 #include <stdio.h>
 
+#include <ace/Task.h>
+#include <ace/TSS_T.h>
+#include <ace/OS_NS_unistd.h>
+
+#include <algorithm>
+
+/// Single producer (owning thread), single consumer (log writer) ring of lines
+class LogRing
+{
+    public:
+        explicit LogRing() : m_owner(sLog), m_size(sLog->m_ringSize), m_head(0), m_tail(0), m_dropped(0)
+        {
+            m_data = new char[m_size];
+            m_owner->RegisterRing(this);
+        }
+
+        ~LogRing()
+        {
+            // writes what is left, unless the log went first at exit
+            if (m_owner)
+                m_owner->UnregisterRing(this);
+
+            delete[] m_data;
+        }
+
+        bool Push(LogMessage const& message, char const* text)
+        {
+            unsigned long head = (unsigned long)m_head.value();
+            unsigned long used = head - (unsigned long)m_tail.value();
+            if (used + sizeof(LogMessage) + message.length > m_size)
+                return false;
+
+            CopyIn(head, (char const*)&message, sizeof(LogMessage));
+            CopyIn(head + sizeof(LogMessage), text, message.length);
+            m_head = long(head + sizeof(LogMessage) + message.length);     // publishes the line
+            return true;
+        }
+
+    private:
+        friend class Log;
+
+        void CopyIn(unsigned long position, char const* data, uint32 length)
+        {
+            uint32 offset = uint32(position & (m_size - 1));
+            uint32 first = std::min(length, m_size - offset);
+            memcpy(m_data + offset, data, first);
+            memcpy(m_data, data + first, length - first);
+        }
+
+        void CopyOut(unsigned long position, char* data, uint32 length) const
+        {
+            uint32 offset = uint32(position & (m_size - 1));
+            uint32 first = std::min(length, m_size - offset);
+            memcpy(data, m_data + offset, first);
+            memcpy(data + first, m_data, length - first);
+        }
+
+        Log* m_owner;
+        char* m_data;
+        uint32 m_size;
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_head;
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_tail;
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_dropped;
+};
+
+typedef ACE_TSS<LogRing> LogRingTSS;
+static LogRingTSS logRing;
+
+class LogWriter : protected ACE_Task_Base
+{
+    public:
+        explicit LogWriter(Log* log) : m_log(log), m_stop(false)
+        {
+            activate();
+        }
+
+        void Stop()
+        {
+            m_stop = true;
+            wait();
+        }
+
+    private:
+        int svc()
+        {
+            while (!m_stop)
+            {
+                ACE_OS::sleep(ACE_Time_Value(0, m_log->m_writeInterval * 1000));
+                m_log->Flush();
+            }
+
+            return 0;
+        }
+
+        Log* m_log;
+        volatile bool m_stop;
+};
+
 Log::Log() :
     raLogfile(NULL), logfile(NULL), gmLogfile(NULL), charLogfile(NULL),
     dberLogfile(NULL), chatLogfile(NULL), arenaLogFile(NULL), sqlLogFile(NULL), sqlDevLogFile(NULL), wardenLogFile(NULL),
-    m_gmlog_per_account(false), m_enableLogDBLater(false),
-    m_enableLogDB(false), m_colored(false)
+    benchmarkLogFile(NULL), m_gmlog_per_account(false), m_enableLogDBLater(false),
+    m_enableLogDB(false), m_colored(false), m_writer(NULL), m_ringSize(0), m_writeInterval(0), m_benchmarkAsync(false),
+    m_sequence(0), m_dropped(0)
 {
     Initialize();
 }
 
 Log::~Log()
 {
+    if (m_writer)
+    {
+        m_writer->Stop();
+        delete m_writer;
+        m_writer = NULL;
+    }
+
+    {
+        AXIUM_GUARD(ACE_Recursive_Thread_Mutex, m_ringLock);
+        WriteBuffered();
+
+        // rings of threads still running outlive the log
+        for (size_t i = 0; i < m_rings.size(); ++i)
+            m_rings[i]->m_owner = NULL;
+        m_rings.clear();
+    }
+
     if ( logfile != NULL )
         fclose(logfile);
     logfile = NULL;
@@ -166,6 +283,17 @@ void Log::Initialize()
 
     m_DebugLogMask = DebugLogFilters(ConfigMgr::GetIntDefault("DebugLogMask", LOG_FILTER_NONE));
 
+    // Asynchronous writing, the ring size is rounded up to a power of two
+    uint32 ringSize = std::max(ConfigMgr::GetIntDefault("Log.BufferSize", 64), 4) * 1024;
+    m_ringSize = 1;
+    while (m_ringSize < ringSize)
+        m_ringSize <<= 1;
+
+    m_writeInterval = std::max(ConfigMgr::GetIntDefault("Log.WriteInterval", 10), 1);
+
+    if (ConfigMgr::GetBoolDefault("Log.Async", true) && !m_writer)
+        m_writer = new LogWriter(this);
+
     // Char log settings
     m_charLog_Dump = ConfigMgr::GetBoolDefault("CharLogDump", false);
     m_charLog_Dump_Separate = ConfigMgr::GetBoolDefault("CharLogDump.Separate", false);
@@ -217,7 +345,11 @@ FILE* Log::openGmlogPerAccount(uint32 account)
 
 void Log::outTimestamp(FILE* file)
 {
-    time_t t = time(NULL);
+    outTimestamp(file, time(NULL));
+}
+
+void Log::outTimestamp(FILE* file, time_t t)
+{
     tm* aTm = localtime(&t);
     //       YYYY   year
     //       MM     month (2 digits 01-12)
@@ -356,299 +488,458 @@ std::string Log::GetTimestampStr()
     return std::string(buf);
 }
 
-void Log::outDB(LogTypes type, const char * str)
+void Log::RegisterRing(LogRing* ring)
 {
-    if (!str || type >= MAX_LOG_TYPES)
-        return;
+    AXIUM_GUARD(ACE_Recursive_Thread_Mutex, m_ringLock);
+    m_rings.push_back(ring);
+}
 
-    std::string logStr(str);
-    if (logStr.empty())
-        return;
+void Log::UnregisterRing(LogRing* ring)
+{
+    AXIUM_GUARD(ACE_Recursive_Thread_Mutex, m_ringLock);
+    WriteBuffered();
+    m_rings.erase(std::remove(m_rings.begin(), m_rings.end(), ring), m_rings.end());
+}
 
-    PreparedStatement* stmt = LogDatabase.GetPreparedStatement(LOG_INS_ERROR_LOG);
+struct BufferedLogLine
+{
+    LogMessage message;
+    std::string text;
 
-    stmt->setUInt8(0, type);
-    stmt->setString(1, logStr);
+    bool operator<(BufferedLogLine const& right) const
+    {
+        // the sequence may wrap around
+        return long(message.sequence - right.message.sequence) < 0;
+    }
+};
 
-    LogDatabase.Execute(stmt);
+void Log::Flush()
+{
+    AXIUM_GUARD(ACE_Recursive_Thread_Mutex, m_ringLock);
+    WriteBuffered();
 }
 
-void Log::outString(const char * str, ...)
+void Log::WriteBuffered()
 {
-    if (!str)
-        return;
+    std::vector<BufferedLogLine> lines;
+    uint32 dropped = 0;
 
-    if (m_enableLogDB && m_dbLogLevel > LOGL_NORMAL)
+    for (size_t i = 0; i < m_rings.size(); ++i)
     {
-        // we don't want empty strings in the DB
-        std::string s(str);
-        if (s.empty() || s == " ")
-            return;
+        LogRing& ring = *m_rings[i];
 
-        va_list ap2;
-        va_start(ap2, str);
-        char nnew_str[MAX_QUERY_LEN];
-        vsnprintf(nnew_str, MAX_QUERY_LEN, str, ap2);
-        outDB(LOG_TYPE_STRING, nnew_str);
-        va_end(ap2);
-    }
+        unsigned long tail = (unsigned long)ring.m_tail.value();
+        unsigned long head = (unsigned long)ring.m_head.value();
 
-    if (m_colored)
-        SetColor(true, m_colors[LOGL_NORMAL]);
+        while (tail != head)
+        {
+            lines.resize(lines.size() + 1);
+            BufferedLogLine& line = lines.back();
 
-    va_list ap;
+            ring.CopyOut(tail, (char*)&line.message, sizeof(LogMessage));
+            line.text.resize(line.message.length);
+            if (line.message.length)
+                ring.CopyOut(tail + sizeof(LogMessage), &line.text[0], line.message.length);
 
-    va_start(ap, str);
-    vutf8printf(stdout, str, &ap);
-    va_end(ap);
+            tail += sizeof(LogMessage) + line.message.length;
+        }
+
+        ring.m_tail = long(tail);
+
+        if (long ringDropped = ring.m_dropped.value())
+        {
+            dropped += uint32(ringDropped);
+            ring.m_dropped -= ringDropped;
+        }
+    }
 
-    if (m_colored)
-        ResetColor(true);
+    if (lines.empty() && !dropped)
+        return;
+
+    std::sort(lines.begin(), lines.end());
 
-    printf("\n");
-    if (logfile)
+    SQLTransaction trans;
+    for (size_t i = 0; i < lines.size(); ++i)
     {
-        outTimestamp(logfile);
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
-        va_end(ap);
+        LogMessage const& message = lines[i].message;
+        Write(message, lines[i].text.c_str(), false);
+
+        if (message.db < MAX_LOG_TYPES && !lines[i].text.empty())
+        {
+            if (trans.null())
+                trans = LogDatabase.BeginTransaction();
 
-        fflush(logfile);
+            PreparedStatement* stmt = LogDatabase.GetPreparedStatement(LOG_INS_ERROR_LOG);
+            stmt->setUInt8(0, message.db);
+            stmt->setString(1, lines[i].text);
+            trans->Append(stmt);
+        }
     }
-    fflush(stdout);
-}
 
-void Log::outString()
-{
-    printf("\n");
-    if (logfile)
+    if (!trans.null())
+        LogDatabase.CommitTransaction(trans);
+
+    if (dropped)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "\n");
-        fflush(logfile);
+        m_dropped += dropped;
+        if (logfile)
+        {
+            outTimestamp(logfile);
+            fprintf(logfile, "ERROR: %u log lines dropped, a thread logged more than Log.BufferSize in Log.WriteInterval\n", dropped);
+        }
     }
-    fflush(stdout);
+
+    FlushFiles();
 }
 
-void Log::outCrash(const char * err, ...)
+void Log::FlushFiles()
 {
-    if (!err)
-        return;
+    FILE* files[] = { logfile, gmLogfile, charLogfile, dberLogfile, raLogfile, chatLogfile, castLogfile, arenaLogFile,
+        sqlLogFile, sqlDevLogFile, wardenLogFile, benchmarkLogFile, stdout, stderr };
 
-    if (m_enableLogDB)
-    {
-        va_list ap2;
-        va_start(ap2, err);
-        char nnew_str[MAX_QUERY_LEN];
-        vsnprintf(nnew_str, MAX_QUERY_LEN, err, ap2);
-        outDB(LOG_TYPE_CRASH, nnew_str);
-        va_end(ap2);
-    }
+    for (uint8 i = 0; i < sizeof(files) / sizeof(files[0]); ++i)
+        if (files[i])
+            fflush(files[i]);
+}
 
-    if (m_colored)
-        SetColor(false, LRED);
+void Log::Post(LogMessageType type, LogTypes db, bool local, uint32 account, const char* format, va_list ap)
+{
+    char text[MAX_QUERY_LEN];
+    vsnprintf(text, MAX_QUERY_LEN, format, ap);
+
+    LogMessage message;
+    message.type = type;
+    message.db = db;
+    message.local = local;
+    message.account = account;
+    message.length = uint32(strlen(text));
+    message.time = time(NULL);
+
+    Post(message, text);
+}
 
-    va_list ap;
+void Log::Post(LogMessage& message, const char* text)
+{
+    if (m_writer && (message.type != LOG_MESSAGE_BENCHMARK || m_benchmarkAsync))
+    {
+        message.sequence = (unsigned long)(m_sequence++);
 
-    va_start(ap, err);
-    vutf8printf(stderr, err, &ap);
-    va_end(ap);
+        LogRing* ring = logRing;
+        if (ring && ring->Push(message, text))
+            return;
+
+        switch (message.type)
+        {
+            // must not be lost, make room by writing what all threads buffered
+            case LOG_MESSAGE_ERROR:
+            case LOG_MESSAGE_CRASH:
+            case LOG_MESSAGE_ERROR_DB:
+            case LOG_MESSAGE_COMMAND:
+            case LOG_MESSAGE_REMOTE:
+            case LOG_MESSAGE_SQL_DRIVER:
+                break;
+            default:
+                if (ring)
+                    ++ring->m_dropped;
+                return;
+        }
 
-    if (m_colored)
-        ResetColor(false);
+        AXIUM_GUARD(ACE_Recursive_Thread_Mutex, m_ringLock);
+        WriteBuffered();
 
-    fprintf(stderr, "\n");
-    if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "CRASH ALERT: ");
+        if (ring && ring->Push(message, text))
+        {
+            WriteBuffered();
+            return;
+        }
 
-        va_start(ap, err);
-        vfprintf(logfile, err, ap);
-        va_end(ap);
+        // larger than the ring, still behind everything buffered before it
+        Write(message, text, true);
 
-        fprintf(logfile, "\n");
-        fflush(logfile);
+        if (message.db < MAX_LOG_TYPES)
+            WriteDB(LogTypes(message.db), text);
+        return;
     }
-    fflush(stderr);
+
+    Write(message, text, true);
+
+    if (message.db < MAX_LOG_TYPES)
+        WriteDB(LogTypes(message.db), text);
 }
 
-void Log::outError(const char * err, ...)
+void Log::WriteDB(LogTypes type, const char* text)
 {
-    if (!err)
+    if (!*text)
         return;
 
-    if (m_enableLogDB)
-    {
-        va_list ap2;
-        va_start(ap2, err);
-        char nnew_str[MAX_QUERY_LEN];
-        vsnprintf(nnew_str, MAX_QUERY_LEN, err, ap2);
-        outDB(LOG_TYPE_ERROR, nnew_str);
-        va_end(ap2);
-    }
+    PreparedStatement* stmt = LogDatabase.GetPreparedStatement(LOG_INS_ERROR_LOG);
 
-    if (m_colored)
-        SetColor(false, LRED);
+    stmt->setUInt8(0, type);
+    stmt->setString(1, text);
 
-    va_list ap;
+    LogDatabase.Execute(stmt);
+}
 
-    va_start(ap, err);
-    vutf8printf(stderr, err, &ap);
-    va_end(ap);
+void Log::WriteLine(FILE* file, LogMessage const& message, const char* prefix, const char* text, bool timestamp, bool flush)
+{
+    if (!file)
+        return;
 
-    if (m_colored)
-        ResetColor(false);
+    if (timestamp)
+        outTimestamp(file, message.time);
 
-    fprintf( stderr, "\n");
-    if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR: ");
+    fprintf(file, "%s%s%s", prefix, text, timestamp ? "\n" : "");
 
-        va_start(ap, err);
-        vfprintf(logfile, err, ap);
-        va_end(ap);
+    if (flush)
+        fflush(file);
+}
 
-        fprintf(logfile, "\n");
-        fflush(logfile);
-    }
-    fflush(stderr);
+void Log::WriteConsole(bool stdout_stream, ColorTypes color, bool colored, const char* text, bool newline, bool flush)
+{
+    FILE* out = stdout_stream ? stdout : stderr;
+
+    if (colored)
+        SetColor(stdout_stream, color);
+
+    utf8printf(out, "%s", text);
+
+    if (colored)
+        ResetColor(stdout_stream);
+
+    if (newline)
+        fprintf(out, "\n");
+
+    if (flush)
+        fflush(out);
 }
 
-void Log::outArena(const char * str, ...)
+void Log::Write(LogMessage const& message, const char* text, bool flush)
 {
-    if (!str)
+    if (!message.local)
         return;
 
-    if (arenaLogFile)
+    switch (message.type)
     {
-        va_list ap;
-        outTimestamp(arenaLogFile);
-        va_start(ap, str);
-        vfprintf(arenaLogFile, str, ap);
-        fprintf(arenaLogFile, "\n");
-        va_end(ap);
-        fflush(arenaLogFile);
+        case LOG_MESSAGE_STRING:
+            WriteConsole(true, m_colors[LOGL_NORMAL], m_colored && message.length, text, true, flush);
+            WriteLine(logfile, message, "", text, true, flush);
+            break;
+        case LOG_MESSAGE_STRING_INLINE:
+        case LOG_MESSAGE_DEBUG_INLINE:
+            WriteConsole(true, WHITE, false, text, false, flush);
+            WriteLine(logfile, message, "", text, false, flush);
+            break;
+        case LOG_MESSAGE_ERROR:
+            WriteConsole(false, LRED, m_colored, text, true, flush);
+            WriteLine(logfile, message, "ERROR: ", text, true, flush);
+            break;
+        case LOG_MESSAGE_CRASH:
+            WriteConsole(false, LRED, m_colored, text, true, flush);
+            WriteLine(logfile, message, "CRASH ALERT: ", text, true, flush);
+            break;
+        case LOG_MESSAGE_BASIC:
+            WriteConsole(true, m_colors[LOGL_BASIC], m_colored, text, true, flush);
+            WriteLine(logfile, message, "", text, true, flush);
+            break;
+        case LOG_MESSAGE_DETAIL:
+            WriteConsole(true, m_colors[LOGL_DETAIL], m_colored, text, true, flush);
+            WriteLine(logfile, message, "", text, true, flush);
+            break;
+        case LOG_MESSAGE_DEBUG:
+            WriteConsole(true, m_colors[LOGL_DEBUG], m_colored, text, true, flush);
+            WriteLine(logfile, message, "", text, true, flush);
+            break;
+        case LOG_MESSAGE_SQL_DRIVER:
+            WriteConsole(true, WHITE, false, text, true, flush);
+            WriteLine(sqlLogFile, message, "", text, true, flush);
+            break;
+        case LOG_MESSAGE_SQL_DEV:
+            WriteConsole(true, WHITE, false, text, true, flush);
+            WriteLine(sqlDevLogFile, message, "", text, false, false);
+            WriteLine(sqlDevLogFile, message, "", "\n", false, flush);
+            break;
+        case LOG_MESSAGE_ERROR_DB:
+            WriteConsole(false, LRED, m_colored, text, true, flush);
+            WriteLine(logfile, message, "ERROR: ", text, true, flush);
+            WriteLine(dberLogfile, message, "", text, true, flush);
+            break;
+        case LOG_MESSAGE_COMMAND:
+            if (m_logLevel > LOGL_NORMAL)
+            {
+                WriteConsole(true, m_colors[LOGL_BASIC], m_colored, text, true, flush);
+                WriteLine(logfile, message, "", text, true, flush);
+            }
+
+            if (m_gmlog_per_account)
+            {
+                if (FILE* per_file = openGmlogPerAccount(message.account))
+                {
+                    WriteLine(per_file, message, "", text, true, false);
+                    fclose(per_file);
+                }
+            }
+            else
+                WriteLine(gmLogfile, message, "", text, true, flush);
+            break;
+        case LOG_MESSAGE_CHAR:
+            WriteLine(charLogfile, message, "", text, true, flush);
+            break;
+        case LOG_MESSAGE_REMOTE:
+            WriteLine(raLogfile, message, "", text, true, flush);
+            break;
+        case LOG_MESSAGE_CHAT:
+            WriteLine(chatLogfile, message, "", text, true, flush);
+            break;
+        case LOG_MESSAGE_CAST:
+            WriteLine(castLogfile, message, "", text, true, flush);
+            break;
+        case LOG_MESSAGE_ARENA:
+            WriteLine(arenaLogFile, message, "", text, true, flush);
+            break;
+        case LOG_MESSAGE_WARDEN:
+            WriteLine(wardenLogFile, message, "", text, true, flush);
+            break;
+        case LOG_MESSAGE_BENCHMARK:
+            WriteLine(benchmarkLogFile, message, "", text, true, flush);
+            break;
+        default:
+            break;
     }
 }
 
-void Log::outSQLDriver(const char* str, ...)
+void Log::outDB(LogTypes type, const char * str)
 {
-    if (!str)
+    if (!str || type >= MAX_LOG_TYPES || !*str)
         return;
 
-    va_list ap;
-    va_start(ap, str);
-    vutf8printf(stdout, str, &ap);
-    va_end(ap);
+    LogMessage message;
+    message.type = LOG_MESSAGE_DB;
+    message.db = type;
+    message.local = false;
+    message.account = 0;
+    message.length = uint32(strlen(str));
+    message.time = time(NULL);
 
-    printf("\n");
+    Post(message, str);
+}
 
-    if (sqlLogFile)
-    {
-        outTimestamp(sqlLogFile);
+void Log::outString(const char * str, ...)
+{
+    if (!str)
+        return;
 
-        va_list apSQL;
-        va_start(apSQL, str);
-        vfprintf(sqlLogFile, str, apSQL);
-        va_end(apSQL);
+    bool db = m_enableLogDB && m_dbLogLevel > LOGL_NORMAL;
 
-        fprintf(sqlLogFile, "\n");
-        fflush(sqlLogFile);
-    }
+    // we don't want empty strings in the DB
+    if (db && (!*str || !strcmp(str, " ")))
+        return;
 
-    fflush(stdout);
+    va_list ap;
+    va_start(ap, str);
+    Post(LOG_MESSAGE_STRING, db ? LOG_TYPE_STRING : MAX_LOG_TYPES, true, 0, str, ap);
+    va_end(ap);
 }
 
-void Log::outErrorDb(const char * err, ...)
+void Log::outString()
+{
+    LogMessage message;
+    message.type = LOG_MESSAGE_STRING;
+    message.db = MAX_LOG_TYPES;
+    message.local = true;
+    message.account = 0;
+    message.length = 0;
+    message.time = time(NULL);
+
+    Post(message, "");
+}
+
+void Log::outCrash(const char * err, ...)
 {
     if (!err)
         return;
 
-    if (m_colored)
-        SetColor(false, LRED);
+    // everything logged before first, the process may not get much further
+    if (m_writer)
+        Flush();
 
+    char text[MAX_QUERY_LEN];
     va_list ap;
-
     va_start(ap, err);
-    vutf8printf(stderr, err, &ap);
+    vsnprintf(text, MAX_QUERY_LEN, err, ap);
     va_end(ap);
 
-    if (m_colored)
-        ResetColor(false);
+    LogMessage message;
+    message.type = LOG_MESSAGE_CRASH;
+    message.db = MAX_LOG_TYPES;
+    message.local = true;
+    message.account = 0;
+    message.length = uint32(strlen(text));
+    message.time = time(NULL);
 
-    fprintf( stderr, "\n" );
+    Write(message, text, true);
 
-    if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR: " );
+    if (m_enableLogDB)
+        WriteDB(LOG_TYPE_CRASH, text);
+}
 
-        va_start(ap, err);
-        vfprintf(logfile, err, ap);
-        va_end(ap);
+void Log::outError(const char * err, ...)
+{
+    if (!err)
+        return;
 
-        fprintf(logfile, "\n" );
-        fflush(logfile);
-    }
+    va_list ap;
+    va_start(ap, err);
+    Post(LOG_MESSAGE_ERROR, m_enableLogDB ? LOG_TYPE_ERROR : MAX_LOG_TYPES, true, 0, err, ap);
+    va_end(ap);
+}
 
-    if (dberLogfile)
-    {
-        outTimestamp(dberLogfile);
-        va_start(ap, err);
-        vfprintf(dberLogfile, err, ap);
-        va_end(ap);
+void Log::outArena(const char * str, ...)
+{
+    if (!str || !arenaLogFile)
+        return;
 
-        fprintf(dberLogfile, "\n" );
-        fflush(dberLogfile);
-    }
-    fflush(stderr);
+    va_list ap;
+    va_start(ap, str);
+    Post(LOG_MESSAGE_ARENA, MAX_LOG_TYPES, true, 0, str, ap);
+    va_end(ap);
 }
 
-void Log::outBasic(const char * str, ...)
+void Log::outSQLDriver(const char* str, ...)
 {
     if (!str)
         return;
 
-    if (m_enableLogDB && m_dbLogLevel > LOGL_NORMAL)
-    {
-        va_list ap2;
-        va_start(ap2, str);
-        char nnew_str[MAX_QUERY_LEN];
-        vsnprintf(nnew_str, MAX_QUERY_LEN, str, ap2);
-        outDB(LOG_TYPE_BASIC, nnew_str);
-        va_end(ap2);
-    }
+    va_list ap;
+    va_start(ap, str);
+    Post(LOG_MESSAGE_SQL_DRIVER, MAX_LOG_TYPES, true, 0, str, ap);
+    va_end(ap);
+}
 
-    if (m_logLevel > LOGL_NORMAL)
-    {
-        if (m_colored)
-            SetColor(true, m_colors[LOGL_BASIC]);
+void Log::outErrorDb(const char * err, ...)
+{
+    if (!err)
+        return;
 
-        va_list ap;
-        va_start(ap, str);
-        vutf8printf(stdout, str, &ap);
-        va_end(ap);
+    va_list ap;
+    va_start(ap, err);
+    Post(LOG_MESSAGE_ERROR_DB, MAX_LOG_TYPES, true, 0, err, ap);
+    va_end(ap);
+}
 
-        if (m_colored)
-            ResetColor(true);
+void Log::outBasic(const char * str, ...)
+{
+    if (!str)
+        return;
 
-        printf("\n");
+    bool db = m_enableLogDB && m_dbLogLevel > LOGL_NORMAL;
+    bool local = m_logLevel > LOGL_NORMAL;
+    if (!db && !local)
+        return;
 
-        if (logfile)
-        {
-            outTimestamp(logfile);
-            va_list ap2;
-            va_start(ap2, str);
-            vfprintf(logfile, str, ap2);
-            fprintf(logfile, "\n" );
-            va_end(ap2);
-            fflush(logfile);
-        }
-    }
-    fflush(stdout);
+    va_list ap;
+    va_start(ap, str);
+    Post(LOG_MESSAGE_BASIC, db ? LOG_TYPE_BASIC : MAX_LOG_TYPES, local, 0, str, ap);
+    va_end(ap);
 }
 
 void Log::outDetail(const char * str, ...)
@@ -656,70 +947,26 @@ void Log::outDetail(const char * str, ...)
     if (!str)
         return;
 
-    if (m_enableLogDB && m_dbLogLevel > LOGL_BASIC)
-    {
-        va_list ap2;
-        va_start(ap2, str);
-        char nnew_str[MAX_QUERY_LEN];
-        vsnprintf(nnew_str, MAX_QUERY_LEN, str, ap2);
-        outDB(LOG_TYPE_DETAIL, nnew_str);
-        va_end(ap2);
-    }
-
-    if (m_logLevel > LOGL_BASIC)
-    {
-        if (m_colored)
-            SetColor(true, m_colors[LOGL_DETAIL]);
-
-        va_list ap;
-        va_start(ap, str);
-        vutf8printf(stdout, str, &ap);
-        va_end(ap);
-
-        if (m_colored)
-            ResetColor(true);
-
-        printf("\n");
-
-        if (logfile)
-        {
-            outTimestamp(logfile);
-            va_list ap2;
-            va_start(ap2, str);
-            vfprintf(logfile, str, ap2);
-            va_end(ap2);
-
-            fprintf(logfile, "\n");
-            fflush(logfile);
-        }
-    }
+    bool db = m_enableLogDB && m_dbLogLevel > LOGL_BASIC;
+    bool local = m_logLevel > LOGL_BASIC;
+    if (!db && !local)
+        return;
 
-    fflush(stdout);
+    va_list ap;
+    va_start(ap, str);
+    Post(LOG_MESSAGE_DETAIL, db ? LOG_TYPE_DETAIL : MAX_LOG_TYPES, local, 0, str, ap);
+    va_end(ap);
 }
 
 void Log::outDebugInLine(const char * str, ...)
 {
-    if (!str)
+    if (!str || m_logLevel <= LOGL_DETAIL)
         return;
 
-    if (m_logLevel > LOGL_DETAIL)
-    {
-        va_list ap;
-        va_start(ap, str);
-        vutf8printf(stdout, str, &ap);
-        va_end(ap);
-
-        //if (m_colored)
-        //    ResetColor(true);
-
-        if (logfile)
-        {
-            va_list ap2;
-            va_start(ap2, str);
-            vfprintf(logfile, str, ap2);
-            va_end(ap2);
-        }
-    }
+    va_list ap;
+    va_start(ap, str);
+    Post(LOG_MESSAGE_DEBUG_INLINE, MAX_LOG_TYPES, true, 0, str, ap);
+    va_end(ap);
 }
 
 void Log::outSQLDev(const char* str, ...)
@@ -729,23 +976,8 @@ void Log::outSQLDev(const char* str, ...)
 
     va_list ap;
     va_start(ap, str);
-    vutf8printf(stdout, str, &ap);
+    Post(LOG_MESSAGE_SQL_DEV, MAX_LOG_TYPES, true, 0, str, ap);
     va_end(ap);
-
-    printf("\n");
-
-    if (sqlDevLogFile)
-    {
-        va_list ap2;
-        va_start(ap2, str);
-        vfprintf(sqlDevLogFile, str, ap2);
-        va_end(ap2);
-
-        fprintf(sqlDevLogFile, "\n");
-        fflush(sqlDevLogFile);
-    }
-
-    fflush(stdout);
 }
 
 void Log::outDebug(DebugLogFilters f, const char * str, ...)
@@ -756,44 +988,15 @@ void Log::outDebug(DebugLogFilters f, const char * str, ...)
     if (!str)
         return;
 
-    if (m_enableLogDB && m_dbLogLevel > LOGL_DETAIL)
-    {
-        va_list ap2;
-        va_start(ap2, str);
-        char nnew_str[MAX_QUERY_LEN];
-        vsnprintf(nnew_str, MAX_QUERY_LEN, str, ap2);
-        outDB(LOG_TYPE_DEBUG, nnew_str);
-        va_end(ap2);
-    }
-
-    if ( m_logLevel > LOGL_DETAIL )
-    {
-        if (m_colored)
-            SetColor(true, m_colors[LOGL_DEBUG]);
-
-        va_list ap;
-        va_start(ap, str);
-        vutf8printf(stdout, str, &ap);
-        va_end(ap);
-
-        if (m_colored)
-            ResetColor(true);
-
-        printf( "\n" );
-
-        if (logfile)
-        {
-            outTimestamp(logfile);
-            va_list ap2;
-            va_start(ap2, str);
-            vfprintf(logfile, str, ap2);
-            va_end(ap2);
+    bool db = m_enableLogDB && m_dbLogLevel > LOGL_DETAIL;
+    bool local = m_logLevel > LOGL_DETAIL;
+    if (!db && !local)
+        return;
 
-            fprintf(logfile, "\n" );
-            fflush(logfile);
-        }
-    }
-    fflush(stdout);
+    va_list ap;
+    va_start(ap, str);
+    Post(LOG_MESSAGE_DEBUG, db ? LOG_TYPE_DEBUG : MAX_LOG_TYPES, local, 0, str, ap);
+    va_end(ap);
 }
 
 void Log::outStaticDebug(const char * str, ...)
@@ -801,44 +1004,15 @@ void Log::outStaticDebug(const char * str, ...)
     if (!str)
         return;
 
-    if (m_enableLogDB && m_dbLogLevel > LOGL_DETAIL)
-    {
-        va_list ap2;
-        va_start(ap2, str);
-        char nnew_str[MAX_QUERY_LEN];
-        vsnprintf(nnew_str, MAX_QUERY_LEN, str, ap2);
-        outDB(LOG_TYPE_DEBUG, nnew_str);
-        va_end(ap2);
-    }
-
-    if ( m_logLevel > LOGL_DETAIL )
-    {
-        if (m_colored)
-            SetColor(true, m_colors[LOGL_DEBUG]);
-
-        va_list ap;
-        va_start(ap, str);
-        vutf8printf(stdout, str, &ap);
-        va_end(ap);
-
-        if (m_colored)
-            ResetColor(true);
-
-        printf( "\n" );
-
-        if (logfile)
-        {
-            outTimestamp(logfile);
-            va_list ap2;
-            va_start(ap2, str);
-            vfprintf(logfile, str, ap2);
-            va_end(ap2);
+    bool db = m_enableLogDB && m_dbLogLevel > LOGL_DETAIL;
+    bool local = m_logLevel > LOGL_DETAIL;
+    if (!db && !local)
+        return;
 
-            fprintf(logfile, "\n" );
-            fflush(logfile);
-        }
-    }
-    fflush(stdout);
+    va_list ap;
+    va_start(ap, str);
+    Post(LOG_MESSAGE_DEBUG, db ? LOG_TYPE_DEBUG : MAX_LOG_TYPES, local, 0, str, ap);
+    va_end(ap);
 }
 
 void Log::outStringInLine(const char * str, ...)
@@ -847,17 +1021,9 @@ void Log::outStringInLine(const char * str, ...)
         return;
 
     va_list ap;
-
     va_start(ap, str);
-    vutf8printf(stdout, str, &ap);
+    Post(LOG_MESSAGE_STRING_INLINE, MAX_LOG_TYPES, true, 0, str, ap);
     va_end(ap);
-
-    if (logfile)
-    {
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        va_end(ap);
-    }
 }
 
 void Log::outCommand(uint32 account, const char * str, ...)
@@ -866,68 +1032,15 @@ void Log::outCommand(uint32 account, const char * str, ...)
         return;
 
     // TODO: support accountid
-    if (m_enableLogDB && m_dbGM)
-    {
-        va_list ap2;
-        va_start(ap2, str);
-        char nnew_str[MAX_QUERY_LEN];
-        vsnprintf(nnew_str, MAX_QUERY_LEN, str, ap2);
-        outDB(LOG_TYPE_GM, nnew_str);
-        va_end(ap2);
-    }
-
-    if (m_logLevel > LOGL_NORMAL)
-    {
-        if (m_colored)
-            SetColor(true, m_colors[LOGL_BASIC]);
-
-        va_list ap;
-        va_start(ap, str);
-        vutf8printf(stdout, str, &ap);
-        va_end(ap);
-
-        if (m_colored)
-            ResetColor(true);
-
-        printf("\n");
-
-        if (logfile)
-        {
-            outTimestamp(logfile);
-            va_list ap2;
-            va_start(ap2, str);
-            vfprintf(logfile, str, ap2);
-            fprintf(logfile, "\n" );
-            va_end(ap2);
-            fflush(logfile);
-        }
-    }
-
-    if (m_gmlog_per_account)
-    {
-        if (FILE* per_file = openGmlogPerAccount (account))
-        {
-            outTimestamp(per_file);
-            va_list ap;
-            va_start(ap, str);
-            vfprintf(per_file, str, ap);
-            fprintf(per_file, "\n" );
-            va_end(ap);
-            fclose(per_file);
-        }
-    }
-    else if (gmLogfile)
-    {
-        outTimestamp(gmLogfile);
-        va_list ap;
-        va_start(ap, str);
-        vfprintf(gmLogfile, str, ap);
-        fprintf(gmLogfile, "\n" );
-        va_end(ap);
-        fflush(gmLogfile);
-    }
+    bool db = m_enableLogDB && m_dbGM;
+    bool local = m_logLevel > LOGL_NORMAL || m_gmlog_per_account || gmLogfile;
+    if (!db && !local)
+        return;
 
-    fflush(stdout);
+    va_list ap;
+    va_start(ap, str);
+    Post(LOG_MESSAGE_COMMAND, db ? LOG_TYPE_GM : MAX_LOG_TYPES, local, account, str, ap);
+    va_end(ap);
 }
 
 void Log::outChar(const char * str, ...)
@@ -935,26 +1048,14 @@ void Log::outChar(const char * str, ...)
     if (!str)
         return;
 
-    if (m_enableLogDB && m_dbChar)
-    {
-        va_list ap2;
-        va_start(ap2, str);
-        char nnew_str[MAX_QUERY_LEN];
-        vsnprintf(nnew_str, MAX_QUERY_LEN, str, ap2);
-        outDB(LOG_TYPE_CHAR, nnew_str);
-        va_end(ap2);
-    }
+    bool db = m_enableLogDB && m_dbChar;
+    if (!db && !charLogfile)
+        return;
 
-    if (charLogfile)
-    {
-        outTimestamp(charLogfile);
-        va_list ap;
-        va_start(ap, str);
-        vfprintf(charLogfile, str, ap);
-        fprintf(charLogfile, "\n" );
-        va_end(ap);
-        fflush(charLogfile);
-    }
+    va_list ap;
+    va_start(ap, str);
+    Post(LOG_MESSAGE_CHAR, db ? LOG_TYPE_CHAR : MAX_LOG_TYPES, charLogfile != NULL, 0, str, ap);
+    va_end(ap);
 }
 
 void Log::outCharDump(const char * str, uint32 account_id, uint32 guid, const char * name)
@@ -985,26 +1086,14 @@ void Log::outRemote(const char * str, ...)
     if (!str)
         return;
 
-    if (m_enableLogDB && m_dbRA)
-    {
-        va_list ap2;
-        va_start(ap2, str);
-        char nnew_str[MAX_QUERY_LEN];
-        vsnprintf(nnew_str, MAX_QUERY_LEN, str, ap2);
-        outDB(LOG_TYPE_RA, nnew_str);
-        va_end(ap2);
-    }
+    bool db = m_enableLogDB && m_dbRA;
+    if (!db && !raLogfile)
+        return;
 
-    if (raLogfile)
-    {
-        outTimestamp(raLogfile);
-        va_list ap;
-        va_start(ap, str);
-        vfprintf(raLogfile, str, ap);
-        fprintf(raLogfile, "\n" );
-        va_end(ap);
-        fflush(raLogfile);
-    }
+    va_list ap;
+    va_start(ap, str);
+    Post(LOG_MESSAGE_REMOTE, db ? LOG_TYPE_RA : MAX_LOG_TYPES, raLogfile != NULL, 0, str, ap);
+    va_end(ap);
 }
 
 void Log::outChat(const char * str, ...)
@@ -1012,43 +1101,25 @@ void Log::outChat(const char * str, ...)
     if (!str)
         return;
 
-    if (m_enableLogDB && m_dbChat)
-    {
-        va_list ap2;
-        va_start(ap2, str);
-        char nnew_str[MAX_QUERY_LEN];
-        vsnprintf(nnew_str, MAX_QUERY_LEN, str, ap2);
-        outDB(LOG_TYPE_CHAT, nnew_str);
-        va_end(ap2);
-    }
+    bool db = m_enableLogDB && m_dbChat;
+    if (!db && !chatLogfile)
+        return;
 
-    if (chatLogfile)
-    {
-        outTimestamp(chatLogfile);
-        va_list ap;
-        va_start(ap, str);
-        vfprintf(chatLogfile, str, ap);
-        fprintf(chatLogfile, "\n" );
-        fflush(chatLogfile);
-        va_end(ap);
-    }
+    va_list ap;
+    va_start(ap, str);
+    Post(LOG_MESSAGE_CHAT, db ? LOG_TYPE_CHAT : MAX_LOG_TYPES, chatLogfile != NULL, 0, str, ap);
+    va_end(ap);
 }
 
 void Log::outCast(const char * str, ...)
 {
-    if (!str)
+    if (!str || !castLogfile)
         return;
 
-    if (castLogfile)
-    {
-        outTimestamp(castLogfile);
-        va_list ap;
-        va_start(ap, str);
-        vfprintf(castLogfile, str, ap);
-        fprintf(castLogfile, "\n" );
-        fflush(castLogfile);
-        va_end(ap);
-    }
+    va_list ap;
+    va_start(ap, str);
+    Post(LOG_MESSAGE_CAST, MAX_LOG_TYPES, true, 0, str, ap);
+    va_end(ap);
 }
 
 void Log::outErrorST(const char * str, ...)
@@ -1065,17 +1136,83 @@ void Log::outErrorST(const char * str, ...)
 
 void Log::outWarden(const char * str, ...)
 {
-    if (!str)
+    if (!str || !wardenLogFile)
+        return;
+
+    va_list ap;
+    va_start(ap, str);
+    Post(LOG_MESSAGE_WARDEN, MAX_LOG_TYPES, true, 0, str, ap);
+    va_end(ap);
+}
+
+void Log::outBenchmark(const char * str, ...)
+{
+    if (!str || !benchmarkLogFile)
         return;
 
-    if (wardenLogFile)
+    va_list ap;
+    va_start(ap, str);
+    Post(LOG_MESSAGE_BENCHMARK, MAX_LOG_TYPES, true, 0, str, ap);
+    va_end(ap);
+}
+
+/// Threads logging lines like a busy map does
+class LogBenchmarkTask : public ACE_Task_Base
+{
+    public:
+        LogBenchmarkTask(uint32 lines) : m_lines(lines), m_nextThread(0) {}
+
+        int svc()
+        {
+            uint32 thread = uint32(m_nextThread++);
+            for (uint32 i = 0; i < m_lines; ++i)
+                sLog->outBenchmark("Thread %u line %u: spell %u hit creature " UI64FMTD " for %u damage at %.2f %.2f %.2f",
+                    thread, i, 133 + i % 1000, uint64(0xF130000000000000ULL) | i, i * 7 % 4000, 1.5f * i, -2.25f * i, 42.0f);
+            return 0;
+        }
+
+    private:
+        uint32 m_lines;
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_nextThread;
+};
+
+bool Log::Benchmark(uint32 threads, uint32 lines, bool async, uint32& postTime, uint32& totalTime)
+{
+    if (async && !m_writer)
+        return false;
+
+    std::string file = m_logsDir + "LogBenchmark.log";
     {
-        outTimestamp(wardenLogFile);
-        va_list ap;
-        va_start(ap, str);
-        vfprintf(wardenLogFile, str, ap);
-        fprintf(wardenLogFile, "\n" );
-        fflush(wardenLogFile);
-        va_end(ap);
+        AXIUM_GUARD(ACE_Recursive_Thread_Mutex, m_ringLock);
+        benchmarkLogFile = fopen(file.c_str(), "w");
+        if (!benchmarkLogFile)
+            return false;
+
+        m_benchmarkAsync = async;
     }
+
+    uint32 start = getMSTime();
+
+    LogBenchmarkTask task(lines);
+    task.activate(THR_NEW_LWP | THR_JOINABLE, int(std::max(threads, uint32(1))));
+    task.wait();
+
+    postTime = GetMSTimeDiffToNow(start);
+
+    {
+        // the rings of the benchmark threads were written as the threads ended,
+        // the writer may still be busy with them
+        AXIUM_GUARD(ACE_Recursive_Thread_Mutex, m_ringLock);
+        if (m_writer)
+            WriteBuffered();
+
+        totalTime = GetMSTimeDiffToNow(start);
+
+        FILE* benchmarkFile = benchmarkLogFile;
+        benchmarkLogFile = NULL;
+        fclose(benchmarkFile);
+    }
+
+    ACE_OS::unlink(file.c_str());
+    return true;
 }
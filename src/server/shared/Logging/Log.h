@@ -3,8 +3,13 @@
 
 #include "Common.h"
 #include <ace/Singleton.h>
+#include <ace/Atomic_Op.h>
+#include <ace/Recursive_Thread_Mutex.h>
 
 class Config;
+class LogRing;
+class LogWriter;
+class LogBenchmarkTask;
 
 enum DebugLogFilters
 {
@@ -82,9 +87,56 @@ enum ColorTypes
 
 const int Colors = int(WHITE)+1;
 
+// which out* function a line comes from, tells where the writer puts it
+enum LogMessageType
+{
+    LOG_MESSAGE_STRING,
+    LOG_MESSAGE_STRING_INLINE,
+    LOG_MESSAGE_ERROR,
+    LOG_MESSAGE_CRASH,
+    LOG_MESSAGE_BASIC,
+    LOG_MESSAGE_DETAIL,
+    LOG_MESSAGE_DEBUG,
+    LOG_MESSAGE_DEBUG_INLINE,
+    LOG_MESSAGE_SQL_DRIVER,
+    LOG_MESSAGE_SQL_DEV,
+    LOG_MESSAGE_ERROR_DB,
+    LOG_MESSAGE_COMMAND,
+    LOG_MESSAGE_CHAR,
+    LOG_MESSAGE_REMOTE,
+    LOG_MESSAGE_CHAT,
+    LOG_MESSAGE_CAST,
+    LOG_MESSAGE_ARENA,
+    LOG_MESSAGE_WARDEN,
+    LOG_MESSAGE_DB,                                     // database only
+    LOG_MESSAGE_BENCHMARK
+};
+
+struct LogMessage
+{
+    unsigned long sequence;                             // order of the lines over all threads
+    time_t time;
+    uint32 account;                                     // of a gm command
+    uint32 length;                                      // of the text that follows
+    uint8 type;                                         // LogMessageType
+    uint8 db;                                           // LogTypes, MAX_LOG_TYPES if not for the database
+    bool local;                                         // to the console and the files, not only the database
+};
+
+/*
+    With Log.Async, a line is formatted by the thread logging it and copied into a ring
+    buffer of that thread, without any lock. A writer thread takes the lines of all rings
+    in their order every few milliseconds, writes them and flushes the files once, and
+    inserts the database lines in one transaction. When the ring of a thread is full, errors,
+    gm commands and other lines that must not be lost make that thread write all rings first,
+    so they still come out in order; the others are dropped and counted.
+*/
 class Log
 {
     friend class ACE_Singleton<Log, ACE_Thread_Mutex>;
+    friend class LogRing;
+    friend class LogWriter;
+    friend class LogBenchmarkTask;
 
     private:
         Log();
@@ -124,6 +176,7 @@ class Log
         void outCharDump( const char * str, uint32 account_id, uint32 guid, const char * name );
 
         static void outTimestamp(FILE* file);
+        static void outTimestamp(FILE* file, time_t t);
         static std::string GetTimestampStr();
 
         void SetLogLevel(char * Level);
@@ -140,7 +193,30 @@ class Log
         void SetLogDB(bool enable) { m_enableLogDB = enable; }
         void SetLogDBLater(bool value) { m_enableLogDBLater = value; }
         bool GetSQLDriverQueryLogging() const { return m_sqlDriverQueryLogging; }
+
+        bool IsAsync() const { return m_writer != NULL; }
+        //! Writes the lines buffered by all threads now
+        void Flush();
+        uint64 GetDroppedLines() const { return m_dropped; }
+        //! threads log lines each to a scratch file, returns the ms until all were written and
+        //! in postTime the ms until all were logged. False if async is asked but not enabled.
+        bool Benchmark(uint32 threads, uint32 lines, bool async, uint32& postTime, uint32& totalTime);
     private:
+        void Post(LogMessageType type, LogTypes db, bool local, uint32 account, const char* format, va_list ap);
+        void Post(LogMessage& message, const char* text);
+        //! Puts the line on the console and in the files, flush after each line when not batched
+        void Write(LogMessage const& message, const char* text, bool flush);
+        void WriteDB(LogTypes type, const char* text);
+        void WriteLine(FILE* file, LogMessage const& message, const char* prefix, const char* text, bool timestamp, bool flush);
+        void WriteConsole(bool stdout_stream, ColorTypes color, bool colored, const char* text, bool newline, bool flush);
+        void FlushFiles();
+
+        //! Writes the lines of all rings in order, m_ringLock must be held
+        void WriteBuffered();
+        void RegisterRing(LogRing* ring);
+        void UnregisterRing(LogRing* ring);
+        void outBenchmark(const char* str, ...)                ATTR_PRINTF(2, 3);
+
         FILE* openLogFile(char const* configFileName, char const* configTimeStampFlag, char const* mode);
         FILE* openGmlogPerAccount(uint32 account);
 
@@ -155,6 +231,7 @@ class Log
         FILE* sqlLogFile;
         FILE* sqlDevLogFile;
         FILE* wardenLogFile;
+        FILE* benchmarkLogFile;
 
         // cache values for after initilization use (like gm log per account case)
         std::string m_logsDir;
@@ -190,6 +267,17 @@ class Log
         std::string m_dumpsDir;
 
         DebugLogFilters m_DebugLogMask;
+
+        // asynchronous writing
+        LogWriter* m_writer;
+        uint32 m_ringSize;                                  // bytes, power of two
+        uint32 m_writeInterval;                             // ms
+        bool m_benchmarkAsync;
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_sequence;
+        ACE_Recursive_Thread_Mutex m_ringLock;              // m_rings and writing what they hold; a line logged while
+                                                            // writing may register the ring of the writing thread
+        std::vector<LogRing*> m_rings;
+        uint64 m_dropped;
 };
 
 #define sLog ACE_Singleton<Log, ACE_Thread_Mutex>::instance()
@@ -5,6 +5,7 @@
 #include "Debugging/Errors.h"
 #include "Logging/Log.h"
 #include "Utilities/ByteConverter.h"
+#include "Packets/ByteBufferPool.h"
 
 class ByteBufferException
 {
@@ -30,12 +31,9 @@ class ByteBufferException
 class ByteBuffer
 {
     public:
-        const static size_t DEFAULT_SIZE = 0x1000;
-
-        // constructor
+        // constructor, the storage grows through the pool size classes as needed
         ByteBuffer(): _rpos(0), _wpos(0)
         {
-            _storage.reserve(DEFAULT_SIZE);
         }
 
         // constructor
@@ -472,7 +470,7 @@ class ByteBuffer
 
     protected:
         size_t _rpos, _wpos;
-        std::vector<uint8> _storage;
+        std::vector<uint8, ByteBufferAllocator<uint8> > _storage;
 };
 
 template <typename T>
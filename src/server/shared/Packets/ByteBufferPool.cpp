@@ -0,0 +1,244 @@
+#include "ByteBufferPool.h"
+
+#include <ace/TSS_T.h>
+#include <ace/Thread_Mutex.h>
+#include <ace/Atomic_Op.h>
+#include <ace/Guard_T.h>
+
+#include <cstdlib>
+
+#define MAX_BYTE_BUFFER_SIZE_CLASSES 5
+
+static size_t const ByteBufferSizeClasses[MAX_BYTE_BUFFER_SIZE_CLASSES] = { 64, 256, 1024, 4096, 65536 };
+
+// free blocks kept per thread and size class, around 1MB per class at most, as many again given back by other threads
+static uint32 const ByteBufferFreeLimits[MAX_BYTE_BUFFER_SIZE_CLASSES] = { 4096, 2048, 1024, 256, 16 };
+
+// in front of every pooled block, keeps the data aligned
+union ByteBufferBlockHeader
+{
+    class ByteBufferFreeLists* owner;
+    double align;
+};
+
+#define BYTE_BUFFER_BLOCK_HEADER sizeof(ByteBufferBlockHeader)
+
+/*
+    Free lists of one thread. Only that thread pushes to and pops from its lists; other
+    threads give blocks back through the returned lists, which the owner takes over in
+    one go once its own list of the size class is empty. The lists outlive the thread
+    while blocks it allocated are still in use elsewhere.
+*/
+class ByteBufferFreeLists
+{
+    public:
+        ByteBufferFreeLists() : _refs(1), _orphaned(false)
+        {
+            for (uint8 i = 0; i < MAX_BYTE_BUFFER_SIZE_CLASSES; ++i)
+            {
+                _heads[i] = NULL;
+                _counts[i] = 0;
+                _returned[i] = NULL;
+                _returnedCounts[i] = 0;
+            }
+        }
+
+        void* Pop(uint8 sizeClass)
+        {
+            if (!_heads[sizeClass] && _returnedCounts[sizeClass])
+            {
+                ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, _returnLock, NULL);
+                _heads[sizeClass] = _returned[sizeClass];
+                _counts[sizeClass] = _returnedCounts[sizeClass];
+                _returned[sizeClass] = NULL;
+                _returnedCounts[sizeClass] = 0;
+            }
+
+            FreeBlock* block = _heads[sizeClass];
+            if (!block)
+                return NULL;
+
+            _heads[sizeClass] = block->next;
+            --_counts[sizeClass];
+            return block;
+        }
+
+        //! A block of the calling thread, false if the list is full
+        bool Push(uint8 sizeClass, void* ptr)
+        {
+            if (_counts[sizeClass] >= ByteBufferFreeLimits[sizeClass])
+                return false;
+
+            FreeBlock* block = static_cast<FreeBlock*>(ptr);
+            block->next = _heads[sizeClass];
+            _heads[sizeClass] = block;
+            ++_counts[sizeClass];
+            return true;
+        }
+
+        //! A block given back by another thread, false if the list is full or the owner ended
+        bool Return(uint8 sizeClass, void* ptr)
+        {
+            ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, _returnLock, false);
+
+            if (_orphaned || _returnedCounts[sizeClass] >= ByteBufferFreeLimits[sizeClass])
+                return false;
+
+            FreeBlock* block = static_cast<FreeBlock*>(ptr);
+            block->next = _returned[sizeClass];
+            _returned[sizeClass] = block;
+            ++_returnedCounts[sizeClass];
+            return true;
+        }
+
+        //! Every block allocated for these lists holds a reference
+        void AddReference() { ++_refs; }
+        void RemoveReference()
+        {
+            if (--_refs == 0)
+                delete this;
+        }
+
+        //! The owning thread ends, frees the blocks kept and drops its reference
+        void Orphan()
+        {
+            FreeBlock* returned[MAX_BYTE_BUFFER_SIZE_CLASSES];
+            {
+                ACE_GUARD(ACE_Thread_Mutex, guard, _returnLock);
+                _orphaned = true;
+                for (uint8 i = 0; i < MAX_BYTE_BUFFER_SIZE_CLASSES; ++i)
+                {
+                    returned[i] = _returned[i];
+                    _returned[i] = NULL;
+                    _returnedCounts[i] = 0;
+                }
+            }
+
+            for (uint8 i = 0; i < MAX_BYTE_BUFFER_SIZE_CLASSES; ++i)
+            {
+                FreeList(_heads[i]);
+                _heads[i] = NULL;
+                _counts[i] = 0;
+                FreeList(returned[i]);
+            }
+
+            RemoveReference();
+        }
+
+        //! Back to the heap
+        static void Release(void* ptr)
+        {
+            ByteBufferBlockHeader* header = reinterpret_cast<ByteBufferBlockHeader*>(static_cast<char*>(ptr) - BYTE_BUFFER_BLOCK_HEADER);
+            ByteBufferFreeLists* owner = header->owner;
+            free(header);
+            if (owner)
+                owner->RemoveReference();
+        }
+
+    private:
+        struct FreeBlock
+        {
+            FreeBlock* next;
+        };
+
+        ~ByteBufferFreeLists() { }
+
+        void FreeList(FreeBlock* block)
+        {
+            while (block)
+            {
+                FreeBlock* next = block->next;
+                Release(block);
+                block = next;
+            }
+        }
+
+        FreeBlock* _heads[MAX_BYTE_BUFFER_SIZE_CLASSES];
+        uint32 _counts[MAX_BYTE_BUFFER_SIZE_CLASSES];
+
+        ACE_Thread_Mutex _returnLock;                       // _returned, _returnedCounts and _orphaned
+        FreeBlock* _returned[MAX_BYTE_BUFFER_SIZE_CLASSES];
+        volatile uint32 _returnedCounts[MAX_BYTE_BUFFER_SIZE_CLASSES]; // read without the lock by the owner to skip empty lists
+        bool _orphaned;
+
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> _refs;
+};
+
+/// Free lists of the calling thread, orphaned when the thread ends
+class ByteBufferThreadLists
+{
+    public:
+        ByteBufferThreadLists() : _lists(new ByteBufferFreeLists()) { }
+        ~ByteBufferThreadLists() { _lists->Orphan(); }
+
+        ByteBufferFreeLists* Get() const { return _lists; }
+
+    private:
+        ByteBufferFreeLists* _lists;
+};
+
+static ByteBufferFreeLists* GetFreeLists()
+{
+    // never destroyed, buffers in static objects may still be freed after the end of main
+    static ACE_TSS<ByteBufferThreadLists>* threadLists = new ACE_TSS<ByteBufferThreadLists>();
+    ByteBufferThreadLists* lists = *threadLists;
+    return lists ? lists->Get() : NULL;
+}
+
+static int8 GetSizeClass(size_t size)
+{
+    for (uint8 i = 0; i < MAX_BYTE_BUFFER_SIZE_CLASSES; ++i)
+        if (size <= ByteBufferSizeClasses[i])
+            return int8(i);
+
+    return -1;
+}
+
+void* ByteBufferPool::Allocate(size_t size)
+{
+    int8 sizeClass = GetSizeClass(size);
+    if (sizeClass < 0)
+    {
+        if (void* ptr = malloc(size))
+            return ptr;
+        throw std::bad_alloc();
+    }
+
+    ByteBufferFreeLists* freeLists = GetFreeLists();
+    if (freeLists)
+        if (void* ptr = freeLists->Pop(uint8(sizeClass)))
+            return ptr;
+
+    ByteBufferBlockHeader* header = static_cast<ByteBufferBlockHeader*>(malloc(BYTE_BUFFER_BLOCK_HEADER + ByteBufferSizeClasses[sizeClass]));
+    if (!header)
+        throw std::bad_alloc();
+
+    header->owner = freeLists;
+    if (freeLists)
+        freeLists->AddReference();
+
+    return reinterpret_cast<char*>(header) + BYTE_BUFFER_BLOCK_HEADER;
+}
+
+void ByteBufferPool::Free(void* ptr, size_t size)
+{
+    if (!ptr)
+        return;
+
+    int8 sizeClass = GetSizeClass(size);
+    if (sizeClass < 0)
+    {
+        free(ptr);
+        return;
+    }
+
+    // back to the lists of the thread that allocated the block
+    ByteBufferFreeLists* owner = reinterpret_cast<ByteBufferBlockHeader*>(static_cast<char*>(ptr) - BYTE_BUFFER_BLOCK_HEADER)->owner;
+    if (owner)
+    {
+        if (owner == GetFreeLists() ? owner->Push(uint8(sizeClass), ptr) : owner->Return(uint8(sizeClass), ptr))
+            return;
+    }
+
+    ByteBufferFreeLists::Release(ptr);
+}
@@ -0,0 +1,71 @@
+#ifndef _BYTEBUFFERPOOL_H
+#define _BYTEBUFFERPOOL_H
+
+#include "Define.h"
+
+#include <cstddef>
+#include <limits>
+#include <new>
+
+/*
+    Storage of ByteBuffer and WorldPacket.
+
+    Requests are rounded up to one of the size classes below and served from free
+    lists of the calling thread. A block always goes back to the lists of the thread
+    that allocated it: blocks freed by another thread (packets built in a map thread
+    and sent from the network thread) are handed back through a locked return list
+    that the owner takes over when its own list runs empty. Every list is bounded and
+    the excess is returned to the heap. Requests above the largest class go to the heap.
+*/
+class ByteBufferPool
+{
+    public:
+        static void* Allocate(size_t size);
+        static void Free(void* ptr, size_t size);
+};
+
+/// std::allocator replacement for the storage vector of ByteBuffer
+template<class T>
+class ByteBufferAllocator
+{
+    public:
+        typedef T value_type;
+        typedef T* pointer;
+        typedef T const* const_pointer;
+        typedef T& reference;
+        typedef T const& const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+        template<class U> struct rebind { typedef ByteBufferAllocator<U> other; };
+
+        ByteBufferAllocator() { }
+        ByteBufferAllocator(ByteBufferAllocator const&) { }
+        template<class U> ByteBufferAllocator(ByteBufferAllocator<U> const&) { }
+
+        pointer address(reference x) const { return &x; }
+        const_pointer address(const_reference x) const { return &x; }
+
+        pointer allocate(size_type n, void const* /*hint*/ = 0)
+        {
+            return static_cast<pointer>(ByteBufferPool::Allocate(n * sizeof(T)));
+        }
+
+        void deallocate(pointer p, size_type n)
+        {
+            ByteBufferPool::Free(p, n * sizeof(T));
+        }
+
+        size_type max_size() const { return std::numeric_limits<size_type>::max() / sizeof(T); }
+
+        void construct(pointer p, T const& val) { new (static_cast<void*>(p)) T(val); }
+        void destroy(pointer p) { p->~T(); }
+};
+
+template<class T, class U>
+inline bool operator==(ByteBufferAllocator<T> const&, ByteBufferAllocator<U> const&) { return true; }
+
+template<class T, class U>
+inline bool operator!=(ByteBufferAllocator<T> const&, ByteBufferAllocator<U> const&) { return false; }
+
+#endif
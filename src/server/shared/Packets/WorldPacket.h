@@ -4,17 +4,63 @@
 #include "Common.h"
 #include "ByteBuffer.h"
 
+#include <ace/Atomic_Op.h>
+#include <ace/Thread_Mutex.h>
+
+/// Refcounted contents of a packet, queued by the sockets it is sent to
+class PacketPayload
+{
+    public:
+        explicit PacketPayload(ByteBuffer const& data) : m_refs(1)
+        {
+            if (!data.empty())
+                m_data.assign(data.contents(), data.contents() + data.size());
+        }
+
+        void AddReference() { ++m_refs; }
+        void RemoveReference()
+        {
+            if (--m_refs == 0)
+                delete this;
+        }
+
+        uint8 const* contents() const { return &m_data[0]; }
+        size_t size() const { return m_data.size(); }
+
+    private:
+        friend class WorldPacket;
+
+        PacketPayload() : m_refs(1) { }
+        ~PacketPayload() { }
+
+        std::vector<uint8, ByteBufferAllocator<uint8> > m_data;
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_refs;
+};
+
 class WorldPacket : public ByteBuffer
 {
     public:
                                                             // just container for later use
-        WorldPacket()                                       : ByteBuffer(0), m_opcode(0)
+        WorldPacket()                                       : ByteBuffer(0), m_opcode(0), m_payload(NULL)
         {
         }
-        explicit WorldPacket(uint16 opcode, size_t res=200) : ByteBuffer(res), m_opcode(opcode) { }
+        explicit WorldPacket(uint16 opcode, size_t res=200) : ByteBuffer(res), m_opcode(opcode), m_payload(NULL) { }
                                                             // copy constructor
-        WorldPacket(const WorldPacket &packet)              : ByteBuffer(packet), m_opcode(packet.m_opcode)
+        WorldPacket(const WorldPacket &packet)              : ByteBuffer(packet), m_opcode(packet.m_opcode), m_payload(NULL)
+        {
+        }
+
+        ~WorldPacket()
+        {
+            if (m_payload)
+                m_payload->RemoveReference();
+        }
+
+        WorldPacket& operator=(const WorldPacket &packet)
         {
+            ByteBuffer::operator=(packet);
+            m_opcode = packet.m_opcode;
+            return *this;
         }
 
         void Initialize(uint16 opcode, size_t newres=200)
@@ -27,8 +73,55 @@ class WorldPacket : public ByteBuffer
         uint16 GetOpcode() const { return m_opcode; }
         void SetOpcode(uint16 opcode) { m_opcode = opcode; }
 
+        /// Contents as a payload for the socket output queues; the caller owns one reference.
+        /// The contents are moved into the payload and the packet is left empty, unless it is
+        /// shared (see SharedPacketScope): then all sockets get the same payload.
+        PacketPayload* AcquirePayload()
+        {
+            if (m_payload)
+            {
+                m_payload->AddReference();
+                return m_payload;
+            }
+
+            PacketPayload* payload = new PacketPayload();
+            payload->m_data.swap(_storage);
+            clear();
+            return payload;
+        }
+
+        bool IsShared() const { return m_payload != NULL; }
+
     protected:
+        friend class SharedPacketScope;
+
         uint16 m_opcode;
+        mutable PacketPayload* m_payload;                   // only set within a SharedPacketScope
 };
-#endif
 
+/**
+ * Shares the contents of a packet between all the sockets it is sent to while in scope,
+ * for broadcasts. The packet must not be changed within the scope.
+ */
+class SharedPacketScope
+{
+    public:
+        explicit SharedPacketScope(WorldPacket const* packet) : _packet(packet->m_payload ? NULL : packet)
+        {
+            if (_packet)
+                _packet->m_payload = new PacketPayload(*_packet);
+        }
+
+        ~SharedPacketScope()
+        {
+            if (!_packet)
+                return;
+
+            _packet->m_payload->RemoveReference();
+            _packet->m_payload = NULL;
+        }
+
+    private:
+        WorldPacket const* _packet;                         // NULL if an outer scope shares the packet already
+};
+#endif
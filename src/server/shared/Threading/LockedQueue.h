@@ -80,6 +80,33 @@ namespace ACE_Based
                 return true;
             }
 
+            //! Moves the items at the front of the queue accepted by the checker to result, in order, with a single lock.
+            template<class Checker>
+            void next_all(StorageType& result, Checker& check)
+            {
+                ACE_GUARD (LockType, g, this->_lock);
+
+                typename StorageType::iterator end = _queue.begin();
+                while (end != _queue.end() && check.Process(*end))
+                    ++end;
+
+                if (end == _queue.end() && result.empty())
+                    result.swap(_queue);
+                else
+                {
+                    result.insert(result.end(), _queue.begin(), end);
+                    _queue.erase(_queue.begin(), end);
+                }
+            }
+
+            //! Puts items back at the front of the queue, in order.
+            template<class Iterator>
+            void add_front(Iterator first, Iterator last)
+            {
+                ACE_GUARD (LockType, g, this->_lock);
+                _queue.insert(_queue.begin(), first, last);
+            }
+
             //! Peeks at the top of the queue. Check if the queue is empty before calling! Remember to unlock after use if autoUnlock == false.
             T& peek(bool autoUnlock = false)
             {
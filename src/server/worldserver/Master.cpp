@@ -316,7 +316,9 @@ bool Master::_StartDB()
 
     sLog->SetLogDB(false);
     std::string dbstring;
-    uint8 async_threads, synch_threads;
+    uint8 async_threads, synch_threads, synch_threads_max;
+    bool statement_cache;
+    bool statement_stats;
 
     dbstring = ConfigMgr::GetStringDefault("WorldDatabaseInfo", "");
     if (dbstring.empty())
@@ -334,8 +336,11 @@ bool Master::_StartDB()
     }
 
     synch_threads = ConfigMgr::GetIntDefault("WorldDatabase.SynchThreads", 1);
+    synch_threads_max = ConfigMgr::GetIntDefault("WorldDatabase.SynchThreadsMax", synch_threads);
+    statement_cache = ConfigMgr::GetBoolDefault("WorldDatabase.StatementCache", false);
+    statement_stats = ConfigMgr::GetBoolDefault("WorldDatabase.StatementStats", false);
     ///- Initialise the world database
-    if (!WorldDatabase.Open(dbstring, async_threads, synch_threads))
+    if (!WorldDatabase.Open(dbstring, async_threads, synch_threads, synch_threads_max, statement_cache, statement_stats))
     {
         sLog->outError("Cannot connect to world database %s", dbstring.c_str());
         return false;
@@ -349,7 +354,7 @@ bool Master::_StartDB()
         return false;
     }
 
-    async_threads = ConfigMgr::GetIntDefault("CharacterDatabase.WorkerThreads", 1);
+    async_threads = ConfigMgr::GetIntDefault("CharacterDatabase.WorkerThreads", 4);
     if (async_threads < 1 || async_threads > 32)
     {
         sLog->outError("Character database: invalid number of worker threads specified. "
@@ -358,9 +363,12 @@ bool Master::_StartDB()
     }
 
     synch_threads = ConfigMgr::GetIntDefault("CharacterDatabase.SynchThreads", 2);
+    synch_threads_max = ConfigMgr::GetIntDefault("CharacterDatabase.SynchThreadsMax", synch_threads);
+    statement_cache = ConfigMgr::GetBoolDefault("CharacterDatabase.StatementCache", false);
+    statement_stats = ConfigMgr::GetBoolDefault("CharacterDatabase.StatementStats", false);
 
     ///- Initialise the Character database
-    if (!CharacterDatabase.Open(dbstring, async_threads, synch_threads))
+    if (!CharacterDatabase.Open(dbstring, async_threads, synch_threads, synch_threads_max, statement_cache, statement_stats))
     {
         sLog->outError("Cannot connect to Character database %s", dbstring.c_str());
         return false;
@@ -383,8 +391,11 @@ bool Master::_StartDB()
     }
 
     synch_threads = ConfigMgr::GetIntDefault("LoginDatabase.SynchThreads", 1);
+    synch_threads_max = ConfigMgr::GetIntDefault("LoginDatabase.SynchThreadsMax", synch_threads);
+    statement_cache = ConfigMgr::GetBoolDefault("LoginDatabase.StatementCache", false);
+    statement_stats = ConfigMgr::GetBoolDefault("LoginDatabase.StatementStats", false);
     ///- Initialise the login database
-    if (!LoginDatabase.Open(dbstring, async_threads, synch_threads))
+    if (!LoginDatabase.Open(dbstring, async_threads, synch_threads, synch_threads_max, statement_cache, statement_stats))
     {
         sLog->outError("Cannot connect to login database %s", dbstring.c_str());
         return false;
@@ -9,10 +9,12 @@
 #include "Database/DatabaseEnv.h"
 #include "ScriptMgr.h"
 #include "BattlegroundMgr.h"
+#include "PvPMgr.h"
 #include "MapManager.h"
 #include "Timer.h"
 #include "WorldRunnable.h"
 #include "SharedDefines.h"
+#include "UpdateProfiler.h"
 
 #ifdef _WIN32
 #include "ServiceWin32.h"
@@ -37,7 +39,11 @@ void WorldRunnable::run()
 
         uint32 diff = getMSTimeDiff(realPrevTime, realCurrTime);
 
-        sWorld->Update(diff);
+        {
+            ProfileZone profile(PROFILE_ZONE_WORLD_UPDATE);
+            sWorld->Update(diff);
+        }
+        sUpdateProfiler->Update(diff);
         realPrevTime = realCurrTime;
 
         // diff (D0) include time of previous sleep (d0) + tick time (t0)
@@ -68,6 +74,8 @@ void WorldRunnable::run()
     sWorld->KickAll();                                       // save and kick all players
     sWorld->UpdateSessions(1);                               // real players unload required UpdateSessions call
 
+    sPvPMgr->SaveToDB();                                     // arena stats not written back yet
+
     // unload battleground templates before different singletons destroyed
     sBattlegroundMgr->DeleteAllBattlegrounds();
 